@@ -0,0 +1,149 @@
+"""
+Web asset generator
+
+Gzips a web UI directory (index.html, app.css, app.js) into a C header of
+PROGMEM arrays and a WebAsset table (teensy-main/include/web_asset.h), so
+the firmware serves precompressed files straight from flash.
+
+index.html's references to app.css and app.js are rewritten to
+app.css?v=<etag>, which lets those be cached for good: new content means
+a new URL. Output is deterministic (no gzip timestamp), so an unchanged
+UI regenerates byte for byte and the header is only rewritten when the
+files change.
+
+Runs as a PlatformIO pre-build script for the ESP firmware
+(web/ -> src/web_assets.h), or by hand for any directory:
+
+    python3 scripts/pre_build.py                     # ESP firmware
+    python3 esp8266-wifi/scripts/pre_build.py web/osc_control osc_control_web.h
+"""
+
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+TYPES = {
+    ".html": "text/html",
+    ".css": "text/css",
+    ".js": "application/javascript",
+    ".svg": "image/svg+xml",
+    ".ico": "image/x-icon",
+    ".json": "application/json",
+}
+
+
+def etag_of(data):
+    return '"' + hashlib.sha1(data).hexdigest()[:12] + '"'
+
+
+def symbol_of(name):
+    return "web_" + re.sub(r"[^0-9A-Za-z]", "_", name)
+
+
+def load(web_dir):
+    assets = {}
+    for name in sorted(os.listdir(web_dir)):
+        ext = os.path.splitext(name)[1]
+        if ext not in TYPES:
+            continue
+        with open(os.path.join(web_dir, name), "rb") as f:
+            assets[name] = f.read()
+    if "index.html" not in assets:
+        sys.exit("pre_build.py: no index.html in " + web_dir)
+    return assets
+
+
+def version_references(assets):
+    """Point index.html at versioned URLs of everything else it uses."""
+    index = assets["index.html"]
+    versioned = set()
+    for name, data in assets.items():
+        if name == "index.html":
+            continue
+        tag = etag_of(data).strip('"')
+        for attr in (b"href", b"src"):
+            ref = attr + b'="' + name.encode() + b'"'
+            if ref in index:
+                index = index.replace(ref, attr + b'="' + name.encode() + b"?v=" + tag.encode() + b'"')
+                versioned.add(name)
+    assets["index.html"] = index
+    return versioned
+
+
+def render(label, guard, assets, versioned):
+    lines = [
+        "/**",
+        " * Generated by esp8266-wifi/scripts/pre_build.py from " + label + "/",
+        " * Do not edit; change the files there and regenerate.",
+        " * Include teensy-main/include/web_asset.h first.",
+        " */",
+        "",
+        "#ifndef " + guard,
+        "#define " + guard,
+        "",
+    ]
+    table = []
+    raw_total = 0
+    gz_total = 0
+    for name, data in assets.items():
+        gz = gzip.compress(data, 9, mtime=0)
+        symbol = symbol_of(name)
+        raw_total += len(data)
+        gz_total += len(gz)
+        lines.append("// %s: %d bytes, %d gzipped" % (name, len(data), len(gz)))
+        lines.append("static const uint8_t %s[] PROGMEM = {" % symbol)
+        for i in range(0, len(gz), 16):
+            lines.append("    " + ", ".join("0x%02x" % b for b in gz[i:i + 16]) + ",")
+        lines.append("};")
+        lines.append("")
+        ext = os.path.splitext(name)[1]
+        etag = etag_of(data).replace('"', '\\"')
+        table.append('    {"/%s", "%s", %s, %d, %d, "%s", %s},' % (
+            name, TYPES[ext], symbol, len(gz), len(data), etag,
+            "true" if name in versioned else "false"))
+
+    lines.append("// %d bytes, %d gzipped" % (raw_total, gz_total))
+    lines.append("static const WebAsset webAssets[] = {")
+    lines.extend(table)
+    lines.append("};")
+    lines.append("")
+    lines.append("static const size_t webAssetCount = sizeof(webAssets) / sizeof(webAssets[0]);")
+    lines.append("")
+    lines.append("#endif // " + guard)
+    lines.append("")
+    return "\n".join(lines)
+
+
+def generate(web_dir, header, root):
+    assets = load(web_dir)
+    versioned = version_references(assets)
+    label = os.path.relpath(os.path.abspath(web_dir), root).replace(os.sep, "/")
+    guard = re.sub(r"[^0-9A-Za-z]", "_", os.path.basename(header)).upper()
+    text = render(label, guard, assets, versioned)
+    if os.path.exists(header):
+        with open(header) as f:
+            if f.read() == text:
+                return False
+    with open(header, "w") as f:
+        f.write(text)
+    print("pre_build.py: " + header + " regenerated")
+    return True
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+    project = env["PROJECT_DIR"]  # noqa: F821
+    generate(os.path.join(project, "web"), os.path.join(project, "src", "web_assets.h"),
+             os.path.dirname(project))
+except NameError:
+    if __name__ == "__main__":
+        project = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+        root = os.path.dirname(project)
+        if len(sys.argv) == 3:
+            generate(sys.argv[1], sys.argv[2], root)
+        elif len(sys.argv) == 1:
+            generate(os.path.join(project, "web"), os.path.join(project, "src", "web_assets.h"), root)
+        else:
+            sys.exit(__doc__)
@@ -0,0 +1,154 @@
+/**
+ * ESP Bridge Implementation
+ */
+
+#include "esp_bridge.h"
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+EspBridge::EspBridge()
+    : flow(BRIDGE_TEENSY_RX_BUFFER),
+      statusCache(formatStatus, this, BRIDGE_STATUS_MAX_AGE_MS) {
+    lastResyncMs = 0;
+    memset(&state, 0, sizeof(state));
+    strcpy(state.lastMessage, "System initialized");
+}
+
+void EspBridge::receive(const uint8_t* data, size_t len, uint32_t nowUs) {
+    for (size_t i = 0; i < len; i++) {
+        bool complete = decoder.push(data[i]);
+        flow.received(1);
+        if (complete) handleFrame(nowUs);
+    }
+}
+
+void EspBridge::handleFrame(uint32_t nowUs) {
+    LinkCredit credit;
+    LinkPing ping;
+    LinkPong pong;
+    if (decoder.get(credit)) {
+        flow.onCredit(credit);
+        return;
+    } else if (decoder.get(ping)) {
+        tx.send(LinkFlow::pong(ping), LINK_LANE_LINK);
+        return;
+    } else if (decoder.get(pong)) {
+        flow.onPong(pong, nowUs);
+        return;
+    }
+
+    if (decoder.type() != LINK_MSG_STATE) return;  // Note batches aren't shown here
+
+    if (!mirror.apply(decoder.payload(), decoder.payloadLength())) {
+        // Builds on a generation we don't have; tick() asks for a resync
+        mirror.reset();
+        return;
+    }
+    LinkStateAck ack = {mirror.getGeneration()};
+    tx.send(ack, LINK_LANE_COMMAND);
+    statePush.changed(mirror.getChangedMask());
+
+    const LinkState& shared = mirror.state();
+    state.controllerConnected = shared.connected;
+    state.currentScale = shared.scale;
+    state.octaveShift = shared.octave;
+    state.cpuUsage = shared.cpuTenths / 10.0f;
+    state.memoryUsage = shared.memBlocks;
+    state.activeVoices = shared.voices;
+    statusCache.invalidate();
+}
+
+void EspBridge::tick(uint32_t nowMs, uint32_t nowUs) {
+    // No copy of the Teensy's state yet (boot, Teensy reset, lost delta):
+    // ask for all of it
+    if (!mirror.isValid() && nowMs - lastResyncMs >= BRIDGE_RESYNC_INTERVAL_MS) {
+        lastResyncMs = nowMs;
+        sendCommand(LINK_CMD_RESYNC);
+    }
+
+    if (flow.creditDue(nowMs)) tx.send(flow.grant(nowMs), LINK_LANE_LINK);
+    if (flow.pingDue(nowMs)) tx.send(flow.ping(nowMs, nowUs), LINK_LANE_LINK);
+    params.flush(nowMs, tx);
+}
+
+void EspBridge::sendCommand(uint8_t command) {
+    LinkCommand message = {command};
+    tx.send(message, LINK_LANE_COMMAND);
+}
+
+void EspBridge::receiveOSC(const uint8_t* packet, size_t len) {
+    oscForEachMessage(packet, len, handleOSCMessage, this);
+}
+
+void EspBridge::handleOSCMessage(const OscMessageView& msg, void* context) {
+    // /synth/<param> for every link parameter; type and range come from
+    // the parameter table. A fader streaming values only sends its latest.
+    EspBridge* bridge = (EspBridge*)context;
+    LinkSetParam param;
+    if (oscToLinkParam(msg, param)) {
+        bridge->params.set(param.param, param.value);
+    }
+}
+
+bool EspBridge::applyControl(const ControlMessage& control) {
+    // Translate to a link message for the Teensy. Parameters are fitted to
+    // their range and coalesced: tick() sends the newest value of each as
+    // the link allows.
+    int param = paramFromCommand(control.command);
+    if (param > 0 && control.hasValue) {
+        params.set(param, control.value);
+    } else if (strcmp(control.command, "savePreset") == 0) {
+        sendCommand(LINK_CMD_SAVE_PRESET);
+    } else if (strcmp(control.command, "getStatus") == 0) {
+        sendCommand(LINK_CMD_RESYNC);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int EspBridge::paramFromCommand(const char* command) {
+    // Web UI and API command names: "set" and a parameter name in any case
+    // ("setScale", "setreverb", "setLfoRate")
+    if (strncasecmp(command, "set", 3) != 0) return 0;
+
+    char name[OSC_MAX_NAME];
+    size_t len = 0;
+    for (command += 3; *command; command++) {
+        if (len == sizeof(name) - 1) return 0;
+        name[len++] = tolower(*command);
+    }
+    name[len] = 0;
+    return linkParamFind(name);
+}
+
+size_t EspBridge::pollPush(uint32_t nowMs, char* out, size_t max) {
+    if (!mirror.isValid()) return 0;
+    return statePush.poll(nowMs, mirror.state(), out, max);
+}
+
+size_t EspBridge::formatStatus(char* out, size_t max, void* context) {
+    const EspBridge* bridge = (const EspBridge*)context;
+    const BridgeState& state = bridge->state;
+    const LinkFlow& flow = bridge->flow;
+
+    size_t len = 0;
+    unsigned cpuTenths = (unsigned)(state.cpuUsage * 10.0f + 0.5f);
+    bool ok = jsonAppend(out, max, len,
+        "{\"connected\":%s,\"scale\":%u,\"octave\":%d,\"cpu\":%u.%u,\"memory\":%u,\"voices\":%u,\"message\":",
+        state.controllerConnected ? "true" : "false", state.currentScale, state.octaveShift,
+        cpuTenths / 10, cpuTenths % 10, state.memoryUsage, state.activeVoices);
+    ok = ok && jsonAppendString(out, max, len, state.lastMessage);
+
+    // Link health, this end's view
+    ok = ok && jsonAppend(out, max, len,
+        ",\"link\":{\"rttUs\":%lu,\"rttMaxUs\":%lu,\"pingsLost\":%lu,\"overruns\":%lu,\"errors\":%lu,"
+        "\"creditStalls\":%lu,\"paramsIn\":%lu,\"paramsOut\":%lu}}",
+        (unsigned long)flow.getRttUs(), (unsigned long)flow.getRttMaxUs(),
+        (unsigned long)flow.getPingsLost(), (unsigned long)flow.getOverruns(),
+        (unsigned long)bridge->getLinkErrors(),
+        (unsigned long)flow.getCreditStalls(),
+        (unsigned long)bridge->params.getReceived(), (unsigned long)bridge->params.getForwarded());
+    return ok ? len : 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * ESP Bridge
+ * Everything the ESP does between its inputs (Teensy UART, OSC, web) and
+ * its outputs, with no Arduino or Wi-Fi code: link framing and flow
+ * control, the Teensy state mirror, parameter coalescing, OSC dispatch,
+ * control commands, /status text and WebSocket pushes
+ *
+ * The firmware (main.cpp) and the Linux build (native/bridge_host.cpp)
+ * are glue around one of these: they move bytes between it and a UART or
+ * a pseudo-terminal, datagrams from WiFiUDP or a socket, and requests
+ * from ESPAsyncWebServer or a plain TCP listener, and pass the time in.
+ */
+
+#ifndef ESP_BRIDGE_H
+#define ESP_BRIDGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../../teensy-main/include/link_protocol.h"
+#include "../../teensy-main/include/link_state.h"
+#include "../../teensy-main/include/link_flow.h"
+#include "../../teensy-main/include/link_tx_queue.h"
+#include "../../teensy-main/include/control_parser.h"
+#include "../../teensy-main/include/state_push.h"
+#include "../../teensy-main/include/osc_dispatch.h"
+#include "../../teensy-main/include/param_coalescer.h"
+#include "../../teensy-main/include/status_cache.h"
+
+#define BRIDGE_TEENSY_RX_BUFFER 512     // UART receive buffer; sets the credit granted to the Teensy
+#define BRIDGE_RESYNC_INTERVAL_MS 500   // Between resync requests while out of sync
+#define BRIDGE_STATUS_MAX_AGE_MS 250    // Link counters move without a state change
+
+// What /status shows, copied from the mirror as deltas arrive
+struct BridgeState {
+    bool controllerConnected;
+    uint8_t currentScale;
+    int8_t octaveShift;
+    float cpuUsage;
+    uint16_t memoryUsage;
+    uint8_t activeVoices;
+    char lastMessage[128];
+};
+
+class EspBridge {
+public:
+    EspBridge();
+
+    // ---- Teensy link
+
+    // Bytes read off the Teensy UART
+    void receive(const uint8_t* data, size_t len, uint32_t nowUs);
+
+    // The UART dropped bytes before they were read
+    void overrun() { flow.overrun(); }
+
+    // Queue what's due: a resync request while there's no mirror, credit
+    // grants, pings, coalesced parameters
+    void tick(uint32_t nowMs, uint32_t nowUs);
+
+    // Up to space bytes for the Teensy, within the credit it has granted;
+    // call until it returns 0 or the UART is full
+    size_t pull(uint8_t* out, size_t space, uint32_t nowMs) { return tx.pull(out, space, &flow, nowMs); }
+
+    // ---- Inputs
+
+    // One OSC datagram (message or bundle): /synth/<param> for every link
+    // parameter
+    void receiveOSC(const uint8_t* packet, size_t len);
+
+    // A web UI or API command ({"command":"setReverb","value":40}).
+    // False if it isn't one.
+    bool applyControl(const ControlMessage& control);
+
+    // "set" and a parameter name in any case ("setScale", "setlforate");
+    // 0 if it isn't one
+    static int paramFromCommand(const char* command);
+
+    // ---- Outputs
+
+    // /status JSON, from the cache (status_cache.h)
+    const char* status(uint32_t nowMs, size_t& len) { return statusCache.get(nowMs, len); }
+
+    // WebSocket text due now (a delta, or the periodic snapshot); 0 if
+    // nothing is due or there's no mirror yet
+    size_t pollPush(uint32_t nowMs, char* out, size_t max);
+
+    // Everything, for a client that just connected
+    size_t snapshot(char* out, size_t max) { return statePush.snapshot(mirror.state(), out, max); }
+
+    bool isSynced() const { return mirror.isValid(); }
+    const BridgeState& getState() const { return state; }
+    const LinkFlow& getFlow() const { return flow; }
+    const LinkTxQueue& getTxQueue() const { return tx; }
+    const ParamCoalescer& getParams() const { return params; }
+    uint32_t getLinkErrors() const { return decoder.getCrcErrors() + decoder.getFramingErrors(); }
+
+private:
+    void handleFrame(uint32_t nowUs);
+    void sendCommand(uint8_t command);
+    static size_t formatStatus(char* out, size_t max, void* context);
+    static void handleOSCMessage(const OscMessageView& msg, void* context);
+
+    LinkDecoder decoder;
+    LinkTxQueue tx;              // Outbound frames by priority lane, sent within our credit
+    LinkFlow flow;               // Credit both ways, RTT (link_flow.h)
+    ParamCoalescer params;       // Latest value per parameter, sent as the link allows
+    LinkStateReceiver mirror;    // Of the Teensy's shared state (link_state.h)
+    uint32_t lastResyncMs;
+
+    StatePush statePush;         // Coalesced deltas for browsers (state_push.h)
+    StatusCache statusCache;     // /status text
+    BridgeState state;
+};
+
+#endif // ESP_BRIDGE_H
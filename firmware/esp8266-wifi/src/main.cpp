@@ -4,349 +4,91 @@
  *
  * Features:
  * - Access Point mode for standalone operation
- * - Web interface for parameter control
+ * - Web interface for parameter control, state pushed over a WebSocket
  * - OSC message handling
  * - Serial communication with Teensy
- * - JSON-based command protocol
+ * - Framed binary link protocol (teensy-main/include/link_protocol.h)
+ *
+ * Everything but the Arduino and Wi-Fi glue is in the bridge
+ * (esp_bridge.h), which also builds natively on Linux (native/).
  */
 
 #include <ESP8266WiFi.h>
-#include <ESP8266WebServer.h>
+#include <ESPAsyncTCP.h>
+#include <ESPAsyncWebServer.h>
 #include <ESP8266mDNS.h>
-#include <ArduinoJson.h>
 #include <LittleFS.h>
 #include <WiFiUdp.h>
-#include <OSCMessage.h>
-#include <OSCBundle.h>
+#include "esp_bridge.h"
+#include "../../teensy-main/include/loop_scheduler.h"
+#include "../../teensy-main/include/web_asset.h"
+#include "web_assets.h"           // Generated from web/ by scripts/pre_build.py
 
 // Configuration
 const char* AP_SSID = "GuitarHeroSynth";
 const char* AP_PASS = "music123";
 const char* HOSTNAME = "guitarhero";
 
-// Serial communication with Teensy
+// Serial communication with Teensy. Debug prints share this UART; the
+// Teensy's frame decoder skips them.
 #define TEENSY_SERIAL Serial
 #define TEENSY_BAUD 115200
-
-// Web server
-ESP8266WebServer server(80);
+EspBridge bridge;                // Link, state mirror, OSC and control handling
+
+// Web server. Browsers get state pushed over the WebSocket and send
+// slider changes back on it; /status and /control remain for scripts.
+// Async handlers run between loop() passes, never inside one.
+AsyncWebServer server(80);
+AsyncWebSocket ws("/ws");
+#define WS_MAX_CLIENTS 4         // Each holds a TCP connection and a send queue
+#define WS_CLEANUP_MS 1000
+uint32_t lastWsCleanupMs = 0;
+
+// A control parser per browser: frames from different sockets can
+// arrive interleaved
+struct WsSlot {
+    uint32_t clientId;           // 0 = free
+    ControlParser parser;
+} wsSlots[WS_MAX_CLIENTS];
+
+// /control body being read, and the request it belongs to
+ControlParser httpControl;
+AsyncWebServerRequest* httpControlRequest = NULL;
 
 // OSC
 WiFiUDP oscUdp;
 const unsigned int OSC_PORT = 8000;
 const unsigned int OSC_REPLY_PORT = 8001;
+#define OSC_MAX_PACKET 512
+uint8_t oscPacket[OSC_MAX_PACKET];   // Incoming datagram, read in place (osc_dispatch.h)
 
-// System state
-struct SystemState {
-    bool controllerConnected;
-    uint8_t currentScale;
-    int8_t octaveShift;
-    float cpuUsage;
-    uint8_t memoryUsage;
-    uint8_t activeVoices;
-    char lastMessage[128];
-} state;
-
-// JSON document for parsing
-StaticJsonDocument<512> jsonDoc;
+// loop() work as prioritised tasks (loop_scheduler.h): the Teensy link
+// runs between every other task, so nothing waits on a whole pass
+uint32_t loopClock() { return micros(); }
+LoopScheduler scheduler(loopClock);
+char loopReport[LOOP_REPORT_MAX_TEXT];
 
 // Function prototypes
 void setupWiFi();
 void setupWebServer();
 void setupOSC();
-void handleRoot();
-void handleStatus();
-void handleControl();
-void handleNotFound();
-void processSerialCommand();
-void sendTeensyCommand(const char* cmd);
-void handleOSCMessage(OSCMessage &msg);
-void updateState(const char* json);
-
-// HTML content (stored in PROGMEM to save RAM)
-const char index_html[] PROGMEM = R"rawliteral(
-<!DOCTYPE html>
-<html lang="en">
-<head>
-    <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <title>Guitar Hero Synthesizer</title>
-    <style>
-        body {
-            font-family: 'Segoe UI', Arial, sans-serif;
-            background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-            color: white;
-            margin: 0;
-            padding: 20px;
-            min-height: 100vh;
-        }
-        .container {
-            max-width: 800px;
-            margin: 0 auto;
-        }
-        h1 {
-            text-align: center;
-            font-size: 2.5em;
-            margin-bottom: 30px;
-            text-shadow: 2px 2px 4px rgba(0,0,0,0.3);
-        }
-        .status {
-            background: rgba(255,255,255,0.1);
-            border-radius: 10px;
-            padding: 20px;
-            margin-bottom: 20px;
-            backdrop-filter: blur(10px);
-        }
-        .status h2 {
-            margin-top: 0;
-            color: #ffd700;
-        }
-        .status-item {
-            display: flex;
-            justify-content: space-between;
-            padding: 10px 0;
-            border-bottom: 1px solid rgba(255,255,255,0.2);
-        }
-        .status-item:last-child {
-            border-bottom: none;
-        }
-        .status-value {
-            font-weight: bold;
-            color: #00ff88;
-        }
-        .controls {
-            background: rgba(255,255,255,0.1);
-            border-radius: 10px;
-            padding: 20px;
-            backdrop-filter: blur(10px);
-        }
-        .control-group {
-            margin-bottom: 20px;
-        }
-        .control-group label {
-            display: block;
-            margin-bottom: 5px;
-            color: #ffd700;
-            font-weight: bold;
-        }
-        select, input[type="range"], button {
-            width: 100%;
-            padding: 10px;
-            border: none;
-            border-radius: 5px;
-            background: rgba(255,255,255,0.2);
-            color: white;
-            font-size: 16px;
-        }
-        select option {
-            background: #764ba2;
-        }
-        input[type="range"] {
-            -webkit-appearance: none;
-            height: 10px;
-            background: rgba(255,255,255,0.3);
-            outline: none;
-        }
-        input[type="range"]::-webkit-slider-thumb {
-            -webkit-appearance: none;
-            appearance: none;
-            width: 25px;
-            height: 25px;
-            background: #ffd700;
-            cursor: pointer;
-            border-radius: 50%;
-        }
-        button {
-            background: #ffd700;
-            color: #764ba2;
-            font-weight: bold;
-            cursor: pointer;
-            transition: all 0.3s;
-            margin-top: 10px;
-        }
-        button:hover {
-            background: #ffed4e;
-            transform: translateY(-2px);
-            box-shadow: 0 5px 10px rgba(0,0,0,0.3);
-        }
-        .range-value {
-            text-align: center;
-            margin-top: 5px;
-            font-size: 0.9em;
-        }
-        .connection-status {
-            width: 15px;
-            height: 15px;
-            border-radius: 50%;
-            display: inline-block;
-            margin-left: 10px;
-        }
-        .connected {
-            background-color: #00ff88;
-            animation: pulse 2s infinite;
-        }
-        .disconnected {
-            background-color: #ff4444;
-        }
-        @keyframes pulse {
-            0% { opacity: 1; }
-            50% { opacity: 0.5; }
-            100% { opacity: 1; }
-        }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <h1>🎸 Guitar Hero Synthesizer</h1>
-
-        <div class="status">
-            <h2>System Status</h2>
-            <div class="status-item">
-                <span>Controller</span>
-                <span class="status-value">
-                    <span id="controller-status">Disconnected</span>
-                    <span id="connection-indicator" class="connection-status disconnected"></span>
-                </span>
-            </div>
-            <div class="status-item">
-                <span>Current Scale</span>
-                <span class="status-value" id="current-scale">Pentatonic Minor</span>
-            </div>
-            <div class="status-item">
-                <span>Octave Shift</span>
-                <span class="status-value" id="octave-shift">0</span>
-            </div>
-            <div class="status-item">
-                <span>CPU Usage</span>
-                <span class="status-value" id="cpu-usage">0%</span>
-            </div>
-            <div class="status-item">
-                <span>Active Voices</span>
-                <span class="status-value" id="active-voices">0/6</span>
-            </div>
-        </div>
-
-        <div class="controls">
-            <h2>Controls</h2>
-
-            <div class="control-group">
-                <label for="scale-select">Scale</label>
-                <select id="scale-select" onchange="changeScale(this.value)">
-                    <option value="0">Pentatonic Minor</option>
-                    <option value="1">Natural Minor</option>
-                    <option value="2">Dorian</option>
-                    <option value="3">Hungarian Minor</option>
-                    <option value="4">Harmonic Minor</option>
-                    <option value="5">Phrygian</option>
-                </select>
-            </div>
-
-            <div class="control-group">
-                <label for="reverb-mix">Reverb Mix</label>
-                <input type="range" id="reverb-mix" min="0" max="100" value="30"
-                       oninput="updateValue('reverb', this.value)">
-                <div class="range-value" id="reverb-value">30%</div>
-            </div>
-
-            <div class="control-group">
-                <label for="delay-mix">Delay Mix</label>
-                <input type="range" id="delay-mix" min="0" max="100" value="20"
-                       oninput="updateValue('delay', this.value)">
-                <div class="range-value" id="delay-value">20%</div>
-            </div>
-
-            <div class="control-group">
-                <label for="filter-freq">Filter Frequency</label>
-                <input type="range" id="filter-freq" min="100" max="4000" value="2000"
-                       oninput="updateValue('filter', this.value)">
-                <div class="range-value" id="filter-value">2000 Hz</div>
-            </div>
-
-            <button onclick="resetDefaults()">Reset to Defaults</button>
-            <button onclick="savePreset()">Save Preset</button>
-        </div>
-    </div>
-
-    <script>
-        // Update status every second
-        setInterval(updateStatus, 1000);
-
-        function updateStatus() {
-            fetch('/status')
-                .then(response => response.json())
-                .then(data => {
-                    document.getElementById('controller-status').textContent =
-                        data.connected ? 'Connected' : 'Disconnected';
-
-                    const indicator = document.getElementById('connection-indicator');
-                    indicator.className = 'connection-status ' +
-                        (data.connected ? 'connected' : 'disconnected');
-
-                    document.getElementById('current-scale').textContent =
-                        getScaleName(data.scale);
-                    document.getElementById('octave-shift').textContent =
-                        (data.octave > 0 ? '+' : '') + data.octave;
-                    document.getElementById('cpu-usage').textContent =
-                        data.cpu.toFixed(1) + '%';
-                    document.getElementById('active-voices').textContent =
-                        data.voices + '/6';
-                })
-                .catch(err => console.error('Status update failed:', err));
-        }
-
-        function getScaleName(index) {
-            const scales = [
-                'Pentatonic Minor', 'Natural Minor', 'Dorian',
-                'Hungarian Minor', 'Harmonic Minor', 'Phrygian'
-            ];
-            return scales[index] || 'Unknown';
-        }
-
-        function changeScale(value) {
-            fetch('/control', {
-                method: 'POST',
-                headers: {'Content-Type': 'application/json'},
-                body: JSON.stringify({command: 'setScale', value: parseInt(value)})
-            });
-        }
-
-        function updateValue(param, value) {
-            document.getElementById(param + '-value').textContent =
-                param === 'filter' ? value + ' Hz' : value + '%';
-
-            fetch('/control', {
-                method: 'POST',
-                headers: {'Content-Type': 'application/json'},
-                body: JSON.stringify({command: 'set' + param, value: parseFloat(value)})
-            });
-        }
-
-        function resetDefaults() {
-            document.getElementById('reverb-mix').value = 30;
-            document.getElementById('delay-mix').value = 20;
-            document.getElementById('filter-freq').value = 2000;
-            updateValue('reverb', 30);
-            updateValue('delay', 20);
-            updateValue('filter', 2000);
-        }
-
-        function savePreset() {
-            fetch('/control', {
-                method: 'POST',
-                headers: {'Content-Type': 'application/json'},
-                body: JSON.stringify({command: 'savePreset'})
-            }).then(() => alert('Preset saved!'));
-        }
-
-        // Initial status update
-        updateStatus();
-    </script>
-</body>
-</html>
-)rawliteral";
+void handleWebAsset(AsyncWebServerRequest* request);
+void handleStatus(AsyncWebServerRequest* request);
+void handleLoop(AsyncWebServerRequest* request);
+void handleControl(AsyncWebServerRequest* request);
+void handleControlBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+void handleNotFound(AsyncWebServerRequest* request);
+void onWsEvent(AsyncWebSocket* socket, AsyncWebSocketClient* client, AwsEventType type,
+               void* arg, uint8_t* data, size_t len);
+WsSlot* wsSlot(uint32_t clientId);
+void pushState();
+void taskTeensyLink();
+void taskOSC();
+void taskMDNS();
 
 void setup() {
     // Initialize serial communication with Teensy
+    TEENSY_SERIAL.setRxBufferSize(BRIDGE_TEENSY_RX_BUFFER);
     TEENSY_SERIAL.begin(TEENSY_BAUD);
 
     // Initialize file system
@@ -354,10 +96,6 @@ void setup() {
         Serial.println(F("Failed to mount file system"));
     }
 
-    // Initialize state
-    memset(&state, 0, sizeof(state));
-    strcpy(state.lastMessage, "System initialized");
-
     // Setup WiFi
     setupWiFi();
 
@@ -367,6 +105,12 @@ void setup() {
     // Setup OSC
     setupOSC();
 
+    // Loop tasks: budgets are the run time each should stay within
+    scheduler.add("teensy", taskTeensyLink, LOOP_PRIORITY_CRITICAL, 500);
+    scheduler.add("osc", taskOSC, LOOP_PRIORITY_HIGH, 500);
+    scheduler.add("push", pushState, LOOP_PRIORITY_NORMAL, 1000);
+    scheduler.add("mdns", taskMDNS, LOOP_PRIORITY_LOW, 500, 10000);
+
     // Start mDNS
     if (MDNS.begin(HOSTNAME)) {
         Serial.println(F("mDNS responder started"));
@@ -380,31 +124,47 @@ void setup() {
 }
 
 void loop() {
-    // Handle web server
-    server.handleClient();
+    scheduler.runPass();
 
-    // Handle mDNS
-    MDNS.update();
+    // Let the Wi-Fi stack and the async web server run
+    yield();
+}
+
+void taskTeensyLink() {
+    // Frames from the Teensy
+    if (TEENSY_SERIAL.hasOverrun()) bridge.overrun();
+    uint8_t chunk[64];
+    int available;
+    while ((available = TEENSY_SERIAL.available()) > 0) {
+        size_t n = TEENSY_SERIAL.readBytes(chunk, available < (int)sizeof(chunk) ? available : sizeof(chunk));
+        bridge.receive(chunk, n, micros());
+    }
 
-    // Process serial commands from Teensy
-    if (TEENSY_SERIAL.available()) {
-        processSerialCommand();
+    // Grants, probes and parameters, then whatever the Teensy has credit
+    // for, without waiting on the UART
+    uint32_t now = millis();
+    bridge.tick(now, micros());
+    int space = TEENSY_SERIAL.availableForWrite();
+    while (space > 0) {
+        size_t n = bridge.pull(chunk, space < (int)sizeof(chunk) ? space : sizeof(chunk), now);
+        if (n == 0) break;
+        TEENSY_SERIAL.write(chunk, n);
+        space -= n;
     }
+}
 
-    // Check for OSC messages
-    OSCMessage msg;
+void taskOSC() {
+    // Check for OSC messages; larger datagrams than we take are skipped
+    // by the next parsePacket()
     int size = oscUdp.parsePacket();
-    if (size > 0) {
-        while (size--) {
-            msg.fill(oscUdp.read());
-        }
-        if (!msg.hasError()) {
-            handleOSCMessage(msg);
-        }
+    if (size > 0 && size <= OSC_MAX_PACKET) {
+        int len = oscUdp.read(oscPacket, sizeof(oscPacket));
+        if (len > 0) bridge.receiveOSC(oscPacket, len);
     }
+}
 
-    // Small delay to prevent watchdog
-    yield();
+void taskMDNS() {
+    MDNS.update();
 }
 
 void setupWiFi() {
@@ -428,9 +188,15 @@ void setupWiFi() {
 
 void setupWebServer() {
     // Route handlers
-    server.on("/", handleRoot);
-    server.on("/status", handleStatus);
-    server.on("/control", HTTP_POST, handleControl);
+    ws.onEvent(onWsEvent);
+    server.addHandler(&ws);
+    server.on("/", HTTP_GET, handleWebAsset);
+    for (size_t i = 0; i < webAssetCount; i++) {
+        server.on(webAssets[i].path, HTTP_GET, handleWebAsset);
+    }
+    server.on("/status", HTTP_GET, handleStatus);
+    server.on("/loop", HTTP_GET, handleLoop);
+    server.on("/control", HTTP_POST, handleControl, nullptr, handleControlBody);
     server.onNotFound(handleNotFound);
 
     // Start server
@@ -444,140 +210,122 @@ void setupOSC() {
     Serial.println(OSC_PORT);
 }
 
-void handleRoot() {
-    server.send_P(200, "text/html", index_html);
-}
+// UI files, gzipped in flash and streamed out as they are. A browser
+// holding the current version gets a bodiless 304 (web_asset.h).
+void handleWebAsset(AsyncWebServerRequest* request) {
+    const WebAsset* asset = webAssetFind(webAssets, webAssetCount, request->url().c_str());
+    if (!asset) {
+        handleNotFound(request);
+        return;
+    }
 
-void handleStatus() {
-    // Create JSON response
-    StaticJsonDocument<256> doc;
-    doc["connected"] = state.controllerConnected;
-    doc["scale"] = state.currentScale;
-    doc["octave"] = state.octaveShift;
-    doc["cpu"] = state.cpuUsage;
-    doc["memory"] = state.memoryUsage;
-    doc["voices"] = state.activeVoices;
-    doc["message"] = state.lastMessage;
-
-    String response;
-    serializeJson(doc, response);
-    server.send(200, "application/json", response);
+    AsyncWebServerResponse* response;
+    if (request->hasHeader("If-None-Match") &&
+        webEtagMatches(request->header("If-None-Match").c_str(), asset->etag)) {
+        response = request->beginResponse(304);
+    } else {
+        response = request->beginResponse_P(200, asset->type, asset->data, asset->length);
+        response->addHeader("Content-Encoding", "gzip");
+    }
+    response->addHeader("ETag", asset->etag);
+    response->addHeader("Cache-Control", webAssetCacheControl(*asset));
+    request->send(response);
 }
 
-void handleControl() {
-    if (server.hasArg("plain")) {
-        String body = server.arg("plain");
-
-        DeserializationError error = deserializeJson(jsonDoc, body);
-        if (!error) {
-            const char* command = jsonDoc["command"];
+void handleStatus(AsyncWebServerRequest* request) {
+    // The async response reads its body as the TCP window opens, by when
+    // the cache may have reformatted both buffers, so it gets its own
+    // copy (STATUS_CACHE_MAX_TEXT at most)
+    size_t len;
+    const char* text = bridge.status(millis(), len);
+    request->send(200, "application/json", text);
+}
 
-            // Build command for Teensy
-            StaticJsonDocument<128> cmdDoc;
-            cmdDoc["cmd"] = command;
+void handleLoop(AsyncWebServerRequest* request) {
+    // Loop task latency histograms, for the UI; polled every few seconds,
+    // so a copy per request is fine
+    if (!scheduler.report(loopReport, sizeof(loopReport))) {
+        request->send(500, "application/json", "{\"error\":\"Report too long\"}");
+        return;
+    }
+    request->send(200, "application/json", loopReport);
+}
 
-            if (jsonDoc.containsKey("value")) {
-                cmdDoc["value"] = jsonDoc["value"];
-            }
+void handleControlBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+    // Bodies are a few dozen bytes, so one parser does; a body that
+    // starts mid-way through another's takes it over
+    if (index == 0) {
+        httpControl.reset();
+        httpControlRequest = request;
+    }
+    if (request == httpControlRequest) httpControl.push((const char*)data, len);
+}
 
-            String cmd;
-            serializeJson(cmdDoc, cmd);
-            sendTeensyCommand(cmd.c_str());
+void handleControl(AsyncWebServerRequest* request) {
+    if (request != httpControlRequest) {
+        request->send(400, "application/json", "{\"error\":\"No data\"}");
+        return;
+    }
+    httpControlRequest = NULL;
 
-            server.send(200, "application/json", "{\"status\":\"ok\"}");
-        } else {
-            server.send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
-        }
+    if (!httpControl.isComplete()) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    } else if (!bridge.applyControl(httpControl.message())) {
+        request->send(400, "application/json", "{\"error\":\"Unknown command\"}");
     } else {
-        server.send(400, "application/json", "{\"error\":\"No data\"}");
+        request->send(200, "application/json", "{\"status\":\"ok\"}");
     }
 }
 
-void handleNotFound() {
-    server.send(404, "text/plain", "Not Found");
+void handleNotFound(AsyncWebServerRequest* request) {
+    request->send(404, "text/plain", "Not Found");
 }
 
-void processSerialCommand() {
-    static char buffer[256];
-    static uint8_t index = 0;
-
-    while (TEENSY_SERIAL.available()) {
-        char c = TEENSY_SERIAL.read();
-
-        if (c == '\n' || c == '\r') {
-            if (index > 0) {
-                buffer[index] = '\0';
-                updateState(buffer);
-                index = 0;
-            }
-        } else if (index < 255) {
-            buffer[index++] = c;
-        }
+void onWsEvent(AsyncWebSocket* socket, AsyncWebSocketClient* client, AwsEventType type,
+               void* arg, uint8_t* data, size_t len) {
+    if (type == WS_EVT_CONNECT) {
+        WsSlot* slot = wsSlot(0);
+        if (!slot) {
+            client->close(1013, "Too many clients");  // Try again later
+            return;
+        }
+        slot->clientId = client->id();
+        slot->parser.reset();
+
+        // Everything once, deltas from then on
+        char text[STATE_PUSH_MAX_TEXT];
+        size_t n = bridge.snapshot(text, sizeof(text));
+        if (n) client->text(text, n);
+    } else if (type == WS_EVT_DISCONNECT) {
+        WsSlot* slot = wsSlot(client->id());
+        if (slot) slot->clientId = 0;
+    } else if (type == WS_EVT_DATA) {
+        // One control message per WebSocket text message, possibly split
+        // over frames and TCP segments
+        AwsFrameInfo* info = (AwsFrameInfo*)arg;
+        WsSlot* slot = wsSlot(client->id());
+        if (!slot || info->message_opcode != WS_TEXT) return;
+        if (info->num == 0 && info->index == 0) slot->parser.reset();
+        if (slot->parser.push((const char*)data, len)) bridge.applyControl(slot->parser.message());
     }
 }
 
-void sendTeensyCommand(const char* cmd) {
-    TEENSY_SERIAL.println(cmd);
-}
-
-void updateState(const char* json) {
-    DeserializationError error = deserializeJson(jsonDoc, json);
-    if (!error) {
-        if (jsonDoc.containsKey("connected")) {
-            state.controllerConnected = jsonDoc["connected"];
-        }
-        if (jsonDoc.containsKey("scale")) {
-            state.currentScale = jsonDoc["scale"];
-        }
-        if (jsonDoc.containsKey("octave")) {
-            state.octaveShift = jsonDoc["octave"];
-        }
-        if (jsonDoc.containsKey("cpu")) {
-            state.cpuUsage = jsonDoc["cpu"];
-        }
-        if (jsonDoc.containsKey("mem")) {
-            state.memoryUsage = jsonDoc["mem"];
-        }
-        if (jsonDoc.containsKey("voices")) {
-            state.activeVoices = jsonDoc["voices"];
-        }
+WsSlot* wsSlot(uint32_t clientId) {
+    for (WsSlot& slot : wsSlots) {
+        if (slot.clientId == clientId) return &slot;
     }
+    return NULL;
 }
 
-void handleOSCMessage(OSCMessage &msg) {
-    char address[64];
-    msg.getAddress(address);
-
-    // Handle different OSC addresses
-    if (msg.match("/scale")) {
-        if (msg.isInt(0)) {
-            int scale = msg.getInt(0);
-            StaticJsonDocument<64> doc;
-            doc["cmd"] = "setScale";
-            doc["value"] = scale;
-            String cmd;
-            serializeJson(doc, cmd);
-            sendTeensyCommand(cmd.c_str());
-        }
-    } else if (msg.match("/reverb")) {
-        if (msg.isFloat(0)) {
-            float value = msg.getFloat(0);
-            StaticJsonDocument<64> doc;
-            doc["cmd"] = "setReverb";
-            doc["value"] = value;
-            String cmd;
-            serializeJson(doc, cmd);
-            sendTeensyCommand(cmd.c_str());
-        }
-    } else if (msg.match("/delay")) {
-        if (msg.isFloat(0)) {
-            float value = msg.getFloat(0);
-            StaticJsonDocument<64> doc;
-            doc["cmd"] = "setDelay";
-            doc["value"] = value;
-            String cmd;
-            serializeJson(doc, cmd);
-            sendTeensyCommand(cmd.c_str());
-        }
+void pushState() {
+    uint32_t now = millis();
+    if (now - lastWsCleanupMs >= WS_CLEANUP_MS) {
+        lastWsCleanupMs = now;
+        ws.cleanupClients(WS_MAX_CLIENTS);
     }
-}
\ No newline at end of file
+    if (ws.count() == 0) return;
+
+    char text[STATE_PUSH_MAX_TEXT];
+    size_t len = bridge.pollPush(now, text, sizeof(text));
+    if (len) ws.textAll(text, len);
+}
@@ -0,0 +1,388 @@
+/**
+ * ESP Bridge, Linux Host
+ * The ESP firmware's bridge (esp_bridge.h) run natively, for testing and
+ * load generation without an ESP8266
+ *
+ * In place of the ESP's glue:
+ *   - the Teensy UART is a pseudo-terminal (--serial), in raw mode, read
+ *     and written without blocking
+ *   - OSC is a UDP socket on 127.0.0.1 (--osc-port)
+ *   - the web server is a small HTTP/1.1 listener on 127.0.0.1
+ *     (--http-port) with keep-alive: GET /status, GET /loop, POST /control,
+ *     the same handlers and responses as the firmware. No WebSocket and no
+ *     web UI files.
+ *
+ * loop() is the same LoopScheduler with the same tasks and budgets; the
+ * pass waits in poll() for up to a millisecond when nothing is ready
+ * instead of spinning. Every buffer is fixed, as on the ESP, so memory
+ * stays flat however long it runs.
+ *
+ * Build: pio run -e native (from esp8266-wifi), or
+ *   g++ -std=gnu++17 -O2 -Wall -o bridge_host src/esp_bridge.cpp src/native/bridge_host.cpp
+ * Run:   ./bridge_host --serial /dev/pts/N [--osc-port 8000] [--http-port 8080]
+ * tools/load_generator.cpp starts it on a pty of its own.
+ */
+
+#include "../esp_bridge.h"
+#include "../../../teensy-main/include/loop_scheduler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <termios.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#define HOST_MAX_CLIENTS 16        // HTTP connections held open
+#define HOST_REQUEST_BYTES 1024    // Request line, headers and body
+#define HOST_RESPONSE_BYTES (LOOP_REPORT_MAX_TEXT + 256)
+#define HOST_SERIAL_TX_BYTES 256   // Frames pulled but not yet taken by the pty
+#define OSC_MAX_PACKET 512
+
+EspBridge bridge;
+
+int serialFd = -1;
+uint8_t serialTx[HOST_SERIAL_TX_BYTES];
+size_t serialTxLen = 0;
+
+int oscFd = -1;
+uint8_t oscPacket[OSC_MAX_PACKET];
+
+int httpFd = -1;
+struct HttpClient {
+    int fd;                        // -1 = free
+    char in[HOST_REQUEST_BYTES];
+    size_t inLen;
+    char out[HOST_RESPONSE_BYTES];
+    size_t outLen;
+    size_t outSent;
+    bool closeAfter;               // Connection: close, or a request we couldn't frame
+} clients[HOST_MAX_CLIENTS];
+
+uint32_t loopClock();
+LoopScheduler scheduler(loopClock);
+char loopReport[LOOP_REPORT_MAX_TEXT];
+
+volatile sig_atomic_t stopping = 0;
+
+uint32_t micros() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000);
+}
+
+uint32_t millis() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000u + ts.tv_nsec / 1000000);
+}
+
+uint32_t loopClock() { return micros(); }
+
+void onSignal(int) { stopping = 1; }
+
+// ---- Setup
+
+bool openSerial(const char* path) {
+    serialFd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (serialFd < 0) {
+        fprintf(stderr, "bridge_host: %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    termios tio;
+    if (tcgetattr(serialFd, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetspeed(&tio, B115200);
+        tcsetattr(serialFd, TCSANOW, &tio);
+    }
+    return true;
+}
+
+int openSocket(int type, uint16_t port) {
+    int fd = socket(AF_INET, type | SOCK_NONBLOCK, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 ||
+        (type == SOCK_STREAM && listen(fd, HOST_MAX_CLIENTS) < 0)) {
+        fprintf(stderr, "bridge_host: port %u: %s\n", port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// ---- Tasks
+
+void taskTeensyLink() {
+    // Frames from the Teensy
+    uint8_t chunk[64];
+    ssize_t n;
+    while ((n = read(serialFd, chunk, sizeof(chunk))) > 0) {
+        bridge.receive(chunk, n, micros());
+    }
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+        // EIO: the other end of the pty has gone
+        fprintf(stderr, "bridge_host: serial closed\n");
+        stopping = 1;
+        return;
+    }
+
+    // Grants, probes and parameters, then whatever the Teensy has credit
+    // for; what the pty won't take yet waits in serialTx
+    uint32_t now = millis();
+    bridge.tick(now, micros());
+    while (true) {
+        serialTxLen += bridge.pull(serialTx + serialTxLen, sizeof(serialTx) - serialTxLen, now);
+        if (serialTxLen == 0) break;
+        ssize_t sent = write(serialFd, serialTx, serialTxLen);
+        if (sent <= 0) break;
+        memmove(serialTx, serialTx + sent, serialTxLen - sent);
+        serialTxLen -= sent;
+    }
+}
+
+void taskOSC() {
+    // One datagram a run, as on the ESP; larger ones than we take are
+    // truncated by recv() and dropped
+    ssize_t len = recv(oscFd, oscPacket, sizeof(oscPacket), MSG_TRUNC);
+    if (len > 0 && len <= OSC_MAX_PACKET) bridge.receiveOSC(oscPacket, len);
+}
+
+void respond(HttpClient& client, int code, const char* type, const char* body, size_t len) {
+    const char* reason = code == 200 ? "OK" : code == 400 ? "Bad Request" :
+                         code == 404 ? "Not Found" : "Internal Server Error";
+    int head = snprintf(client.out, sizeof(client.out),
+                        "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %u\r\n%s\r\n",
+                        code, reason, type, (unsigned)len,
+                        client.closeAfter ? "Connection: close\r\n" : "");
+    if (head < 0 || (size_t)head + len > sizeof(client.out)) {
+        client.outLen = 0;
+        client.closeAfter = true;
+        return;
+    }
+    memcpy(client.out + head, body, len);
+    client.outLen = head + len;
+    client.outSent = 0;
+}
+
+void respond(HttpClient& client, int code, const char* type, const char* body) {
+    respond(client, code, type, body, strlen(body));
+}
+
+// The handlers: the firmware's, against a buffered request
+void handleRequest(HttpClient& client, const char* method, const char* path, const char* body, size_t bodyLen) {
+    if (strcmp(method, "GET") == 0 && strcmp(path, "/status") == 0) {
+        size_t len;
+        const char* text = bridge.status(millis(), len);
+        respond(client, 200, "application/json", text, len);
+    } else if (strcmp(method, "GET") == 0 && strcmp(path, "/loop") == 0) {
+        if (!scheduler.report(loopReport, sizeof(loopReport))) {
+            respond(client, 500, "application/json", "{\"error\":\"Report too long\"}");
+            return;
+        }
+        respond(client, 200, "application/json", loopReport);
+    } else if (strcmp(method, "POST") == 0 && strcmp(path, "/control") == 0) {
+        ControlParser parser;
+        if (bodyLen == 0) {
+            respond(client, 400, "application/json", "{\"error\":\"No data\"}");
+        } else if (!parser.push(body, bodyLen) || !parser.isComplete()) {
+            respond(client, 400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        } else if (!bridge.applyControl(parser.message())) {
+            respond(client, 400, "application/json", "{\"error\":\"Unknown command\"}");
+        } else {
+            respond(client, 200, "application/json", "{\"status\":\"ok\"}");
+        }
+    } else {
+        respond(client, 404, "text/plain", "Not Found");
+    }
+}
+
+// A whole request waiting in client.in: handle it and drop it from the
+// buffer. False if it isn't all there yet.
+bool serveRequest(HttpClient& client) {
+    char* end = (char*)memmem(client.in, client.inLen, "\r\n\r\n", 4);
+    if (!end) {
+        if (client.inLen == sizeof(client.in)) {
+            client.closeAfter = true;
+            respond(client, 400, "text/plain", "Request too large");
+        }
+        return false;
+    }
+    size_t headerLen = end + 4 - client.in;
+    *end = 0;
+
+    // Content-Length and Connection are the only headers that matter here
+    size_t bodyLen = 0;
+    for (char* line = strstr(client.in, "\r\n"); line; line = strstr(line + 2, "\r\n")) {
+        if (strncasecmp(line + 2, "Content-Length:", 15) == 0) bodyLen = strtoul(line + 17, NULL, 10);
+        if (strncasecmp(line + 2, "Connection: close", 17) == 0) client.closeAfter = true;
+    }
+    if (headerLen + bodyLen > sizeof(client.in)) {
+        client.closeAfter = true;
+        respond(client, 400, "text/plain", "Request too large");
+        return false;
+    }
+    if (client.inLen < headerLen + bodyLen) {
+        *end = '\r';               // Not all of the body yet; look again later
+        return false;
+    }
+
+    char* method = client.in;
+    char* path = strchr(method, ' ');
+    if (!path) {
+        client.closeAfter = true;
+        respond(client, 400, "text/plain", "Bad Request");
+        return false;
+    }
+    *path++ = 0;
+    char* space = strpbrk(path, " ?");
+    if (space) *space = 0;
+
+    handleRequest(client, method, path, client.in + headerLen, bodyLen);
+
+    size_t used = headerLen + bodyLen;
+    memmove(client.in, client.in + used, client.inLen - used);
+    client.inLen -= used;
+    return true;
+}
+
+void closeClient(HttpClient& client) {
+    close(client.fd);
+    client.fd = -1;
+}
+
+void serviceClient(HttpClient& client) {
+    // Send what's waiting before reading the next request, so a client
+    // pipelining requests can't outrun its response buffer
+    if (client.outSent < client.outLen) {
+        ssize_t n = send(client.fd, client.out + client.outSent, client.outLen - client.outSent, MSG_NOSIGNAL);
+        if (n < 0 && errno != EAGAIN) {
+            closeClient(client);
+            return;
+        }
+        if (n > 0) client.outSent += n;
+        if (client.outSent < client.outLen) return;
+    }
+    if (client.closeAfter) {
+        closeClient(client);
+        return;
+    }
+
+    ssize_t n = recv(client.fd, client.in + client.inLen, sizeof(client.in) - client.inLen, 0);
+    if (n == 0 || (n < 0 && errno != EAGAIN)) {
+        closeClient(client);
+        return;
+    }
+    if (n > 0) client.inLen += n;
+    client.outLen = client.outSent = 0;
+    if (serveRequest(client)) serviceClient(client);
+    else if (client.outLen) serviceClient(client);
+}
+
+void taskHTTP() {
+    int fd;
+    while ((fd = accept4(httpFd, NULL, NULL, SOCK_NONBLOCK)) >= 0) {
+        HttpClient* slot = NULL;
+        for (HttpClient& client : clients) {
+            if (client.fd < 0) {
+                slot = &client;
+                break;
+            }
+        }
+        if (!slot) {
+            close(fd);             // Full, as the ESP's server would refuse
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        slot->fd = fd;
+        slot->inLen = slot->outLen = slot->outSent = 0;
+        slot->closeAfter = false;
+    }
+    for (HttpClient& client : clients) {
+        if (client.fd >= 0) serviceClient(client);
+    }
+}
+
+// ---- Main
+
+void usage() {
+    fprintf(stderr, "usage: bridge_host --serial <pty> [--osc-port 8000] [--http-port 8080]\n");
+}
+
+int main(int argc, char** argv) {
+    const char* serialPath = NULL;
+    unsigned oscPort = 8000;
+    unsigned httpPort = 8080;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--serial") == 0 && i + 1 < argc) serialPath = argv[++i];
+        else if (strcmp(argv[i], "--osc-port") == 0 && i + 1 < argc) oscPort = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--http-port") == 0 && i + 1 < argc) httpPort = atoi(argv[++i]);
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (!serialPath) {
+        usage();
+        return 2;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+    for (HttpClient& client : clients) client.fd = -1;
+
+    if (!openSerial(serialPath)) return 1;
+    oscFd = openSocket(SOCK_DGRAM, oscPort);
+    httpFd = openSocket(SOCK_STREAM, httpPort);
+    if (oscFd < 0 || httpFd < 0) return 1;
+
+    // Same tasks and budgets as the firmware, less the WebSocket push and mDNS
+    scheduler.add("teensy", taskTeensyLink, LOOP_PRIORITY_CRITICAL, 500);
+    scheduler.add("osc", taskOSC, LOOP_PRIORITY_HIGH, 500);
+    scheduler.add("http", taskHTTP, LOOP_PRIORITY_NORMAL, 1000);
+
+    fprintf(stderr, "bridge_host: serial %s, OSC udp/%u, HTTP tcp/%u\n", serialPath, oscPort, httpPort);
+
+    while (!stopping) {
+        scheduler.runPass();
+
+        // Sleep until something is ready (or a millisecond passes, for the
+        // link's timers) rather than spin
+        pollfd fds[3 + HOST_MAX_CLIENTS];
+        nfds_t count = 0;
+        fds[count++] = {serialFd, (short)(POLLIN | (serialTxLen ? POLLOUT : 0)), 0};
+        fds[count++] = {oscFd, POLLIN, 0};
+        fds[count++] = {httpFd, POLLIN, 0};
+        for (HttpClient& client : clients) {
+            if (client.fd >= 0) {
+                fds[count++] = {client.fd, (short)(client.outSent < client.outLen ? POLLOUT : POLLIN), 0};
+            }
+        }
+        poll(fds, count, 1);
+    }
+
+    for (HttpClient& client : clients) {
+        if (client.fd >= 0) closeClient(client);
+    }
+    close(httpFd);
+    close(oscFd);
+    close(serialFd);
+    return 0;
+}
@@ -0,0 +1,230 @@
+/**
+ * Generated by esp8266-wifi/scripts/pre_build.py from esp8266-wifi/web/
+ * Do not edit; change the files there and regenerate.
+ * Include teensy-main/include/web_asset.h first.
+ */
+
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+// app.css: 2412 bytes, 847 gzipped
+static const uint8_t web_app_css[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xb5, 0x55, 0x4d, 0x8f, 0x9b, 0x30,
+    0x10, 0xbd, 0xe7, 0x57, 0x58, 0x5d, 0xad, 0x36, 0x2b, 0xc5, 0x11, 0x21, 0x1f, 0xbb, 0x25, 0xaa,
+    0xd4, 0x1e, 0x7b, 0xae, 0x7a, 0xa8, 0xaa, 0x1e, 0x0c, 0x1e, 0xc0, 0x8d, 0xb1, 0x91, 0x6d, 0x36,
+    0x49, 0x57, 0xf9, 0xef, 0xb5, 0xc1, 0x10, 0x48, 0xc8, 0x76, 0x2f, 0x25, 0x42, 0x22, 0xb6, 0x67,
+    0xe6, 0xcd, 0x7b, 0x33, 0xe3, 0x58, 0xd2, 0x23, 0x7a, 0x9d, 0x20, 0xfb, 0xa4, 0x52, 0x18, 0x9c,
+    0x92, 0x82, 0xf1, 0x63, 0x84, 0x1e, 0xbe, 0x41, 0x26, 0x01, 0x7d, 0xff, 0xfa, 0x30, 0x43, 0x5f,
+    0x14, 0x23, 0x7c, 0x86, 0x34, 0x11, 0x1a, 0x6b, 0x50, 0x2c, 0xdd, 0xd6, 0xe7, 0x63, 0x92, 0xec,
+    0x32, 0x25, 0x2b, 0x41, 0x23, 0xc4, 0x99, 0x00, 0xa2, 0x70, 0xa6, 0x08, 0x65, 0x20, 0xcc, 0x74,
+    0xb1, 0x5c, 0x53, 0xc8, 0x66, 0xe8, 0x6e, 0xb3, 0x79, 0x02, 0x20, 0x28, 0xb8, 0xb7, 0xdf, 0x4f,
+    0x9b, 0x55, 0x4c, 0x42, 0xb4, 0x08, 0x82, 0xfb, 0xc7, 0xc6, 0x45, 0x22, 0xb9, 0x54, 0x11, 0xda,
+    0xe7, 0xcc, 0x40, 0xb3, 0x52, 0x10, 0x95, 0x31, 0x11, 0xa1, 0xa0, 0xf9, 0x5b, 0x12, 0x4a, 0x99,
+    0xc8, 0x22, 0x14, 0x06, 0xe5, 0xc1, 0x9f, 0x60, 0x02, 0xe7, 0xc0, 0xb2, 0xdc, 0x44, 0xce, 0xd5,
+    0x4b, 0xbe, 0x9d, 0x9c, 0x26, 0xf3, 0xc4, 0x82, 0x27, 0x16, 0x84, 0xf2, 0xc9, 0x14, 0xe4, 0x80,
+    0xf7, 0x8c, 0x9a, 0x3c, 0x42, 0xcf, 0xc1, 0xd9, 0xb6, 0xf5, 0x8e, 0x48, 0x65, 0xa4, 0x33, 0xcc,
+    0x17, 0xde, 0xc0, 0xc0, 0xc1, 0x60, 0xc2, 0x59, 0x66, 0xb7, 0x13, 0x9b, 0x02, 0xa8, 0xed, 0x99,
+    0x15, 0xcd, 0xfe, 0x80, 0xc5, 0x30, 0x5f, 0x43, 0xd1, 0x77, 0x84, 0x63, 0x69, 0x8c, 0x2c, 0x22,
+    0xb4, 0xec, 0x22, 0xd4, 0x6e, 0x74, 0x4e, 0xa8, 0xdc, 0x5b, 0x83, 0xf2, 0x50, 0xbf, 0x2b, 0xfb,
+    0xaa, 0x2c, 0x26, 0xd3, 0x60, 0x56, 0xff, 0xe6, 0xcb, 0xc7, 0x1a, 0xb4, 0x36, 0xc4, 0x54, 0xda,
+    0x03, 0xe8, 0xd3, 0x59, 0x1f, 0x0e, 0xd7, 0xeb, 0x59, 0xfb, 0x06, 0xf3, 0x85, 0xa7, 0x2c, 0x96,
+    0x8a, 0x82, 0xc2, 0x8e, 0xe8, 0x4a, 0x3b, 0x06, 0xda, 0xc8, 0x63, 0x54, 0x0d, 0x51, 0x9e, 0x37,
+    0x5c, 0x2c, 0xaa, 0x64, 0x89, 0x53, 0xc6, 0x6d, 0xa6, 0x11, 0x8a, 0x79, 0xa5, 0xa6, 0xce, 0xd7,
+    0x00, 0x58, 0x1e, 0x76, 0x6c, 0xd6, 0x8e, 0x8c, 0x2c, 0x3b, 0x65, 0xbc, 0x74, 0x77, 0x69, 0x4a,
+    0x9f, 0x82, 0xa0, 0x67, 0x85, 0xad, 0x96, 0x85, 0xb7, 0xa3, 0x4c, 0x97, 0x9c, 0xd8, 0x72, 0x4a,
+    0x39, 0xf8, 0xd0, 0xbf, 0x2b, 0x6d, 0x58, 0x7a, 0xc4, 0x4e, 0x30, 0x4b, 0x73, 0x84, 0x74, 0x49,
+    0x12, 0xc0, 0x31, 0x98, 0x3d, 0x80, 0xb8, 0x48, 0xc5, 0x21, 0x6a, 0x03, 0xfa, 0xc4, 0xdb, 0x64,
+    0x16, 0x76, 0x47, 0x4b, 0xce, 0xe8, 0x18, 0x59, 0xe1, 0xe3, 0x25, 0xa0, 0x88, 0x13, 0x6d, 0x70,
+    0x92, 0x33, 0x4e, 0x5b, 0xbe, 0x87, 0xfe, 0x84, 0x14, 0xd0, 0x37, 0x7a, 0x21, 0xbc, 0x82, 0x7e,
+    0x67, 0xec, 0x7d, 0xcd, 0xc5, 0x92, 0xd3, 0x21, 0x05, 0x41, 0x90, 0xa6, 0xcf, 0xcf, 0x5d, 0x19,
+    0x2a, 0xc9, 0xff, 0xa3, 0xa6, 0xff, 0x92, 0xce, 0x23, 0xc0, 0x2e, 0x6c, 0x39, 0x94, 0x6f, 0x58,
+    0x07, 0x57, 0x67, 0x39, 0x89, 0x81, 0x5f, 0x0a, 0x17, 0x73, 0x99, 0xec, 0x46, 0xab, 0x69, 0xdd,
+    0x22, 0xba, 0xac, 0x84, 0x1b, 0x8c, 0x9d, 0x26, 0x1a, 0x38, 0x24, 0x66, 0x86, 0x98, 0x28, 0x2b,
+    0xf3, 0xd3, 0x1c, 0x4b, 0xf8, 0xf4, 0x41, 0x11, 0x91, 0xc1, 0x87, 0x5f, 0x33, 0x14, 0x57, 0xd6,
+    0xad, 0xf0, 0xe1, 0x7d, 0xe7, 0xba, 0x49, 0x31, 0x52, 0x11, 0x7d, 0xd2, 0x5a, 0xe1, 0x46, 0x68,
+    0x5c, 0xf7, 0x29, 0x7b, 0x43, 0x85, 0xf0, 0xe6, 0x30, 0xea, 0xf5, 0xfe, 0x62, 0xd3, 0x70, 0xd6,
+    0xe4, 0x80, 0x64, 0x69, 0x58, 0x87, 0xb6, 0xef, 0xdf, 0x0f, 0x39, 0x77, 0x74, 0x24, 0x4d, 0x6f,
+    0x60, 0x99, 0x89, 0x77, 0xcc, 0x8e, 0x9b, 0xb2, 0xb4, 0x53, 0x93, 0x88, 0x04, 0xfa, 0x69, 0x9c,
+    0x87, 0xdb, 0x3b, 0x13, 0x58, 0xfa, 0x04, 0x64, 0x65, 0xdc, 0x1c, 0x3e, 0xd7, 0xf2, 0x08, 0x82,
+    0x28, 0x6a, 0x83, 0x6b, 0xdb, 0x3b, 0x96, 0x2d, 0x93, 0x57, 0x45, 0xfc, 0x2e, 0x5c, 0xe3, 0xab,
+    0x5e, 0xaa, 0xb0, 0x63, 0xbb, 0x85, 0x1f, 0x8e, 0xf2, 0x3f, 0xa8, 0x92, 0xa4, 0x52, 0xda, 0x51,
+    0x5e, 0x4a, 0x76, 0x1e, 0xb8, 0x97, 0x2a, 0xba, 0x12, 0x38, 0x4d, 0x06, 0xe5, 0x71, 0xdb, 0xa1,
+    0x2f, 0xc5, 0x56, 0x84, 0xb7, 0x9a, 0x77, 0x2c, 0xb6, 0xb1, 0xe9, 0x69, 0xe6, 0xa4, 0x8d, 0x10,
+    0xe1, 0x1c, 0x59, 0x6e, 0xf5, 0xf6, 0x6a, 0x02, 0x2e, 0x7c, 0xff, 0x34, 0x98, 0xa2, 0x5c, 0xbe,
+    0x74, 0xd7, 0xce, 0x05, 0x32, 0xa0, 0x2b, 0xe8, 0x79, 0x4e, 0xa5, 0xb2, 0x8d, 0x53, 0x7f, 0x72,
+    0x62, 0xe0, 0xc7, 0x14, 0x87, 0x75, 0xdb, 0x36, 0x69, 0x1f, 0xba, 0x7b, 0x23, 0x70, 0xb5, 0xdb,
+    0x0c, 0xbf, 0xb1, 0x6b, 0xa3, 0x96, 0x72, 0x30, 0xa0, 0x6e, 0x5d, 0x5e, 0x7d, 0xd4, 0x9d, 0x1c,
+    0xbd, 0xaa, 0x0e, 0xe6, 0x1f, 0xdd, 0x8d, 0xd6, 0x8c, 0x02, 0x61, 0x0b, 0xdb, 0x66, 0x8e, 0x07,
+    0xb7, 0x52, 0xdb, 0x89, 0x57, 0xf2, 0x9e, 0x57, 0xc6, 0x04, 0x1b, 0xcc, 0x10, 0x26, 0x5c, 0x59,
+    0xe2, 0xeb, 0x51, 0xc2, 0x21, 0x35, 0x67, 0x3a, 0x5b, 0x0c, 0x40, 0xaf, 0xc8, 0xc4, 0x97, 0xa3,
+    0xb6, 0xae, 0x47, 0xc1, 0x0a, 0xd2, 0x68, 0x55, 0x56, 0x5c, 0x03, 0x0a, 0xb5, 0x0d, 0x95, 0x32,
+    0x51, 0xf7, 0xaf, 0xf5, 0x67, 0x01, 0xbc, 0xc3, 0x65, 0x9a, 0xae, 0xec, 0xe3, 0x0c, 0x3e, 0xef,
+    0xe0, 0x98, 0x2a, 0x52, 0x80, 0xf6, 0x0e, 0x1b, 0x9b, 0xe0, 0x1e, 0xbd, 0xda, 0x86, 0x27, 0x09,
+    0x33, 0x36, 0x99, 0xc5, 0x16, 0x9d, 0xea, 0xe5, 0xf5, 0x70, 0x3d, 0x98, 0xaf, 0xdb, 0x1d, 0x37,
+    0xb6, 0xae, 0x4c, 0x4e, 0x93, 0xc9, 0x5f, 0x11, 0x1c, 0x93, 0x6b, 0x6c, 0x09, 0x00, 0x00,
+};
+
+// app.js: 3593 bytes, 1419 gzipped
+static const uint8_t web_app_js[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x57, 0x5b, 0x6f, 0x13, 0x39,
+    0x14, 0x7e, 0xcf, 0xaf, 0x38, 0x20, 0x81, 0x27, 0x22, 0x99, 0x04, 0x10, 0xab, 0x6d, 0xda, 0x64,
+    0xa5, 0xe5, 0xa2, 0xb2, 0x82, 0xb6, 0x52, 0xcb, 0xf2, 0x80, 0x78, 0x70, 0x67, 0x9c, 0x64, 0x60,
+    0xc6, 0x1e, 0x6c, 0x4f, 0xd3, 0x6c, 0xc9, 0x7f, 0xdf, 0xcf, 0x9e, 0x7b, 0x68, 0x49, 0x1e, 0xaa,
+    0xc6, 0x3e, 0xe7, 0xf8, 0x3b, 0xdf, 0xb9, 0x66, 0x32, 0xa1, 0x4b, 0xcb, 0xad, 0x20, 0xae, 0x75,
+    0x72, 0x23, 0x0c, 0xa9, 0x1b, 0xa1, 0xc9, 0xae, 0x05, 0x7d, 0x16, 0xd7, 0x97, 0x2a, 0xfa, 0x2e,
+    0xec, 0x8c, 0x04, 0xce, 0xb6, 0x76, 0x9d, 0xc8, 0x15, 0x29, 0x49, 0x91, 0x92, 0x52, 0x44, 0x76,
+    0xe4, 0xa4, 0xe4, 0x60, 0x32, 0xc1, 0x59, 0xba, 0xa5, 0xcd, 0x9a, 0x5b, 0x8a, 0xd6, 0x5c, 0xae,
+    0x44, 0x3c, 0x80, 0x88, 0xb1, 0x64, 0xb6, 0xd2, 0xae, 0x69, 0x4e, 0x77, 0xbb, 0xe3, 0x41, 0x2a,
+    0xf0, 0xdd, 0x9b, 0xc3, 0x81, 0x2c, 0xd2, 0xf4, 0x78, 0x30, 0x58, 0x16, 0x32, 0xb2, 0x49, 0x6b,
+    0x31, 0x18, 0xd2, 0xdd, 0x80, 0xf0, 0x69, 0x05, 0xc5, 0xa6, 0xc5, 0x11, 0xb0, 0x8d, 0x99, 0x4d,
+    0x26, 0x8c, 0x9e, 0x51, 0xaa, 0x22, 0xee, 0x34, 0xc3, 0xb5, 0xc2, 0x3b, 0xcf, 0x88, 0x4d, 0x36,
+    0x86, 0x0d, 0x8f, 0x3b, 0xca, 0xa1, 0x92, 0x99, 0x30, 0x86, 0xaf, 0x04, 0xcc, 0x00, 0xbf, 0x84,
+    0xb9, 0x45, 0x65, 0xde, 0x7d, 0xce, 0xaf, 0xbf, 0xe1, 0xc5, 0x90, 0x1b, 0x93, 0xac, 0x64, 0xe0,
+    0x91, 0x8e, 0xe8, 0x9f, 0xcb, 0xf3, 0xb3, 0x30, 0xe7, 0xda, 0x88, 0xc0, 0xab, 0x84, 0x31, 0xb7,
+    0x7c, 0x58, 0xd9, 0x75, 0x1f, 0x2d, 0x64, 0x2c, 0x74, 0x50, 0x9d, 0xec, 0xf6, 0x1e, 0x8c, 0x52,
+    0x65, 0xdc, 0x73, 0xf0, 0xa3, 0xf7, 0xd6, 0x9e, 0xdf, 0xcd, 0xb1, 0xb0, 0x57, 0x49, 0x26, 0x54,
+    0x61, 0x83, 0x86, 0xd2, 0xe7, 0xd3, 0xe9, 0xb4, 0xb5, 0xbe, 0xeb, 0x70, 0x54, 0x3f, 0x5d, 0xd9,
+    0x8d, 0x55, 0x54, 0x64, 0x0e, 0xe2, 0x4a, 0xd8, 0xb7, 0xa9, 0x70, 0xff, 0xfe, 0xbd, 0x7d, 0x1f,
+    0x07, 0x0c, 0xa6, 0xac, 0x56, 0x69, 0x2a, 0xf4, 0xd8, 0x20, 0xb0, 0x05, 0x78, 0x09, 0xad, 0xb8,
+    0xb5, 0xaf, 0x71, 0xee, 0x59, 0x68, 0xdf, 0x77, 0x4e, 0x87, 0xd5, 0xd3, 0x22, 0xa6, 0xbf, 0x88,
+    0xbd, 0xae, 0xbf, 0x30, 0x9a, 0x11, 0x7b, 0x93, 0x98, 0xe6, 0x96, 0x21, 0x5e, 0x4e, 0xa9, 0x8c,
+    0x6c, 0x22, 0xe3, 0x04, 0x11, 0x50, 0x1a, 0x4e, 0xfd, 0x0e, 0x89, 0xd3, 0x05, 0xf8, 0x71, 0x23,
+    0x5f, 0x07, 0xa9, 0x39, 0x08, 0xa3, 0x14, 0x31, 0x38, 0xe3, 0x99, 0x23, 0xae, 0xab, 0x52, 0x82,
+    0x27, 0x44, 0xbb, 0x01, 0x1c, 0xdc, 0x83, 0x38, 0xea, 0x21, 0x8e, 0xbb, 0x88, 0x87, 0x15, 0xe4,
+    0x87, 0x01, 0x16, 0x1a, 0xac, 0xda, 0xb1, 0x89, 0x78, 0x2a, 0x1e, 0xa4, 0x09, 0x5a, 0x97, 0x4e,
+    0xc0, 0x61, 0xac, 0x10, 0x78, 0x85, 0xca, 0x93, 0x07, 0xad, 0xab, 0xc8, 0xf2, 0x1b, 0x31, 0x36,
+    0xeb, 0x64, 0x69, 0x1f, 0x34, 0x5e, 0x19, 0x2c, 0x65, 0x69, 0x41, 0x53, 0xe7, 0xd3, 0x33, 0xef,
+    0x0b, 0x1b, 0x22, 0xb1, 0xbb, 0xd7, 0x07, 0xde, 0x8b, 0xf2, 0x62, 0x5c, 0xb8, 0x84, 0x3f, 0x14,
+    0xf0, 0xbc, 0x08, 0xad, 0x7a, 0x97, 0xdc, 0x8a, 0x38, 0x78, 0xee, 0xde, 0x60, 0x4f, 0xd8, 0x01,
+    0xd3, 0x1c, 0x21, 0x81, 0x2b, 0x37, 0x2a, 0x89, 0xc4, 0xa1, 0x7c, 0x2a, 0x85, 0x7c, 0x4d, 0xfe,
+    0xc9, 0xfa, 0x29, 0xdc, 0x63, 0x12, 0x19, 0x20, 0x6e, 0xeb, 0x6c, 0xae, 0xfa, 0x85, 0xbb, 0x34,
+    0xc8, 0x83, 0x2f, 0x8d, 0x4d, 0x76, 0x81, 0x37, 0x90, 0x27, 0x32, 0x89, 0xe8, 0x63, 0x22, 0x91,
+    0x40, 0x23, 0x62, 0x67, 0xc8, 0x0c, 0xcd, 0xd3, 0xf6, 0xe0, 0x8d, 0xd2, 0x09, 0x97, 0x6c, 0xd4,
+    0xaa, 0x9d, 0x16, 0x72, 0xc5, 0xdd, 0x61, 0x2b, 0x74, 0xca, 0x75, 0xd6, 0xb7, 0x73, 0xb1, 0xd6,
+    0xdb, 0x95, 0x53, 0xf4, 0x7a, 0x5f, 0x4b, 0x12, 0xb4, 0x80, 0x71, 0x59, 0x61, 0xf9, 0xe2, 0x51,
+    0x7e, 0xa5, 0x9f, 0x3f, 0x89, 0x7d, 0x92, 0xdf, 0xa5, 0xda, 0xc8, 0xd2, 0x27, 0x74, 0xbd, 0xf3,
+    0xba, 0x51, 0x56, 0xe5, 0xbd, 0x41, 0x37, 0xa4, 0xc4, 0x32, 0x43, 0x45, 0x3e, 0x22, 0x4e, 0x17,
+    0xe7, 0x97, 0x57, 0x64, 0x15, 0x4d, 0xaa, 0x8a, 0x24, 0x05, 0x61, 0xbd, 0x49, 0x8c, 0x68, 0x19,
+    0x31, 0x28, 0xea, 0xd7, 0xe5, 0x75, 0x50, 0xb5, 0xab, 0x3e, 0x25, 0xd7, 0x2a, 0xde, 0x82, 0x10,
+    0xdf, 0x98, 0x8c, 0xd5, 0xe8, 0xc0, 0xc9, 0x72, 0xdb, 0x88, 0x56, 0xb5, 0xb4, 0x44, 0x1a, 0x95,
+    0x18, 0x9e, 0x3e, 0xad, 0xbb, 0x91, 0x16, 0x3c, 0xde, 0x96, 0x9d, 0x7d, 0x3e, 0x9f, 0xb7, 0x4d,
+    0x34, 0x3c, 0xbf, 0x78, 0x7b, 0x36, 0xfc, 0xa5, 0x39, 0x85, 0x0e, 0x49, 0xe0, 0x5e, 0xeb, 0x75,
+    0x3b, 0x4f, 0xc5, 0x85, 0x56, 0x19, 0x50, 0xc3, 0xa4, 0x51, 0xe9, 0x8d, 0x68, 0xba, 0x5f, 0x97,
+    0xae, 0xa5, 0xb0, 0xd1, 0x3a, 0x60, 0xb5, 0xaf, 0x60, 0xb7, 0x7d, 0x21, 0x13, 0x76, 0xad, 0x62,
+    0x64, 0xb4, 0x63, 0xa4, 0x13, 0xa4, 0x35, 0x20, 0x0a, 0x6d, 0x66, 0x74, 0xc7, 0xaa, 0x64, 0x1a,
+    0x5f, 0x6d, 0x73, 0xc1, 0x20, 0xc9, 0xf3, 0x3c, 0x4d, 0xca, 0x16, 0x3f, 0xf9, 0x66, 0x94, 0x64,
+    0xbb, 0x56, 0xcd, 0x81, 0x9c, 0xf9, 0xbf, 0x25, 0x8c, 0x61, 0x3f, 0xc9, 0xca, 0x11, 0xe4, 0xf3,
+    0x2c, 0xb8, 0xe1, 0x69, 0xd1, 0x10, 0xda, 0xe5, 0xfa, 0x2e, 0x52, 0x59, 0xc6, 0xa5, 0x03, 0x65,
+    0xaa, 0xa4, 0x04, 0x64, 0x2f, 0x3e, 0x23, 0x3f, 0x00, 0xde, 0x4b, 0x5b, 0xa9, 0x57, 0x0f, 0x20,
+    0xe2, 0x9f, 0xd7, 0x49, 0x8a, 0x41, 0x49, 0x26, 0x4d, 0x00, 0x9c, 0x12, 0x43, 0xb1, 0xe6, 0x2b,
+    0xcc, 0xbb, 0x11, 0xe2, 0x6e, 0x28, 0x05, 0xd9, 0x08, 0x99, 0xd7, 0xa2, 0x95, 0x42, 0x26, 0xfb,
+    0xb9, 0x49, 0xaf, 0xa6, 0x99, 0xa9, 0x26, 0x62, 0x0e, 0x0c, 0x88, 0xe1, 0xbf, 0x4e, 0xc4, 0x74,
+    0x27, 0x23, 0xce, 0xdd, 0x2c, 0xd0, 0xf7, 0x0c, 0xc7, 0x22, 0xc7, 0x14, 0x12, 0x5e, 0x25, 0x00,
+    0x34, 0x9e, 0x55, 0x40, 0x0f, 0x4d, 0x02, 0x2f, 0xeb, 0xea, 0x70, 0xec, 0xc5, 0x1f, 0x2c, 0xdb,
+    0x52, 0xce, 0x25, 0x09, 0x5b, 0x26, 0xa9, 0x15, 0x9a, 0xa1, 0x07, 0x95, 0x4e, 0x40, 0x99, 0x4e,
+    0xff, 0x73, 0xdd, 0xa8, 0xf9, 0xfe, 0xa4, 0x1e, 0x04, 0x3d, 0x57, 0xbe, 0x78, 0x23, 0x5f, 0x81,
+    0xde, 0x93, 0xf7, 0x2e, 0x55, 0xbc, 0xa6, 0xaf, 0xcd, 0xd1, 0x47, 0x8d, 0x97, 0xc3, 0x9e, 0xc3,
+    0x9d, 0x39, 0xe8, 0x8e, 0x4b, 0x8b, 0x23, 0xd0, 0xb6, 0x17, 0xd9, 0xf6, 0x32, 0xe8, 0xc6, 0xb4,
+    0xcf, 0x9b, 0x3b, 0x5d, 0x62, 0x2e, 0x05, 0x15, 0xe1, 0xde, 0xb9, 0x44, 0xf6, 0xe1, 0xf6, 0xf2,
+    0xff, 0xc1, 0xb4, 0x70, 0x8b, 0x46, 0x97, 0xf0, 0xd9, 0xbd, 0x3e, 0xef, 0x3a, 0x05, 0x13, 0x0b,
+    0x04, 0x53, 0xdc, 0x2b, 0x56, 0xd7, 0x4c, 0x7f, 0xa4, 0xe3, 0x95, 0x37, 0x62, 0xc9, 0x8b, 0xd4,
+    0x9a, 0xc3, 0x93, 0x5d, 0xbb, 0x74, 0xba, 0x1e, 0x67, 0xc9, 0x2d, 0x62, 0x59, 0x06, 0x64, 0x4e,
+    0x2f, 0xa7, 0x07, 0x7a, 0x37, 0x30, 0xf1, 0xed, 0x9e, 0xd2, 0x8b, 0x43, 0x4a, 0x65, 0x22, 0x8c,
+    0x97, 0x5a, 0xfc, 0xe8, 0xa9, 0x4d, 0x2b, 0xc5, 0x6e, 0x4e, 0x56, 0xb8, 0x50, 0x3f, 0x2f, 0xeb,
+    0xd5, 0xa5, 0x77, 0xed, 0x01, 0xe0, 0xf6, 0xc5, 0xbd, 0xb7, 0x55, 0xca, 0x8d, 0xbc, 0xf1, 0xfd,
+    0x80, 0x63, 0xe8, 0x5d, 0x78, 0x92, 0x82, 0x43, 0x45, 0xdc, 0x48, 0xb2, 0x1d, 0xf2, 0x1c, 0x9d,
+    0x38, 0x28, 0x97, 0x30, 0x14, 0xb6, 0xc6, 0xe2, 0x58, 0xde, 0x79, 0x83, 0xf1, 0x23, 0x36, 0x6c,
+    0x2a, 0xfa, 0x54, 0x6d, 0xb0, 0x4b, 0x62, 0xad, 0x15, 0x3c, 0x5a, 0xd3, 0xdb, 0xcb, 0x0b, 0x7c,
+    0x53, 0x39, 0x59, 0x6e, 0xbe, 0xd3, 0x86, 0xbb, 0xa2, 0x46, 0x03, 0xd7, 0x85, 0xa4, 0x60, 0xe2,
+    0x2e, 0x86, 0x33, 0x3a, 0x3a, 0xc2, 0x4a, 0x9b, 0x0b, 0x1d, 0x81, 0x2b, 0x74, 0x03, 0x67, 0x04,
+    0x10, 0x68, 0xa3, 0x34, 0xb2, 0x2d, 0xe2, 0xd8, 0xff, 0x4c, 0x22, 0x23, 0x81, 0xfe, 0xa4, 0x6c,
+    0xeb, 0x09, 0x32, 0x32, 0xe3, 0xf6, 0x93, 0x09, 0x8a, 0x26, 0xf7, 0x5c, 0x45, 0x60, 0xbf, 0x39,
+    0xa1, 0xe9, 0xb0, 0x6e, 0xa2, 0x6c, 0xf1, 0xc7, 0xab, 0xcc, 0xb0, 0xde, 0x1c, 0x82, 0xc8, 0x62,
+    0xee, 0xd7, 0x42, 0x54, 0xa5, 0x53, 0x98, 0x94, 0x3b, 0xe2, 0xde, 0x08, 0x87, 0x1a, 0xaa, 0xb4,
+    0xf0, 0x73, 0xb7, 0x30, 0x7b, 0x73, 0xb7, 0x24, 0xfc, 0x03, 0x1c, 0x68, 0x78, 0xac, 0xfb, 0xb5,
+    0xf3, 0x8a, 0x0d, 0x9b, 0x04, 0x2e, 0xa9, 0x03, 0x59, 0x39, 0xaa, 0x47, 0x38, 0x02, 0xeb, 0xff,
+    0x43, 0xd7, 0x86, 0x83, 0xe1, 0xaf, 0xa2, 0xb9, 0xd2, 0x7b, 0xab, 0x75, 0x3b, 0xbd, 0xb4, 0xda,
+    0xb8, 0x2e, 0x57, 0x0a, 0x85, 0x8e, 0x55, 0x13, 0x66, 0x3c, 0x0f, 0x3c, 0xbf, 0xf3, 0x45, 0x4f,
+    0xc3, 0x8f, 0xed, 0x93, 0x38, 0xb9, 0x21, 0xbf, 0x11, 0xce, 0x1f, 0x97, 0x0b, 0xe0, 0x38, 0xb1,
+    0x22, 0x7b, 0xbc, 0x38, 0x31, 0x39, 0x97, 0x0b, 0x57, 0x91, 0x4e, 0x37, 0x94, 0x6e, 0x5f, 0x84,
+    0xab, 0x27, 0x93, 0xfa, 0xfc, 0x1e, 0x5b, 0xee, 0x6a, 0xcf, 0x98, 0xcf, 0xe4, 0xc7, 0x8b, 0xfc,
+    0xe8, 0x88, 0x9e, 0xa6, 0xf6, 0xd8, 0xd9, 0x6b, 0x42, 0xe3, 0x0d, 0xe3, 0xe6, 0x13, 0x42, 0x74,
+    0x8f, 0xb9, 0x11, 0x65, 0xfc, 0x96, 0x7e, 0xd5, 0xc0, 0xa9, 0xd7, 0x68, 0xc0, 0x9c, 0x4c, 0xe0,
+    0xc4, 0x82, 0x75, 0xda, 0xc2, 0x6f, 0x4b, 0xcd, 0x45, 0x60, 0xec, 0xa9, 0x41, 0xa5, 0x25, 0xd8,
+    0x5d, 0xf5, 0xe9, 0xd5, 0xc7, 0x0f, 0x8e, 0x35, 0x90, 0x17, 0x7e, 0x53, 0x89, 0x0c, 0x58, 0xd7,
+    0xd8, 0xae, 0x13, 0x02, 0x4c, 0x48, 0x44, 0xb1, 0xfa, 0xb9, 0x51, 0xcd, 0xa9, 0xe6, 0xb7, 0xd4,
+    0xf1, 0xa0, 0x1b, 0xf7, 0xe3, 0x01, 0x0a, 0x00, 0x43, 0x4d, 0x68, 0x70, 0x10, 0xb4, 0x37, 0x4d,
+    0xe1, 0xfd, 0x0f, 0xdc, 0x31, 0x95, 0xca, 0x09, 0x0e, 0x00, 0x00,
+};
+
+// index.html: 3452 bytes, 910 gzipped
+static const uint8_t web_index_html[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xb5, 0x57, 0xe1, 0x6e, 0xd3, 0x30,
+    0x10, 0xfe, 0xbf, 0xa7, 0x30, 0x96, 0x10, 0x43, 0x5a, 0xd6, 0xac, 0xdd, 0xb4, 0x22, 0x35, 0x41,
+    0x88, 0x31, 0xf6, 0x03, 0xd8, 0x44, 0x37, 0x24, 0x7e, 0xba, 0xc9, 0xb5, 0x31, 0x73, 0xed, 0x60,
+    0x3b, 0x65, 0xe5, 0x21, 0x78, 0x05, 0x5e, 0x83, 0xc7, 0xe2, 0x11, 0x38, 0xdb, 0x29, 0x0b, 0x6b,
+    0x3a, 0xb5, 0x1d, 0xeb, 0x9f, 0xc6, 0xf6, 0xdd, 0xe7, 0xef, 0x3e, 0xdf, 0x5d, 0xe2, 0xc1, 0x93,
+    0x93, 0xf3, 0xd7, 0x97, 0x9f, 0x2f, 0xde, 0x90, 0xc2, 0x4e, 0x45, 0xba, 0x33, 0x70, 0x7f, 0x44,
+    0x30, 0x39, 0x49, 0x28, 0x48, 0xea, 0x26, 0x80, 0xe5, 0xe9, 0x0e, 0xc1, 0xdf, 0x60, 0x0a, 0x96,
+    0x91, 0xac, 0x60, 0xda, 0x80, 0x4d, 0xe8, 0xd5, 0xe5, 0x69, 0xd4, 0xa7, 0xcd, 0x25, 0xc9, 0xa6,
+    0x90, 0xd0, 0x19, 0x87, 0x6f, 0xa5, 0xd2, 0x96, 0x92, 0x4c, 0x49, 0x0b, 0x12, 0x4d, 0xbf, 0xf1,
+    0xdc, 0x16, 0x49, 0x0e, 0x33, 0x9e, 0x41, 0xe4, 0x07, 0x7b, 0x84, 0x4b, 0x6e, 0x39, 0x13, 0x91,
+    0xc9, 0x98, 0x80, 0xe4, 0x60, 0x3f, 0x5e, 0x40, 0x59, 0x6e, 0x05, 0xa4, 0x6f, 0x2b, 0x6e, 0x99,
+    0x26, 0x67, 0xa0, 0x15, 0x19, 0xce, 0xa5, 0x2d, 0xc0, 0xf0, 0xef, 0xa0, 0x07, 0x9d, 0xb0, 0x1c,
+    0x4c, 0x05, 0x97, 0xd7, 0x44, 0x83, 0x48, 0xa8, 0xb1, 0x73, 0x01, 0xa6, 0x00, 0xc0, 0x6d, 0x0b,
+    0x0d, 0xe3, 0x84, 0xb2, 0xb2, 0xdc, 0xcf, 0x8c, 0x79, 0x39, 0x4b, 0x0e, 0x0e, 0x47, 0xf9, 0x31,
+    0x1c, 0x1e, 0x8d, 0x7a, 0xf0, 0xc2, 0x45, 0xd4, 0x09, 0x21, 0x0d, 0x46, 0x2a, 0x9f, 0xd7, 0x40,
+    0x39, 0x9f, 0x91, 0x4c, 0x30, 0x63, 0x12, 0xea, 0x48, 0x33, 0x2e, 0x41, 0xd7, 0x7c, 0xfc, 0x7a,
+    0x71, 0x90, 0xfe, 0xfe, 0xf9, 0xe3, 0x17, 0x59, 0xc9, 0x0a, 0x0d, 0x76, 0x6e, 0xcd, 0x1b, 0x70,
+    0xc6, 0x32, 0x5b, 0x99, 0x06, 0x56, 0xc0, 0xeb, 0xa6, 0xc3, 0xb9, 0xb1, 0x30, 0x25, 0x43, 0xbf,
+    0x8e, 0x00, 0xdd, 0x3b, 0x26, 0x4b, 0x18, 0x11, 0x47, 0xfb, 0x3b, 0x40, 0xde, 0xd2, 0x94, 0x4c,
+    0xa6, 0xaf, 0x91, 0xb6, 0x56, 0x42, 0x38, 0x32, 0x7e, 0xa2, 0xdd, 0xee, 0x0e, 0xe4, 0x8c, 0x89,
+    0x0a, 0x5a, 0x30, 0x6f, 0xed, 0x79, 0x1e, 0x24, 0x09, 0xd8, 0xd1, 0x22, 0x9c, 0x13, 0x6e, 0x70,
+    0x56, 0x42, 0x66, 0x21, 0x5f, 0xb5, 0xe1, 0x12, 0x88, 0x33, 0xe7, 0x4a, 0x46, 0x5c, 0xe6, 0x3c,
+    0x63, 0x56, 0x69, 0xda, 0x10, 0x7d, 0xb1, 0x18, 0x76, 0x20, 0x79, 0x63, 0x03, 0x9a, 0xae, 0x8c,
+    0xa9, 0x65, 0x7e, 0xd0, 0x41, 0xe9, 0x1e, 0x28, 0x66, 0xa5, 0x35, 0x26, 0x2e, 0x19, 0xba, 0xdc,
+    0xdc, 0x5c, 0xcf, 0x10, 0x6f, 0xc0, 0x08, 0xf9, 0x4d, 0xd3, 0x0b, 0x7c, 0xc6, 0x90, 0x25, 0xcf,
+    0xc8, 0x7b, 0x2e, 0x95, 0x7e, 0x24, 0xe6, 0xe7, 0x99, 0x65, 0x33, 0x20, 0xc3, 0x82, 0x8f, 0xed,
+    0x96, 0xc4, 0x95, 0x87, 0x88, 0x8c, 0x83, 0xa0, 0x69, 0xfc, 0x58, 0x12, 0x5f, 0x5c, 0x91, 0x2b,
+    0xc3, 0x26, 0x5b, 0xcb, 0x5b, 0x56, 0x51, 0xe5, 0xfc, 0x91, 0xe2, 0xd3, 0x47, 0xe2, 0xf8, 0x0a,
+    0x33, 0x12, 0xc5, 0xfc, 0xa4, 0xb0, 0x6d, 0x99, 0x2d, 0x79, 0x32, 0x8f, 0x11, 0xcd, 0x3c, 0x06,
+    0x72, 0xed, 0xf4, 0xd7, 0x20, 0x5b, 0x0f, 0x37, 0x6b, 0x28, 0xef, 0x94, 0x2a, 0xc9, 0x3b, 0x86,
+    0x1d, 0x37, 0x9b, 0xaf, 0xe8, 0x27, 0x8e, 0x90, 0x40, 0xb3, 0xc8, 0x32, 0x73, 0x6d, 0x5c, 0x59,
+    0xad, 0xbd, 0x6d, 0xdd, 0x03, 0xda, 0x36, 0xae, 0x5b, 0x4f, 0xdd, 0xc4, 0x56, 0x2a, 0x5e, 0x23,
+    0x44, 0x13, 0xad, 0xaa, 0xb2, 0x4d, 0x73, 0xc1, 0x46, 0x20, 0xc8, 0x58, 0x69, 0x0c, 0xd2, 0x15,
+    0x4d, 0x64, 0x40, 0x60, 0xfd, 0xd3, 0xb4, 0x2e, 0x43, 0xbf, 0xde, 0x76, 0x00, 0xde, 0xcc, 0x07,
+    0xf7, 0x8f, 0x1f, 0x51, 0x12, 0x5f, 0x56, 0x72, 0x82, 0xef, 0xa4, 0xf0, 0xef, 0x71, 0x76, 0x6d,
+    0xc1, 0xcd, 0xbe, 0x3f, 0xa1, 0xe7, 0xab, 0x3a, 0x9f, 0x2a, 0x5d, 0x2b, 0x22, 0xde, 0x28, 0xa1,
+    0x71, 0x5b, 0xf5, 0x06, 0x93, 0xb5, 0xfc, 0x0f, 0x68, 0xfa, 0x01, 0xcf, 0x4c, 0x33, 0xb1, 0x85,
+    0x73, 0x17, 0x7b, 0xad, 0xd2, 0x9c, 0xc9, 0x8d, 0xbc, 0x7a, 0x34, 0x3d, 0xab, 0xe4, 0x84, 0x39,
+    0xc7, 0x2d, 0x36, 0x3d, 0x44, 0x77, 0xa6, 0xa7, 0x5b, 0xc6, 0x7b, 0x84, 0x7a, 0x15, 0x7a, 0x3e,
+    0xb9, 0x97, 0x34, 0x56, 0x81, 0x3f, 0xa5, 0xd6, 0x3a, 0xf8, 0x2f, 0x39, 0xa4, 0x61, 0x06, 0x7a,
+    0x14, 0x4d, 0xf9, 0x0d, 0x4d, 0x3f, 0xfa, 0x67, 0x8c, 0xe5, 0x66, 0x75, 0x1a, 0x71, 0x59, 0x56,
+    0x96, 0xd8, 0x79, 0x89, 0x21, 0x68, 0x97, 0x2e, 0xa1, 0x80, 0x1b, 0x30, 0x64, 0xca, 0xa5, 0x4b,
+    0x07, 0x32, 0x65, 0x37, 0x78, 0xac, 0x31, 0x3e, 0x2d, 0xf4, 0x8e, 0x69, 0xab, 0x32, 0xf8, 0x43,
+    0x11, 0x1d, 0x70, 0x42, 0xab, 0x32, 0xc7, 0xe2, 0xfc, 0xe4, 0x1c, 0x76, 0x9f, 0x05, 0xd4, 0x67,
+    0x7b, 0xe4, 0xfe, 0x6c, 0x6c, 0xc6, 0xee, 0x39, 0x35, 0x5b, 0x4b, 0xcd, 0xac, 0x7e, 0x87, 0xf7,
+    0x5c, 0x1b, 0x5c, 0x6e, 0x79, 0xff, 0x51, 0xd0, 0x1c, 0x04, 0x9b, 0x07, 0x3d, 0x4f, 0xdc, 0xe3,
+    0x56, 0x72, 0xde, 0x82, 0xac, 0x56, 0xb3, 0xbb, 0xa9, 0x9a, 0x1e, 0xf4, 0x61, 0x62, 0x06, 0x5e,
+    0xb5, 0x96, 0xdd, 0x47, 0xd7, 0x72, 0xcc, 0x85, 0xc5, 0xcf, 0xa9, 0xb1, 0x86, 0xaf, 0x34, 0x3d,
+    0xf5, 0x03, 0x72, 0x8a, 0x83, 0x2a, 0x74, 0xef, 0x0d, 0x45, 0x6d, 0xa2, 0x05, 0x59, 0xbd, 0x9c,
+    0x5e, 0xd8, 0xc3, 0xf8, 0x1f, 0x65, 0xe3, 0x4d, 0xb5, 0x0d, 0xd8, 0x0f, 0x13, 0xb7, 0xe6, 0xf7,
+    0x57, 0xdd, 0x38, 0x26, 0x67, 0xdf, 0xd7, 0x55, 0x78, 0x54, 0x59, 0xec, 0xbc, 0xae, 0x99, 0x0b,
+    0x9e, 0x5d, 0xbb, 0xb4, 0xc7, 0xeb, 0xc7, 0x09, 0x8c, 0x59, 0x25, 0xac, 0xd9, 0x7d, 0xee, 0x8a,
+    0x1b, 0x27, 0x88, 0x55, 0x64, 0x31, 0x39, 0xe8, 0x04, 0x9f, 0xf4, 0x7e, 0x20, 0x83, 0x9f, 0x39,
+    0x17, 0x1e, 0xcd, 0xa1, 0x0c, 0xdd, 0x77, 0x53, 0x18, 0x2e, 0xfb, 0x37, 0xb8, 0x36, 0x39, 0x0e,
+    0x4c, 0xa6, 0x79, 0x69, 0x89, 0xd1, 0x59, 0xb8, 0x70, 0x7c, 0x71, 0xf7, 0x8d, 0x5e, 0xdc, 0x3f,
+    0x86, 0x1e, 0xf4, 0x8f, 0xfb, 0xa3, 0xf0, 0xe9, 0xea, 0x8d, 0xdc, 0xc5, 0x23, 0xdc, 0x38, 0xf0,
+    0x3d, 0xe9, 0xef, 0x5a, 0x7f, 0x00, 0xed, 0x37, 0xa6, 0xf4, 0x7c, 0x0d, 0x00, 0x00,
+};
+
+// 9457 bytes, 3176 gzipped
+static const WebAsset webAssets[] = {
+    {"/app.css", "text/css", web_app_css, 847, 2412, "\"14bd7e45b3e9\"", true},
+    {"/app.js", "application/javascript", web_app_js, 1419, 3593, "\"3087e3e878bd\"", true},
+    {"/index.html", "text/html", web_index_html, 910, 3452, "\"8bab33034693\"", false},
+};
+
+static const size_t webAssetCount = sizeof(webAssets) / sizeof(webAssets[0]);
+
+#endif // WEB_ASSETS_H
@@ -0,0 +1,498 @@
+/**
+ * Bridge Load Generator
+ * Drives the native ESP bridge (src/native/bridge_host.cpp) with OSC,
+ * HTTP and serial traffic at once and reports throughput, latency
+ * percentiles and the bridge's memory high-water mark
+ *
+ * Starts the bridge on a pseudo-terminal of its own and plays the Teensy
+ * on the other end:
+ *   - serial: grants credit, answers pings and sends a state delta every
+ *     --state-ms (as syncESPState() does), timing each until the bridge
+ *     acknowledges it
+ *   - OSC: --osc-rate /synth/filter messages a second over UDP, each
+ *     value unique, timed until the LinkSetParam carrying it comes out of
+ *     the pty. Values the coalescer replaced before sending are counted,
+ *     not timed.
+ *   - HTTP: --http-clients keep-alive connections, each sending GET
+ *     /status back to back with a POST /control every tenth request
+ *
+ * Memory is VmRSS and VmHWM from /proc/<pid>/status, after a second of
+ * load and at the end: with fixed buffers throughout the two should
+ * match.
+ *
+ * Build (from esp8266-wifi):
+ *   g++ -std=gnu++17 -O2 -Wall -o bridge_host src/esp_bridge.cpp src/native/bridge_host.cpp
+ *   g++ -std=gnu++17 -O2 -Wall -pthread -o load_generator tools/load_generator.cpp
+ * Run:
+ *   ./load_generator [--bridge ./bridge_host] [--seconds 10] [--osc-rate 2000]
+ *                    [--http-clients 4] [--state-ms 10] [--osc-port 9000] [--http-port 9080]
+ */
+
+#include "../../teensy-main/include/link_protocol.h"
+#include "../../teensy-main/include/link_state.h"
+#include "../../teensy-main/include/link_flow.h"
+#include "../../teensy-main/include/link_tx_queue.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <termios.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define OSC_VALUE_BASE 20          // filter's minimum; values run up from here
+#define OSC_VALUE_SLOTS 16384      // Unique values in flight (up to 16403Hz)
+#define TEENSY_RX_BUFFER 512       // Credit the fake Teensy grants the bridge
+
+struct Options {
+    const char* bridge = "./bridge_host";
+    double seconds = 10;
+    unsigned oscRate = 2000;
+    unsigned httpClients = 4;
+    unsigned stateMs = 10;
+    unsigned oscPort = 9000;
+    unsigned httpPort = 9080;
+} options;
+
+std::atomic<bool> stopping(false);
+
+uint32_t nowUs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000);
+}
+
+// Latency samples and counters for one kind of traffic; each is written
+// by one thread only
+struct Series {
+    const char* name;
+    uint64_t sent = 0;
+    uint64_t errors = 0;
+    std::vector<uint32_t> latencyUs;
+
+    Series(const char* name) : name(name) { latencyUs.reserve(1 << 20); }
+};
+
+// ---- Fake Teensy on the pty master
+
+std::atomic<uint32_t> oscSentUs[OSC_VALUE_SLOTS];
+
+struct TeensyStats {
+    Series state{"serial state -> ack"};
+    Series osc{"osc -> serial param"};
+    uint64_t paramFrames = 0;
+    uint64_t resyncs = 0;
+    uint32_t rttUs = 0;
+    uint32_t rttMaxUs = 0;
+    uint32_t creditStalls = 0;
+} teensy;
+
+void runTeensy(int master) {
+    LinkDecoder decoder;
+    LinkTxQueue tx;
+    LinkFlow flow(TEENSY_RX_BUFFER);
+    LinkStateSender sender;
+    static uint32_t stateSentUs[65536];
+
+    uint32_t start = nowUs();
+    uint32_t lastStateUs = start;
+    while (!stopping) {
+        uint32_t now = nowUs();
+        uint32_t nowMs = now / 1000;
+
+        uint8_t chunk[256];
+        ssize_t n;
+        while ((n = read(master, chunk, sizeof(chunk))) > 0) {
+            for (ssize_t i = 0; i < n; i++) {
+                flow.received(1);
+                if (!decoder.push(chunk[i])) continue;
+                uint32_t at = nowUs();
+
+                LinkCommand command;
+                LinkSetParam param;
+                LinkStateAck ack;
+                LinkCredit credit;
+                LinkPing ping;
+                LinkPong pong;
+                if (decoder.get(credit)) {
+                    flow.onCredit(credit);
+                } else if (decoder.get(ping)) {
+                    tx.send(LinkFlow::pong(ping), LINK_LANE_LINK);
+                } else if (decoder.get(pong)) {
+                    flow.onPong(pong, at);
+                } else if (decoder.get(ack)) {
+                    sender.ack(ack.generation);
+                    teensy.state.latencyUs.push_back(at - stateSentUs[ack.generation]);
+                } else if (decoder.get(command)) {
+                    if (command.command == LINK_CMD_RESYNC) {
+                        sender.resync();
+                        teensy.resyncs++;
+                    }
+                } else if (decoder.get(param)) {
+                    teensy.paramFrames++;
+                    if (param.param != LINK_PARAM_FILTER) continue;
+                    uint32_t slot = (uint32_t)param.value - OSC_VALUE_BASE;
+                    if (slot < OSC_VALUE_SLOTS) teensy.osc.latencyUs.push_back(at - oscSentUs[slot].load());
+                }
+            }
+        }
+
+        // A state change every stateMs: voices and CPU move, as they do
+        // while playing
+        if (now - lastStateUs >= options.stateMs * 1000) {
+            lastStateUs = now;
+            LinkState& state = sender.state();
+            state.connected = 1;
+            state.voices = (state.voices + 1) % 16;
+            state.cpuTenths = (state.cpuTenths + 7) % 1000;
+            state.totalNotes++;
+        }
+        uint8_t payload[LINK_MAX_PAYLOAD];
+        size_t len = sender.poll(nowMs, payload);
+        if (len) {
+            uint8_t frame[LINK_MAX_FRAME];
+            if (tx.push(frame, linkEncode(LINK_MSG_STATE, payload, len, frame), LINK_LANE_COMMAND)) {
+                stateSentUs[sender.getGeneration()] = nowUs();
+                teensy.state.sent++;
+            } else {
+                teensy.state.errors++;
+            }
+        }
+
+        if (flow.creditDue(nowMs)) tx.send(flow.grant(nowMs), LINK_LANE_LINK);
+        if (flow.pingDue(nowMs)) tx.send(flow.ping(nowMs, nowUs()), LINK_LANE_LINK);
+        size_t out;
+        while ((out = tx.pull(chunk, sizeof(chunk), &flow, nowMs)) > 0) {
+            if (write(master, chunk, out) != (ssize_t)out) break;
+        }
+
+        pollfd pfd = {master, POLLIN, 0};
+        poll(&pfd, 1, 1);
+    }
+    teensy.rttUs = flow.getRttUs();
+    teensy.rttMaxUs = flow.getRttMaxUs();
+    teensy.creditStalls = flow.getCreditStalls();
+}
+
+// ---- OSC sender
+
+Series oscSeries("osc datagrams");
+
+size_t oscFloat(const char* address, float value, uint8_t* out) {
+    size_t len = strlen(address) + 1;
+    memcpy(out, address, len);
+    while (len % 4) out[len++] = 0;
+    memcpy(out + len, ",f\0\0", 4);
+    len += 4;
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    bits = htonl(bits);
+    memcpy(out + len, &bits, 4);
+    return len + 4;
+}
+
+void runOSC() {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(options.oscPort);
+    connect(fd, (sockaddr*)&addr, sizeof(addr));
+
+    // Paced in 1ms steps against the start time, so a late step catches up
+    timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    uint64_t due = 0;
+    uint64_t step = 0;
+    while (!stopping) {
+        step++;
+        due = step * options.oscRate / 1000;
+        while (oscSeries.sent < due) {
+            uint32_t slot = oscSeries.sent % OSC_VALUE_SLOTS;
+            uint8_t packet[32];
+            size_t len = oscFloat("/synth/filter", (float)(OSC_VALUE_BASE + slot), packet);
+            oscSentUs[slot].store(nowUs());
+            if (send(fd, packet, len, 0) != (ssize_t)len) oscSeries.errors++;
+            oscSeries.sent++;
+        }
+        next.tv_nsec += 1000000;
+        if (next.tv_nsec >= 1000000000) {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+    close(fd);
+}
+
+// ---- HTTP clients
+
+int connectHTTP() {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(options.httpPort);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+// One request and its whole response on a keep-alive connection; the
+// status code, or -1 if the connection failed. body receives the body.
+int httpExchange(int fd, const char* request, char* body, size_t bodyMax) {
+    size_t len = strlen(request);
+    if (send(fd, request, len, MSG_NOSIGNAL) != (ssize_t)len) return -1;
+
+    char buffer[4096];
+    size_t have = 0;
+    while (true) {
+        ssize_t n = recv(fd, buffer + have, sizeof(buffer) - 1 - have, 0);
+        if (n <= 0) return -1;
+        have += n;
+        buffer[have] = 0;
+        char* end = strstr(buffer, "\r\n\r\n");
+        if (!end) continue;
+        char* lengthHeader = strstr(buffer, "Content-Length: ");
+        size_t contentLength = lengthHeader ? strtoul(lengthHeader + 16, NULL, 10) : 0;
+        size_t headerLen = end + 4 - buffer;
+        if (have < headerLen + contentLength) continue;
+        if (body && bodyMax) {
+            size_t copy = std::min(contentLength, bodyMax - 1);
+            memcpy(body, buffer + headerLen, copy);
+            body[copy] = 0;
+        }
+        return atoi(buffer + 9);   // "HTTP/1.1 200"
+    }
+}
+
+void runHTTP(Series* status, Series* control, unsigned id) {
+    int fd = connectHTTP();
+    if (fd < 0) {
+        status->errors++;
+        return;
+    }
+    char request[256];
+    for (uint64_t i = 0; !stopping; i++) {
+        Series* series = status;
+        if (i % 10 == 9) {
+            char body[64];
+            int bodyLen = snprintf(body, sizeof(body), "{\"command\":\"setReverb\",\"value\":%u}",
+                                   (unsigned)((i + id) % 101));
+            snprintf(request, sizeof(request),
+                     "POST /control HTTP/1.1\r\nHost: bridge\r\nContent-Type: application/json\r\n"
+                     "Content-Length: %d\r\n\r\n%s", bodyLen, body);
+            series = control;
+        } else {
+            snprintf(request, sizeof(request), "GET /status HTTP/1.1\r\nHost: bridge\r\n\r\n");
+        }
+
+        uint32_t start = nowUs();
+        int code = httpExchange(fd, request, NULL, 0);
+        series->sent++;
+        if (code != 200) {
+            series->errors++;
+            if (code < 0) break;
+            continue;
+        }
+        series->latencyUs.push_back(nowUs() - start);
+    }
+    close(fd);
+}
+
+// ---- Bridge process
+
+bool readMemory(pid_t pid, long& rssKb, long& hwmKb) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/status", (int)pid);
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+    char line[256];
+    rssKb = hwmKb = -1;
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, "VmRSS:", 6) == 0) rssKb = atol(line + 6);
+        if (strncmp(line, "VmHWM:", 6) == 0) hwmKb = atol(line + 6);
+    }
+    fclose(file);
+    return rssKb >= 0 && hwmKb >= 0;
+}
+
+pid_t startBridge(const char* slave) {
+    char oscPort[16];
+    char httpPort[16];
+    snprintf(oscPort, sizeof(oscPort), "%u", options.oscPort);
+    snprintf(httpPort, sizeof(httpPort), "%u", options.httpPort);
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl(options.bridge, options.bridge, "--serial", slave, "--osc-port", oscPort,
+              "--http-port", httpPort, (char*)NULL);
+        fprintf(stderr, "load_generator: %s: %s\n", options.bridge, strerror(errno));
+        _exit(127);
+    }
+    return pid;
+}
+
+void report(const Series& series, double seconds) {
+    std::vector<uint32_t> sorted = series.latencyUs;
+    std::sort(sorted.begin(), sorted.end());
+    auto pct = [&](double p) -> unsigned {
+        if (sorted.empty()) return 0;
+        size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+        return sorted[i];
+    };
+    printf("%-22s %9llu %9zu %9.0f %8u %8u %8u %7llu\n", series.name,
+           (unsigned long long)series.sent, sorted.size(), sorted.size() / seconds,
+           pct(0.50), pct(0.99), sorted.empty() ? 0 : sorted.back(),
+           (unsigned long long)series.errors);
+}
+
+void merge(Series& total, std::vector<Series*>& parts) {
+    for (Series* part : parts) {
+        total.sent += part->sent;
+        total.errors += part->errors;
+        total.latencyUs.insert(total.latencyUs.end(), part->latencyUs.begin(), part->latencyUs.end());
+        delete part;
+    }
+    parts.clear();
+}
+
+void usage() {
+    fprintf(stderr,
+            "usage: load_generator [--bridge ./bridge_host] [--seconds 10] [--osc-rate 2000]\n"
+            "                      [--http-clients 4] [--state-ms 10] [--osc-port 9000] [--http-port 9080]\n");
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) {
+            usage();
+            return 2;
+        }
+        if (strcmp(arg, "--bridge") == 0) options.bridge = value;
+        else if (strcmp(arg, "--seconds") == 0) options.seconds = atof(value);
+        else if (strcmp(arg, "--osc-rate") == 0) options.oscRate = atoi(value);
+        else if (strcmp(arg, "--http-clients") == 0) options.httpClients = atoi(value);
+        else if (strcmp(arg, "--state-ms") == 0) options.stateMs = atoi(value);
+        else if (strcmp(arg, "--osc-port") == 0) options.oscPort = atoi(value);
+        else if (strcmp(arg, "--http-port") == 0) options.httpPort = atoi(value);
+        else {
+            usage();
+            return 2;
+        }
+        i++;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    // The pty standing in for the Teensy UART. The slave is held open here
+    // too, so the master doesn't see a hangup before the bridge opens it.
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0) {
+        perror("load_generator: pty");
+        return 1;
+    }
+    const char* slave = ptsname(master);
+    int slaveFd = open(slave, O_RDWR | O_NOCTTY);
+    termios tio;
+    tcgetattr(slaveFd, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slaveFd, TCSANOW, &tio);
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+    pid_t bridge = startBridge(slave);
+    int probe = -1;
+    for (int tries = 0; tries < 200 && probe < 0; tries++) {
+        usleep(10000);
+        probe = connectHTTP();
+    }
+    if (probe < 0) {
+        fprintf(stderr, "load_generator: bridge didn't start listening\n");
+        kill(bridge, SIGTERM);
+        return 1;
+    }
+    close(probe);
+
+    printf("load_generator: %s on %s for %.0fs: OSC %u/s, %u HTTP clients, state every %ums\n\n",
+           options.bridge, slave, options.seconds, options.oscRate, options.httpClients, options.stateMs);
+
+    std::vector<Series*> statusSeries;
+    std::vector<Series*> controlSeries;
+    std::vector<std::thread> threads;
+    threads.emplace_back(runTeensy, master);
+    usleep(200000);            // Let the link sync before the load starts
+    threads.emplace_back(runOSC);
+    for (unsigned i = 0; i < options.httpClients; i++) {
+        statusSeries.push_back(new Series("http GET /status"));
+        controlSeries.push_back(new Series("http POST /control"));
+        threads.emplace_back(runHTTP, statusSeries.back(), controlSeries.back(), i);
+    }
+
+    uint32_t start = nowUs();
+    long rssEarly = 0, hwmEarly = 0;
+    usleep(1000000);
+    readMemory(bridge, rssEarly, hwmEarly);
+    while (nowUs() - start < options.seconds * 1e6) usleep(10000);
+    double seconds = (nowUs() - start) / 1e6;
+    long rssEnd = 0, hwmEnd = 0;
+    readMemory(bridge, rssEnd, hwmEnd);
+
+    // The bridge's own view, before the load stops
+    char status[512] = "";
+    char loop[4096] = "";
+    int fd = connectHTTP();
+    if (fd >= 0) {
+        httpExchange(fd, "GET /status HTTP/1.1\r\nHost: bridge\r\n\r\n", status, sizeof(status));
+        httpExchange(fd, "GET /loop HTTP/1.1\r\nHost: bridge\r\n\r\n", loop, sizeof(loop));
+        close(fd);
+    }
+
+    stopping = true;
+    for (std::thread& thread : threads) thread.join();
+    kill(bridge, SIGTERM);
+    int exitStatus;
+    waitpid(bridge, &exitStatus, 0);
+    close(slaveFd);
+    close(master);
+
+    // Every client's samples together
+    Series httpStatus("http GET /status");
+    Series httpControl("http POST /control");
+    merge(httpStatus, statusSeries);
+    merge(httpControl, controlSeries);
+
+    printf("%-22s %9s %9s %9s %8s %8s %8s %7s\n", "traffic", "sent", "timed", "timed/s",
+           "p50 us", "p99 us", "max us", "errors");
+    report(httpStatus, seconds);
+    report(httpControl, seconds);
+    report(oscSeries, seconds);
+    report(teensy.osc, seconds);
+    report(teensy.state, seconds);
+    printf("\nOSC values coalesced before the link: %llu of %llu; LinkSetParam frames: %llu\n",
+           (unsigned long long)(oscSeries.sent - teensy.osc.latencyUs.size()),
+           (unsigned long long)oscSeries.sent, (unsigned long long)teensy.paramFrames);
+    printf("Link (Teensy's view): RTT %uus, max %uus, credit stalls %u, resyncs %llu\n",
+           teensy.rttUs, teensy.rttMaxUs, teensy.creditStalls, (unsigned long long)teensy.resyncs);
+    printf("Bridge memory: VmRSS %ld kB after 1s, %ld kB at end; VmHWM %ld kB after 1s, %ld kB at end\n",
+           rssEarly, rssEnd, hwmEarly, hwmEnd);
+    printf("\nBridge /status: %s\nBridge /loop: %s\n", status, loop);
+    return 0;
+}
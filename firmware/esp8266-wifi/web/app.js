@@ -0,0 +1,117 @@
+// State arrives over the WebSocket: everything on connect, then
+// only what changed
+const synth = {};
+let socket = null;
+
+function connect() {
+    socket = new WebSocket('ws://' + location.host + '/ws');
+    socket.onmessage = event => {
+        Object.assign(synth, JSON.parse(event.data));
+        render();
+    };
+    socket.onclose = () => {
+        socket = null;
+        setTimeout(connect, 1000);
+    };
+}
+
+function render() {
+    document.getElementById('controller-status').textContent =
+        synth.connected ? 'Connected' : 'Disconnected';
+
+    const indicator = document.getElementById('connection-indicator');
+    indicator.className = 'connection-status ' +
+        (synth.connected ? 'connected' : 'disconnected');
+
+    document.getElementById('current-scale').textContent =
+        getScaleName(synth.scale);
+    document.getElementById('octave-shift').textContent =
+        (synth.octave > 0 ? '+' : '') + synth.octave;
+    document.getElementById('cpu-usage').textContent =
+        synth.cpu.toFixed(1) + '%';
+    document.getElementById('active-voices').textContent =
+        synth.voices + '/8';
+}
+
+function getScaleName(index) {
+    const scales = [
+        'Pentatonic Minor', 'Natural Minor', 'Dorian',
+        'Hungarian Minor', 'Harmonic Minor', 'Phrygian'
+    ];
+    return scales[index] || 'Unknown';
+}
+
+// Over the socket when it's up, a POST to /control otherwise
+function sendControl(message) {
+    const body = JSON.stringify(message);
+    if (socket && socket.readyState === WebSocket.OPEN) {
+        socket.send(body);
+        return Promise.resolve();
+    }
+    return fetch('/control', {
+        method: 'POST',
+        headers: {'Content-Type': 'application/json'},
+        body: body
+    });
+}
+
+function changeScale(value) {
+    sendControl({command: 'setScale', value: parseInt(value)});
+}
+
+// While a slider is dragged, its latest value goes every 50ms
+const pendingValues = {};
+let sendTimer = null;
+
+function updateValue(param, value) {
+    document.getElementById(param + '-value').textContent =
+        param === 'filter' ? value + ' Hz' : value + '%';
+
+    pendingValues[param] = parseFloat(value);
+    if (!sendTimer) sendTimer = setTimeout(sendValues, 50);
+}
+
+function sendValues() {
+    sendTimer = null;
+    for (const param in pendingValues) {
+        sendControl({command: 'set' + param, value: pendingValues[param]});
+        delete pendingValues[param];
+    }
+}
+
+function resetDefaults() {
+    document.getElementById('reverb-mix').value = 30;
+    document.getElementById('delay-mix').value = 20;
+    document.getElementById('filter-freq').value = 2000;
+    updateValue('reverb', 30);
+    updateValue('delay', 20);
+    updateValue('filter', 2000);
+}
+
+function savePreset() {
+    sendControl({command: 'savePreset'}).then(() => alert('Preset saved!'));
+}
+
+// How long each ESP loop task waits to run (/loop): 99th percentile
+// and worst case since boot
+function formatUs(us) {
+    if (us < 0) return '>65ms';
+    return us >= 1000 ? (us / 1000).toFixed(1) + 'ms' : us + 'us';
+}
+
+function updateLoop() {
+    fetch('/loop')
+        .then(response => response.json())
+        .then(report => {
+            const rows = report.tasks.map(task =>
+                '<div class="status-item"><span>' + task.name + '</span>' +
+                '<span class="status-value">p99 &lt;' + formatUs(task.p99Us) +
+                ', max ' + formatUs(task.maxUs) + '</span></div>');
+            document.getElementById('loop-tasks').innerHTML = rows.join('');
+        })
+        .catch(() => {});
+}
+
+connect();
+updateLoop();
+setInterval(updateLoop, 2000);
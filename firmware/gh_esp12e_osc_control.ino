@@ -1,10 +1,11 @@
 /*
  * ESP-12E WiFi Control + OSC for Guitar Hero Synth
- * Real-time web interface + OSC broadcasting
+ * Real-time web interface + OSC to subscribed clients
  *
  * Features:
  * - Web interface with live visualization
- * - OSC output (UDP port 8000)
+ * - OSC output (UDP port 8000), unicast to each client that subscribes
+ *   or sends us OSC (osc_subscribers.h)
  * - Real-time note display
  * - CPU/Memory monitoring
  * - Configuration persistence
@@ -16,6 +17,18 @@
 #include <ESP8266mDNS.h>
 #include <WiFiUdp.h>
 #include <EEPROM.h>
+#include "teensy-main/include/link_protocol.h"
+#include "teensy-main/include/link_state.h"
+#include "teensy-main/include/control_parser.h"
+#include "teensy-main/include/osc_bundle.h"
+#include "teensy-main/include/osc_dispatch.h"
+#include "teensy-main/include/osc_subscribers.h"
+#include "teensy-main/include/param_coalescer.h"
+#include "teensy-main/include/status_cache.h"
+#include "teensy-main/include/loop_scheduler.h"
+#include "teensy-main/include/web_asset.h"
+#include "osc_control_web.h"   // Generated from web/osc_control by esp8266-wifi/scripts/pre_build.py
+#include <sys/time.h>
 
 // ===== CONFIGURATION =====
 const char* AP_SSID = "GuitarHero-Synth";
@@ -25,9 +38,13 @@ const char* MDNS_NAME = "gh-synth";
 // OSC Configuration
 #define OSC_ENABLED true
 #define OSC_PORT 8000
+#define OSC_MAX_PACKET 512
 WiFiUDP udp;
-IPAddress oscTargetIP(255, 255, 255, 255);  // Broadcast
-uint16_t oscTargetPort = OSC_PORT;
+OscSubscribers oscSubscribers;           // Who gets what, instead of broadcast
+OscBundle oscTopics[OSC_NUM_TOPICS];     // This update's messages, by topic
+OscBundle oscBundle;                     // One subscriber's share: one datagram each (osc_bundle.h)
+uint64_t oscUpdateTime;
+uint8_t oscPacket[OSC_MAX_PACKET];       // Incoming datagram
 
 // Web Server
 ESP8266WebServer server(80);
@@ -66,488 +83,278 @@ struct SynthState {
   unsigned long lastUpdate;
 } synthState;
 
-// ===== OSC FUNCTIONS =====
-
-void sendOSC(const char* address, const char* types, ...) {
-  if (!OSC_ENABLED) return;
+// /api/status text, reformatted when synthState changes (status_cache.h).
+// The OSC client count moves on its own, so it's refreshed every second.
+size_t formatStatus(char* out, size_t max, void* context);
+StatusCache statusCache(formatStatus, NULL, 1000);
+
+// loop() work as prioritised tasks (loop_scheduler.h): Teensy data runs
+// between every other task, so a slow HTTP client holds it up for one
+// handleClient() at most
+uint32_t loopClock() { return micros(); }
+LoopScheduler scheduler(loopClock);
+char loopReport[LOOP_REPORT_MAX_TEXT];
+
+// Framed messages from the Teensy (link_protocol.h) and our mirror of
+// its shared state (link_state.h)
+LinkDecoder teensyLink;
+LinkStateReceiver teensyState;
+unsigned long lastResyncRequest = 0;
+
+// /synth/<param> values from control surfaces: only the newest of each
+// goes to the Teensy, at most every PARAM_COALESCE_INTERVAL_MS
+// (param_coalescer.h), through a queue of its own
+ParamCoalescer params;
+LinkTxQueue paramTx;
+
+const char* const noteNames[12] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+
+// Same order as the standalone synth's scale table
+const char* const scaleNames[] = {
+  "Major Pentatonic", "Minor Pentatonic", "Blues", "Japanese (In Sen)",
+  "Egyptian", "Dorian Pentatonic", "Lydian Pentatonic"
+};
+const uint8_t NUM_SCALE_NAMES = sizeof(scaleNames) / sizeof(scaleNames[0]);
 
-  // Simple OSC message format
-  // Format: /address\0,types\0data...
-  uint8_t buffer[256];
-  int pos = 0;
+// ===== OSC FUNCTIONS =====
 
-  // Address
-  int addrLen = strlen(address) + 1;
-  memcpy(buffer + pos, address, addrLen);
-  pos += addrLen;
+// Timetag for now: NTP once the clock has been set (SNTP in station
+// mode), "immediately" until then
+uint64_t oscNow() {
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  if (now.tv_sec < 1600000000) return OSC_IMMEDIATE;
+  return oscTimetag(now.tv_sec, now.tv_usec);
+}
 
-  // Align to 4 bytes
-  while (pos % 4 != 0) buffer[pos++] = 0;
+// Start collecting an update's messages
+void beginOSC() {
+  oscUpdateTime = oscNow();
+  for (uint8_t t = 0; t < OSC_NUM_TOPICS; t++) oscTopics[t].begin(oscUpdateTime);
+}
 
-  // Type tag
-  buffer[pos++] = ',';
-  int typesLen = strlen(types);
-  memcpy(buffer + pos, types, typesLen);
-  pos += typesLen;
-  buffer[pos++] = 0;
+// Unicast each subscriber the topics it wants from what's been collected,
+// one bundle per subscriber, then start over
+void sendOSCBundle() {
+  uint8_t available = 0;
+  for (uint8_t t = 0; t < OSC_NUM_TOPICS; t++) {
+    if (!oscTopics[t].empty()) available |= 1 << t;
+  }
+  if (!OSC_ENABLED || !available) return;
+
+  uint32_t now = millis();
+  oscSubscribers.expire(now);
+  for (uint8_t i = 0; i < oscSubscribers.getCount(); i++) {
+    uint8_t topics = oscSubscribers.topicsFor(i, available, now);
+    if (!topics) continue;
+    const OscSubscriber& subscriber = oscSubscribers.get(i);
+
+    oscBundle.begin(oscUpdateTime);
+    for (uint8_t t = 0; t < OSC_NUM_TOPICS; t++) {
+      if (!(topics & (1 << t))) continue;
+      if (!oscBundle.append(oscTopics[t])) {
+        // Too much for one datagram: send what fits, then the rest
+        udp.beginPacket(IPAddress(subscriber.ip), subscriber.port);
+        udp.write(oscBundle.data(), oscBundle.size());
+        udp.endPacket();
+        oscBundle.sent();
+        oscBundle.begin(oscUpdateTime);
+        oscBundle.append(oscTopics[t]);
+      }
+    }
+    udp.beginPacket(IPAddress(subscriber.ip), subscriber.port);
+    udp.write(oscBundle.data(), oscBundle.size());
+    udp.endPacket();
+    oscBundle.sent();
+    oscSubscribers.sent(i);
+  }
 
-  // Align to 4 bytes
-  while (pos % 4 != 0) buffer[pos++] = 0;
+  for (uint8_t t = 0; t < OSC_NUM_TOPICS; t++) oscTopics[t].begin(oscUpdateTime);
+}
 
-  // Arguments
+// Add a message to the update, sending what's collected first if its
+// topic is full
+void addOSC(uint8_t topic, const char* address, const char* types, ...) {
+  OscBundle& bundle = oscTopics[topic];
   va_list args;
   va_start(args, types);
-
-  for (int i = 0; i < typesLen; i++) {
-    switch (types[i]) {
-      case 'i':  // int32
-        {
-          int32_t val = va_arg(args, int32_t);
-          buffer[pos++] = (val >> 24) & 0xFF;
-          buffer[pos++] = (val >> 16) & 0xFF;
-          buffer[pos++] = (val >> 8) & 0xFF;
-          buffer[pos++] = val & 0xFF;
-        }
-        break;
-
-      case 'f':  // float32
-        {
-          union {
-            float f;
-            uint32_t i;
-          } u;
-          u.f = (float)va_arg(args, double);
-          buffer[pos++] = (u.i >> 24) & 0xFF;
-          buffer[pos++] = (u.i >> 16) & 0xFF;
-          buffer[pos++] = (u.i >> 8) & 0xFF;
-          buffer[pos++] = u.i & 0xFF;
-        }
-        break;
-
-      case 's':  // string
-        {
-          const char* str = va_arg(args, const char*);
-          int strLen = strlen(str) + 1;
-          memcpy(buffer + pos, str, strLen);
-          pos += strLen;
-          while (pos % 4 != 0) buffer[pos++] = 0;
-        }
-        break;
-    }
+  if (!bundle.addV(address, types, args)) {
+    sendOSCBundle();
+    va_end(args);
+    va_start(args, types);
+    bundle.addV(address, types, args);
   }
-
   va_end(args);
-
-  // Send UDP packet
-  udp.beginPacket(oscTargetIP, oscTargetPort);
-  udp.write(buffer, pos);
-  udp.endPacket();
 }
 
 // ===== TEENSY COMMUNICATION =====
 
-void processTeensyData() {
-  if (!Serial.available()) return;
-
-  String data = Serial.readStringUntil('\n');
-  data.trim();
-
-  if (data.length() == 0) return;
-
-  // Parse JSON from Teensy
-  if (data.startsWith("{\"type\":\"config\"")) {
-    // Config update
-    int scalePos = data.indexOf("\"scale\":");
-    if (scalePos >= 0) {
-      synthState.currentScale = data.substring(scalePos + 8).toInt();
-    }
-
-    int scaleNamePos = data.indexOf("\"scaleName\":\"");
-    if (scaleNamePos >= 0) {
-      int endPos = data.indexOf("\"", scaleNamePos + 13);
-      String name = data.substring(scaleNamePos + 13, endPos);
-      strncpy(synthState.scaleName, name.c_str(), 31);
-    }
-
-    int rootPos = data.indexOf("\"root\":");
-    if (rootPos >= 0) {
-      synthState.currentRoot = data.substring(rootPos + 7).toInt();
-    }
-
-    int rootNamePos = data.indexOf("\"rootName\":\"");
-    if (rootNamePos >= 0) {
-      int endPos = data.indexOf("\"", rootNamePos + 12);
-      String name = data.substring(rootNamePos + 12, endPos);
-      strncpy(synthState.rootName, name.c_str(), 7);
-    }
-
-    int octavePos = data.indexOf("\"octave\":");
-    if (octavePos >= 0) {
-      synthState.octave = data.substring(octavePos + 9).toInt();
-    }
-
-    synthState.arpActive = data.indexOf("\"arp\":true") >= 0;
-
-    // Send OSC
-    sendOSC("/synth/scale", "is", synthState.currentScale, synthState.scaleName);
-    sendOSC("/synth/root", "is", synthState.currentRoot, synthState.rootName);
-    sendOSC("/synth/octave", "i", synthState.octave);
-    sendOSC("/synth/arp", "i", synthState.arpActive ? 1 : 0);
+template <typename T>
+void sendTeensy(const T& message) {
+  uint8_t frame[LINK_MAX_FRAME];
+  Serial.write(frame, linkEncode(message, frame));
+}
 
+void processTeensyData() {
+  while (Serial.available()) {
+    if (!teensyLink.push(Serial.read())) continue;
+
+    // Everything this frame produces goes out as one OSC bundle per
+    // subscriber
+    beginOSC();
+
+    if (teensyLink.type() == LINK_MSG_STATE) {
+      if (!teensyState.apply(teensyLink.payload(), teensyLink.payloadLength())) {
+        teensyState.reset();  // Resync requested from loop()
+        continue;
+      }
+      LinkStateAck ack = {teensyState.getGeneration()};
+      sendTeensy(ack);
+
+      // Copy the state and send OSC only for what changed
+      const LinkState& s = teensyState.state();
+      uint16_t changed = teensyState.getChangedMask();
+      synthState.currentScale = s.scale;
+      strcpy(synthState.scaleName, s.scale < NUM_SCALE_NAMES ? scaleNames[s.scale] : "Custom");
+      synthState.currentRoot = s.root % 12;
+      strcpy(synthState.rootName, noteNames[synthState.currentRoot]);
+      synthState.octave = s.octave;
+      synthState.arpActive = s.arp;
+      synthState.cpuUsage = s.cpuTenths / 10.0f;
+      synthState.memUsage = s.memBlocks;
+      synthState.totalNotes = s.totalNotes;
+      synthState.latency = s.loopMaxUs;
+
+      if (changed & (1 << LINK_FIELD_SCALE)) addOSC(OSC_TOPIC_STATE, "/synth/scale", "is", synthState.currentScale, synthState.scaleName);
+      if (changed & (1 << LINK_FIELD_ROOT)) addOSC(OSC_TOPIC_STATE, "/synth/root", "is", synthState.currentRoot, synthState.rootName);
+      if (changed & (1 << LINK_FIELD_OCTAVE)) addOSC(OSC_TOPIC_STATE, "/synth/octave", "i", synthState.octave);
+      if (changed & (1 << LINK_FIELD_ARP)) addOSC(OSC_TOPIC_STATE, "/synth/arp", "i", synthState.arpActive ? 1 : 0);
+
+      // Stats go all together, so a client whose rate limit skipped some
+      // still gets every current value next time
+      const uint16_t stats = (1 << LINK_FIELD_CPU) | (1 << LINK_FIELD_MEM) | (1 << LINK_FIELD_LOOP_MAX);
+      if (changed & stats) {
+        addOSC(OSC_TOPIC_STATS, "/synth/cpu", "f", synthState.cpuUsage);
+        addOSC(OSC_TOPIC_STATS, "/synth/memory", "i", synthState.memUsage);
+        addOSC(OSC_TOPIC_STATS, "/synth/latency", "i", synthState.latency);
+      }
+    }
+    else if (teensyLink.type() == LINK_MSG_NOTES) {
+      // Up to a 10ms window of note on/offs
+      LinkNoteEvent events[LINK_NOTES_PER_BATCH];
+      uint8_t count = linkNotesDecode(teensyLink.payload(), teensyLink.payloadLength(), events);
+      for (uint8_t i = 0; i < count; i++) {
+        synthState.lastNote = events[i].note;
+        synthState.noteOn = events[i].velocity > 0;
+        addOSC(OSC_TOPIC_NOTES, synthState.noteOn ? "/synth/noteon" : "/synth/noteoff", "i", synthState.lastNote);
+      }
+    }
+    else {
+      continue;
+    }
+
+    sendOSCBundle();
     synthState.lastUpdate = millis();
+    statusCache.invalidate();
   }
-  else if (data.startsWith("{\"type\":\"note\"")) {
-    // Note on/off
-    int notePos = data.indexOf("\"note\":");
-    if (notePos >= 0) {
-      synthState.lastNote = data.substring(notePos + 7).toInt();
-    }
 
-    synthState.noteOn = data.indexOf("\"on\":true") >= 0;
+  // Nothing mirrored yet (boot, Teensy reset, lost delta): ask for everything
+  if (!teensyState.isValid() && millis() - lastResyncRequest >= 500) {
+    lastResyncRequest = millis();
+    LinkCommand command = {LINK_CMD_RESYNC};
+    sendTeensy(command);
+  }
+}
 
-    // Send OSC
-    if (synthState.noteOn) {
-      sendOSC("/synth/noteon", "i", synthState.lastNote);
-    } else {
-      sendOSC("/synth/noteoff", "i", synthState.lastNote);
-    }
+// Send the coalesced parameters that are due. Each frame is written
+// whole, like sendTeensy(), so nothing interleaves with it on the wire.
+void flushParams() {
+  if (!params.flush(millis(), paramTx)) return;
+  uint8_t chunk[LINK_MAX_FRAME];
+  size_t len;
+  while ((len = paramTx.pull(chunk, sizeof(chunk))) > 0) Serial.write(chunk, len);
+}
 
-    synthState.lastUpdate = millis();
-  }
-  else if (data.startsWith("{\"type\":\"status\"")) {
-    // Status update
-    int cpuPos = data.indexOf("\"cpu\":");
-    if (cpuPos >= 0) {
-      synthState.cpuUsage = data.substring(cpuPos + 6).toFloat();
-    }
+// ===== OSC INPUT =====
 
-    int memPos = data.indexOf("\"mem\":");
-    if (memPos >= 0) {
-      synthState.memUsage = data.substring(memPos + 6).toInt();
-    }
+// Inbound OSC: subscriptions, plus /synth/<param> from control surfaces
+// (whose senders are subscribed automatically)
+struct OscSender {
+  uint32_t ip;
+};
 
-    int notesPos = data.indexOf("\"notes\":");
-    if (notesPos >= 0) {
-      synthState.totalNotes = data.substring(notesPos + 8).toInt();
-    }
+void handleOSCMessage(const OscMessageView& message, void* context) {
+  const OscSender* sender = (const OscSender*)context;
+  if (oscSubscribers.handle(message, sender->ip, millis())) return;
 
-    int latencyPos = data.indexOf("\"latency\":");
-    if (latencyPos >= 0) {
-      synthState.latency = data.substring(latencyPos + 10).toInt();
-    }
+  LinkSetParam param;
+  if (oscToLinkParam(message, param)) params.set(param.param, param.value);
+}
 
-    // Send OSC
-    sendOSC("/synth/cpu", "f", synthState.cpuUsage);
-    sendOSC("/synth/memory", "i", synthState.memUsage);
-    sendOSC("/synth/latency", "i", synthState.latency);
+void processOSCInput() {
+  int size = udp.parsePacket();
+  if (size <= 0 || size > OSC_MAX_PACKET) return;
 
-    synthState.lastUpdate = millis();
-  }
+  OscSender sender = {(uint32_t)udp.remoteIP()};
+  int len = udp.read(oscPacket, sizeof(oscPacket));
+  if (len > 0) oscForEachMessage(oscPacket, len, handleOSCMessage, &sender);
 }
 
 // ===== WEB SERVER =====
 
-String getWebPage() {
-  return R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-  <meta charset="UTF-8">
-  <meta name="viewport" content="width=device-width, initial-scale=1.0">
-  <title>Guitar Hero Synth Control</title>
-  <style>
-    * { margin: 0; padding: 0; box-sizing: border-box; }
-    body {
-      font-family: 'Segoe UI', Tahoma, Geneva, Verdana, sans-serif;
-      background: linear-gradient(135deg, #1e3c72 0%, #2a5298 100%);
-      color: white;
-      padding: 20px;
-      min-height: 100vh;
-    }
-    .container {
-      max-width: 1200px;
-      margin: 0 auto;
-    }
-    .header {
-      text-align: center;
-      margin-bottom: 30px;
-    }
-    .header h1 {
-      font-size: 36px;
-      margin-bottom: 10px;
-      text-shadow: 2px 2px 4px rgba(0,0,0,0.5);
-    }
-    .grid {
-      display: grid;
-      grid-template-columns: repeat(auto-fit, minmax(300px, 1fr));
-      gap: 20px;
-    }
-    .card {
-      background: rgba(255, 255, 255, 0.1);
-      backdrop-filter: blur(10px);
-      border-radius: 15px;
-      padding: 20px;
-      box-shadow: 0 8px 32px rgba(0,0,0,0.3);
-    }
-    .card h2 {
-      font-size: 20px;
-      margin-bottom: 15px;
-      border-bottom: 2px solid rgba(255,255,255,0.3);
-      padding-bottom: 10px;
-    }
-    .note-display {
-      text-align: center;
-      font-size: 72px;
-      font-weight: bold;
-      padding: 30px;
-      background: rgba(0,0,0,0.3);
-      border-radius: 10px;
-      min-height: 150px;
-      display: flex;
-      align-items: center;
-      justify-content: center;
-    }
-    .note-on {
-      animation: pulse 0.5s infinite;
-      color: #4ade80;
-    }
-    @keyframes pulse {
-      0%, 100% { transform: scale(1); }
-      50% { transform: scale(1.1); }
-    }
-    .info-row {
-      display: flex;
-      justify-content: space-between;
-      padding: 10px 0;
-      border-bottom: 1px solid rgba(255,255,255,0.1);
-    }
-    .info-label {
-      opacity: 0.7;
-    }
-    .info-value {
-      font-weight: bold;
-    }
-    .btn {
-      background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-      border: none;
-      color: white;
-      padding: 12px 24px;
-      border-radius: 8px;
-      cursor: pointer;
-      font-size: 16px;
-      margin: 5px;
-      transition: transform 0.2s;
-    }
-    .btn:hover {
-      transform: translateY(-2px);
-    }
-    .btn:active {
-      transform: translateY(0);
-    }
-    .controls {
-      display: grid;
-      grid-template-columns: 1fr 1fr;
-      gap: 10px;
-    }
-    .meter {
-      background: rgba(0,0,0,0.3);
-      border-radius: 10px;
-      height: 30px;
-      position: relative;
-      overflow: hidden;
-    }
-    .meter-fill {
-      height: 100%;
-      background: linear-gradient(90deg, #4ade80 0%, #22c55e 100%);
-      transition: width 0.3s;
-      display: flex;
-      align-items: center;
-      justify-content: center;
-      font-weight: bold;
-    }
-    .status-indicator {
-      width: 12px;
-      height: 12px;
-      border-radius: 50%;
-      display: inline-block;
-      margin-right: 8px;
-    }
-    .status-online {
-      background: #4ade80;
-      box-shadow: 0 0 10px #4ade80;
-    }
-    .status-offline {
-      background: #ef4444;
-    }
-  </style>
-</head>
-<body>
-  <div class="container">
-    <div class="header">
-      <h1>🎸 Guitar Hero Synth Control</h1>
-      <p>
-        <span class="status-indicator" id="status"></span>
-        <span id="statusText">Connecting...</span>
-      </p>
-    </div>
-
-    <div class="grid">
-      <!-- Note Display -->
-      <div class="card">
-        <h2>🎵 Current Note</h2>
-        <div class="note-display" id="noteDisplay">---</div>
-      </div>
-
-      <!-- Performance -->
-      <div class="card">
-        <h2>⚡ Performance</h2>
-        <div class="info-row">
-          <span class="info-label">CPU Usage:</span>
-          <span class="info-value" id="cpu">0%</span>
-        </div>
-        <div class="meter">
-          <div class="meter-fill" id="cpuMeter" style="width: 0%">
-            <span id="cpuText">0%</span>
-          </div>
-        </div>
-        <div class="info-row">
-          <span class="info-label">Memory:</span>
-          <span class="info-value" id="mem">0 blocks</span>
-        </div>
-        <div class="info-row">
-          <span class="info-label">Latency:</span>
-          <span class="info-value" id="latency">0 μs</span>
-        </div>
-        <div class="info-row">
-          <span class="info-label">Total Notes:</span>
-          <span class="info-value" id="notes">0</span>
-        </div>
-      </div>
-
-      <!-- Configuration -->
-      <div class="card">
-        <h2>🎹 Configuration</h2>
-        <div class="info-row">
-          <span class="info-label">Scale:</span>
-          <span class="info-value" id="scale">---</span>
-        </div>
-        <div class="info-row">
-          <span class="info-label">Root Note:</span>
-          <span class="info-value" id="root">---</span>
-        </div>
-        <div class="info-row">
-          <span class="info-label">Octave:</span>
-          <span class="info-value" id="octave">0</span>
-        </div>
-        <div class="info-row">
-          <span class="info-label">Arpeggiator:</span>
-          <span class="info-value" id="arp">OFF</span>
-        </div>
-      </div>
-
-      <!-- Quick Controls -->
-      <div class="card">
-        <h2>🎛️ Quick Controls</h2>
-        <div class="controls">
-          <button class="btn" onclick="sendCmd('scale', 0)">Major Pent</button>
-          <button class="btn" onclick="sendCmd('scale', 1)">Minor Pent</button>
-          <button class="btn" onclick="sendCmd('scale', 2)">Blues</button>
-          <button class="btn" onclick="sendCmd('scale', 3)">Japanese</button>
-          <button class="btn" onclick="sendCmd('octave', 1)">Octave +</button>
-          <button class="btn" onclick="sendCmd('octave', -1)">Octave -</button>
-          <button class="btn" onclick="toggleArp()">Toggle Arp</button>
-          <button class="btn" onclick="location.reload()">Refresh</button>
-        </div>
-      </div>
-    </div>
-  </div>
-
-  <script>
-    let lastUpdate = 0;
-
-    function updateStatus() {
-      fetch('/api/status')
-        .then(r => r.json())
-        .then(data => {
-          document.getElementById('status').className = 'status-indicator status-online';
-          document.getElementById('statusText').textContent = 'Connected';
-
-          if (data.noteOn) {
-            document.getElementById('noteDisplay').textContent = data.noteName || data.lastNote;
-            document.getElementById('noteDisplay').className = 'note-display note-on';
-          } else {
-            document.getElementById('noteDisplay').textContent = '---';
-            document.getElementById('noteDisplay').className = 'note-display';
-          }
-
-          document.getElementById('cpu').textContent = data.cpu.toFixed(1) + '%';
-          document.getElementById('cpuMeter').style.width = data.cpu + '%';
-          document.getElementById('cpuText').textContent = data.cpu.toFixed(1) + '%';
-
-          document.getElementById('mem').textContent = data.mem + ' blocks';
-          document.getElementById('latency').textContent = data.latency + ' μs';
-          document.getElementById('notes').textContent = data.notes;
-
-          document.getElementById('scale').textContent = data.scale;
-          document.getElementById('root').textContent = data.root;
-          document.getElementById('octave').textContent = data.octave;
-          document.getElementById('arp').textContent = data.arp ? 'ON' : 'OFF';
-
-          lastUpdate = Date.now();
-        })
-        .catch(err => {
-          if (Date.now() - lastUpdate > 3000) {
-            document.getElementById('status').className = 'status-indicator status-offline';
-            document.getElementById('statusText').textContent = 'Disconnected';
-          }
-        });
-    }
-
-    function sendCmd(cmd, value) {
-      fetch('/api/cmd', {
-        method: 'POST',
-        headers: {'Content-Type': 'application/json'},
-        body: JSON.stringify({cmd: cmd, value: value})
-      });
-    }
+// UI files, gzipped in flash and sent from there in chunks. A browser
+// holding the current version gets a bodiless 304 (web_asset.h).
+void handleWebAsset() {
+  const WebAsset* asset = webAssetFind(webAssets, webAssetCount, server.uri().c_str());
+  if (!asset) {
+    server.send(404, "text/plain", "Not Found");
+    return;
+  }
 
-    function toggleArp() {
-      fetch('/api/cmd', {
-        method: 'POST',
-        headers: {'Content-Type': 'application/json'},
-        body: JSON.stringify({cmd: 'arp'})
-      });
-    }
+  server.sendHeader("ETag", asset->etag);
+  server.sendHeader("Cache-Control", webAssetCacheControl(*asset));
+  if (webEtagMatches(server.header("If-None-Match").c_str(), asset->etag)) {
+    server.send(304);
+    return;
+  }
+  server.sendHeader("Content-Encoding", "gzip");
+  server.send_P(200, asset->type, (PGM_P)asset->data, asset->length);
+}
 
-    // Update every 100ms
-    setInterval(updateStatus, 100);
-    updateStatus();
-  </script>
-</body>
-</html>
-)rawliteral";
+void handleStatus() {
+  // send_P copies with memcpy_P, which reads RAM as well as flash
+  size_t len;
+  const char* text = statusCache.get(millis(), len);
+  server.send_P(200, "application/json", text, len);
 }
 
-void handleRoot() {
-  server.send(200, "text/html", getWebPage());
+size_t formatStatus(char* out, size_t max, void* context) {
+  size_t len = 0;
+  unsigned cpuTenths = (unsigned)(synthState.cpuUsage * 10.0f + 0.5f);
+  bool ok = jsonAppend(out, max, len,
+    "{\"noteOn\":%s,\"lastNote\":%u,\"noteName\":",
+    synthState.noteOn ? "true" : "false", synthState.lastNote);
+  ok = ok && jsonAppendString(out, max, len, synthState.rootName);
+  ok = ok && jsonAppend(out, max, len,
+    ",\"cpu\":%u.%u,\"mem\":%u,\"latency\":%lu,\"notes\":%lu,\"scale\":",
+    cpuTenths / 10, cpuTenths % 10, synthState.memUsage,
+    (unsigned long)synthState.latency, (unsigned long)synthState.totalNotes);
+  ok = ok && jsonAppendString(out, max, len, synthState.scaleName);
+  ok = ok && jsonAppend(out, max, len, ",\"root\":");
+  ok = ok && jsonAppendString(out, max, len, synthState.rootName);
+  ok = ok && jsonAppend(out, max, len, ",\"octave\":%d,\"arp\":%s,\"oscClients\":%u}",
+    synthState.octave, synthState.arpActive ? "true" : "false", oscSubscribers.getCount());
+  return ok ? len : 0;
 }
 
-void handleStatus() {
-  String json = "{";
-  json += "\"noteOn\":" + String(synthState.noteOn ? "true" : "false") + ",";
-  json += "\"lastNote\":" + String(synthState.lastNote) + ",";
-  json += "\"noteName\":\"" + String(synthState.rootName) + "\",";
-  json += "\"cpu\":" + String(synthState.cpuUsage, 1) + ",";
-  json += "\"mem\":" + String(synthState.memUsage) + ",";
-  json += "\"latency\":" + String(synthState.latency) + ",";
-  json += "\"notes\":" + String(synthState.totalNotes) + ",";
-  json += "\"scale\":\"" + String(synthState.scaleName) + "\",";
-  json += "\"root\":\"" + String(synthState.rootName) + "\",";
-  json += "\"octave\":" + String(synthState.octave) + ",";
-  json += "\"arp\":" + String(synthState.arpActive ? "true" : "false");
-  json += "}";
-
-  server.send(200, "application/json", json);
+void handleLoop() {
+  // Loop task latency histograms, for the UI
+  size_t len = scheduler.report(loopReport, sizeof(loopReport));
+  if (!len) {
+    server.send(500, "application/json", "{\"error\":\"Report too long\"}");
+    return;
+  }
+  server.send_P(200, "application/json", loopReport, len);
 }
 
 void handleCommand() {
@@ -556,16 +363,52 @@ void handleCommand() {
     return;
   }
 
-  String body = server.arg("plain");
+  // {"cmd":"scale","value":2} or {"cmd":"arp"}, read without String copies
+  const String& body = server.arg("plain");
+  ControlParser parser;
+  if (!parser.push(body.c_str(), body.length())) {
+    server.send(400, "text/plain", "Bad JSON");
+    return;
+  }
+  const ControlMessage& control = parser.message();
+  if (control.command[0] == 0) {
+    server.send(400, "text/plain", "No cmd");
+    return;
+  }
 
   // Forward command to Teensy
-  Serial.println(body);
+  if (strcmp(control.command, "arp") == 0) {
+    LinkCommand command = {LINK_CMD_TOGGLE_ARP};
+    sendTeensy(command);
+  } else {
+    LinkSetParam param = {0, control.value};
+    if (strcmp(control.command, "scale") == 0) param.param = LINK_PARAM_SCALE;
+    else if (strcmp(control.command, "root") == 0) param.param = LINK_PARAM_ROOT;
+    else if (strcmp(control.command, "octave") == 0) param.param = LINK_PARAM_OCTAVE;
+    else {
+      server.send(400, "text/plain", "Unknown cmd");
+      return;
+    }
+    if (!control.hasValue) {
+      server.send(400, "text/plain", "No value");
+      return;
+    }
+    sendTeensy(param);
+  }
 
   server.send(200, "application/json", "{\"status\":\"ok\"}");
 }
 
 // ===== MAIN =====
 
+void taskHTTP() {
+  server.handleClient();
+}
+
+void taskMDNS() {
+  MDNS.update();
+}
+
 void setup() {
   Serial.begin(115200);
   delay(100);
@@ -593,21 +436,31 @@ void setup() {
   Serial.println(OSC_PORT);
 
   // Setup web server
-  server.on("/", handleRoot);
+  static const char* webHeaders[] = {"If-None-Match"};
+  server.collectHeaders(webHeaders, 1);
+  server.on("/", handleWebAsset);
+  for (size_t i = 0; i < webAssetCount; i++) {
+    server.on(webAssets[i].path, handleWebAsset);
+  }
   server.on("/api/status", handleStatus);
   server.on("/api/cmd", HTTP_POST, handleCommand);
+  server.on("/api/loop", handleLoop);
   server.begin();
 
+  // Loop tasks: budgets are the run time each should stay within
+  scheduler.add("teensy", processTeensyData, LOOP_PRIORITY_CRITICAL, 500);
+  scheduler.add("osc", processOSCInput, LOOP_PRIORITY_HIGH, 500);
+  scheduler.add("params", flushParams, LOOP_PRIORITY_HIGH, 500);
+  scheduler.add("http", taskHTTP, LOOP_PRIORITY_NORMAL, 1000);
+  scheduler.add("mdns", taskMDNS, LOOP_PRIORITY_LOW, 500, 10000);
+
   Serial.println("Web server started");
   Serial.println("Ready!");
 }
 
 void loop() {
-  server.handleClient();
-  MDNS.update();
-
-  // Process data from Teensy
-  processTeensyData();
+  scheduler.runPass();
 
-  delay(1);
+  // Let the Wi-Fi stack run
+  yield();
 }
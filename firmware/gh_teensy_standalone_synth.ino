@@ -26,6 +26,10 @@
 #include <Arduino.h>
 #include <USBHost_t36.h>
 #include <Audio.h>
+#include "teensy-main/include/analog_conditioner.h"
+#include "teensy-main/include/audio_pitch_bus.h"
+#include "teensy-main/include/link_protocol.h"
+#include "teensy-main/include/link_state.h"
 
 // ===== CONFIGURATION =====
 #define USE_AUDIO_SHIELD  true   // Set false if using external DAC
@@ -36,6 +40,13 @@
 #define ESP_SERIAL        Serial1
 #define ESP_BAUD          115200
 
+// Analog conditioning (10-bit joystick axes)
+#define WHAMMY_DEADZONE   16     // Raw counts around rest that read as zero
+#define WHAMMY_SPAN       511    // Rest to full travel
+#define ANALOG_SMOOTHING_SHIFT 2 // One-pole coefficient 1/4 per audio block
+#define WHAMMY_HYSTERESIS 4      // Raw movement worth an update
+#define AUDIO_BLOCK_US    (AUDIO_BLOCK_SAMPLES * 1000000UL / 44100)
+
 // ===== USB HOST SETUP =====
 USBHost myusb;
 USBHub hub1(myusb);
@@ -52,6 +63,14 @@ const char * driver_names[CNT_DEVICES] = {"Hub1", "Hub2", "HID1", "HID2", "HID3"
 bool driver_active[CNT_DEVICES] = {false};
 
 // ===== AUDIO SYNTHESIS SETUP =====
+// Per-oscillator pitch buses: detune, whammy bend and portamento, rendered
+// per sample (declared first so they update ahead of the oscillators)
+AudioPitchBus bus1;
+AudioPitchBus bus2;
+AudioPitchBus bus3;
+AudioPitchBus bus4;
+AudioPitchBus bus5;
+
 // SuperSaw oscillators (5 detuned sawtooth waves)
 AudioSynthWaveformModulated osc1;
 AudioSynthWaveformModulated osc2;
@@ -104,6 +123,12 @@ AudioConnection patchCord16(delay1, 0, i2s1, 0);      // Left
 AudioConnection patchCord17(delay1, 0, i2s1, 1);      // Right
 AudioConnection patchCord18(delay1, 0, dac1, 0);      // Analog out
 
+AudioConnection patchCord19(bus1, 0, osc1, 0);        // Frequency modulation
+AudioConnection patchCord20(bus2, 0, osc2, 0);
+AudioConnection patchCord21(bus3, 0, osc3, 0);
+AudioConnection patchCord22(bus4, 0, osc4, 0);
+AudioConnection patchCord23(bus5, 0, osc5, 0);
+
 AudioControlSGTL5000 audioShield;
 
 // ===== SCALE DEFINITIONS =====
@@ -172,14 +197,13 @@ bool arpDirection = true;
 uint16_t arpSpeed = 125;  // milliseconds
 elapsedMillis arpTimer;
 
-// Portamento
-float currentFrequency = 440.0f;
-float targetFrequency = 440.0f;
-float portamentoSpeed = 0.08f;
+// Portamento - the pitch buses slide from the last note to the new one
+float noteFrequency = 440.0f;
+float portamentoMs = 50.0f;
 bool noteActive = false;
 
-// Whammy bar
-uint16_t lastWhammyValue = 512;   // 10-bit center
+// Whammy bar - calibrated at connect, updated at most once per audio block
+AnalogConditioner whammy;
 float filterFreq = 2000.0f;
 float pitchBendCents = 0.0f;
 
@@ -190,6 +214,10 @@ elapsedMillis espTimer;
 uint32_t maxLoopTime = 0;
 uint32_t totalNotes = 0;
 
+// Shared state and note events for the ESP (link_state.h)
+LinkStateSender espState;
+LinkNoteBatcher espNotes;
+
 // USB state
 bool lastJoystickAvailable = false;
 uint32_t lastButtons = 0;
@@ -264,6 +292,14 @@ void initAudio() {
   osc4.amplitude(0.20);
   osc5.amplitude(0.18);
 
+  for (auto* osc : {&osc1, &osc2, &osc3, &osc4, &osc5}) {
+    osc->frequencyModulation(PITCH_BUS_OCTAVES);
+  }
+  bus1.setDetune(PITCH_CENTS(-10));
+  bus2.setDetune(PITCH_CENTS(-5));
+  bus4.setDetune(PITCH_CENTS(5));
+  bus5.setDetune(PITCH_CENTS(10));
+
   // Configure envelopes (guitar-like attack)
   for (auto* env : {&env1, &env2, &env3, &env4, &env5}) {
     env->attack(3);      // Fast attack (3ms)
@@ -298,33 +334,43 @@ void initAudio() {
 }
 
 void updateOscillatorFrequencies(float baseFreq) {
-  // Apply pitch bend
-  float bendRatio = pow(2.0f, pitchBendCents / 1200.0f);
-  baseFreq *= bendRatio;
-
-  // SuperSaw detune (cents: -10, -5, 0, +5, +10)
-  float detune1 = baseFreq * pow(2.0f, -10.0f / 1200.0f);
-  float detune2 = baseFreq * pow(2.0f, -5.0f / 1200.0f);
-  float detune3 = baseFreq;
-  float detune4 = baseFreq * pow(2.0f, 5.0f / 1200.0f);
-  float detune5 = baseFreq * pow(2.0f, 10.0f / 1200.0f);
-
-  osc1.frequency(detune1);
-  osc2.frequency(detune2);
-  osc3.frequency(detune3);
-  osc4.frequency(detune4);
-  osc5.frequency(detune5);
+  // Detune and bend ride on the pitch buses
+  osc1.frequency(baseFreq);
+  osc2.frequency(baseFreq);
+  osc3.frequency(baseFreq);
+  osc4.frequency(baseFreq);
+  osc5.frequency(baseFreq);
 }
 
-void playNote(uint8_t midiNote) {
-  targetFrequency = midiToFreq(midiNote);
+void setPitchBend(float cents) {
+  pitchBendCents = cents;
+  for (auto* bus : {&bus1, &bus2, &bus3, &bus4, &bus5}) {
+    bus->setBend(PITCH_CENTS(cents));
+  }
+}
 
-  if (!noteActive) {
-    currentFrequency = targetFrequency;
-    noteActive = true;
+void playNote(uint8_t midiNote) {
+  float frequency = midiToFreq(midiNote);
+
+  // Oscillators and buses must change in the same audio block
+  AudioNoInterrupts();
+  if (noteActive && portamentoMs > 0) {
+    // Start where the last note is sounding now and slide to the new one
+    int32_t from = bus3.getPitch() + (int32_t)(log2f(noteFrequency / frequency) * PITCH_UNITS_PER_OCTAVE);
+    for (auto* bus : {&bus1, &bus2, &bus3, &bus4, &bus5}) {
+      bus->jumpTo(from);
+      bus->glideTo(0, portamentoMs);
+    }
+  } else {
+    for (auto* bus : {&bus1, &bus2, &bus3, &bus4, &bus5}) {
+      bus->jumpTo(0);
+    }
   }
+  updateOscillatorFrequencies(frequency);
+  AudioInterrupts();
 
-  updateOscillatorFrequencies(currentFrequency);
+  noteFrequency = frequency;
+  noteActive = true;
 
   // Trigger all envelopes
   env1.noteOn();
@@ -341,7 +387,7 @@ void playNote(uint8_t midiNote) {
   Serial.print("♪ ");
   Serial.print(getNoteName(midiNote));
   Serial.print(" (");
-  Serial.print(targetFrequency, 1);
+  Serial.print(frequency, 1);
   Serial.println(" Hz)");
 }
 
@@ -356,15 +402,6 @@ void stopNote() {
   sendNoteToESP(0, false);
 }
 
-void updateAudio() {
-  // Portamento: smooth frequency transitions
-  if (noteActive && abs(currentFrequency - targetFrequency) > 0.5f) {
-    float diff = targetFrequency - currentFrequency;
-    currentFrequency += diff * portamentoSpeed;
-    updateOscillatorFrequencies(currentFrequency);
-  }
-}
-
 void allNotesOff() {
   stopNote();
   noteCount = 0;
@@ -372,7 +409,7 @@ void allNotesOff() {
   memset(activeNotes, 0, sizeof(activeNotes));
   memset(strumNotes, 0, sizeof(strumNotes));
   noteActive = false;
-  pitchBendCents = 0.0f;
+  setPitchBend(0.0f);
 }
 
 // ===== GUITAR HERO INPUT PROCESSING =====
@@ -467,7 +504,7 @@ void processControlButtons() {
     arpIndex = 0;
     Serial.print("Arpeggiator: ");
     Serial.println(arpeggiatorActive ? "ON" : "OFF");
-    sendConfigToESP();
+    syncStateToESP();
   }
   lastStarPower = starPower;
 
@@ -482,7 +519,7 @@ void processControlButtons() {
     Serial.print("Scale: ");
     Serial.println(scaleNames[currentScale]);
     allNotesOff();
-    sendConfigToESP();
+    syncStateToESP();
   }
   lastPlus = plusBtn;
 
@@ -491,7 +528,7 @@ void processControlButtons() {
     Serial.print("Scale: ");
     Serial.println(scaleNames[currentScale]);
     allNotesOff();
-    sendConfigToESP();
+    syncStateToESP();
   }
   lastMinus = minusBtn;
 }
@@ -500,21 +537,16 @@ void processAnalogControls() {
   if (!joystick1.available()) return;
 
   // Whammy bar (usually axis 5 or similar)
-  uint32_t whammyValue = joystick1.getAxis(5);  // Adjust axis number
-
-  if (abs((int)whammyValue - (int)lastWhammyValue) > 20) {
-    lastWhammyValue = whammyValue;
+  whammy.update(joystick1.getAxis(5));  // Adjust axis number
 
+  int16_t whammyValue;
+  if (whammy.poll(micros() / AUDIO_BLOCK_US, whammyValue)) {
     // Map to pitch bend (-200 to +200 cents = ±2 semitones)
-    pitchBendCents = map(whammyValue, 0, 1023, -200, 200);
+    setPitchBend(whammyValue * 200.0f / ANALOG_FULL_SCALE);
 
-    // Also control filter frequency
-    filterFreq = map(whammyValue, 0, 1023, 500, 8000);
+    // Also control filter frequency (500 to 8000 Hz)
+    filterFreq = 4250.0f + whammyValue * 3750.0f / ANALOG_FULL_SCALE;
     filter.frequency(filterFreq);
-
-    if (noteActive) {
-      updateOscillatorFrequencies(currentFrequency);
-    }
   }
 
   // D-Pad for octave control
@@ -527,13 +559,13 @@ void processAnalogControls() {
       Serial.print("Octave: ");
       Serial.println(currentOctave);
       allNotesOff();
-      sendConfigToESP();
+      syncStateToESP();
     } else if (dpadY > 50 && currentOctave > -2) {
       currentOctave--;
       Serial.print("Octave: ");
       Serial.println(currentOctave);
       allNotesOff();
-      sendConfigToESP();
+      syncStateToESP();
     }
     lastDpadY = dpadY;
   }
@@ -574,96 +606,90 @@ void initESP() {
   delay(100);
 
   // Send initial config
-  sendConfigToESP();
+  syncStateToESP();
 
   Serial.println("✓ ESP-12E communication initialized");
   #endif
 }
 
-void sendConfigToESP() {
+void sendToESP(uint8_t type, const void* payload, size_t len) {
   #if USE_ESP_WIFI
-  // Send JSON config to ESP
-  ESP_SERIAL.print("{\"type\":\"config\",");
-  ESP_SERIAL.print("\"scale\":");
-  ESP_SERIAL.print(currentScale);
-  ESP_SERIAL.print(",\"scaleName\":\"");
-  ESP_SERIAL.print(scaleNames[currentScale]);
-  ESP_SERIAL.print("\",\"root\":");
-  ESP_SERIAL.print(currentRoot);
-  ESP_SERIAL.print(",\"rootName\":\"");
-  ESP_SERIAL.print(noteNames[currentRoot]);
-  ESP_SERIAL.print("\",\"octave\":");
-  ESP_SERIAL.print(currentOctave);
-  ESP_SERIAL.print(",\"arp\":");
-  ESP_SERIAL.print(arpeggiatorActive ? "true" : "false");
-  ESP_SERIAL.println("}");
+  uint8_t frame[LINK_MAX_FRAME];
+  ESP_SERIAL.write(frame, linkEncode(type, payload, len, frame));
   #endif
 }
 
-void sendNoteToESP(uint8_t note, bool on) {
-  #if USE_ESP_WIFI
-  ESP_SERIAL.print("{\"type\":\"note\",\"note\":");
-  ESP_SERIAL.print(note);
-  ESP_SERIAL.print(",\"on\":");
-  ESP_SERIAL.print(on ? "true" : "false");
-  ESP_SERIAL.println("}");
-  #endif
+void syncStateToESP() {
+  // Only the fields that changed since the ESP last acknowledged go out;
+  // unacknowledged changes are resent on the next call
+  LinkState& state = espState.state();
+  state.connected = joystick1.available();
+  state.scale = currentScale;
+  state.root = currentRoot;
+  state.octave = currentOctave;
+  state.arp = arpeggiatorActive;
+  state.voices = noteActive ? 5 : 0;
+  state.cpuTenths = (uint16_t)(AudioProcessorUsage() * 10.0f);
+  state.memBlocks = AudioMemoryUsage();
+  state.totalNotes = totalNotes;
+  state.loopMaxUs = maxLoopTime;
+
+  uint8_t payload[LINK_MAX_PAYLOAD];
+  size_t len = espState.poll(millis(), payload);
+  if (len) sendToESP(LINK_MSG_STATE, payload, len);
 }
 
-void sendStatusToESP() {
-  #if USE_ESP_WIFI
-  ESP_SERIAL.print("{\"type\":\"status\",");
-  ESP_SERIAL.print("\"cpu\":");
-  ESP_SERIAL.print(AudioProcessorUsage(), 1);
-  ESP_SERIAL.print(",\"mem\":");
-  ESP_SERIAL.print(AudioMemoryUsage());
-  ESP_SERIAL.print(",\"notes\":");
-  ESP_SERIAL.print(totalNotes);
-  ESP_SERIAL.print(",\"latency\":");
-  ESP_SERIAL.print(maxLoopTime);
-  ESP_SERIAL.println("}");
-  #endif
+void sendNoteToESP(uint8_t note, bool on) {
+  // Collected into one frame per LINK_NOTE_BATCH_MS, sent from loop()
+  uint8_t payload[LINK_MAX_PAYLOAD];
+  if (espNotes.full()) sendToESP(LINK_MSG_NOTES, payload, espNotes.flush(payload));
+  espNotes.add(note, on ? 100 : 0, 0, millis());
 }
 
 void processESPCommands() {
   #if USE_ESP_WIFI
-  if (ESP_SERIAL.available()) {
-    String cmd = ESP_SERIAL.readStringUntil('\n');
-    cmd.trim();
-
-    // Simple command parsing
-    if (cmd.startsWith("{\"cmd\":\"scale\",\"value\":")) {
-      int value = cmd.substring(26).toInt();
-      if (value >= 0 && value < NUM_SCALES) {
+  static LinkDecoder espLink;
+
+  while (ESP_SERIAL.available()) {
+    if (!espLink.push(ESP_SERIAL.read())) continue;
+
+    LinkSetParam param;
+    LinkCommand command;
+    LinkStateAck ack;
+    if (espLink.get(ack)) {
+      espState.ack(ack.generation);
+      continue;
+    }
+    else if (espLink.get(param)) {
+      int value = (int)param.value;
+      if (param.param == LINK_PARAM_SCALE && value >= 0 && value < NUM_SCALES) {
         currentScale = value;
         allNotesOff();
         Serial.print("ESP Command - Scale: ");
         Serial.println(scaleNames[currentScale]);
       }
-    }
-    else if (cmd.startsWith("{\"cmd\":\"root\",\"value\":")) {
-      int value = cmd.substring(24).toInt();
-      if (value >= 0 && value < 12) {
+      else if (param.param == LINK_PARAM_ROOT && value >= 0 && value < 12) {
         currentRoot = value;
         allNotesOff();
         Serial.print("ESP Command - Root: ");
         Serial.println(noteNames[currentRoot]);
       }
-    }
-    else if (cmd.startsWith("{\"cmd\":\"octave\",\"value\":")) {
-      int value = cmd.substring(26).toInt();
-      if (value >= -2 && value <= 2) {
+      else if (param.param == LINK_PARAM_OCTAVE && value >= -2 && value <= 2) {
         currentOctave = value;
         allNotesOff();
         Serial.print("ESP Command - Octave: ");
         Serial.println(currentOctave);
       }
     }
-    else if (cmd.indexOf("\"arp\"") >= 0) {
+    else if (espLink.get(command) && command.command == LINK_CMD_TOGGLE_ARP) {
       arpeggiatorActive = !arpeggiatorActive;
       Serial.print("ESP Command - Arp: ");
       Serial.println(arpeggiatorActive ? "ON" : "OFF");
     }
+    else if (espLink.get(command) && command.command == LINK_CMD_RESYNC) {
+      espState.resync();
+    }
+    syncStateToESP();
   }
   #endif
 }
@@ -686,6 +712,7 @@ void setup() {
 
   // Initialize Audio
   initAudio();
+  whammy.init(WHAMMY_DEADZONE, WHAMMY_SPAN, ANALOG_SMOOTHING_SHIFT, WHAMMY_HYSTERESIS);
 
   // Initialize ESP-12E
   initESP();
@@ -741,6 +768,7 @@ void loop() {
       Serial.print(joystick1.idVendor(), HEX);
       Serial.print(" PID: 0x");
       Serial.println(joystick1.idProduct(), HEX);
+      whammy.reset();  // First reading becomes the rest position
       Serial.println("Ready to play!\n");
     } else {
       Serial.println("\n*** CONTROLLER DISCONNECTED! ***\n");
@@ -755,18 +783,19 @@ void loop() {
     processAnalogControls();
   }
 
-  // Update audio (portamento)
-  updateAudio();
-
   // Process arpeggiator
   processArpeggiator();
 
   // ESP communication
   processESPCommands();
 
-  // Send status to ESP every 500ms
-  if (espTimer >= 500) {
-    sendStatusToESP();
+  // Note batches as their window closes; state deltas (and retries of
+  // unacknowledged ones) every 100ms
+  uint8_t notes[LINK_MAX_PAYLOAD];
+  size_t notesLen = espNotes.poll(millis(), notes);
+  if (notesLen) sendToESP(LINK_MSG_NOTES, notes, notesLen);
+  if (espTimer >= 100) {
+    syncStateToESP();
     espTimer = 0;
   }
 
@@ -0,0 +1,201 @@
+/**
+ * Generated by esp8266-wifi/scripts/pre_build.py from web/osc_control/
+ * Do not edit; change the files there and regenerate.
+ * Include teensy-main/include/web_asset.h first.
+ */
+
+#ifndef OSC_CONTROL_WEB_H
+#define OSC_CONTROL_WEB_H
+
+// app.css: 2422 bytes, 934 gzipped
+static const uint8_t web_app_css[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x55, 0x4d, 0x8f, 0xe2, 0x38,
+    0x10, 0xbd, 0xf3, 0x2b, 0x2c, 0x8d, 0x5a, 0x03, 0x2b, 0x8c, 0x92, 0x40, 0x80, 0xa1, 0x2f, 0x73,
+    0x1b, 0xed, 0x79, 0x3f, 0xa4, 0x3d, 0x3a, 0x71, 0x25, 0xf1, 0x76, 0x62, 0x47, 0xb6, 0x03, 0xf4,
+    0x8e, 0xe6, 0xbf, 0x6f, 0xd9, 0xce, 0x17, 0xd0, 0xdd, 0xab, 0x5d, 0x2d, 0x28, 0x90, 0x54, 0x5c,
+    0xae, 0xaa, 0x57, 0xaf, 0x9e, 0x7f, 0x22, 0xdf, 0x49, 0xc3, 0x74, 0x29, 0xe4, 0x89, 0x44, 0xcf,
+    0xa4, 0x65, 0x9c, 0x0b, 0x59, 0xfa, 0xfb, 0x4c, 0x5d, 0xa9, 0x11, 0x7f, 0xf9, 0xc7, 0x4c, 0x69,
+    0x0e, 0x9a, 0xa2, 0xe9, 0x99, 0xfc, 0x58, 0x64, 0x8a, 0xbf, 0x92, 0xef, 0x0b, 0x42, 0x0a, 0x25,
+    0x2d, 0x2d, 0x58, 0x23, 0xea, 0xd7, 0x13, 0xf9, 0xfc, 0x0b, 0x94, 0x0a, 0xc8, 0x6f, 0x3f, 0x7f,
+    0x5e, 0x93, 0x5f, 0x59, 0xa5, 0x1a, 0xb6, 0x26, 0xdf, 0x40, 0xc2, 0x19, 0xff, 0x7f, 0x07, 0xcd,
+    0x99, 0xc4, 0x1b, 0xc3, 0xa4, 0xa1, 0x06, 0xb4, 0x28, 0x9e, 0xd1, 0x3f, 0x63, 0xf9, 0x4b, 0xa9,
+    0x55, 0x27, 0xf9, 0x89, 0xd4, 0x42, 0x02, 0xd3, 0xb4, 0xd4, 0x8c, 0x0b, 0x90, 0x76, 0x19, 0x6f,
+    0x53, 0x0e, 0xe5, 0x9a, 0x7c, 0x8a, 0x61, 0x9b, 0x1f, 0x12, 0x12, 0x3d, 0xe1, 0x7d, 0xc2, 0xd2,
+    0xe4, 0xcb, 0x91, 0xc4, 0x51, 0xf4, 0xb4, 0x72, 0x1b, 0xe4, 0xaa, 0x56, 0xfa, 0x44, 0x2e, 0x95,
+    0xb0, 0xe0, 0x9e, 0xc7, 0xfc, 0x93, 0xa8, 0xbd, 0x3a, 0x43, 0x23, 0x24, 0xad, 0x40, 0x94, 0x95,
+    0x3d, 0x39, 0xaf, 0x73, 0xf5, 0xbc, 0xf8, 0xb1, 0xd8, 0xe4, 0x98, 0x37, 0xc3, 0x78, 0xda, 0x57,
+    0xd1, 0xb0, 0x2b, 0xbd, 0x08, 0x6e, 0x2b, 0x5c, 0x92, 0x44, 0x83, 0xe3, 0x00, 0x0a, 0x61, 0x9d,
+    0x55, 0xde, 0xab, 0x02, 0xc6, 0x7b, 0x17, 0x0b, 0x57, 0x4b, 0x59, 0x2d, 0x4a, 0x5c, 0x91, 0x63,
+    0xb6, 0xa0, 0x27, 0x1f, 0x44, 0xc9, 0x5a, 0xd5, 0x9c, 0xc8, 0xd6, 0x6f, 0x35, 0x39, 0x56, 0xf1,
+    0x04, 0x1a, 0x02, 0x0b, 0xb8, 0x62, 0x3f, 0x0f, 0x36, 0x3a, 0xc6, 0x7d, 0x0e, 0x3e, 0x8a, 0xa9,
+    0x18, 0x57, 0x17, 0xac, 0xa8, 0xbd, 0xfa, 0x6b, 0x87, 0x97, 0x2e, 0x33, 0xb6, 0x8c, 0xd6, 0xfe,
+    0xbb, 0x49, 0x57, 0x3e, 0x48, 0xa9, 0x05, 0xf7, 0xfb, 0x73, 0x61, 0xda, 0x9a, 0x61, 0x43, 0x9c,
+    0xc5, 0x6d, 0xe3, 0xfe, 0xa9, 0x85, 0x06, 0xad, 0x16, 0x28, 0x42, 0xd6, 0x35, 0xd2, 0x9c, 0x88,
+    0x86, 0x16, 0x98, 0x5d, 0xba, 0xf2, 0x68, 0x21, 0xec, 0xda, 0x61, 0x85, 0x50, 0x2c, 0xb7, 0x0e,
+    0x82, 0x35, 0x89, 0x0b, 0xbd, 0xf2, 0x18, 0x97, 0xac, 0x1d, 0xf0, 0x74, 0xd0, 0x31, 0x1d, 0xc2,
+    0xcc, 0x7b, 0xe7, 0xf3, 0x49, 0xd2, 0x74, 0x4d, 0xa6, 0x9f, 0x68, 0x13, 0xaf, 0x86, 0x1e, 0x73,
+    0xad, 0x5a, 0x8c, 0x51, 0x23, 0x4e, 0xc8, 0xa5, 0xba, 0xd3, 0x4b, 0x57, 0x62, 0x78, 0x1d, 0x98,
+    0xe5, 0xba, 0xde, 0x61, 0x52, 0x71, 0x1a, 0x4a, 0x7f, 0x68, 0xa4, 0x67, 0x63, 0x0f, 0x45, 0x44,
+    0x8e, 0x08, 0xc2, 0x36, 0xb9, 0x47, 0x62, 0xbb, 0x9a, 0x52, 0xac, 0x92, 0x7b, 0xb0, 0x93, 0xe8,
+    0x6d, 0xb0, 0xd3, 0x21, 0x40, 0x4f, 0xf1, 0x60, 0x76, 0x9b, 0x1b, 0x55, 0x23, 0xa6, 0x63, 0x71,
+    0xc3, 0x15, 0x02, 0x8d, 0x39, 0xde, 0xb5, 0x0d, 0x13, 0x90, 0x0a, 0x71, 0xee, 0xdb, 0xf0, 0x01,
+    0x5d, 0x66, 0xb9, 0x1d, 0x92, 0x90, 0x84, 0x37, 0x5d, 0x7a, 0xbe, 0x66, 0xaa, 0xe6, 0x37, 0x58,
+    0x6c, 0x07, 0x2c, 0xee, 0xa1, 0x9f, 0x03, 0xf0, 0x08, 0xe9, 0x5b, 0xa3, 0x90, 0xf6, 0xc6, 0x91,
+    0x2c, 0x45, 0x0d, 0xde, 0xe0, 0xb3, 0xa4, 0x38, 0x4e, 0x8d, 0x99, 0xe7, 0xfa, 0x67, 0x67, 0xac,
+    0x28, 0x5e, 0xa9, 0x9b, 0x1c, 0x34, 0x4e, 0xaf, 0x86, 0x72, 0x95, 0xf4, 0x95, 0x32, 0x29, 0x1a,
+    0x66, 0x85, 0xc2, 0x42, 0xdb, 0xae, 0x36, 0x80, 0x34, 0x48, 0x0d, 0x11, 0xb2, 0x10, 0xb2, 0x1f,
+    0xd1, 0x7e, 0x64, 0x3f, 0xed, 0x70, 0x26, 0x8e, 0x91, 0xdb, 0xe0, 0xeb, 0x0b, 0xbc, 0x16, 0x9a,
+    0x35, 0x60, 0x7a, 0x1f, 0xb7, 0x91, 0x1b, 0x77, 0x37, 0xe6, 0xa8, 0x4f, 0x56, 0xa3, 0x68, 0x14,
+    0x4a, 0x23, 0xc4, 0x26, 0x67, 0x35, 0x2c, 0x91, 0x58, 0xa8, 0x42, 0x84, 0xa4, 0xef, 0xbc, 0xde,
+    0x84, 0x05, 0x98, 0x1a, 0x06, 0x56, 0x54, 0xab, 0xcb, 0xed, 0x60, 0x0c, 0xb5, 0x3e, 0x14, 0x65,
+    0x5a, 0x96, 0x03, 0xcd, 0xc0, 0x5e, 0x00, 0xe4, 0x0d, 0xf4, 0x0e, 0x44, 0x14, 0xc5, 0x47, 0x9e,
+    0xc4, 0x1f, 0xf1, 0x24, 0x0e, 0x84, 0xf4, 0x59, 0xd4, 0x2c, 0x83, 0xda, 0xe7, 0xa1, 0x30, 0x8a,
+    0xb0, 0x98, 0x47, 0xb4, 0x39, 0x4c, 0xef, 0xcf, 0xac, 0xee, 0x60, 0xe2, 0xec, 0x2d, 0x09, 0x70,
+    0x51, 0x66, 0xe5, 0xc3, 0xdc, 0xbd, 0xab, 0x99, 0xfb, 0xfd, 0x01, 0x80, 0x05, 0xcd, 0x3c, 0xec,
+    0x77, 0x19, 0x4b, 0x26, 0xcd, 0x0c, 0x05, 0x9c, 0x88, 0x54, 0x12, 0x3e, 0xd4, 0xd0, 0xd8, 0x4b,
+    0xce, 0xee, 0x66, 0x3c, 0x06, 0x52, 0x1d, 0x83, 0x35, 0xef, 0xb4, 0x71, 0xce, 0xad, 0x12, 0x6f,
+    0xb0, 0x3a, 0xde, 0xdf, 0x6a, 0x69, 0x3f, 0x69, 0xbe, 0x61, 0x22, 0x90, 0x64, 0x6c, 0x1e, 0x82,
+    0x91, 0x98, 0xa1, 0xd0, 0x53, 0xa5, 0xce, 0x83, 0xd2, 0x4e, 0xdd, 0xf5, 0xb7, 0x4e, 0xc3, 0xfe,
+    0x58, 0xd2, 0xc4, 0xcb, 0x47, 0xbf, 0x9a, 0xe5, 0x56, 0x9c, 0xe1, 0x83, 0xe5, 0xd1, 0x6a, 0x94,
+    0x7d, 0xad, 0x6a, 0xf3, 0xaf, 0x64, 0x12, 0x75, 0xd0, 0x5d, 0xa3, 0x12, 0x8e, 0x53, 0xde, 0x80,
+    0xed, 0x73, 0xfc, 0x6f, 0xf3, 0x38, 0xcc, 0xe2, 0x30, 0xd5, 0xad, 0x1a, 0x40, 0xd1, 0x80, 0x29,
+    0x60, 0x45, 0xce, 0xea, 0x80, 0x28, 0x6a, 0xa7, 0x7a, 0x95, 0xe0, 0xdc, 0xb1, 0x72, 0x08, 0xed,
+    0x04, 0x35, 0x10, 0x6a, 0x76, 0xc0, 0x3d, 0xfd, 0xd3, 0xb1, 0xfa, 0x25, 0x0a, 0x0c, 0x09, 0xe3,
+    0xd7, 0x9f, 0xaa, 0x49, 0x9e, 0xa6, 0x30, 0x31, 0x64, 0xde, 0x20, 0x7f, 0x30, 0x62, 0x73, 0xb6,
+    0xe6, 0x7f, 0x91, 0x8b, 0xf7, 0xd8, 0x6d, 0x2c, 0xb3, 0x9d, 0xa1, 0x42, 0x72, 0x91, 0x33, 0xab,
+    0x02, 0xae, 0xe3, 0xa1, 0x7c, 0x0b, 0xd8, 0xf0, 0x7c, 0x87, 0x6b, 0x1a, 0x8a, 0x1f, 0x53, 0x14,
+    0xd2, 0xd5, 0x4e, 0xb3, 0x5a, 0xe5, 0x2f, 0x33, 0xdd, 0xd7, 0x61, 0x93, 0x63, 0xdf, 0xc5, 0x3e,
+    0xb0, 0xf2, 0x8b, 0x1f, 0xba, 0x39, 0xaa, 0xd4, 0xfd, 0x01, 0x14, 0x05, 0x45, 0x98, 0xa9, 0xd8,
+    0xb8, 0x53, 0x51, 0xbc, 0xbd, 0x15, 0x14, 0x3b, 0xfc, 0xb8, 0xa5, 0x8b, 0xbf, 0x01, 0xb0, 0x54,
+    0x2a, 0x43, 0x76, 0x09, 0x00, 0x00,
+};
+
+// app.js: 2766 bytes, 905 gzipped
+static const uint8_t web_app_js[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xc5, 0x56, 0xdb, 0x6e, 0xdb, 0x38,
+    0x10, 0x7d, 0xf7, 0x57, 0x0c, 0x02, 0x74, 0x29, 0xa3, 0xb6, 0xec, 0xb6, 0xd8, 0x05, 0xe2, 0x8b,
+    0x16, 0xbd, 0x05, 0x6d, 0xd1, 0x24, 0x05, 0xe2, 0x7c, 0x00, 0x23, 0x8d, 0x6d, 0xb6, 0x14, 0x29,
+    0x90, 0x54, 0x1c, 0x23, 0xf5, 0x9f, 0xf5, 0x1b, 0xfa, 0x4d, 0x1d, 0x52, 0x8a, 0x2d, 0xd7, 0x4e,
+    0xed, 0xee, 0x2e, 0xb0, 0x4f, 0x92, 0xe6, 0x0c, 0x0f, 0xcf, 0x5c, 0x38, 0xa2, 0x44, 0x07, 0x92,
+    0x5b, 0x77, 0x5d, 0x64, 0xdc, 0x21, 0x8c, 0xa1, 0x3f, 0x6c, 0xb5, 0xa6, 0xa5, 0x4a, 0x9d, 0xd0,
+    0x0a, 0xca, 0x60, 0xbd, 0x72, 0xdc, 0x95, 0x36, 0x6a, 0xc3, 0x7d, 0x0b, 0x60, 0x8a, 0x2e, 0x9d,
+    0x47, 0xac, 0xc7, 0x0b, 0xd1, 0xb3, 0x01, 0x60, 0x6d, 0x32, 0x03, 0xc4, 0x6e, 0x8e, 0x2a, 0x32,
+    0x30, 0x4e, 0xc0, 0xc4, 0x9f, 0xad, 0x56, 0x51, 0xbb, 0x09, 0x10, 0x11, 0xf7, 0xd8, 0x7d, 0xb0,
+    0x01, 0x64, 0x3a, 0x2d, 0x73, 0x54, 0x2e, 0x9e, 0xa1, 0x7b, 0x2b, 0xd1, 0xbf, 0xbe, 0x5a, 0xbe,
+    0xcf, 0x22, 0xf6, 0x40, 0x1a, 0xa7, 0xa4, 0xcb, 0x5e, 0xf0, 0xdc, 0xab, 0xaa, 0xad, 0x5d, 0xa1,
+    0x32, 0x91, 0x72, 0xa7, 0x0d, 0xd4, 0x06, 0xad, 0xa4, 0x50, 0xc8, 0x86, 0xc7, 0xb1, 0x4e, 0xf0,
+    0xce, 0x11, 0xb3, 0xa3, 0xc7, 0x6b, 0xad, 0x1c, 0xa1, 0x9e, 0x9b, 0x5e, 0x15, 0xa6, 0x0e, 0x33,
+    0xa2, 0xa9, 0x79, 0xc4, 0x14, 0x82, 0xe2, 0x58, 0x69, 0x87, 0x97, 0xaa, 0xbd, 0x96, 0xfd, 0x8b,
+    0x2d, 0xbc, 0xeb, 0x1b, 0x61, 0x0b, 0xc9, 0x97, 0x3b, 0x7b, 0xac, 0xb9, 0x42, 0x3c, 0x5f, 0xbf,
+    0x56, 0x06, 0x9f, 0xf8, 0x0b, 0x32, 0x0e, 0x7f, 0x97, 0x7c, 0x2b, 0x35, 0x1e, 0xea, 0x66, 0x15,
+    0x06, 0xe1, 0x43, 0xab, 0x75, 0x42, 0x56, 0x80, 0xd2, 0xe2, 0xbf, 0x95, 0xcf, 0xba, 0xdd, 0x2e,
+    0xfb, 0xef, 0x54, 0x6e, 0xd4, 0xb5, 0x0e, 0xd5, 0x2d, 0x2d, 0xca, 0xfd, 0xc9, 0x24, 0x20, 0x76,
+    0xfa, 0x4c, 0xdc, 0x61, 0x16, 0x3d, 0x6b, 0xc3, 0x53, 0x60, 0x4f, 0x0e, 0x77, 0x01, 0x2d, 0x3a,
+    0x47, 0x87, 0x86, 0x28, 0xad, 0x5b, 0x4a, 0x8c, 0x17, 0x22, 0x73, 0xf3, 0x06, 0xe5, 0xf1, 0x3c,
+    0x7b, 0x5b, 0xe9, 0x17, 0xca, 0x0e, 0x51, 0xe6, 0x98, 0xef, 0xa7, 0x23, 0xc0, 0x73, 0xc0, 0x8d,
+    0xd4, 0xe9, 0x17, 0x7b, 0x58, 0x9b, 0xa4, 0x13, 0xab, 0xd2, 0x47, 0x5a, 0xb0, 0x06, 0x03, 0xe1,
+    0xf7, 0x6f, 0x47, 0xb0, 0xf9, 0xb2, 0xd9, 0xc7, 0xdb, 0xd9, 0x1e, 0x0e, 0xcc, 0xa6, 0x5c, 0xe2,
+    0x7e, 0x86, 0x00, 0x1d, 0x94, 0x60, 0xb4, 0x7e, 0x24, 0xd3, 0x1e, 0x39, 0xb8, 0x5c, 0xa7, 0x8e,
+    0xdf, 0x3e, 0x22, 0xa0, 0xc2, 0x0e, 0x52, 0x70, 0x53, 0xec, 0x5f, 0x4f, 0x00, 0xfc, 0x0d, 0xec,
+    0xf2, 0x82, 0xc1, 0x80, 0x1e, 0x67, 0x67, 0x9b, 0x42, 0x6f, 0x0d, 0xd5, 0x37, 0xf4, 0xa0, 0x7c,
+    0x2d, 0xa2, 0x76, 0xb5, 0xd7, 0xaa, 0x9e, 0x8c, 0x34, 0xca, 0x68, 0x98, 0xa2, 0x31, 0xcd, 0xc9,
+    0xe8, 0x67, 0xcf, 0x66, 0x01, 0x74, 0x9b, 0x54, 0x09, 0xbc, 0xe8, 0xf7, 0xfb, 0x47, 0x8d, 0xa3,
+    0xdf, 0x9c, 0xa3, 0xd3, 0xe9, 0xd6, 0x20, 0xfd, 0x87, 0xa3, 0x94, 0x0e, 0x7f, 0xda, 0x98, 0xa6,
+    0x0f, 0xa7, 0xbc, 0x8a, 0x79, 0xd8, 0x5a, 0x35, 0xfe, 0x2d, 0x16, 0x55, 0xf6, 0x3a, 0xcf, 0xa2,
+    0x34, 0xcf, 0x3a, 0x70, 0xcb, 0x65, 0x89, 0xbb, 0x3f, 0x18, 0xc2, 0x58, 0xa7, 0x0e, 0x36, 0x47,
+    0x37, 0xd7, 0x19, 0xa5, 0xf9, 0xd3, 0xe5, 0xd5, 0x84, 0x75, 0x82, 0x6d, 0x8e, 0x3c, 0x43, 0x63,
+    0x07, 0x70, 0xcf, 0x6a, 0x11, 0xdd, 0xc9, 0xb2, 0x40, 0x46, 0x5e, 0xbc, 0x28, 0xa4, 0x0f, 0x91,
+    0xb6, 0xea, 0xf9, 0xbf, 0x11, 0x5b, 0x55, 0x4b, 0x6e, 0x74, 0xb6, 0x1c, 0xc0, 0x87, 0xab, 0xcb,
+    0x0b, 0x1a, 0x01, 0x46, 0xa8, 0x99, 0x98, 0x2e, 0xa3, 0x7b, 0xda, 0x68, 0x00, 0x1b, 0x25, 0x83,
+    0xea, 0x11, 0xca, 0xf4, 0xb3, 0x6e, 0xa7, 0x67, 0x33, 0x89, 0x2f, 0x4d, 0x11, 0xfd, 0xdf, 0x7a,
+    0x43, 0x5f, 0x36, 0x35, 0xf6, 0x7a, 0xf0, 0x4e, 0x2f, 0x40, 0x6a, 0x35, 0x03, 0xe4, 0xe9, 0x1c,
+    0xde, 0x5e, 0x7d, 0xa2, 0x2f, 0x5d, 0x80, 0xe3, 0xf6, 0x0b, 0x2c, 0xb8, 0x70, 0x96, 0xf4, 0x83,
+    0x29, 0x15, 0x44, 0x41, 0xb0, 0x07, 0xdb, 0x03, 0x38, 0x3d, 0x75, 0x73, 0xbf, 0xba, 0x40, 0x93,
+    0x92, 0x28, 0x21, 0x11, 0xb8, 0xca, 0x60, 0xa1, 0x8d, 0x75, 0x90, 0x72, 0xfa, 0x81, 0x58, 0xa1,
+    0x52, 0x24, 0x31, 0xda, 0x6d, 0x32, 0x31, 0xd5, 0x26, 0xe7, 0xee, 0xda, 0x46, 0xa5, 0xad, 0x52,
+    0xe1, 0x3b, 0xb7, 0xb4, 0x30, 0x02, 0xea, 0x50, 0x83, 0xae, 0x34, 0x0a, 0x58, 0xf2, 0xd7, 0x9f,
+    0x79, 0x35, 0x67, 0x6a, 0x0b, 0x39, 0x24, 0x63, 0x78, 0x46, 0x6d, 0x4c, 0x47, 0xc7, 0xbb, 0xf7,
+    0xc2, 0x47, 0xfb, 0xa7, 0x99, 0x09, 0xb4, 0x8a, 0x0e, 0x15, 0xe1, 0x9b, 0x59, 0xb5, 0xda, 0xb9,
+    0x9a, 0x7c, 0x24, 0xfd, 0x7b, 0xea, 0xe0, 0xc3, 0x3a, 0xee, 0x5a, 0x62, 0xb0, 0xd0, 0xc6, 0x1d,
+    0x75, 0x31, 0xf1, 0xa4, 0x13, 0xca, 0xa3, 0x3f, 0x53, 0x82, 0x7a, 0xdc, 0xbc, 0x9b, 0x9c, 0x7f,
+    0xa4, 0xa6, 0xaf, 0x28, 0x62, 0x9f, 0x62, 0x1b, 0xe7, 0xbc, 0x88, 0x42, 0xb2, 0xc7, 0xc9, 0xfa,
+    0x24, 0xb1, 0x51, 0x26, 0x6e, 0x21, 0x1c, 0xc3, 0xf1, 0x89, 0x50, 0x53, 0xdd, 0x35, 0x7a, 0x71,
+    0x92, 0x8c, 0x6c, 0xc1, 0xd5, 0x96, 0x59, 0xf2, 0x1b, 0x94, 0x27, 0x09, 0xa3, 0x90, 0x3d, 0x47,
+    0xac, 0xfc, 0xa1, 0xa5, 0xf0, 0x07, 0xa3, 0x9e, 0xf7, 0xf5, 0x40, 0x83, 0x74, 0x67, 0x79, 0xe8,
+    0xd9, 0x93, 0xa4, 0x38, 0x3d, 0x85, 0x3f, 0xa4, 0x1b, 0x7a, 0x9a, 0x75, 0x89, 0x02, 0x1f, 0x21,
+    0xd7, 0x54, 0xaa, 0x06, 0x49, 0x07, 0x72, 0x7e, 0x07, 0xbb, 0x9e, 0x64, 0x0d, 0x9e, 0xb4, 0x4d,
+    0xb5, 0xf5, 0xa8, 0x47, 0x31, 0x24, 0x14, 0xf9, 0x67, 0x2d, 0x54, 0xc4, 0xd8, 0xde, 0x41, 0x46,
+    0x95, 0xf0, 0x89, 0xdc, 0x74, 0x63, 0x3d, 0xb5, 0xf0, 0x16, 0xcd, 0xd2, 0x57, 0x39, 0xb7, 0x2d,
+    0x8b, 0xee, 0x3d, 0x75, 0xbe, 0x21, 0xb1, 0x51, 0xf3, 0x7a, 0xd9, 0xf1, 0x38, 0x2d, 0xdc, 0xbe,
+    0x72, 0x0e, 0xf7, 0xf8, 0xfb, 0x9a, 0x77, 0xe0, 0x79, 0xbf, 0xe1, 0x5e, 0xb5, 0xc1, 0xb0, 0xf5,
+    0x03, 0x41, 0x97, 0xcc, 0x82, 0xce, 0x0a, 0x00, 0x00,
+};
+
+// index.html: 3274 bytes, 861 gzipped
+static const uint8_t web_index_html[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xb5, 0x57, 0xd1, 0x6e, 0xd3, 0x30,
+    0x14, 0x7d, 0xdf, 0x57, 0x98, 0x48, 0x68, 0x4c, 0x90, 0xb6, 0xeb, 0xa4, 0x31, 0x50, 0x1a, 0x04,
+    0x83, 0x81, 0xd0, 0xc6, 0xc6, 0xd6, 0x3d, 0xf0, 0xe8, 0x3a, 0x37, 0xad, 0x99, 0x6b, 0x47, 0xb6,
+    0xdb, 0xd1, 0x9f, 0x60, 0xef, 0xf0, 0x80, 0xf8, 0x04, 0x1e, 0x90, 0x86, 0xc4, 0x37, 0xf0, 0x11,
+    0xfc, 0x00, 0x7c, 0x02, 0xd7, 0x4e, 0xba, 0x26, 0x6b, 0x37, 0x08, 0xdb, 0x9e, 0x9a, 0xc4, 0xf7,
+    0x1c, 0x9f, 0x6b, 0xdf, 0x73, 0xed, 0x46, 0xb7, 0x9e, 0xee, 0x6e, 0x76, 0xdf, 0xec, 0x3d, 0x23,
+    0x03, 0x3b, 0x14, 0xf1, 0x52, 0x34, 0xfd, 0x01, 0x9a, 0xc4, 0x4b, 0x84, 0x44, 0x43, 0xb0, 0x94,
+    0xb0, 0x01, 0xd5, 0x06, 0x6c, 0x27, 0x38, 0xec, 0x6e, 0x85, 0x1b, 0xc1, 0x6c, 0x40, 0xd2, 0x21,
+    0x74, 0x82, 0x31, 0x87, 0xe3, 0x4c, 0x69, 0x1b, 0x10, 0xa6, 0xa4, 0x05, 0x89, 0x81, 0xc7, 0x3c,
+    0xb1, 0x83, 0x4e, 0x02, 0x63, 0xce, 0x20, 0xf4, 0x2f, 0xf7, 0x08, 0x97, 0xdc, 0x72, 0x2a, 0x42,
+    0xc3, 0xa8, 0x80, 0xce, 0x6a, 0xa3, 0x95, 0x13, 0x59, 0x6e, 0x05, 0xc4, 0xcf, 0x47, 0xdc, 0x52,
+    0x4d, 0x5e, 0x80, 0x56, 0xe4, 0x60, 0x22, 0xed, 0x80, 0x6c, 0x22, 0x97, 0x56, 0x22, 0x6a, 0xe6,
+    0x01, 0x2e, 0x54, 0x70, 0x79, 0x44, 0x34, 0x88, 0x4e, 0x60, 0xec, 0x44, 0x80, 0x19, 0x00, 0xe0,
+    0xa4, 0x03, 0x0d, 0x69, 0x27, 0xa0, 0x59, 0xd6, 0x60, 0xc6, 0x3c, 0x1a, 0x77, 0xd2, 0x84, 0x32,
+    0xb6, 0xd6, 0x4b, 0x5b, 0x69, 0x7a, 0x1f, 0xa7, 0x88, 0x9a, 0x79, 0x32, 0x51, 0x4f, 0x25, 0x13,
+    0x4f, 0x93, 0xf0, 0x31, 0x61, 0x82, 0x1a, 0xd3, 0x09, 0x9c, 0x60, 0xca, 0x25, 0x68, 0xaf, 0xa5,
+    0x3a, 0xe6, 0x60, 0x67, 0x03, 0x38, 0x34, 0x58, 0x8d, 0x7f, 0x7f, 0x7a, 0x7f, 0x4a, 0x2e, 0x91,
+    0x8a, 0x21, 0xd3, 0xe8, 0x6c, 0xfa, 0x84, 0xcf, 0x26, 0xa3, 0x72, 0xca, 0x6a, 0x2c, 0xb5, 0x23,
+    0x13, 0x72, 0x99, 0x70, 0x46, 0xad, 0xd2, 0x01, 0xe1, 0xc9, 0xf4, 0x6b, 0x10, 0x47, 0x4d, 0x17,
+    0x7b, 0x1e, 0x3a, 0x8b, 0xe8, 0xc2, 0x3b, 0x1b, 0xc4, 0x38, 0x9f, 0x04, 0x66, 0xb9, 0xec, 0x37,
+    0x1a, 0x8d, 0x2a, 0x24, 0x6a, 0x16, 0x13, 0x47, 0x4d, 0x4c, 0x25, 0x5e, 0x9a, 0xcb, 0xaa, 0xaf,
+    0x79, 0x32, 0xcb, 0xe9, 0x56, 0x18, 0x92, 0x57, 0xca, 0x02, 0x79, 0xca, 0x4d, 0x26, 0xe8, 0x84,
+    0x84, 0xe1, 0xd9, 0x58, 0x79, 0x99, 0xa8, 0x9e, 0x81, 0xdc, 0x52, 0xb4, 0xdd, 0x52, 0x7c, 0x25,
+    0x9b, 0x23, 0xad, 0x71, 0xbf, 0x3d, 0x05, 0x66, 0xdf, 0x2e, 0x85, 0x94, 0xd0, 0x12, 0x47, 0xc3,
+    0x24, 0x9f, 0x20, 0x4f, 0xd7, 0x7d, 0x29, 0x66, 0x0c, 0xe2, 0x30, 0x0c, 0x0b, 0xb1, 0xd3, 0x14,
+    0x66, 0xca, 0x0b, 0x89, 0x7b, 0xa0, 0x53, 0xa5, 0x87, 0x54, 0x32, 0xf8, 0x77, 0x85, 0x3f, 0x3f,
+    0x7c, 0x2e, 0x03, 0x2f, 0xd6, 0xc7, 0x65, 0xaa, 0x42, 0xad, 0x8e, 0x4b, 0xf8, 0x73, 0x9b, 0xe6,
+    0x23, 0x04, 0xed, 0x81, 0xc0, 0xc5, 0xdf, 0x3b, 0x24, 0x87, 0x86, 0xf6, 0xe1, 0xe1, 0xf9, 0xcd,
+    0x5a, 0x04, 0x1a, 0x53, 0x31, 0x82, 0x3c, 0x69, 0x96, 0x8d, 0x82, 0xb8, 0x75, 0x7b, 0x6e, 0x8b,
+    0xcb, 0xb9, 0x57, 0x85, 0xa1, 0xc7, 0x4a, 0x05, 0xb8, 0x70, 0x34, 0x4c, 0xb9, 0x10, 0x67, 0xfc,
+    0x3b, 0x1e, 0x40, 0xbc, 0x3b, 0x0a, 0x13, 0x3e, 0x24, 0xad, 0xdb, 0x15, 0x8a, 0x72, 0x51, 0x21,
+    0x24, 0xaf, 0xa8, 0x79, 0x59, 0xf3, 0xc2, 0x2e, 0xd6, 0x59, 0x6f, 0x01, 0x77, 0x60, 0xa8, 0xf4,
+    0xa4, 0xee, 0xea, 0x0d, 0x61, 0x88, 0x32, 0x49, 0x4f, 0x28, 0x76, 0x64, 0x6a, 0xac, 0x61, 0x3d,
+    0x6d, 0xdb, 0x14, 0xfb, 0x17, 0xab, 0x2d, 0x4e, 0xe4, 0x30, 0x27, 0xf0, 0xc7, 0xf7, 0x9b, 0x53,
+    0xd7, 0x55, 0x96, 0x0a, 0x6f, 0x36, 0x53, 0x57, 0xa1, 0x73, 0x1c, 0xf6, 0x97, 0xd6, 0xa5, 0xda,
+    0x16, 0x38, 0x0f, 0x5b, 0x4d, 0xca, 0xfb, 0x23, 0x4d, 0x2d, 0x57, 0xb2, 0x56, 0x77, 0xf8, 0x56,
+    0xc5, 0x5e, 0x97, 0xfd, 0x0e, 0xdc, 0xe9, 0x51, 0x37, 0x7b, 0x7f, 0xe4, 0x14, 0x9d, 0xe6, 0x86,
+    0xf6, 0x66, 0x5f, 0xa9, 0xbc, 0x0f, 0xd6, 0xd5, 0xa6, 0x11, 0x78, 0xb3, 0xd2, 0x76, 0x99, 0xa5,
+    0xe3, 0xda, 0xba, 0x94, 0x47, 0xfd, 0xad, 0x64, 0xae, 0xa2, 0xeb, 0xb1, 0xce, 0xa0, 0xdf, 0xe7,
+    0xee, 0x14, 0xac, 0x2b, 0x8e, 0xea, 0x0c, 0xf3, 0xda, 0xda, 0xaa, 0x5b, 0xce, 0xdb, 0x4a, 0x65,
+    0xa4, 0x30, 0x79, 0x8d, 0x93, 0xe4, 0xe4, 0xcb, 0xaf, 0xd3, 0x93, 0x0a, 0x78, 0x41, 0x39, 0xfb,
+    0x46, 0x80, 0x21, 0x5d, 0x6a, 0x8e, 0xfc, 0x51, 0x7e, 0xb9, 0x94, 0xd7, 0x23, 0xce, 0x8e, 0xa6,
+    0x57, 0x07, 0x53, 0xcb, 0x5a, 0x1f, 0x9d, 0x9a, 0x2a, 0xfe, 0x62, 0x7b, 0xb1, 0x22, 0xa2, 0xba,
+    0x27, 0xbd, 0x91, 0xb5, 0xea, 0x6c, 0x79, 0x7b, 0x56, 0x06, 0x44, 0x49, 0x26, 0x90, 0x12, 0xdd,
+    0x02, 0x32, 0xd9, 0x1c, 0x26, 0x77, 0x96, 0xbd, 0x6d, 0x96, 0xef, 0x91, 0xd6, 0x0a, 0x76, 0x6d,
+    0xfa, 0x56, 0x69, 0x3c, 0x4f, 0xa5, 0x8d, 0x9a, 0x39, 0xf8, 0xff, 0xf9, 0x56, 0x1d, 0x1f, 0x97,
+    0xd7, 0xc6, 0xd7, 0x46, 0xbe, 0x27, 0x58, 0x1b, 0xe6, 0xea, 0x54, 0x6b, 0x48, 0xf5, 0x92, 0x62,
+    0x4d, 0x81, 0x81, 0xff, 0x67, 0xcb, 0xbd, 0x53, 0x64, 0x9a, 0xdb, 0x8f, 0xdc, 0xbd, 0x06, 0xba,
+    0xb0, 0xc4, 0x17, 0xd6, 0xe6, 0xb3, 0xaa, 0xdf, 0x17, 0x80, 0xae, 0xbb, 0xb3, 0xe2, 0xce, 0x12,
+    0xf7, 0x42, 0xf0, 0xad, 0x36, 0x0f, 0x1e, 0xc1, 0xbe, 0xa5, 0x37, 0xf0, 0x2a, 0xae, 0x68, 0xe2,
+    0xd8, 0xf6, 0x21, 0xd5, 0x78, 0x1f, 0x9f, 0xa7, 0x5a, 0xe4, 0x82, 0xca, 0xe3, 0xcc, 0x19, 0x91,
+    0x61, 0x9a, 0x67, 0x96, 0x18, 0xcd, 0xf2, 0xeb, 0xfc, 0x5b, 0x77, 0x9b, 0x87, 0x75, 0x48, 0x7a,
+    0xed, 0x07, 0x1b, 0x14, 0xe8, 0xba, 0xbf, 0x1f, 0xfb, 0x20, 0x77, 0xad, 0xcf, 0xef, 0xf3, 0x58,
+    0xf8, 0xfe, 0x2f, 0xcb, 0x1f, 0x31, 0xdd, 0x2c, 0x30, 0xca, 0x0c, 0x00, 0x00,
+};
+
+// 8462 bytes, 2700 gzipped
+static const WebAsset webAssets[] = {
+    {"/app.css", "text/css", web_app_css, 934, 2422, "\"fdacc3bf0ff7\"", true},
+    {"/app.js", "application/javascript", web_app_js, 905, 2766, "\"e6edb298aea6\"", true},
+    {"/index.html", "text/html", web_index_html, 861, 3274, "\"7338ec8a2480\"", false},
+};
+
+static const size_t webAssetCount = sizeof(webAssets) / sizeof(webAssets[0]);
+
+#endif // OSC_CONTROL_WEB_H
@@ -0,0 +1,139 @@
+/**
+ * Analog Control Conditioning
+ * Smooths a noisy controller axis (whammy, tilt) and rate-limits the
+ * parameter updates it drives
+ *
+ * Each input report just stores the raw value. poll() is called from the
+ * main loop with the current audio block number; it advances a fixed-point
+ * one-pole filter once per block and emits a new output only if the
+ * filtered position moved by more than the hysteresis band since the last
+ * output. Analog noise therefore costs at most one
+ * parameter write per audio block per destination, however fast reports
+ * arrive.
+ *
+ * The rest position is captured from the first report after reset(), so a
+ * guitar connected while held at an angle reads level.
+ *
+ * Header-only and free of Arduino dependencies so the standalone sketch
+ * and host tests can use it too.
+ */
+
+#ifndef ANALOG_CONDITIONER_H
+#define ANALOG_CONDITIONER_H
+
+#include <stdint.h>
+
+#define ANALOG_FULL_SCALE 32767
+
+class AnalogConditioner {
+public:
+    AnalogConditioner() {
+        init(0, 1, 0, 0);
+    }
+
+    // deadzone: raw distance around rest that reads as zero
+    // span: raw distance from rest to full scale
+    // smoothingShift: filter coefficient is 1/2^smoothingShift per block
+    // hysteresis: raw movement needed before a new output is emitted
+    void init(int32_t deadzone, int32_t span, uint8_t smoothingShift, int32_t hysteresis) {
+        this->deadzone = deadzone;
+        this->span = span > deadzone ? span : deadzone + 1;
+        this->smoothingShift = smoothingShift;
+        this->hysteresis = hysteresis;
+        reset();
+    }
+
+    // Forget calibration; the next report becomes the rest position
+    void reset() {
+        calibrated = false;
+        rest = 0;
+        raw = 0;
+        smoothed = 0;
+        value = 0;
+        emittedDeviation = 0;
+        lastBlock = 0;
+        polled = false;
+        samples = 0;
+        emitted = 0;
+    }
+
+    void calibrate(int32_t restValue) {
+        rest = restValue;
+        smoothed = restValue * 256;
+        calibrated = true;
+    }
+
+    // Latest raw reading (call once per input report)
+    void update(int32_t rawValue) {
+        if (!calibrated) calibrate(rawValue);
+        raw = rawValue;
+        samples++;
+    }
+
+    // Advance one step per audio block; true (with the new output in
+    // out) when the conditioned value has moved enough to be worth applying
+    bool poll(uint32_t block, int16_t& out) {
+        if (!calibrated || (polled && block == lastBlock)) return false;
+        lastBlock = block;
+        polled = true;
+
+        // Q8 one-pole low-pass: smoothed += (raw - smoothed) / 2^shift
+        smoothed += (raw * 256 - smoothed) >> smoothingShift;
+
+        int32_t deviation = ((smoothed + 128) >> 8) - rest;
+        int16_t target = shape(deviation);
+        if (target == value) return false;
+
+        // Always land exactly on rest and full scale, otherwise only move
+        // once outside the hysteresis band around the last output
+        int32_t moved = deviation - emittedDeviation;
+        if (moved < 0) moved = -moved;
+        bool endpoint = (target == 0 || target == ANALOG_FULL_SCALE || target == -ANALOG_FULL_SCALE);
+        if (moved <= hysteresis && !endpoint) return false;
+
+        emittedDeviation = deviation;
+        value = target;
+        out = value;
+        emitted++;
+        return true;
+    }
+
+    int16_t getValue() const { return value; }
+    int32_t getRest() const { return rest; }
+    bool isCalibrated() const { return calibrated; }
+
+    // Reports fed vs updates emitted, for the performance report
+    uint32_t getSampleCount() const { return samples; }
+    uint32_t getEmitCount() const { return emitted; }
+    void clearCounts() { samples = 0; emitted = 0; }
+
+private:
+    int32_t deadzone;
+    int32_t span;
+    uint8_t smoothingShift;
+    int32_t hysteresis;
+
+    bool calibrated;
+    int32_t rest;
+    int32_t raw;
+    int32_t smoothed;     // Q8
+    int16_t value;        // Last emitted output
+    int32_t emittedDeviation;  // Raw deviation it was computed from
+    uint32_t lastBlock;
+    bool polled;
+    uint32_t samples;
+    uint32_t emitted;
+
+    // Deviation from rest -> signed output, zero inside the deadzone and
+    // rising continuously from its edge
+    int16_t shape(int32_t deviation) const {
+        int32_t magnitude = deviation < 0 ? -deviation : deviation;
+        if (magnitude <= deadzone) return 0;
+
+        int32_t scaled = (int32_t)((int64_t)(magnitude - deadzone) * ANALOG_FULL_SCALE / (span - deadzone));
+        if (scaled > ANALOG_FULL_SCALE) scaled = ANALOG_FULL_SCALE;
+        return (int16_t)(deviation < 0 ? -scaled : scaled);
+    }
+};
+
+#endif // ANALOG_CONDITIONER_H
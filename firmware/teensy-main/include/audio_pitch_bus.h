@@ -0,0 +1,156 @@
+/**
+ * Per-Voice Pitch Bus
+ * Audio-rate pitch offset for one oscillator, in log-pitch units
+ * (PITCH_UNITS_PER_OCTAVE), rendered into the oscillator's frequency
+ * modulation input
+ *
+ * Four sources are summed every sample in the log domain:
+ *   glide    - slides to a target over a time (portamento, scale glides)
+ *   bend     - whammy bend, ramped across a block so it never zippers
+ *   vibrato  - sine LFO from a small table
+ *   detune   - fixed offset (chorus/supersaw spread)
+ * The modulated oscillator then turns the sum into its phase increment
+ * every sample, so glides and vibrato are smooth and their speed doesn't
+ * depend on how often loop() gets round to them. The control side only
+ * sets targets.
+ *
+ * Patch each bus into input 0 of its AudioSynthWaveformModulated and set
+ * frequencyModulation(PITCH_BUS_OCTAVES) on the oscillator. Declare the
+ * buses before the oscillators so they update first.
+ *
+ * Header-only so the standalone sketch can use it as well.
+ */
+
+#ifndef AUDIO_PITCH_BUS_H
+#define AUDIO_PITCH_BUS_H
+
+#include <Arduino.h>
+#include <AudioStream.h>
+#include <math.h>
+#include "tuning.h"
+
+#define PITCH_BUS_OCTAVES 4   // Full-scale modulation range, each direction
+#define PITCH_BUS_UNITS_PER_LSB (PITCH_UNITS_PER_OCTAVE * PITCH_BUS_OCTAVES / 32768)
+#define PITCH_BUS_SINE_SIZE 256
+
+// Cents -> pitch units
+#define PITCH_CENTS(c) ((int32_t)((c) * PITCH_UNITS_PER_OCTAVE / 1200))
+
+class AudioPitchBus : public AudioStream {
+public:
+    AudioPitchBus() : AudioStream(0, NULL) {
+        glide = 0;
+        glideTarget = 0;
+        glideStep = 0;
+        bend = 0;
+        bendTarget = 0;
+        detune = 0;
+        vibratoDepth = 0;
+        vibratoPhase = 0;
+        vibratoIncrement = 0;
+        sineTable();  // Build the shared table before the audio interrupt can
+    }
+
+    // Slide to pitch over milliseconds, linearly in log pitch
+    void glideTo(int32_t pitch, float milliseconds) {
+        int32_t goal = pitch * 256;  // Q8 for sub-unit steps
+        int32_t samples = (int32_t)(milliseconds * (AUDIO_SAMPLE_RATE_EXACT / 1000.0f));
+
+        __disable_irq();
+        glideTarget = goal;
+        if (samples <= 0) {
+            glide = goal;
+            glideStep = 0;
+        } else {
+            glideStep = (goal - glide) / samples;
+            if (glideStep == 0) glideStep = (goal > glide) ? 1 : -1;
+        }
+        __enable_irq();
+    }
+
+    void jumpTo(int32_t pitch) { glideTo(pitch, 0.0f); }
+
+    void setBend(int32_t pitch) { bendTarget = pitch; }
+    void setDetune(int32_t pitch) { detune = pitch; }
+
+    void setVibrato(float rateHz, int32_t depth) {
+        __disable_irq();
+        vibratoIncrement = (uint32_t)(rateHz * (4294967296.0f / AUDIO_SAMPLE_RATE_EXACT));
+        vibratoDepth = depth;
+        __enable_irq();
+    }
+
+    int32_t getPitch() const { return glide / 256; }
+    int32_t getTarget() const { return glideTarget / 256; }
+
+    virtual void update(void) {
+        int32_t bendGoal = bendTarget;
+
+        // All sources at rest: send nothing, the oscillator runs unmodulated
+        if (glide == 0 && glideTarget == 0 && bend == 0 && bendGoal == 0 &&
+            detune == 0 && vibratoDepth == 0) return;
+
+        audio_block_t* block = allocate();
+        if (!block) return;
+
+        const int16_t* sine = sineTable();
+        int32_t value = glide;
+        int32_t goal = glideTarget;
+        int32_t step = glideStep;
+        int32_t bendStart = bend;
+        int32_t bendDelta = bendGoal - bendStart;
+        int32_t offset = detune;
+        int32_t depth = vibratoDepth;
+        uint32_t phase = vibratoPhase;
+        uint32_t increment = vibratoIncrement;
+
+        for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+            if (value != goal) {
+                value += step;
+                if ((step > 0 && value > goal) || (step < 0 && value < goal)) value = goal;
+            }
+
+            int32_t pitch = value / 256 + offset + bendStart + bendDelta * (i + 1) / AUDIO_BLOCK_SAMPLES;
+            if (depth) {
+                pitch += (depth * sine[phase >> 24]) >> 15;
+                phase += increment;
+            }
+
+            int32_t sample = pitch / PITCH_BUS_UNITS_PER_LSB;
+            if (sample > 32767) sample = 32767;
+            if (sample < -32768) sample = -32768;
+            block->data[i] = sample;
+        }
+        glide = value;
+        bend = bendGoal;
+        vibratoPhase = phase;
+
+        transmit(block);
+        release(block);
+    }
+
+private:
+    volatile int32_t glide;         // Q8 pitch units
+    volatile int32_t glideTarget;
+    volatile int32_t glideStep;     // Per sample
+    int32_t bend;                   // Reached at the end of the last block
+    volatile int32_t bendTarget;
+    volatile int32_t detune;
+    volatile int32_t vibratoDepth;  // Peak pitch units
+    uint32_t vibratoPhase;
+    volatile uint32_t vibratoIncrement;
+
+    static const int16_t* sineTable() {
+        static int16_t table[PITCH_BUS_SINE_SIZE];
+        static bool built = false;
+        if (!built) {
+            for (int i = 0; i < PITCH_BUS_SINE_SIZE; i++) {
+                table[i] = (int16_t)(sinf(i * (6.2831853f / PITCH_BUS_SINE_SIZE)) * 32767.0f);
+            }
+            built = true;
+        }
+        return table;
+    }
+};
+
+#endif // AUDIO_PITCH_BUS_H
@@ -0,0 +1,103 @@
+/**
+ * Sample-Accurate Note Scheduling
+ *
+ * AudioNoteScheduler keeps a running sample clock and fires queued
+ * note-ons from inside the audio update, in the block that contains their
+ * sample position. AudioEffectOnsetGate sits after each voice envelope and
+ * holds the block silent up to the exact onset sample, then fades in over
+ * ONSET_RAMP_SAMPLES so the start is click-free. A voice restruck while
+ * still sounding doesn't drop to zero: the last sample it played fades
+ * out over the same ramp, across the silence and the new note's fade-in.
+ *
+ * Teensy runs update() in construction order: declare the scheduler
+ * before the voices so a note fired this block is rendered this block.
+ */
+
+#ifndef AUDIO_SCHEDULER_H
+#define AUDIO_SCHEDULER_H
+
+#include <Arduino.h>
+#include <AudioStream.h>
+#include "config.h"
+
+class AudioEffectOnsetGate : public AudioStream {
+public:
+    AudioEffectOnsetGate() : AudioStream(1, inputQueueArray) {
+        pendingOffset = -1;
+        rampPos = ONSET_RAMP_SAMPLES;
+        lastOut = 0;
+        tail = 0;
+        tailPos = ONSET_RAMP_SAMPLES;
+    }
+
+    // Open at sample offset within the block about to be rendered.
+    // Called from the audio update (AudioNoteScheduler).
+    void openAt(uint16_t offset) {
+        pendingOffset = offset;
+    }
+
+    virtual void update(void);
+
+private:
+    audio_block_t* inputQueueArray[1];
+    volatile int16_t pendingOffset;  // -1 = no onset this block
+    uint16_t rampPos;                // ONSET_RAMP_SAMPLES = fully open
+    int16_t lastOut;                 // Last sample sent, where a restrike fades from
+    int16_t tail;                    // Level fading out after a restrike
+    uint16_t tailPos;                // ONSET_RAMP_SAMPLES = faded out
+};
+
+// Applies a due event to the audio objects of one voice
+typedef void (*NoteFireFn)(uint8_t voice, float frequency, float amplitude, uint16_t offset);
+
+class AudioNoteScheduler : public AudioStream {
+public:
+    AudioNoteScheduler() : AudioStream(0, NULL) {
+        blockSample = 0;
+        blockMicros = 0;
+        nextSample = 0;
+        fire = nullptr;
+        lateCount = 0;
+        firedCount = 0;
+        for (int i = 0; i < STRUM_MAX_PENDING; i++) events[i].pending = false;
+    }
+
+    void setFireCallback(NoteFireFn fn) { fire = fn; }
+
+    // Sample position corresponding to a micros() timestamp
+    uint32_t sampleAtMicros(uint32_t us);
+
+    // Queue a note-on for voice at an absolute sample position.
+    // Returns false if the queue is full.
+    bool schedule(uint32_t sampleTime, uint8_t voice, float frequency, float amplitude);
+
+    // Drop any pending note-on for voice (note released before its onset)
+    void cancel(uint8_t voice);
+
+    // Audio blocks rendered so far - the control-rate clock
+    uint32_t getBlockCount() const { return nextSample / AUDIO_BLOCK_SAMPLES; }
+
+    uint32_t getFiredCount() const { return firedCount; }
+    uint32_t getLateCount() const { return lateCount; }  // Fired after their sample
+
+    virtual void update(void);
+
+private:
+    struct Event {
+        volatile bool pending;
+        uint32_t sampleTime;
+        uint8_t voice;
+        float frequency;
+        float amplitude;
+    };
+
+    Event events[STRUM_MAX_PENDING];
+    volatile uint32_t blockSample;   // First sample of the latest block rendered
+    volatile uint32_t blockMicros;   // micros() when that block started rendering
+    volatile uint32_t nextSample;    // First sample of the block after it
+    NoteFireFn fire;
+    volatile uint32_t firedCount;
+    volatile uint32_t lateCount;
+};
+
+#endif // AUDIO_SCHEDULER_H
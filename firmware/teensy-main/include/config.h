@@ -13,8 +13,14 @@
 // Audio configuration
 #define AUDIO_SAMPLE_RATE 44100
 #define AUDIO_BLOCK_SIZE 128
-#define NUM_VOICES 6
+#define NUM_VOICES 8
 #define AUDIO_MEMORY_BLOCKS 64
+#define USB_AUDIO_DRY 0          // 1: USB audio's right channel is the dry (pre-effects) mix
+
+// Multi-controller configuration (guitars attached through the USB hub)
+#define NUM_CONTROLLERS 2
+#define VOICE_SHARE_DEFAULT (NUM_VOICES / NUM_CONTROLLERS)  // Guaranteed voices per player
+#define VOICE_LIMIT_DEFAULT 6    // Max voices one player may hold by borrowing
 
 // Performance limits
 #define MAX_CPU_USAGE 80.0f      // Warning threshold
@@ -35,6 +41,9 @@
 #define ESP_RX_PIN 0             // Serial1 RX
 #define ESP_RESET_PIN 2          // ESP8266 reset (optional)
 #define ESP_ENABLE_PIN 3         // ESP8266 chip enable (optional)
+#define ESP_TX_BUFFER_BYTES 256  // Extra Serial1 TX buffer, drained by the UART interrupt
+#define ESP_RX_BUFFER_BYTES 256  // Extra Serial1 RX buffer; sets the credit granted to the ESP
+#define ESP_RX_HARDWARE_BYTES 64 // Serial1's built-in RX buffer
 
 // Status LEDs (optional)
 #define LED_POWER_PIN 13         // Built-in LED
@@ -43,6 +52,10 @@
 
 // SD Card (built into Teensy 4.1)
 #define SD_CS_PIN BUILTIN_SDCARD
+#define HID_CAPTURE_FILE "/capture.ghc"  // Raw HID capture for replay
+#define TUNING_SCL_FILE "/tuning.scl"    // Scala scale loaded with 't'
+#define TUNING_KBM_FILE "/tuning.kbm"    // Optional Scala keyboard map
+#define TUNING_MAX_FILE_SIZE 8192
 
 // Debug serial port
 #define DEBUG_SERIAL Serial
@@ -51,10 +64,33 @@
 // MIDI configuration
 #define MIDI_CHANNEL 1
 #define MIDI_VELOCITY_DEFAULT 100
+#define MIDI_IN_PER_LOOP 16        // USB-MIDI messages read per loop() pass
+#define MIDI_PROBE_INTERVAL_MS 100 // Round-trip probes while measuring ('m')
 
 // Control ranges
 #define WHAMMY_DEADZONE 10       // Ignore small whammy movements
 #define TILT_DEADZONE 1000       // Ignore small tilt changes
+#define WHAMMY_SPAN 255          // Whammy travel from rest to fully pressed
+#define TILT_SPAN 32767          // Tilt travel from level to fully up/down
+#define ANALOG_SMOOTHING_SHIFT 2 // One-pole smoothing, coefficient 1/2^n per audio block
+#define WHAMMY_HYSTERESIS (WHAMMY_DEADZONE / 4)  // Raw movement worth an update
+#define TILT_HYSTERESIS (TILT_DEADZONE / 4)
+#define GLIDE_RANGE_SEMITONES 12 // Full whammy/tilt sweep in scale-glide mode
+#define GLIDE_TIME_MS 40.0f      // Slide time between snapped scale notes
+#define PORTAMENTO_TIME_MS 0.0f  // Default slide between successive notes, 0 = off
+#define PORTAMENTO_MAX_MS 2000
+#define VIBRATO_RATE_HZ 5.0f     // Whammy vibrato
+#define VIBRATO_DEPTH_CENTS 85   // Peak vibrato per semitone of whammy bend
+
+// Strum engine (strummed chords from held frets)
+#define STRUM_SPREAD_US 8000             // Gap between strings on a slow strum
+#define STRUM_FAST_INTERVAL_US 80000     // Strums this close get the tightest spread
+#define STRUM_SLOW_INTERVAL_US 400000    // Strums this far apart get the full spread
+#define STRUM_MIN_SPREAD_PERCENT 25      // Tightest spread, % of STRUM_SPREAD_US
+#define STRUM_UPSTROKE_PERCENT 75        // Up strokes are tighter than down strokes
+#define STRUM_SCHEDULE_LATENCY AUDIO_BLOCK_SIZE  // Samples between report and first onset
+#define STRUM_MAX_PENDING 16             // Scheduled note-ons waiting for their block
+#define ONSET_RAMP_SAMPLES 32            // Fade-in at a scheduled onset
 
 // Timing constants (milliseconds)
 #define CONTROLLER_POLL_RATE 1   // 1ms = 1000Hz polling
@@ -97,10 +133,16 @@
 #define USE_PCM5102A             // Recommended: Simple I2S DAC
 // #define USE_SGTL5000          // Alternative: Audio shield codec
 
-// Controller compatibility modes
+// Controller compatibility modes (selects the profiles in controller_profiles.h)
+#ifndef SUPPORT_XBOX360
 #define SUPPORT_XBOX360 true
-#define SUPPORT_PS3 false        // Future expansion
-#define SUPPORT_WII false        // Future expansion
+#endif
+#ifndef SUPPORT_PS3
+#define SUPPORT_PS3 false        // RedOctane PS3 guitar dongle
+#endif
+#ifndef SUPPORT_WII
+#define SUPPORT_WII false        // Rock Band Wii guitar dongle
+#endif
 
 // Helper macros
 #define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
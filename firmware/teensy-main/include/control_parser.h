@@ -0,0 +1,390 @@
+/**
+ * Web Control Message Parser
+ * Incremental, fixed-buffer reader for the JSON control bodies the web UIs
+ * post to the ESP, e.g. {"command":"setScale","value":3} or {"cmd":"arp"}
+ *
+ * Bytes go in as they arrive, in any chunking, and the command name and
+ * value are written straight into a fixed ControlMessage - no document
+ * tree, no String copies, no heap. Only the flat keys the firmware uses
+ * are kept ("command"/"cmd" and "value"); other keys are skipped, nested
+ * objects and arrays included. Numbers are converted digit by digit
+ * rather than with strtod(), which allocates in newlib.
+ *
+ * Deliberately not a general JSON parser: \u escapes are refused, and a
+ * command name longer than CONTROL_MAX_COMMAND - 1 is an error rather
+ * than silently truncated.
+ *
+ * Header-only so both ESP firmwares and the host tests share it.
+ */
+
+#ifndef CONTROL_PARSER_H
+#define CONTROL_PARSER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define CONTROL_MAX_COMMAND 24  // Including the terminator
+#define CONTROL_MAX_KEY 12      // Longer keys can't be ones we keep
+#define CONTROL_MAX_DEPTH 8     // Nesting skipped inside an ignored value
+
+struct ControlMessage {
+    char command[CONTROL_MAX_COMMAND];
+    float value;
+    bool hasValue;
+};
+
+class ControlParser {
+public:
+    ControlParser() {
+        messages = 0;
+        errors = 0;
+        reset();
+    }
+
+    // Forget any partial message; the next byte starts a new one
+    void reset() {
+        state = PARSE_START;
+        memset(&result, 0, sizeof(result));
+        keyLen = 0;
+        field = FIELD_NONE;
+        commandLen = 0;
+        depth = 0;
+    }
+
+    // Feed one byte. Returns true when it completes a message; the result
+    // stays readable until the next byte. Whitespace between messages is
+    // ignored and a '{' after a complete one starts the next.
+    bool push(char c) {
+        switch (state) {
+            case PARSE_START:
+            case PARSE_DONE:
+                if (isSpace(c)) return false;
+                if (c != '{') return fail();
+                if (state == PARSE_DONE) reset();
+                state = PARSE_KEY_OR_END;
+                return false;
+
+            case PARSE_KEY_OR_END:
+            case PARSE_KEY:
+                if (isSpace(c)) return false;
+                if (c == '}' && state == PARSE_KEY_OR_END) return finish();
+                if (c != '"') return fail();
+                keyLen = 0;
+                state = PARSE_KEY_TEXT;
+                return false;
+
+            case PARSE_KEY_TEXT:
+                if (c == '"') {
+                    key[keyLen < CONTROL_MAX_KEY ? keyLen : CONTROL_MAX_KEY - 1] = 0;
+                    field = keyLen < CONTROL_MAX_KEY ? fieldFor(key) : FIELD_NONE;
+                    state = PARSE_COLON;
+                } else if (c == '\\') {
+                    return fail();  // Our keys never need escapes
+                } else if (keyLen < CONTROL_MAX_KEY) {
+                    key[keyLen++] = c;
+                } else {
+                    keyLen = CONTROL_MAX_KEY;  // Too long to be one of ours
+                }
+                return false;
+
+            case PARSE_COLON:
+                if (isSpace(c)) return false;
+                if (c != ':') return fail();
+                state = PARSE_VALUE;
+                return false;
+
+            case PARSE_VALUE:
+                return startValue(c);
+
+            case PARSE_STRING:
+                return stringByte(c);
+
+            case PARSE_STRING_ESCAPE:
+                return escapeByte(c);
+
+            case PARSE_NUMBER:
+                return numberByte(c);
+
+            case PARSE_LITERAL:
+                return literalByte(c);
+
+            case PARSE_SKIP:
+                return skipByte(c);
+
+            case PARSE_AFTER_VALUE:
+                if (isSpace(c)) return false;
+                if (c == ',') {
+                    state = PARSE_KEY;
+                    return false;
+                }
+                if (c == '}') return finish();
+                return fail();
+
+            case PARSE_ERROR:
+            default:
+                return false;
+        }
+    }
+
+    // Feed a chunk; returns true if a message completed within it. Stops
+    // at the first complete message, so one per call (count in *used).
+    bool push(const char* data, size_t len, size_t* used = NULL) {
+        for (size_t i = 0; i < len; i++) {
+            if (push(data[i])) {
+                if (used) *used = i + 1;
+                return true;
+            }
+        }
+        if (used) *used = len;
+        return false;
+    }
+
+    bool isComplete() const { return state == PARSE_DONE; }
+    bool hasError() const { return state == PARSE_ERROR; }
+    const ControlMessage& message() const { return result; }
+
+    uint32_t getMessageCount() const { return messages; }
+    uint32_t getErrorCount() const { return errors; }
+
+private:
+    enum ParseState {
+        PARSE_START,
+        PARSE_KEY_OR_END,      // After '{': a key or an empty object
+        PARSE_KEY,             // After ',': a key
+        PARSE_KEY_TEXT,
+        PARSE_COLON,
+        PARSE_VALUE,
+        PARSE_STRING,
+        PARSE_STRING_ESCAPE,
+        PARSE_NUMBER,
+        PARSE_LITERAL,         // true / false / null
+        PARSE_SKIP,            // Inside an ignored object or array
+        PARSE_AFTER_VALUE,
+        PARSE_DONE,
+        PARSE_ERROR
+    };
+
+    enum Field {
+        FIELD_NONE,
+        FIELD_COMMAND,
+        FIELD_VALUE
+    };
+
+    static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+    static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    static Field fieldFor(const char* name) {
+        if (strcmp(name, "command") == 0 || strcmp(name, "cmd") == 0) return FIELD_COMMAND;
+        if (strcmp(name, "value") == 0) return FIELD_VALUE;
+        return FIELD_NONE;
+    }
+
+    bool fail() {
+        state = PARSE_ERROR;
+        errors++;
+        return false;
+    }
+
+    bool finish() {
+        state = PARSE_DONE;
+        messages++;
+        return true;
+    }
+
+    bool startValue(char c) {
+        if (isSpace(c)) return false;
+
+        if (c == '"') {
+            if (field == FIELD_COMMAND) commandLen = 0;
+            state = PARSE_STRING;
+        } else if (c == '-' || isDigit(c)) {
+            numberNegative = c == '-';
+            numberWhole = isDigit(c) ? c - '0' : 0;
+            numberDigits = isDigit(c) ? 1 : 0;
+            numberFraction = 0;
+            numberScale = 1;
+            numberExponent = 0;
+            numberExponentNegative = false;
+            numberPhase = NUMBER_WHOLE;
+            state = PARSE_NUMBER;
+        } else if (c == 't' || c == 'f' || c == 'n') {
+            literal = c == 't' ? "true" : c == 'f' ? "false" : "null";
+            literalPos = 1;
+            state = PARSE_LITERAL;
+        } else if (c == '{' || c == '[') {
+            if (field != FIELD_NONE) return fail();  // Ours are never nested
+            depth = 1;
+            skipInString = false;
+            skipEscape = false;
+            state = PARSE_SKIP;
+        } else {
+            return fail();
+        }
+        return false;
+    }
+
+    bool stringByte(char c) {
+        if (c == '"') {
+            if (field == FIELD_COMMAND) result.command[commandLen] = 0;
+            state = PARSE_AFTER_VALUE;
+            return false;
+        }
+        if (c == '\\') {
+            state = PARSE_STRING_ESCAPE;
+            return false;
+        }
+        if ((uint8_t)c < 0x20) return fail();
+        return keepStringByte(c);
+    }
+
+    bool escapeByte(char c) {
+        char out;
+        switch (c) {
+            case '"':
+            case '\\':
+            case '/':
+                out = c;
+                break;
+            case 'n': out = '\n'; break;
+            case 't': out = '\t'; break;
+            case 'r': out = '\r'; break;
+            case 'b': out = '\b'; break;
+            case 'f': out = '\f'; break;
+            default:
+                return fail();  // \u and anything unknown
+        }
+        state = PARSE_STRING;
+        return keepStringByte(out);
+    }
+
+    bool keepStringByte(char c) {
+        if (field == FIELD_COMMAND) {
+            if (commandLen >= CONTROL_MAX_COMMAND - 1) return fail();
+            result.command[commandLen++] = c;
+        } else if (field == FIELD_VALUE) {
+            return fail();  // "value" must be a number or boolean
+        }
+        return false;
+    }
+
+    bool numberByte(char c) {
+        if (isDigit(c)) {
+            uint8_t digit = c - '0';
+            if (numberPhase == NUMBER_WHOLE) {
+                numberWhole = numberWhole * 10 + digit;
+            } else if (numberPhase == NUMBER_FRACTION) {
+                if (numberScale < 1e9) {  // Past float precision anyway
+                    numberFraction = numberFraction * 10 + digit;
+                    numberScale *= 10;
+                }
+            } else {
+                if (numberExponent < 100) numberExponent = numberExponent * 10 + digit;
+                numberPhase = NUMBER_EXPONENT;
+            }
+            numberDigits++;
+            return false;
+        }
+
+        if (c == '.' && numberPhase == NUMBER_WHOLE && numberDigits > 0) {
+            numberPhase = NUMBER_FRACTION;
+            return false;
+        }
+        if ((c == 'e' || c == 'E') && numberPhase <= NUMBER_FRACTION && numberDigits > 0) {
+            numberPhase = NUMBER_EXPONENT_SIGN;
+            return false;
+        }
+        if ((c == '+' || c == '-') && numberPhase == NUMBER_EXPONENT_SIGN) {
+            numberExponentNegative = c == '-';
+            numberPhase = NUMBER_EXPONENT;
+            return false;
+        }
+
+        // Anything else ends the number and is read as what follows it
+        if (numberDigits == 0 || numberPhase == NUMBER_EXPONENT_SIGN) return fail();
+        if (field == FIELD_VALUE) {
+            double value = numberWhole + numberFraction / numberScale;
+            for (uint8_t i = 0; i < numberExponent; i++) {
+                value = numberExponentNegative ? value / 10 : value * 10;
+            }
+            result.value = (float)(numberNegative ? -value : value);
+            result.hasValue = true;
+        } else if (field == FIELD_COMMAND) {
+            return fail();
+        }
+        state = PARSE_AFTER_VALUE;
+        return push(c);
+    }
+
+    bool literalByte(char c) {
+        if (literal[literalPos] != 0) {
+            if (c != literal[literalPos++]) return fail();
+            return false;
+        }
+
+        // Whole literal matched
+        if (field == FIELD_VALUE && literal[0] != 'n') {
+            result.value = literal[0] == 't' ? 1.0f : 0.0f;
+            result.hasValue = true;
+        } else if (field == FIELD_COMMAND && literal[0] != 'n') {
+            return fail();
+        }
+        state = PARSE_AFTER_VALUE;
+        return push(c);
+    }
+
+    bool skipByte(char c) {
+        if (skipInString) {
+            if (skipEscape) skipEscape = false;
+            else if (c == '\\') skipEscape = true;
+            else if (c == '"') skipInString = false;
+            return false;
+        }
+        if (c == '"') {
+            skipInString = true;
+        } else if (c == '{' || c == '[') {
+            if (++depth > CONTROL_MAX_DEPTH) return fail();
+        } else if (c == '}' || c == ']') {
+            if (--depth == 0) state = PARSE_AFTER_VALUE;
+        }
+        return false;
+    }
+
+    enum NumberPhase {
+        NUMBER_WHOLE,
+        NUMBER_FRACTION,
+        NUMBER_EXPONENT_SIGN,
+        NUMBER_EXPONENT
+    };
+
+    ParseState state;
+    ControlMessage result;
+
+    char key[CONTROL_MAX_KEY];
+    uint8_t keyLen;
+    Field field;
+    uint8_t commandLen;
+
+    // Number being read
+    bool numberNegative;
+    double numberWhole;
+    double numberFraction;
+    double numberScale;
+    uint8_t numberExponent;
+    bool numberExponentNegative;
+    uint8_t numberDigits;
+    NumberPhase numberPhase;
+
+    const char* literal;
+    uint8_t literalPos;
+
+    // Ignored nested value
+    uint8_t depth;
+    bool skipInString;
+    bool skipEscape;
+
+    uint32_t messages;
+    uint32_t errors;
+};
+
+#endif // CONTROL_PARSER_H
@@ -0,0 +1,240 @@
+/**
+ * Controller Profiles
+ * VID/PID-keyed table of guitar report layouts
+ *
+ * Each layout is a traits struct of byte offsets and bit positions.
+ * decodeReport<Layout>() is instantiated once per layout, so every
+ * offset and mask is a compile-time constant and the decode is a straight
+ * run of loads, shifts and masks with no per-field branches.
+ */
+
+#ifndef CONTROLLER_PROFILES_H
+#define CONTROLLER_PROFILES_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Xbox 360 Guitar Hero Controller USB IDs
+#define XBOX360_VID 0x1430  // RedOctane (Guitar Hero)
+#define XBOX360_PID_GH_GUITAR 0x4748  // Guitar Hero guitar
+#define XBOX360_PID_GH_XPLORER 0x474C  // X-plorer guitar
+#define MSFT_VID 0x045E               // Microsoft
+#define MSFT_PID_XBOX360 0x028E       // Wired Xbox 360 controller
+
+// PS3 / Wii USB guitar dongles
+#define PS3_GH_VID 0x12BA             // Sony (RedOctane PS3 guitars)
+#define PS3_GH_PID_GUITAR 0x0100      // Guitar Hero PS3 guitar
+#define WII_RB_VID 0x1BAD             // Harmonix (Rock Band Wii)
+#define WII_RB_PID_GUITAR 0x0004      // Rock Band Wii guitar
+
+// HID Report structure for Guitar Hero controllers
+struct GHControllerState {
+    // Fret buttons
+    bool greenFret;   // A button
+    bool redFret;     // B button
+    bool yellowFret;  // Y button
+    bool blueFret;    // X button
+    bool orangeFret;  // LB button
+
+    // Strum bar
+    bool strumUp;     // D-pad up
+    bool strumDown;   // D-pad down
+
+    // Control buttons
+    bool starPower;   // Back button
+    bool plusButton;  // Start button
+    bool minusButton; // Xbox button
+
+    // D-pad (for navigation)
+    bool dpadUp;
+    bool dpadDown;
+    bool dpadLeft;
+    bool dpadRight;
+
+    // Analog controls
+    uint8_t whammyBar;       // 0-255 (0 = not pressed, 255 = fully pressed)
+    uint8_t pickupSelector;  // 0-2 (3 positions)
+    int16_t tiltX;          // -32768 to 32767 (accelerometer X)
+    int16_t tiltY;          // -32768 to 32767 (accelerometer Y)
+
+    // Raw button state for debugging
+    uint16_t buttonsRaw;
+};
+
+// Analog field encodings
+enum AxisKind {
+    AXIS_U8 = 0,      // 0..255, centre 128
+    AXIS_S16LE,       // Signed 16-bit little-endian
+    AXIS_U10LE        // 10-bit accelerometer, centre 512
+};
+
+// Decode a report of at least minLength bytes into state
+typedef void (*ControllerDecodeFn)(const uint8_t* data, GHControllerState& state);
+
+struct ControllerProfile {
+    uint16_t vendorID;
+    uint16_t productID;
+    const char* name;
+    uint8_t minLength;
+    ControllerDecodeFn decode;
+};
+
+// ===== Layouts =====
+
+// XInput (wired Xbox 360 / wireless receiver) report:
+//   byte 2-3 buttons: dpad U/D/L/R 0-3, start 4, back 5, LB 8, guide 10,
+//                     A 12, B 13, X 14, Y 15
+//   byte 4 left trigger, 5 right trigger, 6-13 sticks LX/LY/RX/RY (s16)
+// GH guitars put the whammy on right stick X and tilt on right stick Y.
+struct XInputGuitarLayout {
+    static const uint8_t MIN_LENGTH = 14;
+    static const uint8_t BUTTONS_OFFSET = 2;
+    static const bool DPAD_IS_HAT = false;
+    static const uint8_t DPAD_OFFSET = 2;   // Low nibble: U, D, L, R bits
+    static const uint8_t GREEN_BIT = 12;
+    static const uint8_t RED_BIT = 13;
+    static const uint8_t YELLOW_BIT = 15;
+    static const uint8_t BLUE_BIT = 14;
+    static const uint8_t ORANGE_BIT = 8;
+    static const uint8_t STAR_BIT = 5;
+    static const uint8_t PLUS_BIT = 4;
+    static const uint8_t MINUS_BIT = 10;
+    static const uint8_t WHAMMY_OFFSET = 10;
+    static const uint8_t WHAMMY_KIND = AXIS_S16LE;
+    static const uint8_t PICKUP_OFFSET = 4;  // Left trigger
+    static const uint8_t PICKUP_MID = 85;
+    static const uint8_t PICKUP_HIGH = 170;
+    static const uint8_t TILT_X_OFFSET = 12;
+    static const uint8_t TILT_Y_OFFSET = 12;
+    static const uint8_t TILT_KIND = AXIS_S16LE;
+};
+
+// Generic Xbox 360 pad in guitar mode: same button word, but whammy on the
+// right trigger and tilt on the left stick
+struct XInputPadLayout : XInputGuitarLayout {
+    static const uint8_t WHAMMY_OFFSET = 5;
+    static const uint8_t WHAMMY_KIND = AXIS_U8;
+    static const uint8_t TILT_X_OFFSET = 6;
+    static const uint8_t TILT_Y_OFFSET = 8;
+};
+
+// PS3 / Rock Band Wii dongle report:
+//   byte 0-1 buttons: blue 0, green 1, red 2, yellow 3, orange 4,
+//                     select 8, start 9, PS 12
+//   byte 2 hat switch (0 = up, clockwise, 8 = centred)
+//   byte 5 whammy, byte 6 pickup selector, byte 19-20 tilt accelerometer
+struct PS3GuitarLayout {
+    static const uint8_t MIN_LENGTH = 21;
+    static const uint8_t BUTTONS_OFFSET = 0;
+    static const bool DPAD_IS_HAT = true;
+    static const uint8_t DPAD_OFFSET = 2;
+    static const uint8_t GREEN_BIT = 1;
+    static const uint8_t RED_BIT = 2;
+    static const uint8_t YELLOW_BIT = 3;
+    static const uint8_t BLUE_BIT = 0;
+    static const uint8_t ORANGE_BIT = 4;
+    static const uint8_t STAR_BIT = 8;
+    static const uint8_t PLUS_BIT = 9;
+    static const uint8_t MINUS_BIT = 12;
+    static const uint8_t WHAMMY_OFFSET = 5;
+    static const uint8_t WHAMMY_KIND = AXIS_U8;
+    static const uint8_t PICKUP_OFFSET = 6;
+    static const uint8_t PICKUP_MID = 64;
+    static const uint8_t PICKUP_HIGH = 160;
+    static const uint8_t TILT_X_OFFSET = 19;
+    static const uint8_t TILT_Y_OFFSET = 19;
+    static const uint8_t TILT_KIND = AXIS_U10LE;
+};
+
+// ===== Decoder =====
+
+// Hat switch -> U/D/L/R bitmask (same bit order as the XInput dpad nibble)
+static const uint8_t HAT_TO_DPAD[16] = {
+    0x1, 0x9, 0x8, 0xA, 0x2, 0x6, 0x4, 0x5,  // N, NE, E, SE, S, SW, W, NW
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0   // Centred / invalid
+};
+
+template <uint8_t Kind>
+inline int16_t readAxis(const uint8_t* p) {
+    return Kind == AXIS_U8 ? (int16_t)((p[0] - 128) * 256) :
+           Kind == AXIS_S16LE ? (int16_t)(p[0] | (p[1] << 8)) :
+           (int16_t)((((p[0] | (p[1] << 8)) & 0x3FF) - 512) * 64);
+}
+
+template <uint8_t Kind>
+inline uint8_t readWhammy(const uint8_t* p) {
+    // 16-bit axes rest at -32768; keep the top byte, shifted to 0..255
+    return Kind == AXIS_U8 ? p[0] : (uint8_t)((readAxis<Kind>(p) >> 8) + 128);
+}
+
+template <class L>
+void decodeReport(const uint8_t* data, GHControllerState& state) {
+    uint16_t buttons = data[L::BUTTONS_OFFSET] | (data[L::BUTTONS_OFFSET + 1] << 8);
+    uint8_t dpad = L::DPAD_IS_HAT ? HAT_TO_DPAD[data[L::DPAD_OFFSET] & 0x0F]
+                                  : (data[L::DPAD_OFFSET] & 0x0F);
+
+    state.dpadUp = dpad & 0x1;
+    state.dpadDown = (dpad >> 1) & 0x1;
+    state.dpadLeft = (dpad >> 2) & 0x1;
+    state.dpadRight = (dpad >> 3) & 0x1;
+
+    // Strum bar is mapped to D-pad up/down
+    state.strumUp = state.dpadUp;
+    state.strumDown = state.dpadDown;
+
+    state.greenFret = (buttons >> L::GREEN_BIT) & 1;
+    state.redFret = (buttons >> L::RED_BIT) & 1;
+    state.yellowFret = (buttons >> L::YELLOW_BIT) & 1;
+    state.blueFret = (buttons >> L::BLUE_BIT) & 1;
+    state.orangeFret = (buttons >> L::ORANGE_BIT) & 1;
+
+    state.starPower = (buttons >> L::STAR_BIT) & 1;
+    state.plusButton = (buttons >> L::PLUS_BIT) & 1;
+    state.minusButton = (buttons >> L::MINUS_BIT) & 1;
+
+    state.whammyBar = readWhammy<L::WHAMMY_KIND>(data + L::WHAMMY_OFFSET);
+
+    // Comparisons evaluate to 0/1, so three positions need no branches
+    uint8_t pickup = data[L::PICKUP_OFFSET];
+    state.pickupSelector = (pickup > L::PICKUP_MID) + (pickup > L::PICKUP_HIGH);
+
+    state.tiltX = readAxis<L::TILT_KIND>(data + L::TILT_X_OFFSET);
+    state.tiltY = readAxis<L::TILT_KIND>(data + L::TILT_Y_OFFSET);
+
+    state.buttonsRaw = buttons;
+}
+
+// ===== Profile table =====
+
+static const ControllerProfile controllerProfiles[] = {
+#if SUPPORT_XBOX360
+    {XBOX360_VID, XBOX360_PID_GH_GUITAR, "Guitar Hero Guitar",
+     XInputGuitarLayout::MIN_LENGTH, decodeReport<XInputGuitarLayout>},
+    {XBOX360_VID, XBOX360_PID_GH_XPLORER, "Guitar Hero X-plorer",
+     XInputGuitarLayout::MIN_LENGTH, decodeReport<XInputGuitarLayout>},
+    {MSFT_VID, MSFT_PID_XBOX360, "Xbox 360 Controller (Possible GH)",
+     XInputPadLayout::MIN_LENGTH, decodeReport<XInputPadLayout>},
+#endif
+#if SUPPORT_PS3
+    {PS3_GH_VID, PS3_GH_PID_GUITAR, "Guitar Hero PS3 Guitar",
+     PS3GuitarLayout::MIN_LENGTH, decodeReport<PS3GuitarLayout>},
+#endif
+#if SUPPORT_WII
+    {WII_RB_VID, WII_RB_PID_GUITAR, "Rock Band Wii Guitar",
+     PS3GuitarLayout::MIN_LENGTH, decodeReport<PS3GuitarLayout>},
+#endif
+};
+
+#define NUM_CONTROLLER_PROFILES (sizeof(controllerProfiles) / sizeof(controllerProfiles[0]))
+
+// Look up the profile for a device, or nullptr if it isn't supported
+inline const ControllerProfile* findControllerProfile(uint16_t vendorID, uint16_t productID) {
+    for (unsigned i = 0; i < NUM_CONTROLLER_PROFILES; i++) {
+        if (controllerProfiles[i].vendorID == vendorID && controllerProfiles[i].productID == productID) {
+            return &controllerProfiles[i];
+        }
+    }
+    return nullptr;
+}
+
+#endif // CONTROLLER_PROFILES_H
@@ -1,6 +1,6 @@
 /**
  * Guitar Hero Controller USB HID Driver
- * For Xbox 360 Wireless Guitar Hero Controller
+ * For Xbox 360 Guitar Hero Controllers (plus PS3/Wii dongles when enabled)
  *
  * Handles USB enumeration, HID report parsing, and control mapping
  */
@@ -9,45 +9,10 @@
 #define GH_CONTROLLER_H
 
 #include <USBHost_t36.h>
+#include "controller_profiles.h"
+#include "strum_engine.h"
 
-// Xbox 360 Guitar Hero Controller USB IDs
-#define XBOX360_VID 0x1430  // RedOctane (Guitar Hero)
-#define XBOX360_PID_GH_GUITAR 0x4748  // Guitar Hero guitar
-#define XBOX360_PID_GH_XPLORER 0x474C  // X-plorer guitar
-
-// HID Report structure for Xbox 360 Guitar Hero controller
-struct GHControllerState {
-    // Fret buttons
-    bool greenFret;   // A button
-    bool redFret;     // B button
-    bool yellowFret;  // Y button
-    bool blueFret;    // X button
-    bool orangeFret;  // LB button
-
-    // Strum bar
-    bool strumUp;     // D-pad up
-    bool strumDown;   // D-pad down
-
-    // Control buttons
-    bool starPower;   // Back button
-    bool plusButton;  // Start button
-    bool minusButton; // Xbox button
-
-    // D-pad (for navigation)
-    bool dpadUp;
-    bool dpadDown;
-    bool dpadLeft;
-    bool dpadRight;
-
-    // Analog controls
-    uint8_t whammyBar;       // 0-255 (0 = not pressed, 255 = fully pressed)
-    uint8_t pickupSelector;  // 0-2 (3 positions)
-    int16_t tiltX;          // -32768 to 32767 (accelerometer X)
-    int16_t tiltY;          // -32768 to 32767 (accelerometer Y)
-
-    // Raw button state for debugging
-    uint16_t buttonsRaw;
-};
+class HIDCapture;
 
 class GuitarHeroController : public USBHIDInput {
 public:
@@ -67,18 +32,39 @@ public:
     GHControllerState getState() const { return state; }
     void rumble(uint8_t leftMotor, uint8_t rightMotor);
     const char* getControllerName() const { return controllerName; }
+    const ControllerProfile* getProfile() const { return profile; }
     uint16_t getVendorID() const { return vendorID; }
     uint16_t getProductID() const { return productID; }
 
+    // Input timing: micros() when the latest report arrived, and a running
+    // report count so the main loop can tell whether anything new came in
+    uint32_t getReportMicros() const { return reportMicros; }
+    uint32_t getReportCount() const { return reportCount; }
+
+    // Latest strum edge: report timestamp, direction, and a running count
+    uint32_t getStrumMicros() const { return strumMicros; }
+    StrumDirection getStrumDirection() const { return strumDirection; }
+    uint32_t getStrumCount() const { return strumCount; }
+
+    // Capture: mirror every live report into capture, tagged with index
+    void setCapture(HIDCapture* capture, uint8_t index) { this->capture = capture; captureIndex = index; }
+
+    // Feed a report through the same path as live USB input (used by
+    // replay). layout overrides the claimed profile, for reports captured
+    // from another device.
+    bool injectReport(const uint8_t* data, uint16_t len, uint32_t timestampUs,
+                      const ControllerProfile* layout = nullptr);
+
+    // Ignore the guitar's own reports, so a replay has the state to itself
+    void setLiveInput(bool enabled) { liveInput = enabled; }
+
     // Debug functions
     void printRawReport(const uint8_t* data, uint16_t len);
     void printState();
 
 protected:
     void init();
-    bool parseHIDReport(const uint8_t* data, uint16_t len);
-    void updateButtonState(uint16_t buttons);
-    void updateAnalogState(const uint8_t* data);
+    bool parseHIDReport(const uint8_t* data, uint16_t len, const ControllerProfile* layout);
 
 private:
     USBHost* myHost;
@@ -90,6 +76,7 @@ private:
     GHControllerState previousState;
 
     // Device information
+    const ControllerProfile* profile;  // Report layout for this VID/PID
     uint16_t vendorID;
     uint16_t productID;
     char controllerName[64];
@@ -98,23 +85,19 @@ private:
     uint8_t reportBuffer[64];
     uint16_t reportLength;
     bool reportAvailable;
+    volatile uint32_t reportMicros;
+    volatile uint32_t reportCount;
+    volatile uint32_t strumMicros;
+    volatile uint32_t strumCount;
+    volatile StrumDirection strumDirection;
+
+    // Optional raw report capture
+    HIDCapture* capture;
+    uint8_t captureIndex;
+    volatile bool liveInput;
 
     // Rumble output report
     uint8_t rumbleData[8];
-
-    // Button mapping (Xbox 360 format)
-    static const uint16_t BUTTON_GREEN = 0x0002;   // A
-    static const uint16_t BUTTON_RED = 0x0004;     // B
-    static const uint16_t BUTTON_YELLOW = 0x0008;  // Y
-    static const uint16_t BUTTON_BLUE = 0x0001;    // X
-    static const uint16_t BUTTON_ORANGE = 0x0100;  // LB
-    static const uint16_t BUTTON_STAR = 0x0020;    // Back
-    static const uint16_t BUTTON_PLUS = 0x0010;    // Start
-    static const uint16_t BUTTON_MINUS = 0x0040;   // Xbox Guide
-    static const uint16_t DPAD_UP = 0x0001;
-    static const uint16_t DPAD_DOWN = 0x0002;
-    static const uint16_t DPAD_LEFT = 0x0004;
-    static const uint16_t DPAD_RIGHT = 0x0008;
 };
 
 #endif // GH_CONTROLLER_H
\ No newline at end of file
@@ -0,0 +1,140 @@
+/**
+ * HID Capture and Replay Module
+ * Records raw controller reports with microsecond timestamps and plays
+ * them back through the same input pipeline for benchmarking
+ *
+ * Capture file layout (little-endian):
+ *   header: "GHC1", uint16 version, uint16 record size
+ *   records: uint32 timestampUs, uint8 controller, uint8 length,
+ *            uint16 sequence, uint16 vendorID, uint16 productID,
+ *            uint8 data[HID_CAPTURE_MAX_REPORT]
+ *
+ * The VID/PID pick the report layout on replay, so a capture decodes the
+ * same whichever guitar (if any) is plugged in at the time.
+ *
+ * Storage is reached through read/write callbacks so the same code runs
+ * against SD on the Teensy and against stdio on the host.
+ */
+
+#ifndef HID_CAPTURE_H
+#define HID_CAPTURE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define HID_CAPTURE_MAX_REPORT 64
+#define HID_CAPTURE_RING_SIZE 64     // Records buffered between ISR and loop(), power of two
+#define HID_CAPTURE_VERSION 2      // 2: VID/PID per record
+#define HID_CAPTURE_HEADER_SIZE 8
+#define HID_CAPTURE_RECORD_SIZE (12 + HID_CAPTURE_MAX_REPORT)
+
+struct HIDCaptureRecord {
+    uint32_t timestampUs;    // micros() when the report arrived
+    uint8_t controller;      // Player index
+    uint8_t length;          // Valid bytes in data
+    uint16_t sequence;       // Capture order, gaps mean dropped reports
+    uint16_t vendorID;       // The device that sent it
+    uint16_t productID;
+    uint8_t data[HID_CAPTURE_MAX_REPORT];
+};
+
+// Storage callbacks - return the number of bytes transferred
+typedef size_t (*HIDCaptureWriteFn)(void* ctx, const uint8_t* data, size_t len);
+typedef size_t (*HIDCaptureReadFn)(void* ctx, uint8_t* data, size_t len);
+
+// Called by HIDReplay for every record that is due
+typedef void (*HIDReplaySink)(void* ctx, const HIDCaptureRecord& record);
+
+// Record (de)serialization
+void hidCaptureEncode(const HIDCaptureRecord& record, uint8_t* out);
+bool hidCaptureDecode(const uint8_t* in, HIDCaptureRecord& record);
+size_t hidCaptureWriteHeader(HIDCaptureWriteFn write, void* ctx);
+bool hidCaptureReadHeader(HIDCaptureReadFn read, void* ctx);
+
+// FNV-1a, used to fingerprint a replay's note output
+inline uint32_t hidCaptureHash(uint32_t hash, const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+#define HID_CAPTURE_HASH_SEED 2166136261u
+
+class HIDCapture {
+public:
+    HIDCapture();
+
+    void begin();
+    void end();
+    bool isActive() const { return active; }
+
+    // Queue one report. Safe to call from the USB host interrupt; drops
+    // the report (and counts it) if loop() has fallen behind.
+    void record(uint8_t controller, uint16_t vendorID, uint16_t productID,
+                const uint8_t* data, uint16_t len, uint32_t timestampUs);
+
+    // Write queued records to storage from loop(). Returns records written.
+    uint16_t drain(HIDCaptureWriteFn write, void* ctx);
+
+    uint32_t getRecorded() const { return recorded; }
+    uint32_t getDropped() const { return dropped; }
+
+private:
+    HIDCaptureRecord ring[HID_CAPTURE_RING_SIZE];
+    volatile uint16_t head;  // Written by record()
+    volatile uint16_t tail;  // Written by drain()
+    volatile bool active;
+    uint16_t sequence;
+    uint32_t recorded;
+    uint32_t dropped;
+};
+
+class HIDReplay {
+public:
+    enum Mode {
+        REPLAY_REALTIME = 0,  // Honour the captured inter-report timing
+        REPLAY_FAST           // Deliver records back to back
+    };
+
+    HIDReplay();
+
+    // Validate the header and prime the first record
+    bool begin(HIDCaptureReadFn read, void* ctx, Mode mode, uint32_t nowUs);
+    void end() { active = false; }
+    bool isActive() const { return active; }
+    Mode getMode() const { return mode; }
+
+    // Deliver every record that is due at nowUs (one per call in fast
+    // mode). Returns the number delivered; the replay ends at end of file.
+    uint16_t poll(uint32_t nowUs, HIDReplaySink sink, void* sinkCtx);
+
+    uint32_t getDelivered() const { return delivered; }
+    uint32_t getSequenceGaps() const { return sequenceGaps; }
+
+    // When record arrived on the replay's clock: the start time plus its
+    // offset into the capture. Timing a replayed report by this rather
+    // than by when loop() got to it makes strums come out the same every
+    // run, in either mode.
+    uint32_t replayTimeUs(const HIDCaptureRecord& record) const {
+        return startUs + (record.timestampUs - firstCaptureUs);
+    }
+
+private:
+    HIDCaptureReadFn read;
+    void* readCtx;
+    Mode mode;
+    bool active;
+    bool havePending;
+    HIDCaptureRecord pending;
+    uint32_t firstCaptureUs;
+    uint32_t startUs;
+    uint16_t lastSequence;
+    uint32_t delivered;
+    uint32_t sequenceGaps;
+
+    bool fetch();
+};
+
+#endif // HID_CAPTURE_H
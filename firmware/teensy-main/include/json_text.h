@@ -0,0 +1,53 @@
+/**
+ * JSON Text Helpers
+ * Bounded appends into a fixed char buffer, for the JSON the ESP and the
+ * OSC sketch build without the heap (status_cache.h, state_push.h,
+ * loop_scheduler.h)
+ *
+ * Each call appends at len and advances it, or returns false once the
+ * text would no longer fit in max (including its terminator), so a
+ * formatter can chain calls with && and give up at the first failure.
+ *
+ * Header-only so the ESP firmware, the OSC sketch and the host tests
+ * share it.
+ */
+
+#ifndef JSON_TEXT_H
+#define JSON_TEXT_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+// printf-style append
+__attribute__((format(printf, 4, 5)))
+inline bool jsonAppend(char* out, size_t max, size_t& len, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(out + len, max - len, format, args);
+    va_end(args);
+    if (n < 0 || (size_t)n >= max - len) return false;
+    len += n;
+    return true;
+}
+
+// A JSON string value, quoted, with quotes, backslashes and control
+// characters escaped
+inline bool jsonAppendString(char* out, size_t max, size_t& len, const char* value) {
+    if (max - len < 2) return false;
+    out[len++] = '"';
+    for (; *value; value++) {
+        unsigned char c = *value;
+        if (c == '"' || c == '\\') {
+            if (!jsonAppend(out, max, len, "\\%c", c)) return false;
+        } else if (c < 0x20) {
+            if (!jsonAppend(out, max, len, "\\u%04x", c)) return false;
+        } else {
+            if (max - len < 2) return false;
+            out[len++] = c;
+        }
+    }
+    return jsonAppend(out, max, len, "\"");
+}
+
+#endif // JSON_TEXT_H
@@ -0,0 +1,215 @@
+/**
+ * Link Flow Control and Health
+ * Credit-based backpressure and round-trip monitoring for one end of the
+ * Teensy <-> ESP link
+ *
+ * Credit: each side tells the other, in LinkCredit frames, how many bytes
+ * it has read off its UART so far and how many more its receive buffer
+ * can hold. The sender only starts a frame when it fits in what is left,
+ * so a busy receiver (the ESP serving a web page, the Teensy in a long
+ * loop) makes the sender queue - where lanes and drop policies apply -
+ * instead of overrunning a UART buffer and losing bytes. Grants are
+ * cumulative, so a lost one is made good by the next; they are repeated
+ * every LINK_CREDIT_INTERVAL_MS even when nothing arrives.
+ *
+ * A side that has never heard a grant, or has heard nothing for
+ * LINK_CREDIT_TIMEOUT_MS while waiting, sends without limit: the peer
+ * may not speak flow control at all (the standalone sketches), or has
+ * restarted and will grant again once it is up.
+ *
+ * Health: periodic LinkPing/LinkPong give the round-trip time and lost
+ * probes; credit stalls and timeouts, and receive overruns the firmware
+ * reports, are counted alongside.
+ *
+ * Header-only so both firmwares and the host tests share it.
+ */
+
+#ifndef LINK_FLOW_H
+#define LINK_FLOW_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "link_protocol.h"
+
+#define LINK_CREDIT_INTERVAL_MS 100   // Grant at least this often
+#define LINK_CREDIT_TIMEOUT_MS 500    // Waiting this long for a grant: stop enforcing
+#define LINK_PING_INTERVAL_MS 1000
+#define LINK_RX_HEADROOM 32           // Receive buffer kept back for credit/ping frames
+#define LINK_CREDIT_UNLIMITED 0xFFFF
+
+class LinkFlow {
+public:
+    // rxCapacity: bytes this side's UART can hold unread
+    explicit LinkFlow(uint16_t rxCapacity) {
+        window = rxCapacity > LINK_RX_HEADROOM ? rxCapacity - LINK_RX_HEADROOM : 0;
+        sent = 0;
+        peerConsumed = 0;
+        skew = 0;
+        peerWindow = 0;
+        granted = false;
+        stalled = false;
+        stallStartMs = 0;
+        consumed = 0;
+        grantedConsumed = 0;
+        lastGrantMs = 0;
+        grantsSent = 0;
+        pingSequence = 0;
+        lastPingMs = 0;
+        awaitingPong = false;
+        pingsSent = 0;
+        pingsLost = 0;
+        pongsReceived = 0;
+        rttUs = 0;
+        rttMinUs = 0;
+        rttMaxUs = 0;
+        rttAvgUs = 0;
+        creditStalls = 0;
+        creditTimeouts = 0;
+        overruns = 0;
+    }
+
+    // ---- Sending: what the peer lets us put on the wire
+
+    // Bytes that may start going out now
+    size_t credit() const {
+        if (!granted) return LINK_CREDIT_UNLIMITED;
+        uint32_t inFlight = sent - peerConsumed;
+        return inFlight >= peerWindow ? 0 : peerWindow - inFlight;
+    }
+
+    // Bytes handed to the UART, credited or not
+    void charge(size_t bytes) { sent += bytes; }
+
+    // A frame is waiting for credit. After LINK_CREDIT_TIMEOUT_MS of that
+    // the peer is presumed gone and sending goes unlimited until it
+    // grants again.
+    void stall(uint32_t nowMs) {
+        if (!stalled) {
+            stalled = true;
+            stallStartMs = nowMs;
+            creditStalls++;
+        } else if (nowMs - stallStartMs >= LINK_CREDIT_TIMEOUT_MS) {
+            granted = false;
+            stalled = false;
+            creditTimeouts++;
+        }
+    }
+
+    void onCredit(const LinkCredit& credit) {
+        // Peer's count in our numbering. On the first grant (or the first
+        // after a timeout) the two counts have never been compared; debug
+        // text on a shared UART (the ESP's) counts there but was never
+        // charged here; a peer that restarted counts from zero again. In
+        // each case line the counts up and treat nothing as in flight.
+        uint32_t theirs = credit.consumed - skew;
+        if (!granted || (int32_t)(theirs - sent) > 0 || (int32_t)(theirs - peerConsumed) < 0) {
+            skew = credit.consumed - sent;
+            theirs = sent;
+        }
+        peerConsumed = theirs;
+        peerWindow = credit.window;
+        granted = true;
+        stalled = false;
+    }
+
+    // ---- Receiving: what we let the peer send
+
+    // Bytes read off the UART
+    void received(size_t bytes) { consumed += bytes; }
+
+    // A grant is worth sending: the first one, a quarter of the window
+    // freed, or the periodic refresh
+    bool creditDue(uint32_t nowMs) const {
+        return grantsSent == 0 || consumed - grantedConsumed >= window / 4 ||
+               nowMs - lastGrantMs >= LINK_CREDIT_INTERVAL_MS;
+    }
+
+    LinkCredit grant(uint32_t nowMs) {
+        LinkCredit credit;
+        credit.consumed = consumed;
+        credit.window = window;
+        grantedConsumed = consumed;
+        lastGrantMs = nowMs;
+        grantsSent++;
+        return credit;
+    }
+
+    // ---- Health
+
+    bool pingDue(uint32_t nowMs) const { return nowMs - lastPingMs >= LINK_PING_INTERVAL_MS; }
+
+    LinkPing ping(uint32_t nowMs, uint32_t nowUs) {
+        LinkPing message;
+        message.sequence = ++pingSequence;
+        message.stampUs = nowUs;
+        lastPingMs = nowMs;
+        if (awaitingPong) pingsLost++;  // Previous probe never came back
+        awaitingPong = true;
+        pingsSent++;
+        return message;
+    }
+
+    static LinkPong pong(const LinkPing& ping) {
+        LinkPong message;
+        message.sequence = ping.sequence;
+        message.stampUs = ping.stampUs;
+        return message;
+    }
+
+    void onPong(const LinkPong& pong, uint32_t nowUs) {
+        if (!awaitingPong || pong.sequence != pingSequence) return;  // Late answer to an older probe
+        awaitingPong = false;
+        pongsReceived++;
+        rttUs = nowUs - pong.stampUs;
+        if (pongsReceived == 1 || rttUs < rttMinUs) rttMinUs = rttUs;
+        if (rttUs > rttMaxUs) rttMaxUs = rttUs;
+        rttAvgUs = pongsReceived == 1 ? rttUs : rttAvgUs + ((int32_t)(rttUs - rttAvgUs) >> 3);
+    }
+
+    // The firmware found its receive buffer overrun (bytes lost)
+    void overrun() { overruns++; }
+
+    bool isGranted() const { return granted; }
+    uint16_t getWindow() const { return window; }
+    uint32_t getRttUs() const { return rttUs; }
+    uint32_t getRttMinUs() const { return rttMinUs; }
+    uint32_t getRttMaxUs() const { return rttMaxUs; }
+    uint32_t getRttAvgUs() const { return rttAvgUs; }   // Running average, 1/8 weight
+    uint32_t getPingsLost() const { return pingsLost; }
+    uint32_t getGrantsSent() const { return grantsSent; }
+    uint32_t getCreditStalls() const { return creditStalls; }
+    uint32_t getCreditTimeouts() const { return creditTimeouts; }
+    uint32_t getOverruns() const { return overruns; }
+
+private:
+    uint16_t window;          // Advertised to the peer
+    uint32_t sent;
+    uint32_t peerConsumed;    // In our numbering
+    uint32_t skew;            // Peer's numbering minus ours
+    uint16_t peerWindow;
+    bool granted;
+    bool stalled;
+    uint32_t stallStartMs;
+
+    uint32_t consumed;
+    uint32_t grantedConsumed;
+    uint32_t lastGrantMs;
+    uint32_t grantsSent;
+
+    uint16_t pingSequence;
+    uint32_t lastPingMs;
+    bool awaitingPong;
+    uint32_t pingsSent;
+    uint32_t pingsLost;
+    uint32_t pongsReceived;
+    uint32_t rttUs;
+    uint32_t rttMinUs;
+    uint32_t rttMaxUs;
+    uint32_t rttAvgUs;
+
+    uint32_t creditStalls;
+    uint32_t creditTimeouts;
+    uint32_t overruns;
+};
+
+#endif // LINK_FLOW_H
@@ -0,0 +1,389 @@
+/**
+ * Teensy <-> ESP Serial Link Protocol
+ * One message catalogue shared by the Teensy firmware, the ESP firmware
+ * and the standalone sketches
+ *
+ * Frame on the wire:
+ *   0x00 COBS( type, payload, crc16 ) 0x00
+ *
+ * COBS removes every zero from the frame so 0x00 only ever marks a frame
+ * boundary. The leading zero closes off anything else that was on the
+ * line (boot messages, debug prints, noise), so the frame after it always
+ * decodes; an empty frame between two zeros is simply skipped. The CRC (CRC-16/CCITT-FALSE, little-endian) covers type and
+ * payload. Most payloads are fixed-size packed structs per type, so
+ * decoding is a length check and a memcpy - no text parsing on either
+ * side. The shared-state deltas and note batches (link_state.h) are the
+ * only variable-length payloads. Both MCUs are little-endian, and so is
+ * the payload layout.
+ *
+ * Header-only and free of Arduino dependencies so every firmware and the
+ * host tests compile the same definitions.
+ */
+
+#ifndef LINK_PROTOCOL_H
+#define LINK_PROTOCOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define LINK_MAX_PAYLOAD 32
+#define LINK_MAX_RAW (1 + LINK_MAX_PAYLOAD + 2)   // Type + payload + CRC
+#define LINK_MAX_FRAME (LINK_MAX_RAW + 3)         // COBS overhead + delimiters
+#define LINK_VARIABLE -2   // linkPayloadSize() of a variable-length type
+
+enum LinkMessageType {
+    // Teensy -> ESP
+    LINK_MSG_STATE = 1,      // Shared-state delta (variable, link_state.h)
+    LINK_MSG_NOTES,          // Note event batch (variable, link_state.h)
+
+    // ESP -> Teensy
+    LINK_MSG_COMMAND = 0x40, // LinkCommand
+    LINK_MSG_SET_PARAM,      // LinkSetParam
+    LINK_MSG_STATE_ACK,      // LinkStateAck
+
+    // Either direction, link housekeeping (link_flow.h)
+    LINK_MSG_CREDIT = 0x70,  // LinkCredit
+    LINK_MSG_PING,           // LinkPing
+    LINK_MSG_PONG            // LinkPong
+};
+
+enum LinkCommandId {
+    LINK_CMD_RESYNC = 1,     // Send the whole shared state again
+    LINK_CMD_TOGGLE_ARP,
+    LINK_CMD_SAVE_PRESET
+};
+
+// Ranges and names in linkParamInfo(); append only, ids are on the wire
+enum LinkParamId {
+    LINK_PARAM_SCALE = 1,   // Scale index
+    LINK_PARAM_ROOT,        // Root note 0-11
+    LINK_PARAM_OCTAVE,      // Octave shift, absolute
+    LINK_PARAM_REVERB,      // Mix 0-100
+    LINK_PARAM_DELAY,       // Mix 0-100
+    LINK_PARAM_FILTER,      // Cutoff Hz
+    LINK_PARAM_PORTAMENTO,  // Slide time ms, 0 = off
+
+    // The rest of SynthParams
+    LINK_PARAM_WAVEFORM,    // WAVEFORM_* index
+    LINK_PARAM_DETUNE,      // Cents
+    LINK_PARAM_PULSE_WIDTH, // 0-1
+    LINK_PARAM_ATTACK,      // ms
+    LINK_PARAM_DECAY,       // ms
+    LINK_PARAM_SUSTAIN,     // Level 0-1
+    LINK_PARAM_RELEASE,     // ms
+    LINK_PARAM_RESONANCE,   // Filter Q
+    LINK_PARAM_FILTER_ENV,  // Envelope to filter amount 0-1
+    LINK_PARAM_DELAY_TIME,  // ms
+    LINK_PARAM_LFO_RATE,    // Hz
+    LINK_PARAM_LFO_DEPTH,   // 0-1
+    LINK_PARAM_LFO_TARGET,  // 0 = pitch, 1 = filter, 2 = amplitude
+    LINK_NUM_PARAMS
+};
+
+struct LinkCommand {
+    enum { TYPE = LINK_MSG_COMMAND };
+    uint8_t command;        // LinkCommandId
+} __attribute__((packed));
+
+struct LinkSetParam {
+    enum { TYPE = LINK_MSG_SET_PARAM };
+    uint8_t param;          // LinkParamId
+    float value;
+} __attribute__((packed));
+
+// Receiver has applied state up to this generation
+struct LinkStateAck {
+    enum { TYPE = LINK_MSG_STATE_ACK };
+    uint16_t generation;
+} __attribute__((packed));
+
+// Receive-side flow control: total bytes read off the UART so far, and
+// how many more may be outstanding beyond that
+struct LinkCredit {
+    enum { TYPE = LINK_MSG_CREDIT };
+    uint32_t consumed;
+    uint16_t window;
+} __attribute__((packed));
+
+// Round-trip probe; the peer echoes it back as a LinkPong
+struct LinkPing {
+    enum { TYPE = LINK_MSG_PING };
+    uint16_t sequence;
+    uint32_t stampUs;       // Sender's clock, only meaningful to the sender
+} __attribute__((packed));
+
+struct LinkPong {
+    enum { TYPE = LINK_MSG_PONG };
+    uint16_t sequence;
+    uint32_t stampUs;
+} __attribute__((packed));
+
+// What a parameter accepts. name is how OSC (/synth/<name>) and the web
+// UI ("set<name>", any case) address it.
+struct LinkParamInfo {
+    const char* name;
+    float min;
+    float max;
+    bool integer;           // Whole numbers only; values are rounded
+};
+
+// NULL for an unknown id
+inline const LinkParamInfo* linkParamInfo(uint8_t param) {
+    static const LinkParamInfo params[LINK_NUM_PARAMS] = {
+        {NULL, 0, 0, false},
+        {"scale", 0, 5, true},           // NUM_SCALES - 1
+        {"root", 0, 11, true},
+        {"octave", -2, 2, true},
+        {"reverb", 0, 100, false},
+        {"delay", 0, 100, false},
+        {"filter", 20, 20000, false},
+        {"portamento", 0, 2000, false},  // PORTAMENTO_MAX_MS
+        {"waveform", 0, 12, true},       // Up to WAVEFORM_BANDLIMIT_PULSE
+        {"detune", 0, 50, false},
+        {"pulsewidth", 0, 1, false},
+        {"attack", 0, 11880, false},     // AudioEffectEnvelope's longest
+        {"decay", 0, 11880, false},
+        {"sustain", 0, 1, false},
+        {"release", 0, 11880, false},
+        {"resonance", 0.7f, 5, false},
+        {"filterenv", 0, 1, false},
+        {"delaytime", 0, 500, false},
+        {"lforate", 0, 20, false},
+        {"lfodepth", 0, 1, false},
+        {"lfotarget", 0, 2, true}
+    };
+    return param > 0 && param < LINK_NUM_PARAMS ? &params[param] : NULL;
+}
+
+// Fit a value to a parameter's range (rounding integer ones). False for
+// an unknown id or a value that isn't a number.
+inline bool linkParamClamp(uint8_t param, float value, float& out) {
+    const LinkParamInfo* info = linkParamInfo(param);
+    if (!info || value != value) return false;  // NaN
+    if (value < info->min) value = info->min;
+    if (value > info->max) value = info->max;
+    if (info->integer) value = (float)(long)(value + (value < 0 ? -0.5f : 0.5f));
+    out = value;
+    return true;
+}
+
+// FNV-1a, usable in case labels
+constexpr uint32_t linkParamHash(const char* name, uint32_t hash = 2166136261u) {
+    return *name ? linkParamHash(name + 1, (hash ^ (uint8_t)*name) * 16777619u) : hash;
+}
+
+// Parameter id for a name, 0 if none. One hash and one compare: the
+// switch is built from the names at compile time, and two names hashing
+// alike would be a duplicate case label, so the compiler rejects it.
+inline uint8_t linkParamFind(const char* name) {
+    uint8_t param;
+    switch (linkParamHash(name)) {
+        case linkParamHash("scale"):      param = LINK_PARAM_SCALE; break;
+        case linkParamHash("root"):       param = LINK_PARAM_ROOT; break;
+        case linkParamHash("octave"):     param = LINK_PARAM_OCTAVE; break;
+        case linkParamHash("reverb"):     param = LINK_PARAM_REVERB; break;
+        case linkParamHash("delay"):      param = LINK_PARAM_DELAY; break;
+        case linkParamHash("filter"):     param = LINK_PARAM_FILTER; break;
+        case linkParamHash("portamento"): param = LINK_PARAM_PORTAMENTO; break;
+        case linkParamHash("waveform"):   param = LINK_PARAM_WAVEFORM; break;
+        case linkParamHash("detune"):     param = LINK_PARAM_DETUNE; break;
+        case linkParamHash("pulsewidth"): param = LINK_PARAM_PULSE_WIDTH; break;
+        case linkParamHash("attack"):     param = LINK_PARAM_ATTACK; break;
+        case linkParamHash("decay"):      param = LINK_PARAM_DECAY; break;
+        case linkParamHash("sustain"):    param = LINK_PARAM_SUSTAIN; break;
+        case linkParamHash("release"):    param = LINK_PARAM_RELEASE; break;
+        case linkParamHash("resonance"):  param = LINK_PARAM_RESONANCE; break;
+        case linkParamHash("filterenv"):  param = LINK_PARAM_FILTER_ENV; break;
+        case linkParamHash("delaytime"):  param = LINK_PARAM_DELAY_TIME; break;
+        case linkParamHash("lforate"):    param = LINK_PARAM_LFO_RATE; break;
+        case linkParamHash("lfodepth"):   param = LINK_PARAM_LFO_DEPTH; break;
+        case linkParamHash("lfotarget"):  param = LINK_PARAM_LFO_TARGET; break;
+        default: return 0;
+    }
+    // Anything else with the same hash
+    return strcmp(linkParamInfo(param)->name, name) == 0 ? param : 0;
+}
+
+// Payload bytes for a message type: LINK_VARIABLE for 1..LINK_MAX_PAYLOAD
+// bytes, -1 if the type is unknown
+inline int linkPayloadSize(uint8_t type) {
+    switch (type) {
+        case LINK_MSG_STATE:     return LINK_VARIABLE;
+        case LINK_MSG_NOTES:     return LINK_VARIABLE;
+        case LINK_MSG_COMMAND:   return sizeof(LinkCommand);
+        case LINK_MSG_SET_PARAM: return sizeof(LinkSetParam);
+        case LINK_MSG_STATE_ACK: return sizeof(LinkStateAck);
+        case LINK_MSG_CREDIT:    return sizeof(LinkCredit);
+        case LINK_MSG_PING:      return sizeof(LinkPing);
+        case LINK_MSG_PONG:      return sizeof(LinkPong);
+        default:                 return -1;
+    }
+}
+
+inline uint16_t linkCrc16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF) {
+    // Polynomial 0x1021 a byte at a time, without a table
+    while (len--) {
+        crc = (uint16_t)((crc >> 8) | (crc << 8));
+        crc ^= *data++;
+        crc ^= (crc & 0xFF) >> 4;
+        crc ^= (uint16_t)(crc << 12);
+        crc ^= (uint16_t)((crc & 0xFF) << 5);
+    }
+    return crc;
+}
+
+// COBS-encode len bytes into out (len + len/254 + 1 bytes at most, no
+// delimiter). Returns the encoded length.
+inline size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out) {
+    size_t codePos = 0;
+    size_t pos = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[codePos] = code;
+            codePos = pos++;
+            code = 1;
+        } else {
+            out[pos++] = in[i];
+            if (++code == 0xFF) {
+                out[codePos] = code;
+                codePos = pos++;
+                code = 1;
+            }
+        }
+    }
+    out[codePos] = code;
+    return pos;
+}
+
+// Decode a COBS block (without its delimiter). Returns the decoded length,
+// 0 if the block is malformed.
+inline size_t cobsDecode(const uint8_t* in, size_t len, uint8_t* out) {
+    size_t pos = 0;
+    size_t outPos = 0;
+
+    while (pos < len) {
+        uint8_t code = in[pos++];
+        if (code == 0 || pos + code - 1 > len) return 0;
+        for (uint8_t i = 1; i < code; i++) {
+            if (in[pos] == 0) return 0;
+            out[outPos++] = in[pos++];
+        }
+        if (code != 0xFF && pos < len) out[outPos++] = 0;
+    }
+    return outPos;
+}
+
+// Build a complete frame, delimiters included. frame needs LINK_MAX_FRAME
+// bytes. Returns the frame length, 0 for an unknown type or a size the
+// type doesn't allow.
+inline size_t linkEncode(uint8_t type, const void* payload, size_t size, uint8_t* frame) {
+    int expected = linkPayloadSize(type);
+    if (expected == -1) return 0;
+    if (expected == LINK_VARIABLE ? (size == 0 || size > LINK_MAX_PAYLOAD) : size != (size_t)expected) return 0;
+
+    uint8_t raw[LINK_MAX_RAW];
+    raw[0] = type;
+    memcpy(raw + 1, payload, size);
+    uint16_t crc = linkCrc16(raw, 1 + size);
+    raw[1 + size] = crc & 0xFF;
+    raw[2 + size] = crc >> 8;
+
+    frame[0] = 0;
+    size_t len = 1 + cobsEncode(raw, 3 + size, frame + 1);
+    frame[len++] = 0;
+    return len;
+}
+
+template <typename T>
+inline size_t linkEncode(const T& message, uint8_t* frame) {
+    return linkEncode(T::TYPE, &message, sizeof(T), frame);
+}
+
+// Byte-at-a-time frame receiver. Feed every received byte to push(); it
+// returns true when a frame has been completed and checked, after which
+// type(), payload() and payloadLength() are valid until the next push().
+class LinkDecoder {
+public:
+    LinkDecoder() {
+        reset();
+        frameCount = 0;
+        crcErrors = 0;
+        framingErrors = 0;
+    }
+
+    void reset() {
+        length = 0;
+        overflow = false;
+        rawType = 0;
+        rawLength = 0;
+    }
+
+    bool push(uint8_t byte) {
+        if (byte != 0) {
+            if (length < sizeof(buffer)) {
+                buffer[length++] = byte;
+            } else {
+                overflow = true;  // Too long for any message; drop to the next zero
+            }
+            return false;
+        }
+
+        // Delimiter: decode whatever arrived since the last one
+        size_t encoded = length;
+        bool tooLong = overflow;
+        length = 0;
+        overflow = false;
+        if (encoded == 0) return false;  // Back-to-back delimiters are fine
+
+        size_t decoded = tooLong ? 0 : cobsDecode(buffer, encoded, raw);
+        int size = decoded ? linkPayloadSize(raw[0]) : -1;
+        if (size == LINK_VARIABLE && decoded > 3) size = decoded - 3;
+        if (size < 0 || decoded != (size_t)size + 3) {
+            framingErrors++;
+            return false;
+        }
+
+        uint16_t crc = raw[decoded - 2] | (raw[decoded - 1] << 8);
+        if (linkCrc16(raw, decoded - 2) != crc) {
+            crcErrors++;
+            return false;
+        }
+
+        rawType = raw[0];
+        rawLength = size;
+        frameCount++;
+        return true;
+    }
+
+    uint8_t type() const { return rawType; }
+    const uint8_t* payload() const { return raw + 1; }
+    size_t payloadLength() const { return rawLength; }
+
+    // Copy the payload out as its message struct; false on a type mismatch
+    template <typename T>
+    bool get(T& message) const {
+        if (rawType != T::TYPE) return false;
+        memcpy(&message, raw + 1, sizeof(T));
+        return true;
+    }
+
+    uint32_t getFrameCount() const { return frameCount; }
+    uint32_t getCrcErrors() const { return crcErrors; }
+    uint32_t getFramingErrors() const { return framingErrors; }  // Bad COBS, length or type
+
+private:
+    uint8_t buffer[LINK_MAX_RAW + 1];  // Encoded frame, delimiter excluded
+    uint8_t raw[LINK_MAX_RAW];
+    size_t length;
+    bool overflow;
+    uint8_t rawType;
+    size_t rawLength;
+    uint32_t frameCount;
+    uint32_t crcErrors;
+    uint32_t framingErrors;
+};
+
+#endif // LINK_PROTOCOL_H
@@ -0,0 +1,373 @@
+/**
+ * Shared Synth State over the ESP Link
+ * Versioned state model the Teensy keeps and the ESP mirrors, sent as
+ * deltas, plus batching of note events
+ *
+ * Every change the Teensy sends gets a new generation number. A delta
+ * carries only the fields that changed since the generation the ESP last
+ * acknowledged (plus any sent since then, in case an unacknowledged
+ * change was reverted), with absolute values, so applying one twice or
+ * after a lost frame is harmless. Unacknowledged deltas are retried. An
+ * ESP that has no state yet (boot, reconnect) asks for a resync and gets
+ * every field.
+ *
+ * STATE payload:  uint16 generation, uint16 baseGeneration (0 = full),
+ *                 uint16 field mask, then each masked field in field order
+ * NOTES payload:  uint8 count, then count x {note, velocity (0 = off), player}
+ *
+ * Header-only so the Teensy firmware, the ESP firmware and the sketches
+ * share it.
+ */
+
+#ifndef LINK_STATE_H
+#define LINK_STATE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "link_protocol.h"
+
+#define LINK_STATE_HISTORY 8         // Unacknowledged generations remembered
+#define LINK_STATE_RETRY_MS 250      // Resend an unacknowledged delta after
+#define LINK_NOTE_BATCH_MS 10        // Note events collected per frame
+#define LINK_NOTES_PER_BATCH ((LINK_MAX_PAYLOAD - 1) / 3)
+
+// Fields are sent in declaration order; keep linkStateFields in step
+struct LinkState {
+    uint8_t connected;
+    uint8_t scale;
+    uint8_t root;           // 0-11
+    int8_t octave;
+    uint8_t arp;
+    uint8_t voices;         // Sounding
+    uint16_t cpuTenths;     // AudioProcessorUsage() x 10
+    uint16_t memBlocks;     // AudioMemoryUsage()
+    uint32_t totalNotes;
+    uint32_t loopMaxUs;
+};
+
+enum LinkStateField {
+    LINK_FIELD_CONNECTED = 0,
+    LINK_FIELD_SCALE,
+    LINK_FIELD_ROOT,
+    LINK_FIELD_OCTAVE,
+    LINK_FIELD_ARP,
+    LINK_FIELD_VOICES,
+    LINK_FIELD_CPU,
+    LINK_FIELD_MEM,
+    LINK_FIELD_TOTAL_NOTES,
+    LINK_FIELD_LOOP_MAX,
+    LINK_NUM_FIELDS
+};
+
+#define LINK_FIELDS_ALL ((1 << LINK_NUM_FIELDS) - 1)
+#define LINK_STATE_HEADER 6
+
+struct LinkStateFieldInfo {
+    uint8_t offset;
+    uint8_t size;
+};
+
+inline const LinkStateFieldInfo& linkStateField(uint8_t field) {
+    static const LinkStateFieldInfo fields[LINK_NUM_FIELDS] = {
+        {offsetof(LinkState, connected), 1},
+        {offsetof(LinkState, scale), 1},
+        {offsetof(LinkState, root), 1},
+        {offsetof(LinkState, octave), 1},
+        {offsetof(LinkState, arp), 1},
+        {offsetof(LinkState, voices), 1},
+        {offsetof(LinkState, cpuTenths), 2},
+        {offsetof(LinkState, memBlocks), 2},
+        {offsetof(LinkState, totalNotes), 4},
+        {offsetof(LinkState, loopMaxUs), 4}
+    };
+    return fields[field];
+}
+
+// Fields whose values differ between two states
+inline uint16_t linkStateDiff(const LinkState& a, const LinkState& b) {
+    uint16_t mask = 0;
+    for (uint8_t f = 0; f < LINK_NUM_FIELDS; f++) {
+        const LinkStateFieldInfo& info = linkStateField(f);
+        if (memcmp((const uint8_t*)&a + info.offset, (const uint8_t*)&b + info.offset, info.size) != 0) {
+            mask |= 1 << f;
+        }
+    }
+    return mask;
+}
+
+// Generation a is newer than b (wrapping 16-bit counters)
+inline bool linkGenerationAfter(uint16_t a, uint16_t b) {
+    return (int16_t)(a - b) > 0;
+}
+
+// Teensy side: tracks the current state and builds the deltas
+class LinkStateSender {
+public:
+    LinkStateSender() {
+        memset(&current, 0, sizeof(current));
+        memset(&acked, 0, sizeof(acked));
+        memset(&lastSent, 0, sizeof(lastSent));
+        generation = 0;
+        ackedGeneration = 0;
+        pendingMask = 0;
+        lastSentMs = 0;
+        fullPending = true;
+        historyCount = 0;
+        deltaCount = 0;
+        retryCount = 0;
+        bytesSent = 0;
+    }
+
+    // Set fields here; poll() works out what changed
+    LinkState& state() { return current; }
+
+    // Receiver confirmed it has applied generation
+    void ack(uint16_t gen) {
+        for (uint8_t i = 0; i < historyCount; i++) {
+            if (history[i].generation != gen) continue;
+            acked = history[i].state;
+            ackedGeneration = gen;
+
+            // Anything sent after gen is still unconfirmed
+            pendingMask = 0;
+            for (uint8_t j = 0; j < historyCount; j++) {
+                if (linkGenerationAfter(history[j].generation, gen)) pendingMask |= history[j].mask;
+            }
+            return;
+        }
+    }
+
+    // Receiver lost its copy: the next delta carries every field
+    void resync() {
+        ackedGeneration = 0;
+        fullPending = true;
+    }
+
+    bool isSynced() const { return ackedGeneration != 0 && ackedGeneration == generation; }
+
+    // Fill payload (LINK_MAX_PAYLOAD bytes) with a STATE delta if one is
+    // due: the state changed since the last delta, a resync was asked
+    // for, or the last delta is unacknowledged for LINK_STATE_RETRY_MS.
+    // Returns the payload length, 0 if nothing needs sending.
+    size_t poll(uint32_t nowMs, uint8_t* payload) {
+        bool changed = fullPending || linkStateDiff(current, lastSent) != 0;
+        bool retry = ackedGeneration != generation && nowMs - lastSentMs >= LINK_STATE_RETRY_MS;
+        if (!changed && !retry) return 0;
+
+        uint16_t mask;
+        if (ackedGeneration == 0) {
+            mask = LINK_FIELDS_ALL;
+        } else {
+            mask = linkStateDiff(acked, current) | pendingMask;
+        }
+
+        if (changed) {
+            generation++;
+            if (generation == 0) generation = 1;  // 0 means "no state"
+            remember(generation, current, mask);
+            pendingMask |= mask;
+            lastSent = current;
+            fullPending = false;
+            deltaCount++;
+        } else {
+            retryCount++;
+        }
+        lastSentMs = nowMs;
+
+        size_t len = encode(payload, mask);
+        bytesSent += len;
+        return len;
+    }
+
+    uint16_t getGeneration() const { return generation; }
+    uint16_t getAckedGeneration() const { return ackedGeneration; }
+    uint32_t getDeltaCount() const { return deltaCount; }
+    uint32_t getRetryCount() const { return retryCount; }
+    uint32_t getBytesSent() const { return bytesSent; }
+
+private:
+    struct Entry {
+        uint16_t generation;
+        uint16_t mask;
+        LinkState state;
+    };
+
+    void remember(uint16_t gen, const LinkState& state, uint16_t mask) {
+        if (historyCount == LINK_STATE_HISTORY) {
+            memmove(history, history + 1, sizeof(Entry) * (LINK_STATE_HISTORY - 1));
+            historyCount--;
+        }
+        history[historyCount].generation = gen;
+        history[historyCount].mask = mask;
+        history[historyCount].state = state;
+        historyCount++;
+    }
+
+    size_t encode(uint8_t* payload, uint16_t mask) const {
+        memcpy(payload, &generation, 2);
+        memcpy(payload + 2, &ackedGeneration, 2);
+        memcpy(payload + 4, &mask, 2);
+        size_t pos = LINK_STATE_HEADER;
+        for (uint8_t f = 0; f < LINK_NUM_FIELDS; f++) {
+            if (!(mask & (1 << f))) continue;
+            const LinkStateFieldInfo& info = linkStateField(f);
+            memcpy(payload + pos, (const uint8_t*)&current + info.offset, info.size);
+            pos += info.size;
+        }
+        return pos;
+    }
+
+    LinkState current;
+    LinkState acked;       // As of ackedGeneration
+    LinkState lastSent;
+    uint16_t generation;
+    uint16_t ackedGeneration;  // 0 = receiver has nothing
+    uint16_t pendingMask;      // Fields sent since the acknowledged generation
+    uint32_t lastSentMs;
+    bool fullPending;
+    Entry history[LINK_STATE_HISTORY];
+    uint8_t historyCount;
+    uint32_t deltaCount;
+    uint32_t retryCount;
+    uint32_t bytesSent;
+};
+
+// ESP side: applies deltas to its mirror of the state
+class LinkStateReceiver {
+public:
+    LinkStateReceiver() {
+        memset(&mirror, 0, sizeof(mirror));
+        generation = 0;
+        valid = false;
+        lastMask = 0;
+    }
+
+    // Apply a STATE payload. Returns false if it is malformed or builds on
+    // state this side doesn't have - ask for a resync then.
+    bool apply(const uint8_t* payload, size_t len) {
+        lastMask = 0;
+        if (len < LINK_STATE_HEADER) return false;
+
+        uint16_t gen, base, mask;
+        memcpy(&gen, payload, 2);
+        memcpy(&base, payload + 2, 2);
+        memcpy(&mask, payload + 4, 2);
+
+        if (base == 0) {
+            if (mask != LINK_FIELDS_ALL) return false;
+        } else if (!valid || linkGenerationAfter(base, generation)) {
+            valid = false;
+            return false;
+        }
+
+        // A retry of something already applied changes nothing
+        if (valid && base != 0 && !linkGenerationAfter(gen, generation)) return true;
+
+        LinkState next = mirror;
+        size_t pos = LINK_STATE_HEADER;
+        for (uint8_t f = 0; f < LINK_NUM_FIELDS; f++) {
+            if (!(mask & (1 << f))) continue;
+            const LinkStateFieldInfo& info = linkStateField(f);
+            if (pos + info.size > len) return false;
+            memcpy((uint8_t*)&next + info.offset, payload + pos, info.size);
+            pos += info.size;
+        }
+        if (pos != len) return false;
+
+        lastMask = linkStateDiff(mirror, next) | (valid ? 0 : LINK_FIELDS_ALL);
+        mirror = next;
+        generation = gen;
+        valid = true;
+        return true;
+    }
+
+    // Forget the mirror (link lost); the next delta will fail until a resync
+    void reset() {
+        valid = false;
+        generation = 0;
+    }
+
+    const LinkState& state() const { return mirror; }
+    uint16_t getGeneration() const { return generation; }
+    bool isValid() const { return valid; }
+
+    // Fields whose value the last apply() changed
+    uint16_t getChangedMask() const { return lastMask; }
+
+private:
+    LinkState mirror;
+    uint16_t generation;
+    bool valid;
+    uint16_t lastMask;
+};
+
+struct LinkNoteEvent {
+    uint8_t note;
+    uint8_t velocity;       // 0 = note off
+    uint8_t player;
+};
+
+// Collects note on/offs into one NOTES frame per LINK_NOTE_BATCH_MS window
+class LinkNoteBatcher {
+public:
+    LinkNoteBatcher() {
+        count = 0;
+        firstMs = 0;
+        batchCount = 0;
+        eventCount = 0;
+    }
+
+    bool full() const { return count == LINK_NOTES_PER_BATCH; }
+
+    // Returns false if the batch is full - flush() it first
+    bool add(uint8_t note, uint8_t velocity, uint8_t player, uint32_t nowMs) {
+        if (full()) return false;
+        if (count == 0) firstMs = nowMs;
+        events[count].note = note;
+        events[count].velocity = velocity;
+        events[count].player = player;
+        count++;
+        eventCount++;
+        return true;
+    }
+
+    // Fill payload with the batch once its window has passed (or it is
+    // full). Returns the payload length, 0 if nothing is due.
+    size_t poll(uint32_t nowMs, uint8_t* payload) {
+        if (count == 0 || (!full() && nowMs - firstMs < LINK_NOTE_BATCH_MS)) return 0;
+        return flush(payload);
+    }
+
+    // Fill payload with whatever is collected, due or not
+    size_t flush(uint8_t* payload) {
+        if (count == 0) return 0;
+        payload[0] = count;
+        memcpy(payload + 1, events, count * sizeof(LinkNoteEvent));
+        size_t len = 1 + count * sizeof(LinkNoteEvent);
+        count = 0;
+        batchCount++;
+        return len;
+    }
+
+    uint32_t getBatchCount() const { return batchCount; }
+    uint32_t getEventCount() const { return eventCount; }
+
+private:
+    LinkNoteEvent events[LINK_NOTES_PER_BATCH];
+    uint8_t count;
+    uint32_t firstMs;
+    uint32_t batchCount;
+    uint32_t eventCount;
+};
+
+// Unpack a NOTES payload; returns the event count, 0 if malformed
+inline uint8_t linkNotesDecode(const uint8_t* payload, size_t len, LinkNoteEvent* events) {
+    if (len < 1) return 0;
+    uint8_t count = payload[0];
+    if (count == 0 || count > LINK_NOTES_PER_BATCH || len != 1 + count * sizeof(LinkNoteEvent)) return 0;
+    memcpy(events, payload + 1, count * sizeof(LinkNoteEvent));
+    return count;
+}
+
+#endif // LINK_STATE_H
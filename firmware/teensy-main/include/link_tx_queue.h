@@ -0,0 +1,249 @@
+/**
+ * ESP Link Transmit Queue
+ * Non-blocking outbound queue for link_protocol.h frames, with priority
+ * lanes and credit-based flow control
+ *
+ * Frames are queued whole into one byte ring per lane (length-prefixed
+ * records) and handed to the UART a chunk at a time, never more than the
+ * driver can take without waiting, so loop() never stalls on the link.
+ * The UART's own TX interrupt does the actual draining.
+ *
+ * Lanes, highest priority first:
+ *   link      - credit grants and pings (link_flow.h). Sent even when the
+ *               peer has no credit left, so flow control can't deadlock;
+ *               oldest dropped when full, since the newest supersedes them.
+ *   command   - state changes, commands and replies. Never dropped once
+ *               queued; a full ring refuses new ones.
+ *   notes     - note event batches. Never dropped once queued either.
+ *   telemetry - periodic status. When its ring is full the oldest frames
+ *               are dropped to make room, since only the newest matters.
+ * A frame that has started going out is always finished before the next
+ * one starts, so lanes never interleave on the wire. Given a LinkFlow,
+ * a frame outside the link lane only starts when the peer's credit
+ * covers all of it; until then it waits in its ring.
+ *
+ * Header-only so the ESP firmware queues its side the same way.
+ */
+
+#ifndef LINK_TX_QUEUE_H
+#define LINK_TX_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "link_protocol.h"
+#include "link_flow.h"
+
+// Ring sizes per lane, powers of two
+#ifndef LINK_TX_LINK_BYTES
+#define LINK_TX_LINK_BYTES 64
+#endif
+#ifndef LINK_TX_COMMAND_BYTES
+#define LINK_TX_COMMAND_BYTES 256
+#endif
+#ifndef LINK_TX_NOTE_BYTES
+#define LINK_TX_NOTE_BYTES 128
+#endif
+#ifndef LINK_TX_TELEMETRY_BYTES
+#define LINK_TX_TELEMETRY_BYTES 256
+#endif
+
+enum LinkLane {
+    LINK_LANE_LINK = 0,
+    LINK_LANE_COMMAND,
+    LINK_LANE_NOTES,
+    LINK_LANE_TELEMETRY,
+    LINK_NUM_LANES
+};
+
+class LinkTxQueue {
+public:
+    LinkTxQueue() {
+        rings[LINK_LANE_LINK].init(linkData, sizeof(linkData));
+        rings[LINK_LANE_COMMAND].init(commandData, sizeof(commandData));
+        rings[LINK_LANE_NOTES].init(noteData, sizeof(noteData));
+        rings[LINK_LANE_TELEMETRY].init(telemetryData, sizeof(telemetryData));
+        sendLen = 0;
+        sendPos = 0;
+        waiting = false;
+        bytesQueued = 0;
+        bytesDropped = 0;
+        framesDropped = 0;
+        framesRefused = 0;
+        maxDepth = 0;
+    }
+
+    // Queue a complete frame. Returns false if it can't be queued: a
+    // command or note batch when its ring is full, or any frame larger
+    // than its ring. The link and telemetry lanes make room by dropping
+    // their oldest frames.
+    bool push(const uint8_t* frame, size_t len, LinkLane lane) {
+        Ring& ring = rings[lane];
+        size_t record = len + 1;  // Length prefix
+
+        if (len == 0 || len > LINK_MAX_FRAME || record > ring.size) {
+            bytesDropped += len;
+            framesDropped++;
+            return false;
+        }
+
+        if (ring.free() < record) {
+            if (lane == LINK_LANE_COMMAND || lane == LINK_LANE_NOTES) {
+                // Never thrown away once queued; the caller decides what to do
+                framesRefused++;
+                return false;
+            }
+
+            // Drop the oldest until the new frame fits
+            while (ring.free() < record) {
+                uint8_t oldLen;
+                ring.read(&oldLen, 1);
+                uint8_t discard[LINK_MAX_FRAME];
+                ring.read(discard, oldLen);
+                bytesDropped += oldLen;
+                framesDropped++;
+            }
+        }
+
+        uint8_t prefix = (uint8_t)len;
+        ring.write(&prefix, 1);
+        ring.write(frame, len);
+        bytesQueued += len;
+
+        size_t now = depth();
+        if (now > maxDepth) maxDepth = now;
+        return true;
+    }
+
+    template <typename T>
+    bool send(const T& message, LinkLane lane) {
+        uint8_t frame[LINK_MAX_FRAME];
+        return push(frame, linkEncode(message, frame), lane);
+    }
+
+    // Copy up to max bytes due for transmission into out; returns the
+    // count (0 when idle or waiting for credit). With a flow, frames are
+    // charged to it as they start and wait for its credit.
+    size_t pull(uint8_t* out, size_t max, LinkFlow* flow = NULL, uint32_t nowMs = 0) {
+        size_t count = 0;
+        waiting = false;
+
+        while (count < max) {
+            if (sendPos == sendLen && !startFrame(flow, nowMs)) break;
+
+            size_t n = sendLen - sendPos;
+            if (n > max - count) n = max - count;
+            memcpy(out + count, sending + sendPos, n);
+            sendPos += n;
+            count += n;
+        }
+        return count;
+    }
+
+    bool idle() const {
+        if (sendPos != sendLen) return false;
+        for (int lane = 0; lane < LINK_NUM_LANES; lane++) {
+            if (rings[lane].used) return false;
+        }
+        return true;
+    }
+
+    // Queue bytes in use (frames plus a length byte each) and the rest
+    // of the frame in flight
+    size_t depth() const {
+        size_t total = sendLen - sendPos;
+        for (int lane = 0; lane < LINK_NUM_LANES; lane++) total += rings[lane].used;
+        return total;
+    }
+
+    size_t depth(LinkLane lane) const { return rings[lane].used; }
+
+    // The last pull() stopped for lack of credit
+    bool waitingForCredit() const { return waiting; }
+
+    uint32_t getBytesQueued() const { return bytesQueued; }
+    uint32_t getBytesDropped() const { return bytesDropped; }   // Dropped + oversize
+    uint32_t getFramesDropped() const { return framesDropped; }
+    uint32_t getFramesRefused() const { return framesRefused; } // Commands/notes, ring full
+    size_t getMaxDepth() const { return maxDepth; }
+
+private:
+    struct Ring {
+        uint8_t* data;
+        size_t size;     // Power of two
+        size_t head;     // Write position
+        size_t tail;     // Oldest record
+        size_t used;
+
+        void init(uint8_t* buffer, size_t bytes) {
+            data = buffer;
+            size = bytes;
+            head = 0;
+            tail = 0;
+            used = 0;
+        }
+
+        void write(const uint8_t* src, size_t len) {
+            for (size_t i = 0; i < len; i++) {
+                data[head] = src[i];
+                head = (head + 1) & (size - 1);
+            }
+            used += len;
+        }
+
+        void read(uint8_t* dst, size_t len) {
+            for (size_t i = 0; i < len; i++) {
+                dst[i] = data[tail];
+                tail = (tail + 1) & (size - 1);
+            }
+            used -= len;
+        }
+
+        uint8_t peek() const { return data[tail]; }
+        size_t free() const { return size - used; }
+    };
+
+    // Move the next frame due into sending[], highest lane first
+    bool startFrame(LinkFlow* flow, uint32_t nowMs) {
+        for (int lane = 0; lane < LINK_NUM_LANES; lane++) {
+            Ring& ring = rings[lane];
+            if (!ring.used) continue;
+
+            uint8_t len = ring.peek();
+            if (flow && lane != LINK_LANE_LINK && flow->credit() < len) {
+                // Lower lanes wait too, or they'd overtake this frame's credit
+                waiting = true;
+                flow->stall(nowMs);
+                return false;
+            }
+
+            ring.read(&len, 1);
+            ring.read(sending, len);
+            sendLen = len;
+            sendPos = 0;
+            if (flow) flow->charge(len);
+            return true;
+        }
+        return false;
+    }
+
+    uint8_t linkData[LINK_TX_LINK_BYTES];
+    uint8_t commandData[LINK_TX_COMMAND_BYTES];
+    uint8_t noteData[LINK_TX_NOTE_BYTES];
+    uint8_t telemetryData[LINK_TX_TELEMETRY_BYTES];
+    Ring rings[LINK_NUM_LANES];
+
+    // Frame in flight, moved out of its ring when it started
+    uint8_t sending[LINK_MAX_FRAME];
+    size_t sendLen;
+    size_t sendPos;
+    bool waiting;
+
+    uint32_t bytesQueued;
+    uint32_t bytesDropped;
+    uint32_t framesDropped;
+    uint32_t framesRefused;
+    size_t maxDepth;
+};
+
+#endif // LINK_TX_QUEUE_H
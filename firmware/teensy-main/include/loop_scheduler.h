@@ -0,0 +1,229 @@
+/**
+ * Loop Scheduler
+ * Cooperative, time-budgeted scheduling of the ESP's loop() work, with
+ * per-task latency histograms
+ *
+ * A fixed loop() order makes every job wait for all the others: one slow
+ * HTTP client in handleClient() holds up the Teensy link and inbound OSC
+ * for as long as it takes. Here each job is a task with a priority, an
+ * optional period and a budget - the run time it's expected to stay
+ * within. Each pass:
+ *
+ *   - critical tasks (the Teensy link) run first, and again after every
+ *     other task, so they wait at most one other task's run, never a
+ *     whole pass
+ *   - the rest run in priority order while the pass is within
+ *     LOOP_PASS_BUDGET_US; a task whose budget would take the pass over
+ *     it is deferred to the next pass, unless it has been waiting
+ *     LOOP_MAX_DEFER_US already (nothing starves)
+ *
+ * Nothing is preempted: a task that overruns its budget still holds the
+ * CPU, and is counted. Its budget is what keeps it from starting when it
+ * wouldn't fit.
+ *
+ * Latency is how long a task waited past when it became due: the end of
+ * its last run for tasks that run every pass, the end of its period for
+ * the rest. Each task keeps a histogram of it in power-of-two buckets
+ * from 64us up, and report() renders them all as JSON for the web UI.
+ *
+ * Header-only, no Arduino dependencies (the clock is passed in: micros()
+ * on the ESP), so both ESP sketches and the host tests share it.
+ */
+
+#ifndef LOOP_SCHEDULER_H
+#define LOOP_SCHEDULER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "json_text.h"
+
+#define LOOP_MAX_TASKS 8
+#define LOOP_PASS_BUDGET_US 2000     // Non-critical work per pass
+#define LOOP_MAX_DEFER_US 50000      // Longest a due task is put off
+#define LOOP_HIST_BUCKETS 12         // <64us, <128us, ... <65.5ms, longer
+#define LOOP_HIST_FIRST_US 64
+#define LOOP_REPORT_MAX_TEXT 2688    // report() of LOOP_MAX_TASKS tasks, counters at 10 digits
+
+enum LoopPriority {
+    LOOP_PRIORITY_CRITICAL = 0,      // Every pass, and between every other task
+    LOOP_PRIORITY_HIGH,
+    LOOP_PRIORITY_NORMAL,
+    LOOP_PRIORITY_LOW
+};
+
+typedef void (*LoopTaskFn)();
+typedef uint32_t (*LoopClockFn)();
+
+struct LoopTask {
+    const char* name;
+    LoopTaskFn run;
+    uint8_t priority;
+    uint32_t periodUs;         // 0 = every pass
+    uint32_t budgetUs;
+
+    uint32_t dueUs;            // When it next becomes due
+    uint32_t runs;
+    uint32_t overruns;         // Ran longer than its budget
+    uint32_t deferrals;        // Put off to a later pass
+    uint32_t latencyMaxUs;
+    uint32_t runMaxUs;
+    uint32_t histogram[LOOP_HIST_BUCKETS];
+};
+
+class LoopScheduler {
+public:
+    LoopScheduler(LoopClockFn clock) : clock(clock) {
+        count = 0;
+        passes = 0;
+        overBudgetPasses = 0;
+    }
+
+    // Tasks are kept in priority order; equal priorities in the order
+    // added. False if the table is full.
+    bool add(const char* name, LoopTaskFn run, uint8_t priority, uint32_t budgetUs, uint32_t periodUs = 0) {
+        if (count == LOOP_MAX_TASKS) return false;
+        uint8_t slot = count++;
+        while (slot > 0 && tasks[slot - 1].priority > priority) {
+            tasks[slot] = tasks[slot - 1];
+            slot--;
+        }
+        LoopTask& task = tasks[slot];
+        task.name = name;
+        task.run = run;
+        task.priority = priority;
+        task.periodUs = periodUs;
+        task.budgetUs = budgetUs;
+        task.dueUs = clock();
+        task.runs = 0;
+        task.overruns = 0;
+        task.deferrals = 0;
+        task.latencyMaxUs = 0;
+        task.runMaxUs = 0;
+        for (uint8_t b = 0; b < LOOP_HIST_BUCKETS; b++) task.histogram[b] = 0;
+        return true;
+    }
+
+    // One pass over the tasks; call from loop()
+    void runPass() {
+        uint32_t start = clock();
+        passes++;
+        runCritical();
+
+        // The first task always fits, so every pass gets something done
+        bool ranOne = false;
+        bool overBudget = false;
+        for (uint8_t i = 0; i < count; i++) {
+            LoopTask& task = tasks[i];
+            if (task.priority == LOOP_PRIORITY_CRITICAL) continue;
+            uint32_t now = clock();
+            if (!isDue(task, now)) continue;
+
+            if (ranOne && now - start + task.budgetUs > LOOP_PASS_BUDGET_US &&
+                now - task.dueUs < LOOP_MAX_DEFER_US) {
+                task.deferrals++;
+                overBudget = true;
+                continue;
+            }
+            runTask(task, now);
+            ranOne = true;
+            runCritical();
+        }
+        if (overBudget) overBudgetPasses++;
+    }
+
+    uint8_t getCount() const { return count; }
+    const LoopTask& get(uint8_t index) const { return tasks[index]; }
+    uint32_t getPasses() const { return passes; }
+    uint32_t getOverBudgetPasses() const { return overBudgetPasses; }  // Deferred something
+
+    // Upper edge of the bucket holding the pct'th percentile latency;
+    // UINT32_MAX if it's in the open-ended last bucket
+    static uint32_t percentileUs(const LoopTask& task, uint8_t pct) {
+        if (task.runs == 0) return 0;
+        uint32_t target = (uint32_t)(((uint64_t)task.runs * pct + 99) / 100);
+        uint32_t seen = 0;
+        for (uint8_t b = 0; b < LOOP_HIST_BUCKETS; b++) {
+            seen += task.histogram[b];
+            if (seen >= target) return bucketLimitUs(b);
+        }
+        return bucketLimitUs(LOOP_HIST_BUCKETS - 1);
+    }
+
+    static uint32_t bucketLimitUs(uint8_t bucket) {
+        return bucket == LOOP_HIST_BUCKETS - 1 ? UINT32_MAX : (uint32_t)LOOP_HIST_FIRST_US << bucket;
+    }
+
+    static uint8_t bucketFor(uint32_t us) {
+        uint8_t bucket = 0;
+        while (bucket < LOOP_HIST_BUCKETS - 1 && us >= bucketLimitUs(bucket)) bucket++;
+        return bucket;
+    }
+
+    // Every task's counters and histogram as JSON; 0 if it doesn't fit
+    size_t report(char* out, size_t max) const {
+        size_t len = 0;
+        if (!jsonAppend(out, max, len, "{\"passes\":%lu,\"overBudget\":%lu,\"bucketsUs\":%u,\"tasks\":[",
+                    (unsigned long)passes, (unsigned long)overBudgetPasses, LOOP_HIST_FIRST_US)) return 0;
+        for (uint8_t i = 0; i < count; i++) {
+            const LoopTask& task = tasks[i];
+            if (!jsonAppend(out, max, len,
+                        "%s{\"name\":\"%s\",\"priority\":%u,\"runs\":%lu,\"p50Us\":%ld,\"p99Us\":%ld,\"maxUs\":%lu,"
+                        "\"runMaxUs\":%lu,\"budgetUs\":%lu,\"overruns\":%lu,\"deferred\":%lu,\"hist\":[",
+                        i ? "," : "", task.name, task.priority, (unsigned long)task.runs,
+                        jsonLimit(percentileUs(task, 50)), jsonLimit(percentileUs(task, 99)),
+                        (unsigned long)task.latencyMaxUs, (unsigned long)task.runMaxUs,
+                        (unsigned long)task.budgetUs, (unsigned long)task.overruns,
+                        (unsigned long)task.deferrals)) return 0;
+            for (uint8_t b = 0; b < LOOP_HIST_BUCKETS; b++) {
+                if (!jsonAppend(out, max, len, "%s%lu", b ? "," : "", (unsigned long)task.histogram[b])) return 0;
+            }
+            if (!jsonAppend(out, max, len, "]}")) return 0;
+        }
+        return jsonAppend(out, max, len, "]}") ? len : 0;
+    }
+
+private:
+    static bool isDue(const LoopTask& task, uint32_t now) {
+        return (int32_t)(now - task.dueUs) >= 0;
+    }
+
+    void runCritical() {
+        for (uint8_t i = 0; i < count && tasks[i].priority == LOOP_PRIORITY_CRITICAL; i++) {
+            uint32_t now = clock();
+            if (isDue(tasks[i], now)) runTask(tasks[i], now);
+        }
+    }
+
+    void runTask(LoopTask& task, uint32_t now) {
+        uint32_t latency = now - task.dueUs;
+        task.run();
+        uint32_t end = clock();
+        uint32_t took = end - now;
+
+        task.runs++;
+        task.histogram[bucketFor(latency)]++;
+        if (latency > task.latencyMaxUs) task.latencyMaxUs = latency;
+        if (took > task.runMaxUs) task.runMaxUs = took;
+        if (took > task.budgetUs) task.overruns++;
+
+        if (task.periodUs == 0) {
+            task.dueUs = end;
+        } else {
+            task.dueUs += task.periodUs;
+            // A whole period behind: start the schedule over rather than
+            // run it back to back to catch up
+            if (isDue(task, end)) task.dueUs = now + task.periodUs;
+        }
+    }
+
+    // -1 for "beyond the last bucket"
+    static long jsonLimit(uint32_t us) { return us == UINT32_MAX ? -1 : (long)us; }
+
+    LoopClockFn clock;
+    LoopTask tasks[LOOP_MAX_TASKS];
+    uint8_t count;
+    uint32_t passes;
+    uint32_t overBudgetPasses;
+};
+
+#endif // LOOP_SCHEDULER_H
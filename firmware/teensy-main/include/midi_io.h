@@ -0,0 +1,299 @@
+/**
+ * USB-MIDI Input/Output
+ * Batching of outgoing USB-MIDI events, conversions between the analog
+ * conditioners and MIDI, and a round-trip latency probe
+ *
+ * The Teensy is a USB-MIDI device alongside its audio and serial
+ * interfaces, so a DAW can record the guitar straight off USB instead of
+ * over the ESP link and Wi-Fi. Notes, whammy (pitch bend) and tilt (CC)
+ * are queued here as they happen and handed to usbMIDI once per
+ * MIDI_BATCH_US - one USB high-speed microframe - followed by send_now(),
+ * so everything from one loop pass shares a packet and nothing waits for
+ * the core's own flush timeout.
+ *
+ * A queued pitch bend or CC is replaced by a newer value on the same
+ * channel (and controller) rather than queued twice; notes never are.
+ * Notes can carry a time to go out at: a strummed chord's strings are
+ * scheduled a few milliseconds apart in the audio, and sending each at
+ * its own onset keeps that spread in the recording.
+ *
+ * The probe is a SysEx message (non-commercial ID 0x7D) carrying the
+ * micros() it was sent at. Anything that echoes it back - a MIDI thru, or
+ * `aconnect` looping the Teensy's port onto itself - gives a round trip
+ * without either end keeping state.
+ *
+ * Header-only, no Arduino dependencies, so the host tests share it.
+ */
+
+#ifndef MIDI_IO_H
+#define MIDI_IO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "analog_conditioner.h"
+
+#define MIDI_BATCH_US 125          // USB high-speed microframe
+#define MIDI_OUT_QUEUE 32          // Events waiting for their batch
+#define MIDI_TILT_CC 74            // Brightness: tilt drives the filter here too
+#define MIDI_BEND_CENTER 8192
+#define MIDI_BEND_MAX 16383
+
+#define MIDI_NOTE_OFF 0x80
+#define MIDI_NOTE_ON 0x90
+#define MIDI_CONTROL_CHANGE 0xB0
+#define MIDI_PITCH_BEND 0xE0
+#define MIDI_CC_ALL_NOTES_OFF 123
+
+#define MIDI_PROBE_ID 0x7D         // SysEx non-commercial manufacturer ID
+#define MIDI_PROBE_LENGTH 10       // F0 7D 'G' 'H' 5 x 7-bit timestamp F7
+
+// One channel message, as usbMIDI.send() takes it. Pitch bend is 14 bits:
+// data1 the low 7, data2 the high 7.
+struct MidiEvent {
+    uint8_t type;                  // MIDI_NOTE_ON, ...
+    uint8_t channel;               // 1-16
+    uint8_t data1;
+    uint8_t data2;
+};
+
+// Whammy/tilt conditioner output (+-ANALOG_FULL_SCALE) to a pitch bend
+// value (0-16383, MIDI_BEND_CENTER at rest), and back
+inline uint16_t midiBendFromAnalog(int16_t value) {
+    int32_t bend = MIDI_BEND_CENTER + (int32_t)value * (MIDI_BEND_CENTER - 1) / ANALOG_FULL_SCALE;
+    return bend < 0 ? 0 : bend > MIDI_BEND_MAX ? MIDI_BEND_MAX : bend;
+}
+
+inline int16_t midiAnalogFromBend(uint16_t bend) {
+    int32_t value = ((int32_t)bend - MIDI_BEND_CENTER) * ANALOG_FULL_SCALE / (MIDI_BEND_CENTER - 1);
+    return value > ANALOG_FULL_SCALE ? ANALOG_FULL_SCALE : value < -ANALOG_FULL_SCALE ? -ANALOG_FULL_SCALE : value;
+}
+
+// +-ANALOG_FULL_SCALE to a CC value (0-127, 64 at rest), and back. 64
+// steps below rest and 63 above, as for pan.
+inline uint8_t midiCCFromAnalog(int16_t value) {
+    int32_t steps = value >= 0 ? 63 : 64;
+    return (uint8_t)(64 + ((int32_t)value * steps + (value >= 0 ? 1 : -1) * ANALOG_FULL_SCALE / 2) / ANALOG_FULL_SCALE);
+}
+
+inline int16_t midiAnalogFromCC(uint8_t cc) {
+    if (cc > 127) cc = 127;
+    int32_t offset = (int32_t)cc - 64;
+    return (int16_t)(offset * ANALOG_FULL_SCALE / (offset >= 0 ? 63 : 64));
+}
+
+class MidiOutBatcher {
+public:
+    MidiOutBatcher() {
+        count = 0;
+        firstUs = 0;
+        events = 0;
+        batches = 0;
+        coalesced = 0;
+        refused = 0;
+        cancelled = 0;
+        maxBatch = 0;
+        maxWaitUs = 0;
+    }
+
+    // False if the queue is full (the event is dropped and counted)
+    bool noteOn(uint8_t channel, uint8_t note, uint8_t velocity, uint32_t nowUs) {
+        return add(MIDI_NOTE_ON, channel, note, velocity, nowUs, nowUs);
+    }
+
+    // The same, sent at atUs rather than in the next batch
+    bool noteOnAt(uint8_t channel, uint8_t note, uint8_t velocity, uint32_t nowUs, uint32_t atUs) {
+        return add(MIDI_NOTE_ON, channel, note, velocity, nowUs, atUs);
+    }
+
+    // Released before its scheduled note-on went out: neither is sent, as
+    // neither is heard (the audio scheduler cancels the onset too)
+    bool noteOff(uint8_t channel, uint8_t note, uint32_t nowUs) {
+        for (uint8_t i = 0; i < count; i++) {
+            const Entry& entry = queue[i];
+            if (entry.event.type == MIDI_NOTE_ON && entry.event.channel == channel &&
+                entry.event.data1 == note && !isDue(entry, nowUs)) {
+                memmove(&queue[i], &queue[i + 1], (count - i - 1) * sizeof(Entry));
+                count--;
+                cancelled++;
+                return true;
+            }
+        }
+        return add(MIDI_NOTE_OFF, channel, note, 0, nowUs, nowUs);
+    }
+
+    // bend 0-16383; replaces one still queued for the channel
+    bool pitchBend(uint8_t channel, uint16_t bend, uint32_t nowUs) {
+        return set(MIDI_PITCH_BEND, channel, bend & 0x7F, (bend >> 7) & 0x7F, nowUs);
+    }
+
+    // Replaces a queued value of the same controller on the channel
+    bool controlChange(uint8_t channel, uint8_t control, uint8_t value, uint32_t nowUs) {
+        return set(MIDI_CONTROL_CHANGE, channel, control, value, nowUs);
+    }
+
+    // A batch is due once the microframe its first event arrived in is
+    // over (or the queue is full) and something in it is due
+    bool due(uint32_t nowUs) const {
+        if (count == 0) return false;
+        if (count < MIDI_OUT_QUEUE && nowUs - firstUs < MIDI_BATCH_US) return false;
+        for (uint8_t i = 0; i < count; i++) {
+            if (isDue(queue[i], nowUs)) return true;
+        }
+        return false;
+    }
+
+    // Move the due events into out (MIDI_OUT_QUEUE entries), oldest
+    // first; later ones stay queued. Returns how many.
+    uint8_t take(uint32_t nowUs, MidiEvent* out) {
+        uint8_t taken = 0;
+        uint8_t kept = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            if (isDue(queue[i], nowUs)) {
+                uint32_t waited = nowUs - queue[i].atUs;
+                if (waited > maxWaitUs) maxWaitUs = waited;
+                out[taken++] = queue[i].event;
+            } else {
+                queue[kept++] = queue[i];
+            }
+        }
+        count = kept;
+        firstUs = nowUs;
+        if (taken) {
+            batches++;
+            if (taken > maxBatch) maxBatch = taken;
+        }
+        return taken;
+    }
+
+    uint8_t pending() const { return count; }
+
+    uint32_t getEvents() const { return events; }        // Queued, coalesced ones included
+    uint32_t getBatches() const { return batches; }      // send_now() calls
+    uint32_t getCoalesced() const { return coalesced; }  // Replaced before being sent
+    uint32_t getRefused() const { return refused; }      // Dropped, queue full
+    uint32_t getCancelled() const { return cancelled; }  // Scheduled note-ons released first
+    uint8_t getMaxBatch() const { return maxBatch; }
+    uint32_t getMaxWaitUs() const { return maxWaitUs; }  // Longest past due when sent
+
+    void clearCounts() {
+        maxBatch = 0;
+        maxWaitUs = 0;
+    }
+
+private:
+    struct Entry {
+        MidiEvent event;
+        uint32_t atUs;             // Not before
+    };
+
+    static bool isDue(const Entry& entry, uint32_t nowUs) {
+        return (int32_t)(nowUs - entry.atUs) >= 0;
+    }
+
+    bool add(uint8_t type, uint8_t channel, uint8_t data1, uint8_t data2, uint32_t nowUs, uint32_t atUs) {
+        events++;
+        if (count == MIDI_OUT_QUEUE) {
+            refused++;
+            return false;
+        }
+        if (count == 0) firstUs = nowUs;
+        Entry& entry = queue[count++];
+        entry.event.type = type;
+        entry.event.channel = channel;
+        entry.event.data1 = data1;
+        entry.event.data2 = data2;
+        entry.atUs = atUs;
+        return true;
+    }
+
+    bool set(uint8_t type, uint8_t channel, uint8_t data1, uint8_t data2, uint32_t nowUs) {
+        for (uint8_t i = 0; i < count; i++) {
+            MidiEvent& queued = queue[i].event;
+            if (queued.type == type && queued.channel == channel &&
+                (type == MIDI_PITCH_BEND || queued.data1 == data1)) {
+                queued.data1 = data1;
+                queued.data2 = data2;
+                events++;
+                coalesced++;
+                return true;
+            }
+        }
+        return add(type, channel, data1, data2, nowUs, nowUs);
+    }
+
+    Entry queue[MIDI_OUT_QUEUE];
+    uint8_t count;
+    uint32_t firstUs;              // When the batch being collected started
+
+    uint32_t events;
+    uint32_t batches;
+    uint32_t coalesced;
+    uint32_t refused;
+    uint32_t cancelled;
+    uint8_t maxBatch;
+    uint32_t maxWaitUs;
+};
+
+// ---- Round-trip probe
+
+// SysEx carrying sentUs; returns MIDI_PROBE_LENGTH
+inline size_t midiProbeEncode(uint32_t sentUs, uint8_t* out) {
+    out[0] = 0xF0;
+    out[1] = MIDI_PROBE_ID;
+    out[2] = 'G';
+    out[3] = 'H';
+    for (uint8_t i = 0; i < 5; i++) out[4 + i] = (sentUs >> (7 * i)) & 0x7F;
+    out[9] = 0xF7;
+    return MIDI_PROBE_LENGTH;
+}
+
+// True (with the time it was sent) if data is one of our probes
+inline bool midiProbeDecode(const uint8_t* data, size_t len, uint32_t& sentUs) {
+    if (len != MIDI_PROBE_LENGTH || data[0] != 0xF0 || data[1] != MIDI_PROBE_ID ||
+        data[2] != 'G' || data[3] != 'H' || data[9] != 0xF7) return false;
+    sentUs = 0;
+    for (uint8_t i = 0; i < 5; i++) {
+        if (data[4 + i] & 0x80) return false;
+        sentUs |= (uint32_t)data[4 + i] << (7 * i);
+    }
+    return true;
+}
+
+// Round trips of echoed probes
+class MidiRoundTrip {
+public:
+    MidiRoundTrip() { clear(); }
+
+    void clear() {
+        count = 0;
+        lastUs = 0;
+        minUs = UINT32_MAX;
+        maxUs = 0;
+        sumUs = 0;
+    }
+
+    void record(uint32_t sentUs, uint32_t nowUs) {
+        uint32_t rtt = nowUs - sentUs;
+        lastUs = rtt;
+        if (rtt < minUs) minUs = rtt;
+        if (rtt > maxUs) maxUs = rtt;
+        sumUs += rtt;
+        count++;
+    }
+
+    uint32_t getCount() const { return count; }
+    uint32_t getLastUs() const { return lastUs; }
+    uint32_t getMinUs() const { return count ? minUs : 0; }
+    uint32_t getMaxUs() const { return maxUs; }
+    uint32_t getAvgUs() const { return count ? (uint32_t)(sumUs / count) : 0; }
+
+private:
+    uint32_t count;
+    uint32_t lastUs;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint64_t sumUs;
+};
+
+#endif // MIDI_IO_H
@@ -0,0 +1,192 @@
+/**
+ * OSC Message and Bundle Encoding
+ * Builds OSC 1.0 messages, and bundles of them, into a fixed buffer
+ *
+ * Everything one telemetry update produces (scale, CPU, memory, latency,
+ * a batch of notes) goes out as a single bundle: one datagram instead of
+ * one per message, all stamped with the same time.
+ *
+ *   bundle:   "#bundle\0", uint64 timetag, then per message int32 size + message
+ *   message:  address, ",types", arguments - strings NUL-padded to 4 bytes,
+ *             numbers big-endian
+ *
+ * Timetags are NTP format: seconds since 1900 and a 32-bit binary
+ * fraction. OSC_IMMEDIATE (1) means "as soon as received", which is what
+ * we send until the ESP has a wall clock.
+ *
+ * Argument types: i (int32), f (float32), s (string), T/F (no data).
+ * Header-only, no Arduino dependencies, so the sketches and host tests
+ * share it.
+ */
+
+#ifndef OSC_BUNDLE_H
+#define OSC_BUNDLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdarg.h>
+
+#define OSC_BUNDLE_BYTES 512                 // Fits one datagram on any network
+#define OSC_IMMEDIATE 1ULL
+#define OSC_NTP_UNIX_OFFSET 2208988800UL     // 1900 to 1970, seconds
+
+// NTP timetag from Unix time
+inline uint64_t oscTimetag(uint32_t unixSeconds, uint32_t micros) {
+    uint64_t seconds = (uint64_t)unixSeconds + OSC_NTP_UNIX_OFFSET;
+    uint32_t fraction = (uint32_t)(((uint64_t)micros << 32) / 1000000);
+    return (seconds << 32) | fraction;
+}
+
+inline void oscPutU32(uint8_t* out, uint32_t value) {
+    out[0] = value >> 24;
+    out[1] = value >> 16;
+    out[2] = value >> 8;
+    out[3] = value;
+}
+
+// Bytes a string takes: itself, its NUL, padding to 4
+inline size_t oscPaddedLength(const char* text) {
+    return (strlen(text) + 4) & ~(size_t)3;
+}
+
+// Encode one message into out. Returns its length, or 0 if it doesn't fit
+// in max (or has an unknown type).
+inline size_t oscEncodeMessageV(uint8_t* out, size_t max, const char* address, const char* types, va_list args) {
+    size_t typeCount = strlen(types);
+
+    // Work out the size first, so a message that doesn't fit writes nothing
+    va_list sizing;
+    va_copy(sizing, args);
+    size_t size = oscPaddedLength(address) + ((typeCount + 1 + 4) & ~(size_t)3);
+    bool valid = true;
+    for (size_t i = 0; i < typeCount; i++) {
+        switch (types[i]) {
+            case 'i': (void)va_arg(sizing, int32_t); size += 4; break;
+            case 'f': (void)va_arg(sizing, double); size += 4; break;
+            case 's': size += oscPaddedLength(va_arg(sizing, const char*)); break;
+            case 'T':
+            case 'F': break;
+            default: valid = false; break;
+        }
+    }
+    va_end(sizing);
+    if (!valid || size > max) return 0;
+
+    memset(out, 0, size);  // Padding
+    size_t pos = 0;
+    memcpy(out, address, strlen(address));
+    pos += oscPaddedLength(address);
+    out[pos] = ',';
+    memcpy(out + pos + 1, types, typeCount);
+    pos += (typeCount + 1 + 4) & ~(size_t)3;
+
+    for (size_t i = 0; i < typeCount; i++) {
+        switch (types[i]) {
+            case 'i':
+                oscPutU32(out + pos, (uint32_t)va_arg(args, int32_t));
+                pos += 4;
+                break;
+            case 'f': {
+                float value = (float)va_arg(args, double);
+                uint32_t bits;
+                memcpy(&bits, &value, 4);
+                oscPutU32(out + pos, bits);
+                pos += 4;
+                break;
+            }
+            case 's': {
+                const char* text = va_arg(args, const char*);
+                memcpy(out + pos, text, strlen(text));
+                pos += oscPaddedLength(text);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return pos;
+}
+
+inline size_t oscEncodeMessage(uint8_t* out, size_t max, const char* address, const char* types, ...) {
+    va_list args;
+    va_start(args, types);
+    size_t len = oscEncodeMessageV(out, max, address, types, args);
+    va_end(args);
+    return len;
+}
+
+// Reusable bundle: begin(), add() each message, send data()/size(), repeat
+class OscBundle {
+public:
+    OscBundle() {
+        begin(OSC_IMMEDIATE);
+        bundles = 0;
+        messages = 0;
+    }
+
+    void begin(uint64_t timetag) {
+        memcpy(buffer, "#bundle", 8);
+        oscPutU32(buffer + 8, (uint32_t)(timetag >> 32));
+        oscPutU32(buffer + 12, (uint32_t)timetag);
+        length = 16;
+        count = 0;
+    }
+
+    // Append a message. False if it doesn't fit; the bundle is unchanged,
+    // so send it and begin() another.
+    bool add(const char* address, const char* types, ...) {
+        va_list args;
+        va_start(args, types);
+        bool added = addV(address, types, args);
+        va_end(args);
+        return added;
+    }
+
+    bool addV(const char* address, const char* types, va_list args) {
+        if (length + 4 > OSC_BUNDLE_BYTES) return false;
+
+        size_t len = oscEncodeMessageV(buffer + length + 4, OSC_BUNDLE_BYTES - length - 4, address, types, args);
+        if (len == 0) return false;
+
+        oscPutU32(buffer + length, (uint32_t)len);
+        length += 4 + len;
+        count++;
+        return true;
+    }
+
+    // Append every message of another bundle; its timetag is dropped.
+    // False if they don't all fit, and nothing is appended.
+    bool append(const OscBundle& other) {
+        size_t extra = other.length - 16;
+        if (length + extra > OSC_BUNDLE_BYTES) return false;
+        memcpy(buffer + length, other.buffer + 16, extra);
+        length += extra;
+        count += other.count;
+        return true;
+    }
+
+    // Call after sending, for the counters
+    void sent() {
+        bundles++;
+        messages += count;
+    }
+
+    bool empty() const { return count == 0; }
+    uint8_t getCount() const { return count; }
+    const uint8_t* data() const { return buffer; }
+    size_t size() const { return length; }
+
+    uint32_t getBundlesSent() const { return bundles; }
+    uint32_t getMessagesSent() const { return messages; }
+
+private:
+    uint8_t buffer[OSC_BUNDLE_BYTES];
+    size_t length;
+    uint8_t count;
+
+    uint32_t bundles;
+    uint32_t messages;
+};
+
+#endif // OSC_BUNDLE_H
@@ -0,0 +1,167 @@
+/**
+ * OSC Input Dispatch
+ * Reads incoming OSC datagrams in place and turns /synth/<param> messages
+ * into link parameter commands
+ *
+ * A datagram is walked where it lies - messages, bundles, nested bundles -
+ * with no copies and no heap, and each message is handed over as a view
+ * of its address, type tags and argument bytes. Parameter addresses are
+ * resolved through linkParamFind() (one hash, one compare) and the first
+ * argument is fitted to the parameter's range, so what reaches the link
+ * is already a valid LinkSetParam.
+ *
+ *   /synth/reverb 35.0    /synth/scale 2    /synth/lfotarget 1
+ *
+ * The older short forms (/scale, /reverb, /delay) still work: the
+ * "/synth" prefix is optional.
+ *
+ * Header-only, no Arduino dependencies, so the ESP firmware and the host
+ * tests share it.
+ */
+
+#ifndef OSC_DISPATCH_H
+#define OSC_DISPATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "link_protocol.h"
+
+#define OSC_MAX_BUNDLE_DEPTH 4
+#define OSC_MAX_NAME 16    // Longest parameter name handled, terminator included
+
+// Length of the padded OSC string at data, 0 if it isn't terminated
+// within len
+inline size_t oscStringLength(const uint8_t* data, size_t len) {
+    const uint8_t* end = (const uint8_t*)memchr(data, 0, len);
+    if (!end) return 0;
+    size_t padded = ((end - data) + 4) & ~(size_t)3;
+    return padded <= len ? padded : 0;
+}
+
+// One message inside a datagram; pointers into the datagram
+struct OscMessageView {
+    const char* address;
+    const char* types;      // After the ','
+    const uint8_t* args;
+    size_t argsLength;
+
+    // Argument index as a number: i, f, T (1) or F (0). False for any
+    // other type or a missing argument.
+    bool number(uint8_t index, float& out) const {
+        char type;
+        size_t pos;
+        if (!locate(index, type, pos)) return false;
+        if (type == 'T' || type == 'F') {
+            out = type == 'T' ? 1.0f : 0.0f;
+            return true;
+        }
+        if (type != 'i' && type != 'f') return false;
+
+        uint32_t bits = (uint32_t)args[pos] << 24 | (uint32_t)args[pos + 1] << 16 |
+                        (uint32_t)args[pos + 2] << 8 | args[pos + 3];
+        if (type == 'i') {
+            out = (float)(int32_t)bits;
+        } else {
+            memcpy(&out, &bits, 4);
+        }
+        return true;
+    }
+
+    // Argument index as a string (s), pointing into the datagram
+    bool string(uint8_t index, const char*& out) const {
+        char type;
+        size_t pos;
+        if (!locate(index, type, pos) || type != 's') return false;
+        out = (const char*)args + pos;
+        return true;
+    }
+
+    // Type and offset of argument index, checked to lie within args
+    bool locate(uint8_t index, char& type, size_t& pos) const {
+        pos = 0;
+        for (uint8_t i = 0; types[i]; i++) {
+            type = types[i];
+            size_t size = 0;
+            if (type == 'i' || type == 'f') size = 4;
+            else if (type == 'h' || type == 'd' || type == 't') size = 8;
+            else if (type == 's') size = pos < argsLength ? oscStringLength(args + pos, argsLength - pos) : 0;
+            else if (type != 'T' && type != 'F' && type != 'N' && type != 'I') return false;  // Blobs etc.
+            if ((type == 's' && size == 0) || pos + size > argsLength) return false;
+
+            if (i == index) return true;
+            pos += size;
+        }
+        return false;
+    }
+};
+
+typedef void (*OscMessageHandler)(const OscMessageView& message, void* context);
+
+// Call handler for every message in a datagram (bundles unpacked, their
+// timetags ignored - everything applies now). Returns the number of
+// messages; stops at the first malformed part.
+inline uint16_t oscForEachMessage(const uint8_t* data, size_t len, OscMessageHandler handler,
+                                  void* context, uint8_t depth = 0) {
+    if (len < 4 || (len & 3)) return 0;
+
+    if (len >= 16 && memcmp(data, "#bundle", 8) == 0) {
+        if (depth >= OSC_MAX_BUNDLE_DEPTH) return 0;
+        uint16_t count = 0;
+        size_t pos = 16;  // Past the timetag
+        while (pos + 4 <= len) {
+            uint32_t size = (uint32_t)data[pos] << 24 | (uint32_t)data[pos + 1] << 16 |
+                            (uint32_t)data[pos + 2] << 8 | data[pos + 3];
+            pos += 4;
+            if (size < 4 || size > len - pos) break;
+            count += oscForEachMessage(data + pos, size, handler, context, depth + 1);
+            pos += size;
+        }
+        return count;
+    }
+
+    if (data[0] != '/') return 0;
+    size_t addressLength = oscStringLength(data, len);
+    if (addressLength == 0) return 0;
+
+    OscMessageView message;
+    message.address = (const char*)data;
+    if (addressLength == len || data[addressLength] != ',') {
+        message.types = "";  // No type tags: an old-style message without arguments
+        message.args = data + addressLength;
+        message.argsLength = 0;
+    } else {
+        size_t typesLength = oscStringLength(data + addressLength, len - addressLength);
+        if (typesLength == 0) return 0;
+        message.types = (const char*)data + addressLength + 1;
+        message.args = data + addressLength + typesLength;
+        message.argsLength = len - addressLength - typesLength;
+    }
+
+    handler(message, context);
+    return 1;
+}
+
+// The parameter a /synth/<name> (or /<name>) address sets, 0 if none
+inline uint8_t oscParamFromAddress(const char* address) {
+    if (strncmp(address, "/synth/", 7) == 0) address += 7;
+    else if (*address == '/') address++;
+    else return 0;
+
+    if (strlen(address) >= OSC_MAX_NAME) return 0;
+    return linkParamFind(address);
+}
+
+// A parameter message as the link command to send. False if the address
+// isn't a parameter or the first argument isn't a number.
+inline bool oscToLinkParam(const OscMessageView& message, LinkSetParam& out) {
+    uint8_t param = oscParamFromAddress(message.address);
+    float value;
+    if (!param || !message.number(0, value)) return false;
+    if (!linkParamClamp(param, value, value)) return false;
+    out.param = param;
+    out.value = value;
+    return true;
+}
+
+#endif // OSC_DISPATCH_H
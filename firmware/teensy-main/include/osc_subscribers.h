@@ -0,0 +1,231 @@
+/**
+ * OSC Subscribers
+ * Who gets the OSC sketch's telemetry, in place of broadcasting it
+ *
+ * Broadcast on the soft-AP goes out at the lowest basic rate to everyone,
+ * listening or not, and takes airtime from the web UI and inbound OSC.
+ * Instead each interested client is unicast its own copy, at whatever
+ * rate its link runs, so airtime grows with the number of listeners and
+ * is nothing when nobody listens.
+ *
+ * A client joins by sending, to the OSC port:
+ *
+ *   /subscribe                            everything, to port 8000
+ *   /subscribe "state,notes"              just those topics
+ *   /subscribe "stats" 9000 500           stats to port 9000, at most every 500ms
+ *   /unsubscribe [port]
+ *
+ * Any other message (a control surface sending /synth/...) registers its
+ * sender for everything on OSC_SUBSCRIBER_DEFAULT_PORT, unless that
+ * address already has a subscription. A client is dropped once nothing
+ * has been heard from it for OSC_SUBSCRIBER_TIMEOUT_MS, so send anything
+ * - /subscribe again, /ping - more often than that.
+ *
+ * Topics:
+ *   state - scale, root, octave, arpeggiator: on every change
+ *   notes - note on/off: as played
+ *   stats - CPU, memory, latency: periodic, rate-limited per client
+ * Only stats are rate-limited. State and notes are events a client can't
+ * get back, so they always go.
+ *
+ * Addresses are IPv4 as uint32_t (what IPAddress converts to and from).
+ * Header-only, no Arduino dependencies, so the sketch and host tests
+ * share it.
+ */
+
+#ifndef OSC_SUBSCRIBERS_H
+#define OSC_SUBSCRIBERS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "osc_dispatch.h"
+
+#define OSC_MAX_SUBSCRIBERS 8
+#define OSC_SUBSCRIBER_TIMEOUT_MS 60000
+#define OSC_SUBSCRIBER_DEFAULT_PORT 8000
+#define OSC_STATS_INTERVAL_MS 100       // Default stats rate limit per client
+
+// Topic ids; masks are 1 << id
+enum OscTopic {
+    OSC_TOPIC_STATE = 0,
+    OSC_TOPIC_NOTES,
+    OSC_TOPIC_STATS,
+    OSC_NUM_TOPICS
+};
+
+#define OSC_TOPICS_ALL ((1 << OSC_NUM_TOPICS) - 1)
+
+struct OscSubscriber {
+    uint32_t ip;
+    uint16_t port;
+    uint8_t topics;             // Mask
+    uint16_t statsIntervalMs;   // 0 = every update
+    uint32_t lastHeardMs;
+    uint32_t lastStatsMs;
+    uint32_t datagrams;         // Sent to it
+};
+
+class OscSubscribers {
+public:
+    OscSubscribers() {
+        count = 0;
+        subscribes = 0;
+        expired = 0;
+        evicted = 0;
+        statsSkipped = 0;
+    }
+
+    // Topic mask from a list like "state,notes" or "all"; 0 if none known
+    static uint8_t topicsFromList(const char* list) {
+        uint8_t topics = 0;
+        while (*list) {
+            const char* end = list;
+            while (*end && *end != ',') end++;
+            size_t len = end - list;
+            if (len == 3 && strncmp(list, "all", 3) == 0) topics |= OSC_TOPICS_ALL;
+            else if (len == 5 && strncmp(list, "state", 5) == 0) topics |= 1 << OSC_TOPIC_STATE;
+            else if (len == 5 && strncmp(list, "notes", 5) == 0) topics |= 1 << OSC_TOPIC_NOTES;
+            else if (len == 5 && strncmp(list, "stats", 5) == 0) topics |= 1 << OSC_TOPIC_STATS;
+            list = *end ? end + 1 : end;
+        }
+        return topics;
+    }
+
+    // Add or update a subscription. When the table is full the client
+    // heard from longest ago makes room.
+    void subscribe(uint32_t ip, uint16_t port, uint8_t topics, uint16_t statsIntervalMs, uint32_t nowMs) {
+        subscribes++;
+        int slot = find(ip, port);
+        if (slot < 0) {
+            if (count < OSC_MAX_SUBSCRIBERS) {
+                slot = count++;
+            } else {
+                slot = 0;
+                for (uint8_t i = 1; i < count; i++) {
+                    if (nowMs - subscribers[i].lastHeardMs > nowMs - subscribers[slot].lastHeardMs) slot = i;
+                }
+                evicted++;
+            }
+            subscribers[slot].ip = ip;
+            subscribers[slot].port = port;
+            subscribers[slot].lastStatsMs = nowMs - statsIntervalMs;  // First stats go at once
+            subscribers[slot].datagrams = 0;
+        }
+        subscribers[slot].topics = topics;
+        subscribers[slot].statsIntervalMs = statsIntervalMs;
+        subscribers[slot].lastHeardMs = nowMs;
+    }
+
+    // port 0: every subscription from ip
+    void unsubscribe(uint32_t ip, uint16_t port) {
+        for (uint8_t i = 0; i < count;) {
+            if (subscribers[i].ip == ip && (port == 0 || subscribers[i].port == port)) remove(i);
+            else i++;
+        }
+    }
+
+    // Something arrived from ip: keep its subscriptions alive, or
+    // register it with the defaults if it has none
+    void heard(uint32_t ip, uint32_t nowMs) {
+        bool known = false;
+        for (uint8_t i = 0; i < count; i++) {
+            if (subscribers[i].ip == ip) {
+                subscribers[i].lastHeardMs = nowMs;
+                known = true;
+            }
+        }
+        if (!known) subscribe(ip, OSC_SUBSCRIBER_DEFAULT_PORT, OSC_TOPICS_ALL, OSC_STATS_INTERVAL_MS, nowMs);
+    }
+
+    // An inbound message from ip. Handles /subscribe and /unsubscribe
+    // (returns true: nothing else to do with it); anything else counts
+    // as hearing from the sender and returns false.
+    bool handle(const OscMessageView& message, uint32_t ip, uint32_t nowMs) {
+        if (strcmp(message.address, "/subscribe") == 0) {
+            // Topic list, port and stats interval, each optional
+            const char* list = NULL;
+            bool named = message.string(0, list);
+            uint8_t topics = named ? topicsFromList(list) : OSC_TOPICS_ALL;
+            float port = OSC_SUBSCRIBER_DEFAULT_PORT;
+            float interval = OSC_STATS_INTERVAL_MS;
+            message.number(named ? 1 : 0, port);
+            message.number(named ? 2 : 1, interval);
+
+            if (topics && port >= 1 && port <= 65535 && interval >= 0 && interval <= 60000) {
+                subscribe(ip, (uint16_t)port, topics, (uint16_t)interval, nowMs);
+            }
+            return true;
+        }
+        if (strcmp(message.address, "/unsubscribe") == 0) {
+            float port = 0;
+            message.number(0, port);
+            unsubscribe(ip, port >= 1 && port <= 65535 ? (uint16_t)port : 0);
+            return true;
+        }
+        heard(ip, nowMs);
+        return false;
+    }
+
+    // Drop clients not heard from in OSC_SUBSCRIBER_TIMEOUT_MS
+    void expire(uint32_t nowMs) {
+        for (uint8_t i = 0; i < count;) {
+            if (nowMs - subscribers[i].lastHeardMs >= OSC_SUBSCRIBER_TIMEOUT_MS) {
+                remove(i);
+                expired++;
+            } else {
+                i++;
+            }
+        }
+    }
+
+    // Topics of an update (available) that subscriber index should get
+    // now; 0 to send it nothing. Stats are left out while within its rate
+    // limit, and taking them restarts it.
+    uint8_t topicsFor(uint8_t index, uint8_t available, uint32_t nowMs) {
+        OscSubscriber& subscriber = subscribers[index];
+        uint8_t topics = subscriber.topics & available;
+        if (topics & (1 << OSC_TOPIC_STATS)) {
+            if (nowMs - subscriber.lastStatsMs < subscriber.statsIntervalMs) {
+                topics &= ~(1 << OSC_TOPIC_STATS);
+                statsSkipped++;
+            } else {
+                subscriber.lastStatsMs = nowMs;
+            }
+        }
+        return topics;
+    }
+
+    // Call after sending subscriber index a datagram
+    void sent(uint8_t index) { subscribers[index].datagrams++; }
+
+    uint8_t getCount() const { return count; }
+    const OscSubscriber& get(uint8_t index) const { return subscribers[index]; }
+
+    uint32_t getSubscribes() const { return subscribes; }
+    uint32_t getExpired() const { return expired; }
+    uint32_t getEvicted() const { return evicted; }
+    uint32_t getStatsSkipped() const { return statsSkipped; }
+
+private:
+    int find(uint32_t ip, uint16_t port) const {
+        for (uint8_t i = 0; i < count; i++) {
+            if (subscribers[i].ip == ip && subscribers[i].port == port) return i;
+        }
+        return -1;
+    }
+
+    void remove(uint8_t index) {
+        subscribers[index] = subscribers[--count];
+    }
+
+    OscSubscriber subscribers[OSC_MAX_SUBSCRIBERS];
+    uint8_t count;
+
+    uint32_t subscribes;
+    uint32_t expired;
+    uint32_t evicted;
+    uint32_t statsSkipped;
+};
+
+#endif // OSC_SUBSCRIBERS_H
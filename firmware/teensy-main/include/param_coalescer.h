@@ -0,0 +1,96 @@
+/**
+ * Parameter Coalescing
+ * Last-value-wins table between the ESP's control inputs (OSC, web) and
+ * the link to the Teensy
+ *
+ * A control surface moving a fader sends hundreds of messages a second,
+ * far more than the 115200 baud link carries and far more than the synth
+ * needs. Each value lands in a slot per parameter, overwriting whatever
+ * was waiting there, and the slots go out as LinkSetParam commands at
+ * most every PARAM_COALESCE_INTERVAL_MS, one frame per changed parameter
+ * carrying only its newest value. A change after a quiet spell goes
+ * straight out, so a single tweak costs no latency.
+ *
+ * Values stay in the table, where they can still be superseded, rather
+ * than in the queue, where they can't: nothing is flushed while the link
+ * is waiting for the Teensy's credit, and a slot the command lane refuses
+ * (ring full) stays pending for the next flush. Either way the latest
+ * value always arrives. The counters show how much was absorbed:
+ * received - forwarded values never crossed the link.
+ *
+ * Header-only so the ESP firmware and the host tests share it.
+ */
+
+#ifndef PARAM_COALESCER_H
+#define PARAM_COALESCER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "link_protocol.h"
+#include "link_tx_queue.h"
+
+#define PARAM_COALESCE_INTERVAL_MS 20   // Control rate while the link is busy (50Hz)
+
+class ParamCoalescer {
+public:
+    ParamCoalescer() {
+        for (uint8_t p = 0; p < LINK_NUM_PARAMS; p++) values[p] = 0.0f;
+        pending = 0;
+        lastFlushMs = (uint32_t)-PARAM_COALESCE_INTERVAL_MS;  // First flush is due at once
+        received = 0;
+        forwarded = 0;
+        superseded = 0;
+    }
+
+    // New value for a parameter; replaces one still waiting. False if the
+    // parameter is unknown or the value NaN (linkParamClamp()).
+    bool set(uint8_t param, float value) {
+        if (!linkParamClamp(param, value, value)) return false;
+        received++;
+        if (pending & bit(param)) superseded++;
+        values[param] = value;
+        pending |= bit(param);
+        return true;
+    }
+
+    bool isPending() const { return pending != 0; }
+
+    bool due(uint32_t nowMs) const {
+        return pending && nowMs - lastFlushMs >= PARAM_COALESCE_INTERVAL_MS;
+    }
+
+    // Queue the waiting values on the command lane when due and the link
+    // has credit, lowest parameter first. Returns the number queued.
+    uint8_t flush(uint32_t nowMs, LinkTxQueue& queue) {
+        if (!due(nowMs) || queue.waitingForCredit()) return 0;
+        lastFlushMs = nowMs;
+
+        uint8_t count = 0;
+        for (uint8_t p = 1; p < LINK_NUM_PARAMS; p++) {
+            if (!(pending & bit(p))) continue;
+            LinkSetParam message = {p, values[p]};
+            if (!queue.send(message, LINK_LANE_COMMAND)) break;  // Lane full; the rest wait
+            pending &= ~bit(p);
+            forwarded++;
+            count++;
+        }
+        return count;
+    }
+
+    uint32_t getReceived() const { return received; }
+    uint32_t getForwarded() const { return forwarded; }
+    uint32_t getSuperseded() const { return superseded; }  // Overwritten before being sent
+
+private:
+    static uint32_t bit(uint8_t param) { return (uint32_t)1 << param; }
+
+    float values[LINK_NUM_PARAMS];
+    uint32_t pending;          // Bit per parameter id
+    uint32_t lastFlushMs;
+
+    uint32_t received;
+    uint32_t forwarded;
+    uint32_t superseded;
+};
+
+#endif // PARAM_COALESCER_H
@@ -1,12 +1,19 @@
 /**
  * Scale Quantizer Module
  * Maps fret buttons to musical scales
+ *
+ * Every fret combination is precomputed: setScale()/setRootNote() rebuild
+ * a 32-entry chord table for each octave shift, so playing a note or a
+ * whole chord is a single lookup with the pitches already converted.
+ * Pitches come from the attached TuningEngine (12-TET if none).
  */
 
 #ifndef SCALE_QUANTIZER_H
 #define SCALE_QUANTIZER_H
 
-#include <Arduino.h>
+#include <stdint.h>
+#include "config.h"
+#include "tuning.h"
 
 // Scale types
 enum ScaleType {
@@ -19,6 +26,30 @@ enum ScaleType {
     NUM_SCALES
 };
 
+#define QUANTIZER_FRETS 5
+#define QUANTIZER_CHORDS (1 << QUANTIZER_FRETS)   // Every fret combination
+#define QUANTIZER_MIN_OCTAVE -2
+#define QUANTIZER_MAX_OCTAVE 2
+#define QUANTIZER_OCTAVES (QUANTIZER_MAX_OCTAVE - QUANTIZER_MIN_OCTAVE + 1)
+#define SNAP_STEPS_PER_SEMITONE 8    // Resolution of continuous positions
+#define SNAP_STEPS (12 * SNAP_STEPS_PER_SEMITONE)
+
+// One fret combination, notes in fret order (green first)
+struct FretChord {
+    uint8_t count;
+    uint8_t notes[QUANTIZER_FRETS];              // MIDI note numbers
+    uint32_t phaseIncrements[QUANTIZER_FRETS];   // Oscillator phase step per sample
+};
+
+// Oscillator phase step (full cycle = 2^32) <-> frequency in Hz
+inline uint32_t frequencyToPhaseIncrement(float frequency) {
+    return (uint32_t)(frequency * (4294967296.0f / AUDIO_SAMPLE_RATE) + 0.5f);
+}
+
+inline float phaseIncrementToFrequency(uint32_t phaseIncrement) {
+    return phaseIncrement * ((float)AUDIO_SAMPLE_RATE / 4294967296.0f);
+}
+
 class ScaleQuantizer {
 public:
     ScaleQuantizer();
@@ -29,10 +60,24 @@ public:
     // Set the root note (MIDI note number, default 60 = middle C)
     void setRootNote(uint8_t rootNote);
 
+    // Take pitches from tuning; call again after the tuning reloads
+    void setTuning(const TuningEngine* tuning);
+
     // Quantize a scale degree (0-4 for 5 frets) to a MIDI note
     // octaveShift: -2 to +2 octaves
     uint8_t quantizeNote(uint8_t scaleDegree, int8_t octaveShift = 0);
 
+    // Chord for a fret mask (bit 0 = green) at an octave shift
+    const FretChord& chord(uint8_t fretMask, int8_t octaveShift = 0) const {
+        if (octaveShift < QUANTIZER_MIN_OCTAVE) octaveShift = QUANTIZER_MIN_OCTAVE;
+        if (octaveShift > QUANTIZER_MAX_OCTAVE) octaveShift = QUANTIZER_MAX_OCTAVE;
+        return chords[octaveShift - QUANTIZER_MIN_OCTAVE][fretMask & (QUANTIZER_CHORDS - 1)];
+    }
+
+    // Nearest note of the scale to a continuous position: baseNote plus
+    // offset in 1/SNAP_STEPS_PER_SEMITONE semitone steps. One table lookup.
+    uint8_t snapNote(uint8_t baseNote, int32_t offset) const;
+
     // Get scale name for display
     const char* getScaleName(uint8_t scaleIndex);
 
@@ -45,6 +90,14 @@ public:
 private:
     uint8_t currentScale;
     uint8_t rootNote;
+    const TuningEngine* tuning;
+
+    // Rebuilt whenever the scale or root changes
+    FretChord chords[QUANTIZER_OCTAVES][QUANTIZER_CHORDS];
+
+    // Semitones above the root of the nearest scale note (12 = next root)
+    // for every position within an octave
+    uint8_t snapTable[SNAP_STEPS];
 
     // Scale intervals (semitones from root)
     // Each scale has up to 7 notes, we'll cycle through them for the 5 frets
@@ -54,6 +107,11 @@ private:
 
     // Map fret index (0-4) to scale degree
     uint8_t mapFretToScaleDegree(uint8_t fretIndex);
+
+    // Interval arithmetic behind the tables (and degrees beyond the frets)
+    uint8_t computeNote(uint8_t scaleDegree, int8_t octaveShift) const;
+
+    void rebuildChords();
 };
 
 #endif // SCALE_QUANTIZER_H
\ No newline at end of file
@@ -0,0 +1,127 @@
+/**
+ * Browser State Push
+ * Turns the ESP's mirror of the Teensy state (link_state.h) into compact
+ * JSON deltas for WebSocket clients, in place of /status polling
+ *
+ * Changed fields collect until the push is due - at most one every
+ * STATE_PUSH_INTERVAL_MS, so a burst of link deltas (CPU, voices, notes
+ * while playing) becomes one message. A change after a quiet spell goes
+ * straight out. A new client is sent a full snapshot, and everyone gets
+ * one every STATE_PUSH_REFRESH_MS as well, so a message dropped on a
+ * congested socket doesn't leave a page stale for good.
+ *
+ *   delta:     {"cpu":41.2,"voices":3}
+ *   snapshot:  {"full":1,"connected":1,"scale":2,...}
+ *
+ * Keys match /status. Text is built with snprintf into the caller's
+ * buffer, integers only (CPU is tenths), so no heap and no float printf.
+ *
+ * Header-only so the ESP firmware and the host tests share it.
+ */
+
+#ifndef STATE_PUSH_H
+#define STATE_PUSH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "link_state.h"
+#include "json_text.h"
+
+#define STATE_PUSH_INTERVAL_MS 50    // Deltas coalesce for at most this long
+#define STATE_PUSH_REFRESH_MS 5000   // Full snapshot to everyone this often
+#define STATE_PUSH_MAX_TEXT 192      // Longest message (a snapshot)
+
+class StatePush {
+public:
+    StatePush() {
+        pendingMask = 0;
+        lastPushMs = 0;
+        lastRefreshMs = 0;
+        pushes = 0;
+        snapshots = 0;
+        bytesPushed = 0;
+    }
+
+    // Fields the mirror has changed (LinkStateReceiver::getChangedMask())
+    void changed(uint16_t mask) { pendingMask |= mask; }
+
+    bool due(uint32_t nowMs) const {
+        if (nowMs - lastRefreshMs >= STATE_PUSH_REFRESH_MS) return true;
+        return pendingMask && nowMs - lastPushMs >= STATE_PUSH_INTERVAL_MS;
+    }
+
+    // The message to send everyone now, or 0 if nothing is due. A delta
+    // normally; a snapshot when the refresh is due.
+    size_t poll(uint32_t nowMs, const LinkState& state, char* out, size_t max) {
+        if (!due(nowMs)) return 0;
+
+        bool refresh = nowMs - lastRefreshMs >= STATE_PUSH_REFRESH_MS;
+        size_t len = refresh ? format(state, LINK_FIELDS_ALL, true, out, max)
+                             : format(state, pendingMask, false, out, max);
+        if (refresh) {
+            lastRefreshMs = nowMs;
+            snapshots++;
+        }
+        pendingMask = 0;
+        lastPushMs = nowMs;
+        pushes++;
+        bytesPushed += len;
+        return len;
+    }
+
+    // Everything, for a client that just connected
+    size_t snapshot(const LinkState& state, char* out, size_t max) {
+        snapshots++;
+        return format(state, LINK_FIELDS_ALL, true, out, max);
+    }
+
+    // JSON object holding the masked fields; 0 if it doesn't fit in max
+    static size_t format(const LinkState& state, uint16_t mask, bool full, char* out, size_t max) {
+        size_t len = 0;
+        if (!jsonAppend(out, max, len, "{%s", full ? "\"full\":1" : "")) return 0;
+
+        for (uint8_t f = 0; f < LINK_NUM_FIELDS; f++) {
+            if (!(mask & (1 << f))) continue;
+            const char* comma = len > 1 ? "," : "";
+            bool ok;
+            switch (f) {
+                case LINK_FIELD_CONNECTED: ok = jsonAppend(out, max, len, "%s\"connected\":%u", comma, state.connected); break;
+                case LINK_FIELD_SCALE: ok = jsonAppend(out, max, len, "%s\"scale\":%u", comma, state.scale); break;
+                case LINK_FIELD_ROOT: ok = jsonAppend(out, max, len, "%s\"root\":%u", comma, state.root); break;
+                case LINK_FIELD_OCTAVE: ok = jsonAppend(out, max, len, "%s\"octave\":%d", comma, state.octave); break;
+                case LINK_FIELD_ARP: ok = jsonAppend(out, max, len, "%s\"arp\":%u", comma, state.arp); break;
+                case LINK_FIELD_VOICES: ok = jsonAppend(out, max, len, "%s\"voices\":%u", comma, state.voices); break;
+                case LINK_FIELD_CPU:
+                    ok = jsonAppend(out, max, len, "%s\"cpu\":%u.%u", comma, state.cpuTenths / 10, state.cpuTenths % 10);
+                    break;
+                case LINK_FIELD_MEM: ok = jsonAppend(out, max, len, "%s\"memory\":%u", comma, state.memBlocks); break;
+                case LINK_FIELD_TOTAL_NOTES:
+                    ok = jsonAppend(out, max, len, "%s\"notes\":%lu", comma, (unsigned long)state.totalNotes);
+                    break;
+                case LINK_FIELD_LOOP_MAX:
+                    ok = jsonAppend(out, max, len, "%s\"loopUs\":%lu", comma, (unsigned long)state.loopMaxUs);
+                    break;
+                default: ok = true; break;
+            }
+            if (!ok) return 0;
+        }
+
+        if (!jsonAppend(out, max, len, "}")) return 0;
+        return len;
+    }
+
+    uint32_t getPushCount() const { return pushes; }
+    uint32_t getSnapshotCount() const { return snapshots; }
+    uint32_t getBytesPushed() const { return bytesPushed; }
+
+private:
+    uint16_t pendingMask;
+    uint32_t lastPushMs;
+    uint32_t lastRefreshMs;
+
+    uint32_t pushes;
+    uint32_t snapshots;
+    uint32_t bytesPushed;
+};
+
+#endif // STATE_PUSH_H
@@ -0,0 +1,96 @@
+/**
+ * Status Cache
+ * The ESP's /status (and the OSC sketch's /api/status) JSON, kept
+ * formatted in a fixed buffer instead of being built per request
+ *
+ * Pages and scripts poll status several times a second while it changes
+ * a few times a second at most. The text is reformatted only after
+ * invalidate() - called wherever the state it shows changes - or once it
+ * is older than the cache's max age, for counters that move without a
+ * state change (link RTT, client counts). Every other request sends the
+ * buffer as it is.
+ *
+ * Formatting goes into the other of two buffers and then swaps, so a
+ * state that no longer fits leaves the last text intact. Later get()
+ * calls may rewrite the returned text, so a server that sends it after
+ * returning (the ESP's async one) sends a copy. Text is built with
+ * snprintf (json_text.h), integers only (CPU is tenths), so the cache
+ * never touches the heap.
+ *
+ * Header-only so the ESP firmware, the OSC sketch and the host tests
+ * share it.
+ */
+
+#ifndef STATUS_CACHE_H
+#define STATUS_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "json_text.h"
+
+#define STATUS_CACHE_MAX_TEXT 384
+
+class StatusCache {
+public:
+    // Writes the whole JSON object into out; returns its length, or 0 if
+    // it didn't fit in max
+    typedef size_t (*Formatter)(char* out, size_t max, void* context);
+
+    // maxAgeMs 0: reformat only after invalidate()
+    StatusCache(Formatter format, void* context = NULL, uint32_t maxAgeMs = 0)
+        : format(format), context(context), maxAgeMs(maxAgeMs) {
+        current = 0;
+        length = 0;
+        dirty = true;
+        formattedMs = 0;
+        requests = 0;
+        rebuilds = 0;
+        overflows = 0;
+        text[0][0] = 0;
+    }
+
+    // The state shown has changed
+    void invalidate() { dirty = true; }
+
+    // Text to send now, reformatted first if stale. If the state has
+    // outgrown the buffer the last text that fit is kept.
+    const char* get(uint32_t nowMs, size_t& len) {
+        requests++;
+        if (dirty || (maxAgeMs && nowMs - formattedMs >= maxAgeMs)) {
+            uint8_t next = current ^ 1;
+            size_t n = format(text[next], STATUS_CACHE_MAX_TEXT, context);
+            if (n) {
+                current = next;
+                length = n;
+                rebuilds++;
+            } else {
+                overflows++;
+            }
+            dirty = false;
+            formattedMs = nowMs;
+        }
+        len = length;
+        return text[current];
+    }
+
+    uint32_t getRequests() const { return requests; }
+    uint32_t getRebuilds() const { return rebuilds; }
+    uint32_t getOverflows() const { return overflows; }
+
+private:
+    Formatter format;
+    void* context;
+    uint32_t maxAgeMs;
+
+    char text[2][STATUS_CACHE_MAX_TEXT];
+    uint8_t current;           // Buffer holding the text being served
+    size_t length;
+    bool dirty;
+    uint32_t formattedMs;
+
+    uint32_t requests;
+    uint32_t rebuilds;
+    uint32_t overflows;
+};
+
+#endif // STATUS_CACHE_H
@@ -0,0 +1,57 @@
+/**
+ * Strum Engine Module
+ * Turns a timestamped strum edge plus the held frets into a strummed
+ * chord: which frets sound, in what order, and how far apart
+ *
+ * Down strums run low fret to high, up strums high to low. The per-string
+ * spread tightens as strums come faster, and up strokes are a little
+ * tighter than down strokes, like a real pick.
+ */
+
+#ifndef STRUM_ENGINE_H
+#define STRUM_ENGINE_H
+
+#include <stdint.h>
+
+#define STRUM_MAX_NOTES 5
+
+enum StrumDirection {
+    STRUM_DOWN = 0,
+    STRUM_UP
+};
+
+struct StrumNote {
+    uint8_t fret;             // 0-4 (green to orange)
+    uint32_t offsetSamples;   // Onset relative to the strum edge
+};
+
+class StrumEngine {
+public:
+    StrumEngine();
+
+    // Spread between adjacent strings for a slow strum, in microseconds
+    void setSpread(uint32_t spreadUs) { this->spreadUs = spreadUs; }
+    uint32_t getSpread() const { return spreadUs; }
+
+    void setSampleRate(uint32_t sampleRate) { this->sampleRate = sampleRate; }
+
+    // Plan a strum at timestampUs over the frets set in fretMask (bit 0 =
+    // green). Fills notes in onset order and returns how many there are.
+    uint8_t plan(StrumDirection direction, uint32_t timestampUs, uint8_t fretMask, StrumNote* notes);
+
+    // Spread actually used by the last plan(), for display/debugging
+    uint32_t getLastSpread() const { return lastSpreadUs; }
+
+    void reset() { haveLastStrum = false; }
+
+private:
+    uint32_t spreadUs;
+    uint32_t sampleRate;
+    uint32_t lastStrumUs;
+    uint32_t lastSpreadUs;
+    bool haveLastStrum;
+
+    uint32_t spreadForInterval(uint32_t intervalUs, StrumDirection direction) const;
+};
+
+#endif // STRUM_ENGINE_H
@@ -0,0 +1,94 @@
+/**
+ * Tuning Engine Module
+ * Loads Scala scale (.scl) and keyboard mapping (.kbm) files and compiles
+ * them into a 128-entry table of oscillator phase increments
+ *
+ * All the tuning math happens once, at load time. A note-on is then a
+ * single table read, however many notes or odd ratios the scale has.
+ * Two tables are kept: a load compiles into the idle one and publishes it
+ * with a single pointer store, so the audio side never sees a half-built
+ * table and notes already sounding keep their pitch.
+ *
+ * Parsing works on in-memory text so the same code reads SD files on the
+ * Teensy and plain files on the host.
+ */
+
+#ifndef TUNING_H
+#define TUNING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define TUNING_NOTES 128
+#define SCALA_MAX_NOTES 128          // Pitches per period we accept
+#define TUNING_DESCRIPTION_LENGTH 64
+#define PITCH_UNITS_PER_OCTAVE 65536 // Log-pitch resolution (Q16 octaves)
+
+// A parsed .scl file: pitches in cents above the tonic, the last one
+// being the period (usually 1200.0 = 2/1)
+struct ScalaScale {
+    char description[TUNING_DESCRIPTION_LENGTH];
+    uint8_t count;
+    double cents[SCALA_MAX_NOTES];
+};
+
+// A parsed .kbm file (see the Scala documentation for field meanings)
+#define KBM_UNMAPPED -1
+struct KeyboardMap {
+    uint8_t size;                // Keys per mapping pattern, 0 = linear
+    uint8_t firstNote;           // Keys outside first..last are silent
+    uint8_t lastNote;
+    uint8_t middleNote;          // Key that plays scale degree 0
+    uint8_t referenceNote;       // Key tuned to referenceFrequency
+    double referenceFrequency;
+    uint8_t octaveDegree;        // Scale degree one pattern repeat spans
+    int16_t map[TUNING_NOTES];   // Degree per pattern key, or KBM_UNMAPPED
+};
+
+struct TuningTable {
+    char description[TUNING_DESCRIPTION_LENGTH];
+    uint32_t phaseIncrements[TUNING_NOTES];  // 0 = key not mapped
+    int32_t pitches[TUNING_NOTES];           // log2(freq / 440Hz), PITCH_UNITS_PER_OCTAVE
+};
+
+// Parsers - false on malformed input
+bool scalaParse(const char* text, size_t len, ScalaScale& scale);
+bool keyboardMapParse(const char* text, size_t len, KeyboardMap& map);
+
+// 12-TET and the standard mapping (middle C = degree 0, A4 = 440Hz)
+void scalaEqualTemperament(ScalaScale& scale);
+void keyboardMapDefault(KeyboardMap& map);
+
+// Compile to phase increments at sampleRate; false if the reference key
+// isn't mapped
+bool tuningCompile(const ScalaScale& scale, const KeyboardMap& map, uint32_t sampleRate, TuningTable& table);
+
+class TuningEngine {
+public:
+    TuningEngine();
+
+    // Compile and publish a new tuning
+    bool load(const ScalaScale& scale, const KeyboardMap& map);
+
+    // Back to 12-TET
+    void reset();
+
+    uint32_t phaseIncrement(uint8_t note) const { return active->phaseIncrements[note & (TUNING_NOTES - 1)]; }
+    bool isMapped(uint8_t note) const { return phaseIncrement(note) != 0; }
+    float frequency(uint8_t note) const;
+
+    // Log-domain pitch, for glides and intervals between keys
+    int32_t pitch(uint8_t note) const { return active->pitches[note & (TUNING_NOTES - 1)]; }
+
+    const char* getDescription() const { return active->description; }
+
+    // Bumped on every swap so users of the table can tell it changed
+    uint32_t getGeneration() const { return generation; }
+
+private:
+    TuningTable tables[2];
+    TuningTable* volatile active;
+    volatile uint32_t generation;
+};
+
+#endif // TUNING_H
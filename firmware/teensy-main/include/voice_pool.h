@@ -0,0 +1,79 @@
+/**
+ * Voice Pool Module
+ * Partitions the shared synth voices between several controllers
+ *
+ * Every operation is O(1) in the number of voices: free voices sit on a
+ * stack, and each owner keeps its active voices in an intrusive list
+ * ordered oldest-first so the steal candidate is always the list head.
+ */
+
+#ifndef VOICE_POOL_H
+#define VOICE_POOL_H
+
+#include <stdint.h>
+
+#define VOICE_POOL_MAX_VOICES 16
+#define VOICE_POOL_MAX_OWNERS 4
+#define VOICE_NONE 0xFF
+
+class VoicePool {
+public:
+    VoicePool();
+
+    // Reset the pool to numVoices free voices shared by numOwners
+    void init(uint8_t numVoices, uint8_t numOwners);
+
+    // Fairness policy for one owner:
+    //   share - voices the owner is guaranteed; when the pool is empty it
+    //           may steal from an owner that is above its own share
+    //   limit - hard cap; above it the owner recycles its own oldest voice
+    void setShare(uint8_t owner, uint8_t share, uint8_t limit);
+
+    // Allocate a voice for owner. If a playing voice had to be stolen,
+    // its index is returned in *stolen (VOICE_NONE otherwise) so the
+    // caller can silence it. Returns VOICE_NONE if nothing is available.
+    uint8_t allocate(uint8_t owner, uint8_t* stolen);
+
+    // Return a voice to the free stack
+    void release(uint8_t voice);
+
+    // Queries
+    bool isActive(uint8_t voice) const { return voice < numVoices && voiceOwner[voice] != VOICE_NONE; }
+    uint8_t ownerOf(uint8_t voice) const { return voice < numVoices ? voiceOwner[voice] : VOICE_NONE; }
+    uint8_t activeCount(uint8_t owner) const { return owner < numOwners ? ownerCount[owner] : 0; }
+    uint8_t freeCount() const { return freeTop; }
+    uint8_t getShare(uint8_t owner) const { return owner < numOwners ? ownerShare[owner] : 0; }
+    uint8_t getLimit(uint8_t owner) const { return owner < numOwners ? ownerLimit[owner] : 0; }
+    uint32_t getStealCount(uint8_t owner) const { return owner < numOwners ? stealCount[owner] : 0; }
+
+    // Iterate an owner's voices, oldest first: first(owner), then next(voice)
+    uint8_t first(uint8_t owner) const { return owner < numOwners ? ownerHead[owner] : VOICE_NONE; }
+    uint8_t next(uint8_t voice) const { return voice < numVoices ? nextVoice[voice] : VOICE_NONE; }
+
+private:
+    uint8_t numVoices;
+    uint8_t numOwners;
+
+    // Free stack
+    uint8_t freeStack[VOICE_POOL_MAX_VOICES];
+    uint8_t freeTop;
+
+    // Per-voice links into the owner's age-ordered list
+    uint8_t voiceOwner[VOICE_POOL_MAX_VOICES];
+    uint8_t prevVoice[VOICE_POOL_MAX_VOICES];
+    uint8_t nextVoice[VOICE_POOL_MAX_VOICES];
+
+    // Per-owner bookkeeping
+    uint8_t ownerHead[VOICE_POOL_MAX_OWNERS];
+    uint8_t ownerTail[VOICE_POOL_MAX_OWNERS];
+    uint8_t ownerCount[VOICE_POOL_MAX_OWNERS];
+    uint8_t ownerShare[VOICE_POOL_MAX_OWNERS];
+    uint8_t ownerLimit[VOICE_POOL_MAX_OWNERS];
+    uint32_t stealCount[VOICE_POOL_MAX_OWNERS];
+
+    void link(uint8_t owner, uint8_t voice);
+    void unlink(uint8_t voice);
+    uint8_t stealOldest(uint8_t victimOwner);
+};
+
+#endif // VOICE_POOL_H
@@ -0,0 +1,83 @@
+/**
+ * Web Assets
+ * The web UIs' files, gzipped at build time and served from flash
+ *
+ * scripts/pre_build.py (in esp8266-wifi/) compresses a web/ directory
+ * into a generated header: one PROGMEM array per file plus a WebAsset
+ * table. The ESP streams each array out as it is, with
+ * Content-Encoding: gzip, so a page costs its compressed size in
+ * airtime and nothing on the heap.
+ *
+ * Caching:
+ *   index.html      - "no-cache" plus ETag: the browser asks every
+ *                     visit and gets a 304 with no body until the
+ *                     firmware changes
+ *   app.css, app.js - referenced as app.css?v=<etag>, so a new build
+ *                     means a new URL; cached for a year, never asked
+ *                     for again
+ *
+ * Header-only, no Arduino dependencies, so both sketches and the host
+ * tests share it. Include it before a generated asset header.
+ */
+
+#ifndef WEB_ASSET_H
+#define WEB_ASSET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define WEB_CACHE_IMMUTABLE "public, max-age=31536000, immutable"
+#define WEB_CACHE_REVALIDATE "no-cache"
+
+struct WebAsset {
+    const char* path;          // "/index.html", "/app.css"
+    const char* type;          // Content-Type
+    const uint8_t* data;       // gzip, in flash
+    uint32_t length;           // Of data
+    uint32_t rawLength;        // Before compression
+    const char* etag;          // Quoted, ready for the header
+    bool immutable;            // Referenced by versioned URL
+};
+
+inline const char* webAssetCacheControl(const WebAsset& asset) {
+    return asset.immutable ? WEB_CACHE_IMMUTABLE : WEB_CACHE_REVALIDATE;
+}
+
+// The asset for a request path; "/" is index.html and any query string
+// (the ?v= version) is ignored. NULL if there's none.
+inline const WebAsset* webAssetFind(const WebAsset* assets, size_t count, const char* path) {
+    if (strcmp(path, "/") == 0) path = "/index.html";
+    size_t len = strcspn(path, "?");
+    for (size_t i = 0; i < count; i++) {
+        if (strlen(assets[i].path) == len && strncmp(assets[i].path, path, len) == 0) return &assets[i];
+    }
+    return NULL;
+}
+
+// Whether an If-None-Match header covers etag: a list of tags, any of
+// them weak (W/), or *. A match means the browser's copy is current
+// and a 304 does.
+inline bool webEtagMatches(const char* ifNoneMatch, const char* etag) {
+    if (!ifNoneMatch) return false;
+    size_t etagLen = strlen(etag);
+    const char* p = ifNoneMatch;
+    while (*p) {
+        while (*p == ' ' || *p == ',') p++;
+        if (*p == '*') return true;
+        if (p[0] == 'W' && p[1] == '/') p += 2;
+        const char* end = p;
+        if (*end == '"') {
+            end = strchr(end + 1, '"');
+            if (!end) return false;
+            end++;
+        } else {
+            while (*end && *end != ',' && *end != ' ') end++;
+        }
+        if ((size_t)(end - p) == etagLen && strncmp(p, etag, etagLen) == 0) return true;
+        p = end;
+    }
+    return false;
+}
+
+#endif // WEB_ASSET_H
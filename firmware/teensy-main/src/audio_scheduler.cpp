@@ -0,0 +1,105 @@
+/**
+ * Sample-Accurate Note Scheduling Implementation
+ */
+
+#include "audio_scheduler.h"
+
+void AudioEffectOnsetGate::update(void) {
+    audio_block_t* block = receiveWritable(0);
+    if (!block) {
+        lastOut = 0;  // Idle envelope: nothing to fade from
+        return;
+    }
+
+    int16_t offset = pendingOffset;
+    pendingOffset = -1;
+
+    uint16_t start = 0;
+    if (offset >= 0) {
+        // Silence everything before the onset, then restart the fade-in.
+        // Whatever was still sounding fades from where it left off.
+        for (uint16_t i = 0; i < offset; i++) block->data[i] = 0;
+        start = offset;
+        rampPos = 0;
+        tail = lastOut;
+        tailPos = 0;
+    }
+
+    // Fade-in may carry across a block boundary
+    for (uint16_t i = start; i < AUDIO_BLOCK_SAMPLES && rampPos < ONSET_RAMP_SAMPLES; i++, rampPos++) {
+        block->data[i] = (int32_t)block->data[i] * rampPos / ONSET_RAMP_SAMPLES;
+    }
+
+    // So may the restruck note's fade-out
+    for (uint16_t i = 0; i < AUDIO_BLOCK_SAMPLES && tailPos < ONSET_RAMP_SAMPLES; i++, tailPos++) {
+        int32_t sample = block->data[i] + (int32_t)tail * (ONSET_RAMP_SAMPLES - tailPos) / ONSET_RAMP_SAMPLES;
+        block->data[i] = sample > 32767 ? 32767 : sample < -32768 ? -32768 : sample;
+    }
+
+    lastOut = block->data[AUDIO_BLOCK_SAMPLES - 1];
+    transmit(block);
+    release(block);
+}
+
+uint32_t AudioNoteScheduler::sampleAtMicros(uint32_t us) {
+    __disable_irq();
+    uint32_t sample = blockSample;
+    uint32_t micros0 = blockMicros;
+    __enable_irq();
+
+    // Signed delta: the timestamp may predate the current block
+    int32_t deltaUs = (int32_t)(us - micros0);
+    return sample + (int32_t)((int64_t)deltaUs * AUDIO_SAMPLE_RATE / 1000000);
+}
+
+bool AudioNoteScheduler::schedule(uint32_t sampleTime, uint8_t voice, float frequency, float amplitude) {
+    for (int i = 0; i < STRUM_MAX_PENDING; i++) {
+        Event& e = events[i];
+        if (!e.pending) {
+            e.sampleTime = sampleTime;
+            e.voice = voice;
+            e.frequency = frequency;
+            e.amplitude = amplitude;
+            // Publish last; update() only reads pending slots. The barrier
+            // keeps the compiler from sinking the plain stores below it.
+            __asm__ volatile("" ::: "memory");
+            e.pending = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void AudioNoteScheduler::cancel(uint8_t voice) {
+    for (int i = 0; i < STRUM_MAX_PENDING; i++) {
+        if (events[i].pending && events[i].voice == voice) {
+            events[i].pending = false;
+        }
+    }
+}
+
+void AudioNoteScheduler::update(void) {
+    // Stamp this block's first sample and start time together, so
+    // sampleAtMicros() maps a timestamp to the block it fell in
+    uint32_t start = nextSample;
+    blockSample = start;
+    blockMicros = micros();
+
+    for (int i = 0; i < STRUM_MAX_PENDING; i++) {
+        Event& e = events[i];
+        if (!e.pending) continue;
+
+        int32_t offset = (int32_t)(e.sampleTime - start);
+        if (offset >= AUDIO_BLOCK_SAMPLES) continue;  // Not this block yet
+
+        if (offset < 0) {
+            offset = 0;
+            lateCount++;
+        }
+        if (fire) fire(e.voice, e.frequency, e.amplitude, offset);
+        e.pending = false;
+        firedCount++;
+    }
+
+    nextSample = start + AUDIO_BLOCK_SAMPLES;
+}
@@ -3,16 +3,26 @@
  */
 
 #include "gh_controller.h"
+#include "hid_capture.h"
 #include <Arduino.h>
 
 void GuitarHeroController::init() {
     isConnected = false;
     driver = nullptr;
     device = nullptr;
+    profile = nullptr;
     vendorID = 0;
     productID = 0;
     reportAvailable = false;
     reportLength = 0;
+    reportMicros = 0;
+    reportCount = 0;
+    strumMicros = 0;
+    strumCount = 0;
+    strumDirection = STRUM_DOWN;
+    capture = nullptr;
+    captureIndex = 0;
+    liveInput = true;
 
     memset(&state, 0, sizeof(state));
     memset(&previousState, 0, sizeof(previousState));
@@ -28,60 +38,72 @@ void GuitarHeroController::init() {
 }
 
 hidclaim_t GuitarHeroController::claim_collection(USBHIDParser *driver, Device_t *dev, uint32_t topusage) {
-    // Check if this is a Guitar Hero controller
-    if (dev->idVendor == XBOX360_VID &&
-        (dev->idProduct == XBOX360_PID_GH_GUITAR || dev->idProduct == XBOX360_PID_GH_XPLORER)) {
-
-        Serial.print(F("Guitar Hero Controller detected! VID: 0x"));
-        Serial.print(dev->idVendor, HEX);
-        Serial.print(F(" PID: 0x"));
-        Serial.println(dev->idProduct, HEX);
-
-        this->driver = driver;
-        this->device = dev;
-        this->vendorID = dev->idVendor;
-        this->productID = dev->idProduct;
-
-        // Set controller name based on PID
-        if (dev->idProduct == XBOX360_PID_GH_GUITAR) {
-            strcpy(controllerName, "Guitar Hero Guitar");
-        } else if (dev->idProduct == XBOX360_PID_GH_XPLORER) {
-            strcpy(controllerName, "Guitar Hero X-plorer");
-        }
-
-        isConnected = true;
-        return CLAIM_INTERFACE;  // Claim this device
-    }
-
-    // Also check for generic Xbox 360 controllers that might be GH guitars
-    if (dev->idVendor == 0x045E && dev->idProduct == 0x028E) {  // Microsoft Xbox 360 controller
-        // Could be a Guitar Hero controller in Xbox mode
-        Serial.println(F("Xbox 360 controller detected - checking if Guitar Hero..."));
-        this->driver = driver;
-        this->device = dev;
-        this->vendorID = dev->idVendor;
-        this->productID = dev->idProduct;
-        strcpy(controllerName, "Xbox 360 Controller (Possible GH)");
-        isConnected = true;
-        return CLAIM_INTERFACE;
-    }
-
-    return CLAIM_NO;  // Don't claim this device
+    // Each instance drives one guitar; leave other devices to the next instance
+    if (device != nullptr && device != dev) return CLAIM_NO;
+
+    // Only claim devices with a known report layout
+    const ControllerProfile* match = findControllerProfile(dev->idVendor, dev->idProduct);
+    if (!match) return CLAIM_NO;  // Don't claim this device
+
+    Serial.print(F("Guitar Hero Controller detected! VID: 0x"));
+    Serial.print(dev->idVendor, HEX);
+    Serial.print(F(" PID: 0x"));
+    Serial.print(dev->idProduct, HEX);
+    Serial.print(F(" ("));
+    Serial.print(match->name);
+    Serial.println(F(")"));
+
+    this->driver = driver;
+    this->device = dev;
+    this->profile = match;
+    this->vendorID = dev->idVendor;
+    this->productID = dev->idProduct;
+    strncpy(controllerName, match->name, sizeof(controllerName) - 1);
+
+    isConnected = true;
+    return CLAIM_INTERFACE;  // Claim this device
 }
 
 bool GuitarHeroController::hid_process_in_data(const Transfer_t *transfer) {
     if (!transfer || !transfer->buffer) return false;
+    uint32_t arrivalMicros = micros();
 
     uint16_t len = transfer->length;
+    if (!liveInput) return true;  // Replaying
+    if (capture) {
+        capture->record(captureIndex, vendorID, productID, (const uint8_t*)transfer->buffer, len, arrivalMicros);
+    }
+
+    return injectReport((const uint8_t*)transfer->buffer, len, arrivalMicros);
+}
+
+bool GuitarHeroController::injectReport(const uint8_t* data, uint16_t len, uint32_t timestampUs,
+                                        const ControllerProfile* layout) {
     if (len > sizeof(reportBuffer)) len = sizeof(reportBuffer);
 
     // Copy the HID report data
-    memcpy(reportBuffer, transfer->buffer, len);
+    memcpy(reportBuffer, data, len);
     reportLength = len;
     reportAvailable = true;
 
     // Parse the HID report
-    return parseHIDReport(reportBuffer, reportLength);
+    bool parsed = parseHIDReport(reportBuffer, reportLength, layout);
+    if (parsed) {
+        reportMicros = timestampUs;
+
+        // Strum edges keep the report's own timestamp so the chord can be
+        // placed where the pick actually hit, not where the loop noticed
+        bool downEdge = state.strumDown && !previousState.strumDown;
+        bool upEdge = state.strumUp && !previousState.strumUp;
+        if (downEdge || upEdge) {
+            strumDirection = downEdge ? STRUM_DOWN : STRUM_UP;
+            strumMicros = timestampUs;
+            strumCount++;
+        }
+
+        reportCount++;
+    }
+    return parsed;
 }
 
 bool GuitarHeroController::hid_process_out_data(const Transfer_t *transfer) {
@@ -108,79 +130,27 @@ void GuitarHeroController::disconnect_collection(Device_t *dev) {
         isConnected = false;
         device = nullptr;
         driver = nullptr;
+        profile = nullptr;
         memset(&state, 0, sizeof(state));
     }
 }
 
-bool GuitarHeroController::parseHIDReport(const uint8_t* data, uint16_t len) {
-    // Xbox 360 controller HID report format
-    // Byte 0: Report ID (usually 0x00)
-    // Byte 1: Report length
-    // Bytes 2-3: Button state (16 bits)
-    // Byte 4: Left trigger
-    // Byte 5: Right trigger
-    // Bytes 6-7: Left stick X (signed 16-bit)
-    // Bytes 8-9: Left stick Y (signed 16-bit)
-    // Bytes 10-11: Right stick X (signed 16-bit)
-    // Bytes 12-13: Right stick Y (signed 16-bit)
-
-    if (len < 14) return false;  // Not enough data
+bool GuitarHeroController::parseHIDReport(const uint8_t* data, uint16_t len, const ControllerProfile* layout) {
+    // The claimed profile knows this controller's report layout; its
+    // decoder is specialised at compile time (see controller_profiles.h).
+    // Replay passes the captured device's profile instead.
+    if (!layout) layout = profile;
+    if (!layout) return false;
+    if (len < layout->minLength) return false;  // Not enough data
 
     // Save previous state for edge detection
     previousState = state;
 
-    // Parse button states (bytes 2-3)
-    uint16_t buttons = (data[3] << 8) | data[2];
-    updateButtonState(buttons);
-
-    // Parse analog controls
-    updateAnalogState(data);
-
-    // Store raw button state for debugging
-    state.buttonsRaw = buttons;
+    layout->decode(data, state);
 
     return true;
 }
 
-void GuitarHeroController::updateButtonState(uint16_t buttons) {
-    // Parse D-pad first (it's in the lower nibble of byte 2)
-    uint8_t dpad = buttons & 0x0F;
-    state.dpadUp = (dpad == DPAD_UP) || (dpad == (DPAD_UP | DPAD_LEFT)) || (dpad == (DPAD_UP | DPAD_RIGHT));
-    state.dpadDown = (dpad == DPAD_DOWN) || (dpad == (DPAD_DOWN | DPAD_LEFT)) || (dpad == (DPAD_DOWN | DPAD_RIGHT));
-    state.dpadLeft = (dpad == DPAD_LEFT) || (dpad == (DPAD_UP | DPAD_LEFT)) || (dpad == (DPAD_DOWN | DPAD_LEFT));
-    state.dpadRight = (dpad == DPAD_RIGHT) || (dpad == (DPAD_UP | DPAD_RIGHT)) || (dpad == (DPAD_DOWN | DPAD_RIGHT));
-
-    // Strum bar is mapped to D-pad up/down
-    state.strumUp = state.dpadUp;
-    state.strumDown = state.dpadDown;
-
-    // Parse fret buttons
-    state.greenFret = (buttons & BUTTON_GREEN) != 0;
-    state.redFret = (buttons & BUTTON_RED) != 0;
-    state.yellowFret = (buttons & BUTTON_YELLOW) != 0;
-    state.blueFret = (buttons & BUTTON_BLUE) != 0;
-    state.orangeFret = (buttons & BUTTON_ORANGE) != 0;
-
-    // Parse control buttons
-    state.starPower = (buttons & BUTTON_STAR) != 0;
-    state.plusButton = (buttons & BUTTON_PLUS) != 0;
-    state.minusButton = (buttons & BUTTON_MINUS) != 0;
-}
-
-void GuitarHeroController::updateAnalogState(const uint8_t* data) {
-    // Whammy bar is typically mapped to right trigger (byte 5)
-    state.whammyBar = data[5];
-
-    // Pickup selector might be on left trigger or analog stick
-    // This varies by controller model, may need adjustment
-    state.pickupSelector = (data[4] > 170) ? 2 : (data[4] > 85) ? 1 : 0;
-
-    // Tilt sensor (accelerometer) is typically mapped to analog sticks
-    // Left stick X/Y for tilt
-    state.tiltX = (int16_t)((data[7] << 8) | data[6]);
-    state.tiltY = (int16_t)((data[9] << 8) | data[8]);
-}
-
 void GuitarHeroController::rumble(uint8_t leftMotor, uint8_t rightMotor) {
     if (!isConnected || !driver) return;
 
@@ -0,0 +1,195 @@
+/**
+ * HID Capture and Replay Implementation
+ */
+
+#include "hid_capture.h"
+#include <string.h>
+
+static const uint8_t CAPTURE_MAGIC[4] = {'G', 'H', 'C', '1'};
+
+static void putU16(uint8_t* out, uint16_t v) {
+    out[0] = v & 0xFF;
+    out[1] = v >> 8;
+}
+
+static void putU32(uint8_t* out, uint32_t v) {
+    out[0] = v & 0xFF;
+    out[1] = (v >> 8) & 0xFF;
+    out[2] = (v >> 16) & 0xFF;
+    out[3] = v >> 24;
+}
+
+static uint16_t getU16(const uint8_t* in) {
+    return in[0] | (in[1] << 8);
+}
+
+static uint32_t getU32(const uint8_t* in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+void hidCaptureEncode(const HIDCaptureRecord& record, uint8_t* out) {
+    putU32(out, record.timestampUs);
+    out[4] = record.controller;
+    out[5] = record.length;
+    putU16(out + 6, record.sequence);
+    putU16(out + 8, record.vendorID);
+    putU16(out + 10, record.productID);
+    memcpy(out + 12, record.data, HID_CAPTURE_MAX_REPORT);
+}
+
+bool hidCaptureDecode(const uint8_t* in, HIDCaptureRecord& record) {
+    record.timestampUs = getU32(in);
+    record.controller = in[4];
+    record.length = in[5];
+    record.sequence = getU16(in + 6);
+    record.vendorID = getU16(in + 8);
+    record.productID = getU16(in + 10);
+    memcpy(record.data, in + 12, HID_CAPTURE_MAX_REPORT);
+    return record.length <= HID_CAPTURE_MAX_REPORT;
+}
+
+size_t hidCaptureWriteHeader(HIDCaptureWriteFn write, void* ctx) {
+    uint8_t header[HID_CAPTURE_HEADER_SIZE];
+    memcpy(header, CAPTURE_MAGIC, 4);
+    putU16(header + 4, HID_CAPTURE_VERSION);
+    putU16(header + 6, HID_CAPTURE_RECORD_SIZE);
+    return write(ctx, header, sizeof(header));
+}
+
+bool hidCaptureReadHeader(HIDCaptureReadFn read, void* ctx) {
+    uint8_t header[HID_CAPTURE_HEADER_SIZE];
+    if (read(ctx, header, sizeof(header)) != sizeof(header)) return false;
+    if (memcmp(header, CAPTURE_MAGIC, 4) != 0) return false;
+    if (getU16(header + 4) != HID_CAPTURE_VERSION) return false;
+    return getU16(header + 6) == HID_CAPTURE_RECORD_SIZE;
+}
+
+// ===== Capture =====
+
+HIDCapture::HIDCapture() {
+    head = 0;
+    tail = 0;
+    active = false;
+    sequence = 0;
+    recorded = 0;
+    dropped = 0;
+}
+
+void HIDCapture::begin() {
+    head = 0;
+    tail = 0;
+    sequence = 0;
+    recorded = 0;
+    dropped = 0;
+    active = true;
+}
+
+void HIDCapture::end() {
+    active = false;
+}
+
+void HIDCapture::record(uint8_t controller, uint16_t vendorID, uint16_t productID,
+                        const uint8_t* data, uint16_t len, uint32_t timestampUs) {
+    if (!active) return;
+    if (len > HID_CAPTURE_MAX_REPORT) len = HID_CAPTURE_MAX_REPORT;
+
+    uint16_t h = head;
+    uint16_t seq = sequence++;
+    if ((uint16_t)(h - tail) >= HID_CAPTURE_RING_SIZE) {
+        // Ring full - the sequence gap tells replay a report went missing
+        dropped++;
+        return;
+    }
+
+    HIDCaptureRecord& rec = ring[h & (HID_CAPTURE_RING_SIZE - 1)];
+    rec.timestampUs = timestampUs;
+    rec.controller = controller;
+    rec.length = len;
+    rec.sequence = seq;
+    rec.vendorID = vendorID;
+    rec.productID = productID;
+    memcpy(rec.data, data, len);
+    memset(rec.data + len, 0, HID_CAPTURE_MAX_REPORT - len);
+
+    head = h + 1;
+    recorded++;
+}
+
+uint16_t HIDCapture::drain(HIDCaptureWriteFn write, void* ctx) {
+    uint8_t encoded[HID_CAPTURE_RECORD_SIZE];
+    uint16_t written = 0;
+
+    while (tail != head) {
+        hidCaptureEncode(ring[tail & (HID_CAPTURE_RING_SIZE - 1)], encoded);
+        if (write(ctx, encoded, sizeof(encoded)) != sizeof(encoded)) break;
+        tail = tail + 1;
+        written++;
+    }
+    return written;
+}
+
+// ===== Replay =====
+
+HIDReplay::HIDReplay() {
+    read = nullptr;
+    readCtx = nullptr;
+    mode = REPLAY_REALTIME;
+    active = false;
+    havePending = false;
+    firstCaptureUs = 0;
+    startUs = 0;
+    lastSequence = 0;
+    delivered = 0;
+    sequenceGaps = 0;
+}
+
+bool HIDReplay::begin(HIDCaptureReadFn readFn, void* ctx, Mode replayMode, uint32_t nowUs) {
+    read = readFn;
+    readCtx = ctx;
+    mode = replayMode;
+    delivered = 0;
+    sequenceGaps = 0;
+    active = false;
+
+    if (!hidCaptureReadHeader(read, readCtx)) return false;
+    if (!fetch()) return false;
+
+    firstCaptureUs = pending.timestampUs;
+    lastSequence = pending.sequence - 1;
+    startUs = nowUs;
+    active = true;
+    return true;
+}
+
+bool HIDReplay::fetch() {
+    uint8_t encoded[HID_CAPTURE_RECORD_SIZE];
+    havePending = read(readCtx, encoded, sizeof(encoded)) == sizeof(encoded) &&
+                  hidCaptureDecode(encoded, pending);
+    return havePending;
+}
+
+uint16_t HIDReplay::poll(uint32_t nowUs, HIDReplaySink sink, void* sinkCtx) {
+    uint16_t count = 0;
+
+    while (active && havePending) {
+        // Compare elapsed times rather than absolute stamps so micros()
+        // wrap-around on either side doesn't matter
+        if (mode == REPLAY_REALTIME &&
+            (pending.timestampUs - firstCaptureUs) > (nowUs - startUs)) {
+            break;
+        }
+
+        if ((uint16_t)(pending.sequence - lastSequence) != 1) sequenceGaps++;
+        lastSequence = pending.sequence;
+
+        sink(sinkCtx, pending);
+        delivered++;
+        count++;
+
+        if (!fetch()) active = false;
+        if (mode == REPLAY_FAST) break;
+    }
+
+    if (!havePending) active = false;
+    return count;
+}
@@ -4,14 +4,15 @@
  *
  * Hardware:
  * - Teensy 4.1 (ARM Cortex-M7 @ 600MHz)
- * - USB Host for Xbox 360 Guitar Hero Controller
- * - Audio output via I2S (PCM5102A DAC recommended)
+ * - USB Host for Xbox 360 Guitar Hero Controllers (up to NUM_CONTROLLERS via hub)
+ * - Audio output via I2S (PCM5102A DAC recommended), mirrored to USB audio
  * - ESP8266 for WiFi control (Serial1)
+ * - USB-MIDI out/in for recording into a DAW (midi_io.h)
  *
  * Audio Specifications:
  * - Sample Rate: 44.1kHz
  * - Bit Depth: 16-bit
- * - Polyphony: 6 voices
+ * - Polyphony: 8 voices, partitioned between players
  * - Target Latency: <5ms
  */
 
@@ -26,6 +27,18 @@
 #include "gh_controller.h"
 #include "synth_engine.h"
 #include "scale_quantizer.h"
+#include "voice_pool.h"
+#include "hid_capture.h"
+#include "strum_engine.h"
+#include "audio_scheduler.h"
+#include "analog_conditioner.h"
+#include "tuning.h"
+#include "audio_pitch_bus.h"
+#include "link_protocol.h"
+#include "link_flow.h"
+#include "link_tx_queue.h"
+#include "link_state.h"
+#include "midi_io.h"
 #include "config.h"
 
 // USB Host objects
@@ -35,17 +48,36 @@ USBHIDParser hid1(myusb);
 USBHIDParser hid2(myusb);
 USBHIDParser hid3(myusb);
 
-// Custom Guitar Hero controller driver
-GuitarHeroController ghController(myusb);
+// Custom Guitar Hero controller drivers - one instance per guitar
+GuitarHeroController ghController1(myusb);
+GuitarHeroController ghController2(myusb);
+GuitarHeroController* controllers[NUM_CONTROLLERS] = {&ghController1, &ghController2};
 
-// Audio system objects - 6 voice polyphonic synthesizer
+// Audio system objects - 8 voice polyphonic synthesizer
 // Using PCM5102A DAC for better quality and simpler wiring (no control lines needed)
+
+// Strummed note-ons fire from inside the audio update; this must be
+// constructed before the voices so it updates ahead of them each block
+AudioNoteScheduler noteScheduler;
+
+// Per-voice audio-rate pitch offsets (scale glides), ahead of the voices
+AudioPitchBus pitchBus1;
+AudioPitchBus pitchBus2;
+AudioPitchBus pitchBus3;
+AudioPitchBus pitchBus4;
+AudioPitchBus pitchBus5;
+AudioPitchBus pitchBus6;
+AudioPitchBus pitchBus7;
+AudioPitchBus pitchBus8;
+
 AudioSynthWaveformModulated voice1;
 AudioSynthWaveformModulated voice2;
 AudioSynthWaveformModulated voice3;
 AudioSynthWaveformModulated voice4;
 AudioSynthWaveformModulated voice5;
 AudioSynthWaveformModulated voice6;
+AudioSynthWaveformModulated voice7;
+AudioSynthWaveformModulated voice8;
 
 AudioEffectEnvelope env1;
 AudioEffectEnvelope env2;
@@ -53,6 +85,18 @@ AudioEffectEnvelope env3;
 AudioEffectEnvelope env4;
 AudioEffectEnvelope env5;
 AudioEffectEnvelope env6;
+AudioEffectEnvelope env7;
+AudioEffectEnvelope env8;
+
+// Onset gates start scheduled notes at their exact sample within a block
+AudioEffectOnsetGate gate1;
+AudioEffectOnsetGate gate2;
+AudioEffectOnsetGate gate3;
+AudioEffectOnsetGate gate4;
+AudioEffectOnsetGate gate5;
+AudioEffectOnsetGate gate6;
+AudioEffectOnsetGate gate7;
+AudioEffectOnsetGate gate8;
 
 AudioFilterStateVariable filter1;
 AudioFilterStateVariable filter2;
@@ -60,10 +104,15 @@ AudioFilterStateVariable filter3;
 AudioFilterStateVariable filter4;
 AudioFilterStateVariable filter5;
 AudioFilterStateVariable filter6;
+AudioFilterStateVariable filter7;
+AudioFilterStateVariable filter8;
 
 AudioMixer4 voiceMixer1;  // Voices 1-4
-AudioMixer4 voiceMixer2;  // Voices 5-6 + effects return
-AudioMixer4 mainMixer;    // Final mix
+AudioMixer4 voiceMixer2;  // Voices 5-8
+AudioMixer4 mainMixer;    // Final mix + effects return
+#if USB_AUDIO_DRY
+AudioMixer4 dryMixer;     // All voices before effects, for USB only
+#endif
 
 AudioEffectReverb reverb;
 AudioEffectDelay delay1;
@@ -71,53 +120,167 @@ AudioMixer4 effectsSend;
 AudioMixer4 effectsReturn;
 
 AudioOutputI2S i2s_out;
-AudioConnection patchCords[30];  // We'll initialize these in setup()
+AudioOutputUSB usb_out;   // Recording tap; i2s_out drives the updates
+AudioConnection patchCords[56];  // We'll initialize these in setup()
 
 // Synthesizer engine
 SynthEngine synthEngine;
-ScaleQuantizer scaleQuantizer;
 
 // Performance monitoring
 elapsedMillis perfTimer;
 uint32_t loopCount = 0;
+uint32_t loopMaxUs = 0;      // Longest loop() since the last perf report
+uint32_t totalNotes = 0;
 float cpuUsageMax = 0;
 float memoryUsageMax = 0;
 
 // Serial communication with ESP8266
 HardwareSerial &ESP_SERIAL = Serial1;  // TX1(pin 1), RX1(pin 0)
 const uint32_t ESP_BAUD = 115200;
+LinkDecoder espLink;  // Framed binary messages from the ESP (link_protocol.h)
+LinkTxQueue espTx;    // Outbound frames, handed to the UART without blocking
+LinkFlow espFlow(ESP_RX_HARDWARE_BYTES + ESP_RX_BUFFER_BYTES);  // Credit both ways, RTT (link_flow.h)
+uint8_t espTxBuffer[ESP_TX_BUFFER_BYTES];
+uint8_t espRxBuffer[ESP_RX_BUFFER_BYTES];
+LinkStateSender espState;   // Shared state, sent to the ESP as deltas (link_state.h)
+LinkNoteBatcher espNotes;   // Note events, one frame per LINK_NOTE_BATCH_MS
+uint32_t espNoteBatchesLost = 0;   // Refused by a full notes lane
+uint32_t espStatesRefused = 0;     // Refused by a full command lane; retried
+elapsedMillis espTimer;
+
+// USB-MIDI (midi_io.h): notes, whammy bend and tilt CC out to a DAW, once
+// per USB microframe; player p plays on channel MIDI_CHANNEL + p, and
+// the same channels coming in play the engine
+MidiOutBatcher midiOut;
+MidiRoundTrip midiRtt;
+elapsedMillis midiProbeTimer;
+bool midiProbing = false;       // 'm': round-trip probes every MIDI_PROBE_INTERVAL_MS
+bool midiDispatching = false;   // Playing USB-MIDI input; its voices aren't echoed back out
+uint32_t midiInCount = 0;
+
+// USB audio ('u' toggles, to compare CPU and blocks with and without it)
+bool usbAudioOn = true;
+
+// What the whammy/tilt sweep: the usual bend and filter, or a glide
+// that snaps to the player's scale
+enum GlideMode {
+    GLIDE_OFF = 0,
+    GLIDE_WHAMMY,
+    GLIDE_TILT,
+    NUM_GLIDE_MODES
+};
 
-// State variables
-bool controllerConnected = false;
-uint32_t lastControllerUpdate = 0;
-uint8_t currentScale = 0;  // 0-5 for 6 scales
-int8_t octaveShift = 0;    // -2 to +2 octaves
-float pitchBend = 0.0f;    // -1.0 to +1.0 (normalized from whammy bar)
+// Per-player state - each guitar keeps its own scale, octave and bend
+struct Player {
+    GuitarHeroController* controller;
+    ScaleQuantizer scaleQuantizer;
+    bool connected;
+    uint8_t currentScale;    // 0-5 for 6 scales
+    int8_t octaveShift;      // -2 to +2 octaves
+    float pitchBend;         // -1.0 to +1.0 (normalized from whammy bar)
+    uint8_t glideMode;       // GlideMode
+    int32_t glideOffset;     // Unsnapped sweep, SNAP_STEPS_PER_SEMITONE units
+    float portamentoMs;      // Slide from the previous note, 0 = off
+    uint8_t lastNote;        // Previous note-on, 0 = none yet
+    bool fretStates[5];
+    uint8_t lastPickup;
+    GHControllerState lastState;
+    uint32_t lastControllerUpdate;
+
+    // Strummed chords
+    StrumEngine strumEngine;
+    uint32_t lastStrumCount;
+
+    // Conditioned analog controls - at most one update per audio block
+    AnalogConditioner whammy;
+    AnalogConditioner tilt;
+
+    // Input latency (report arrival -> note on), reset every perf report
+    uint32_t lastReportCount;
+    uint32_t latencyCount;
+    uint32_t latencySumUs;
+    uint32_t latencyMaxUs;
+};
+
+Player players[NUM_CONTROLLERS];
 
-// Voice allocation
+// Voice allocation - voices are indexed through the shared pool
 struct Voice {
-    bool active;
-    uint8_t note;
+    uint8_t note;            // 0 = not sounding
+    uint8_t player;          // Who played it, for the note-off
+    bool fromMIDI;           // Played from USB-MIDI input, so not sent back out
     uint8_t velocity;
     uint32_t startTime;
     AudioSynthWaveformModulated* waveform;
+    AudioPitchBus* pitchBus;
     AudioEffectEnvelope* envelope;
+    AudioEffectOnsetGate* gate;
     AudioFilterStateVariable* filter;
+
+    // Pitch bus at the onset: start here, slide to the target (portamento)
+    int32_t onsetPitch;
+    int32_t onsetTarget;
+    float onsetGlideMs;      // 0 = start on the target
 };
 
 Voice voices[NUM_VOICES];
+VoicePool voicePool;
+
+// Note -> pitch table (12-TET until a Scala file is loaded)
+TuningEngine tuning;
+ScalaScale scalaScale;       // Parse buffers, kept off the stack
+KeyboardMap keyboardMap;
+char tuningText[TUNING_MAX_FILE_SIZE];
+
+// HID capture (raw reports to SD) and deterministic replay
+HIDCapture hidCapture;
+HIDReplay hidReplay;
+File captureFile;
+bool sdReady = false;
+uint32_t replayStartUs = 0;
+uint32_t replayDigest = HID_CAPTURE_HASH_SEED;  // Fingerprint of note events during replay
 
 // Function prototypes
 void setupAudio();
 void setupUSBHost();
-void processControllerInput();
-void updateSynthParameters();
-void noteOn(uint8_t note, uint8_t velocity);
-void noteOff(uint8_t note);
-int8_t allocateVoice();
+void processControllerInput(uint8_t playerIndex);
+void processAnalogControls(uint8_t playerIndex, bool freshReport);
+void applyWhammy(uint8_t playerIndex, int16_t value);
+void applyTilt(uint8_t playerIndex, int16_t value);
+void glideVoices(uint8_t playerIndex, int16_t value);
+int32_t glidePitch(uint8_t playerIndex, uint8_t note);
+void setGlideMode(uint8_t mode);
+void modulateVoice(uint8_t playerIndex, uint8_t voiceIndex);
+void applyDetune();
+bool noteOn(uint8_t playerIndex, uint8_t note, uint8_t velocity);
+void strumChord(uint8_t playerIndex, StrumDirection direction, uint32_t strumUs, uint8_t fretMask);
+bool scheduleNote(uint8_t playerIndex, uint8_t note, float frequency, uint8_t velocity, uint32_t sampleTime, uint8_t fromNote);
+void planVoicePitch(uint8_t playerIndex, uint8_t voiceIndex, uint8_t note, uint8_t fromNote);
+void startVoicePitch(uint8_t voiceIndex);
+void fireScheduledNote(uint8_t voiceIndex, float frequency, float amplitude, uint16_t offset);
+void noteOff(uint8_t playerIndex, uint8_t note);
+void endVoiceNote(uint8_t voiceIndex);
 void releaseVoice(uint8_t voiceIndex);
-void sendESPStatus();
+void releasePlayerVoices(uint8_t playerIndex);
+void resetPlayer(uint8_t playerIndex);
+bool anyControllerConnected();
+void handleDebugCommand();
+void toggleCapture();
+void startReplay(HIDReplay::Mode mode);
+void loadTuning();
+void applyTuning();
+void serviceCaptureReplay();
+void finishReplay();
+void syncESPState(LinkLane lane = LINK_LANE_COMMAND);
+void sendESPNote(uint8_t playerIndex, uint8_t note, uint8_t velocity);
+void sendESPFrame(uint8_t type, const uint8_t* payload, size_t len, LinkLane lane);
+void serviceESPLink();
 void handleSerialCommand();
+void applyLinkParam(const LinkSetParam& param);
+void sendMIDINote(uint8_t playerIndex, uint8_t note, uint8_t velocity, uint32_t atUs);
+void serviceMIDI();
+void handleMIDIInput();
+void setUSBAudio(bool on);
 void performanceReport();
 
 void setup() {
@@ -130,6 +293,8 @@ void setup() {
 
     // Initialize ESP8266 serial
     ESP_SERIAL.begin(ESP_BAUD);
+    ESP_SERIAL.addMemoryForWrite(espTxBuffer, sizeof(espTxBuffer));
+    ESP_SERIAL.addMemoryForRead(espRxBuffer, sizeof(espRxBuffer));
 
     // Initialize audio system
     AudioMemory(64);  // Allocate audio memory blocks
@@ -142,23 +307,41 @@ void setup() {
     // Initialize synthesizer engine
     synthEngine.init();
 
-    // Initialize scale quantizer with Pentatonic Minor as default
-    scaleQuantizer.setScale(SCALE_PENTATONIC_MINOR);
+    // Initialize players - each starts on Pentatonic Minor
+    for (int p = 0; p < NUM_CONTROLLERS; p++) {
+        players[p].controller = controllers[p];
+        players[p].connected = false;
+        players[p].glideMode = GLIDE_OFF;
+        players[p].portamentoMs = PORTAMENTO_TIME_MS;
+        players[p].whammy.init(WHAMMY_DEADZONE, WHAMMY_SPAN, ANALOG_SMOOTHING_SHIFT, WHAMMY_HYSTERESIS);
+        players[p].tilt.init(TILT_DEADZONE, TILT_SPAN, ANALOG_SMOOTHING_SHIFT, TILT_HYSTERESIS);
+        players[p].scaleQuantizer.setTuning(&tuning);
+        resetPlayer(p);
+        controllers[p]->setCapture(&hidCapture, p);
+    }
+
+    // Partition the voice pool between players
+    voicePool.init(NUM_VOICES, NUM_CONTROLLERS);
+    for (int p = 0; p < NUM_CONTROLLERS; p++) {
+        voicePool.setShare(p, VOICE_SHARE_DEFAULT, VOICE_LIMIT_DEFAULT);
+    }
 
     // Initialize voice structures
-    voices[0] = {false, 0, 0, 0, &voice1, &env1, &filter1};
-    voices[1] = {false, 0, 0, 0, &voice2, &env2, &filter2};
-    voices[2] = {false, 0, 0, 0, &voice3, &env3, &filter3};
-    voices[3] = {false, 0, 0, 0, &voice4, &env4, &filter4};
-    voices[4] = {false, 0, 0, 0, &voice5, &env5, &filter5};
-    voices[5] = {false, 0, 0, 0, &voice6, &env6, &filter6};
+    voices[0] = {0, 0, false, 0, 0, &voice1, &pitchBus1, &env1, &gate1, &filter1};
+    voices[1] = {0, 0, false, 0, 0, &voice2, &pitchBus2, &env2, &gate2, &filter2};
+    voices[2] = {0, 0, false, 0, 0, &voice3, &pitchBus3, &env3, &gate3, &filter3};
+    voices[3] = {0, 0, false, 0, 0, &voice4, &pitchBus4, &env4, &gate4, &filter4};
+    voices[4] = {0, 0, false, 0, 0, &voice5, &pitchBus5, &env5, &gate5, &filter5};
+    voices[5] = {0, 0, false, 0, 0, &voice6, &pitchBus6, &env6, &gate6, &filter6};
+    voices[6] = {0, 0, false, 0, 0, &voice7, &pitchBus7, &env7, &gate7, &filter7};
+    voices[7] = {0, 0, false, 0, 0, &voice8, &pitchBus8, &env8, &gate8, &filter8};
 
     // Configure waveforms - start with sawtooth for rich harmonics
     for (int i = 0; i < NUM_VOICES; i++) {
         voices[i].waveform->begin(WAVEFORM_SAWTOOTH);
         voices[i].waveform->amplitude(0.8);
         voices[i].waveform->frequency(440.0);
-        voices[i].waveform->frequencyModulation(1.0);
+        voices[i].waveform->frequencyModulation(PITCH_BUS_OCTAVES);
 
         // Configure ADSR envelope
         voices[i].envelope->attack(5.0);
@@ -173,6 +356,9 @@ void setup() {
         voices[i].filter->octaveControl(1.0);
     }
 
+    applyDetune();
+    noteScheduler.setFireCallback(fireScheduledNote);
+
     // Configure effects
     reverb.roomsize(0.7);
     delay1.delay(0, 150.0);  // 150ms delay
@@ -185,67 +371,101 @@ void setup() {
 
     voiceMixer2.gain(0, 0.25);  // Voice 5
     voiceMixer2.gain(1, 0.25);  // Voice 6
-    voiceMixer2.gain(2, 0.5);   // Effects return
+    voiceMixer2.gain(2, 0.25);  // Voice 7
+    voiceMixer2.gain(3, 0.25);  // Voice 8
 
     mainMixer.gain(0, 0.5);     // Voice mixer 1
     mainMixer.gain(1, 0.5);     // Voice mixer 2
-    mainMixer.gain(2, 0.0);     // Unused
-    mainMixer.gain(3, 0.0);     // Unused
+    mainMixer.gain(2, 0.25);    // Effects return
+    mainMixer.gain(3, 0.0);     // Note scheduler (silent, keeps it updating)
 
     effectsSend.gain(0, 0.3);   // Reverb send
     effectsSend.gain(1, 0.2);   // Delay send
 
+#if USB_AUDIO_DRY
+    dryMixer.gain(0, 0.5);      // Voice mixer 1, as in the main mix
+    dryMixer.gain(1, 0.5);      // Voice mixer 2
+#endif
+
     effectsReturn.gain(0, 0.5); // Reverb return
     effectsReturn.gain(1, 0.5); // Delay return
 
     Serial.println(F("Initialization complete!"));
-    Serial.println(F("Waiting for Guitar Hero controller..."));
+    Serial.println(F("Waiting for Guitar Hero controllers..."));
 }
 
 void loop() {
+    uint32_t loopStartUs = micros();
+
     // Process USB Host tasks
     myusb.Task();
 
-    // Check if controller is connected
-    if (ghController.connected()) {
-        if (!controllerConnected) {
-            controllerConnected = true;
-            Serial.println(F("Guitar Hero controller connected!"));
-            sendESPStatus();
-        }
-
-        // Process controller input
-        processControllerInput();
+    // Debug commands (capture/replay) from the USB serial console
+    if (Serial.available()) {
+        handleDebugCommand();
+    }
 
-    } else {
-        if (controllerConnected) {
-            controllerConnected = false;
-            Serial.println(F("Guitar Hero controller disconnected!"));
-            // Release all notes
-            for (int i = 0; i < NUM_VOICES; i++) {
-                if (voices[i].active) {
-                    releaseVoice(i);
-                }
+    // Write captured reports to SD, or feed a replay in place of live input
+    serviceCaptureReplay();
+
+    // Check each player's controller
+    for (int p = 0; p < NUM_CONTROLLERS && !hidReplay.isActive(); p++) {
+        Player& player = players[p];
+
+        if (player.controller->connected()) {
+            if (!player.connected) {
+                player.connected = true;
+                player.lastReportCount = player.controller->getReportCount();
+                player.lastStrumCount = player.controller->getStrumCount();
+                // Recalibrate whammy rest and tilt level from the first report
+                player.whammy.reset();
+                player.tilt.reset();
+                Serial.print(F("Guitar Hero controller connected! Player "));
+                Serial.println(p + 1);
+                syncESPState();
             }
-            sendESPStatus();
+
+            // Process controller input
+            processControllerInput(p);
+
+        } else if (player.connected) {
+            player.connected = false;
+            Serial.print(F("Guitar Hero controller disconnected! Player "));
+            Serial.println(p + 1);
+            // Release this player's notes
+            releasePlayerVoices(p);
+            memset(player.fretStates, 0, sizeof(player.fretStates));
+            memset(&player.lastState, 0, sizeof(player.lastState));
+            syncESPState();
         }
     }
 
-    // Update synthesizer parameters based on controls
-    updateSynthParameters();
-
     // Handle ESP8266 serial communication
     if (ESP_SERIAL.available()) {
         handleSerialCommand();
     }
+    if (espTimer >= ESP_UPDATE_RATE) {
+        espTimer = 0;
+        syncESPState(LINK_LANE_TELEMETRY);
+    }
+    uint8_t notes[LINK_MAX_PAYLOAD];
+    size_t notesLen = espNotes.poll(millis(), notes);
+    if (notesLen) sendESPFrame(LINK_MSG_NOTES, notes, notesLen, LINK_LANE_NOTES);
+    serviceESPLink();
+
+    // USB-MIDI in, probes, and this pass's events out in one packet
+    serviceMIDI();
 
     // Performance monitoring (every second)
     if (perfTimer >= 1000) {
         performanceReport();
         perfTimer = 0;
         loopCount = 0;
+        loopMaxUs = 0;
     }
     loopCount++;
+    uint32_t loopUs = micros() - loopStartUs;
+    if (loopUs > loopMaxUs) loopMaxUs = loopUs;
 
     // Keep loop fast - target >1000Hz for low latency
     delayMicroseconds(100);
@@ -255,66 +475,124 @@ void setupAudio() {
     Serial.println(F("Configuring audio system..."));
 
     // Create audio connections
+    // Each voice: oscillator -> envelope -> onset gate -> filter -> mixer
+
     // Voice 1 path
     patchCords[0] = AudioConnection(voice1, env1);
-    patchCords[1] = AudioConnection(env1, 0, filter1, 0);
-    patchCords[2] = AudioConnection(filter1, 0, voiceMixer1, 0);
+    patchCords[1] = AudioConnection(env1, 0, gate1, 0);
+    patchCords[2] = AudioConnection(gate1, 0, filter1, 0);
+    patchCords[3] = AudioConnection(filter1, 0, voiceMixer1, 0);
 
     // Voice 2 path
-    patchCords[3] = AudioConnection(voice2, env2);
-    patchCords[4] = AudioConnection(env2, 0, filter2, 0);
-    patchCords[5] = AudioConnection(filter2, 0, voiceMixer1, 1);
+    patchCords[4] = AudioConnection(voice2, env2);
+    patchCords[5] = AudioConnection(env2, 0, gate2, 0);
+    patchCords[6] = AudioConnection(gate2, 0, filter2, 0);
+    patchCords[7] = AudioConnection(filter2, 0, voiceMixer1, 1);
 
     // Voice 3 path
-    patchCords[6] = AudioConnection(voice3, env3);
-    patchCords[7] = AudioConnection(env3, 0, filter3, 0);
-    patchCords[8] = AudioConnection(filter3, 0, voiceMixer1, 2);
+    patchCords[8] = AudioConnection(voice3, env3);
+    patchCords[9] = AudioConnection(env3, 0, gate3, 0);
+    patchCords[10] = AudioConnection(gate3, 0, filter3, 0);
+    patchCords[11] = AudioConnection(filter3, 0, voiceMixer1, 2);
 
     // Voice 4 path
-    patchCords[9] = AudioConnection(voice4, env4);
-    patchCords[10] = AudioConnection(env4, 0, filter4, 0);
-    patchCords[11] = AudioConnection(filter4, 0, voiceMixer1, 3);
+    patchCords[12] = AudioConnection(voice4, env4);
+    patchCords[13] = AudioConnection(env4, 0, gate4, 0);
+    patchCords[14] = AudioConnection(gate4, 0, filter4, 0);
+    patchCords[15] = AudioConnection(filter4, 0, voiceMixer1, 3);
 
     // Voice 5 path
-    patchCords[12] = AudioConnection(voice5, env5);
-    patchCords[13] = AudioConnection(env5, 0, filter5, 0);
-    patchCords[14] = AudioConnection(filter5, 0, voiceMixer2, 0);
+    patchCords[16] = AudioConnection(voice5, env5);
+    patchCords[17] = AudioConnection(env5, 0, gate5, 0);
+    patchCords[18] = AudioConnection(gate5, 0, filter5, 0);
+    patchCords[19] = AudioConnection(filter5, 0, voiceMixer2, 0);
 
     // Voice 6 path
-    patchCords[15] = AudioConnection(voice6, env6);
-    patchCords[16] = AudioConnection(env6, 0, filter6, 0);
-    patchCords[17] = AudioConnection(filter6, 0, voiceMixer2, 1);
+    patchCords[20] = AudioConnection(voice6, env6);
+    patchCords[21] = AudioConnection(env6, 0, gate6, 0);
+    patchCords[22] = AudioConnection(gate6, 0, filter6, 0);
+    patchCords[23] = AudioConnection(filter6, 0, voiceMixer2, 1);
+
+    // Voice 7 path
+    patchCords[24] = AudioConnection(voice7, env7);
+    patchCords[25] = AudioConnection(env7, 0, gate7, 0);
+    patchCords[26] = AudioConnection(gate7, 0, filter7, 0);
+    patchCords[27] = AudioConnection(filter7, 0, voiceMixer2, 2);
+
+    // Voice 8 path
+    patchCords[28] = AudioConnection(voice8, env8);
+    patchCords[29] = AudioConnection(env8, 0, gate8, 0);
+    patchCords[30] = AudioConnection(gate8, 0, filter8, 0);
+    patchCords[31] = AudioConnection(filter8, 0, voiceMixer2, 3);
 
     // Effects sends
-    patchCords[18] = AudioConnection(voiceMixer1, 0, effectsSend, 0);
-    patchCords[19] = AudioConnection(voiceMixer2, 0, effectsSend, 1);
+    patchCords[32] = AudioConnection(voiceMixer1, 0, effectsSend, 0);
+    patchCords[33] = AudioConnection(voiceMixer2, 0, effectsSend, 1);
 
     // Effects processing
-    patchCords[20] = AudioConnection(effectsSend, reverb);
-    patchCords[21] = AudioConnection(effectsSend, delay1);
-    patchCords[22] = AudioConnection(reverb, 0, effectsReturn, 0);
-    patchCords[23] = AudioConnection(delay1, 0, effectsReturn, 1);
-
-    // Effects return to voice mixer 2
-    patchCords[24] = AudioConnection(effectsReturn, 0, voiceMixer2, 2);
+    patchCords[34] = AudioConnection(effectsSend, reverb);
+    patchCords[35] = AudioConnection(effectsSend, delay1);
+    patchCords[36] = AudioConnection(reverb, 0, effectsReturn, 0);
+    patchCords[37] = AudioConnection(delay1, 0, effectsReturn, 1);
 
-    // Main mix
-    patchCords[25] = AudioConnection(voiceMixer1, 0, mainMixer, 0);
-    patchCords[26] = AudioConnection(voiceMixer2, 0, mainMixer, 1);
+    // Main mix (effects return comes in on channel 2, now that voice
+    // mixer 2 is full and no longer loops back into the send)
+    patchCords[38] = AudioConnection(voiceMixer1, 0, mainMixer, 0);
+    patchCords[39] = AudioConnection(voiceMixer2, 0, mainMixer, 1);
+    patchCords[40] = AudioConnection(effectsReturn, 0, mainMixer, 2);
 
     // Output to I2S
-    patchCords[27] = AudioConnection(mainMixer, 0, i2s_out, 0);
-    patchCords[28] = AudioConnection(mainMixer, 0, i2s_out, 1);
+    patchCords[41] = AudioConnection(mainMixer, 0, i2s_out, 0);
+    patchCords[42] = AudioConnection(mainMixer, 0, i2s_out, 1);
+
+    // The scheduler has no audio of its own, but only connected objects
+    // get updated, so park it on the spare main mixer input
+    patchCords[43] = AudioConnection(noteScheduler, 0, mainMixer, 3);
+
+    // Pitch buses into each oscillator's frequency modulation input
+    patchCords[44] = AudioConnection(pitchBus1, 0, voice1, 0);
+    patchCords[45] = AudioConnection(pitchBus2, 0, voice2, 0);
+    patchCords[46] = AudioConnection(pitchBus3, 0, voice3, 0);
+    patchCords[47] = AudioConnection(pitchBus4, 0, voice4, 0);
+    patchCords[48] = AudioConnection(pitchBus5, 0, voice5, 0);
+    patchCords[49] = AudioConnection(pitchBus6, 0, voice6, 0);
+    patchCords[50] = AudioConnection(pitchBus7, 0, voice7, 0);
+    patchCords[51] = AudioConnection(pitchBus8, 0, voice8, 0);
+
+    // USB audio: the blocks the I2S output gets, ref-counted rather than
+    // copied; usb_out only holds them until the USB interrupt packs them.
+    // The core's USB audio is one stereo pair, so the dry mix, if built
+    // in, takes the right channel (the synth is mono, so nothing is lost).
+    patchCords[52] = AudioConnection(mainMixer, 0, usb_out, 0);
+#if USB_AUDIO_DRY
+    patchCords[53] = AudioConnection(dryMixer, 0, usb_out, 1);
+    patchCords[54] = AudioConnection(voiceMixer1, 0, dryMixer, 0);
+    patchCords[55] = AudioConnection(voiceMixer2, 0, dryMixer, 1);
+#else
+    patchCords[53] = AudioConnection(mainMixer, 0, usb_out, 1);
+#endif
 
     Serial.println(F("Audio system configured"));
 }
 
-void processControllerInput() {
+void processControllerInput(uint8_t playerIndex) {
+    Player& player = players[playerIndex];
+    GuitarHeroController* controller = player.controller;
+
     // Get controller state
-    GHControllerState state = ghController.getState();
+    GHControllerState state = controller->getState();
+    GHControllerState& lastState = player.lastState;
+    bool* fretStates = player.fretStates;
+
+    // A fresh report means note-ons below can be timed against its arrival
+    uint32_t reportCount = controller->getReportCount();
+    bool freshReport = (reportCount != player.lastReportCount);
+    player.lastReportCount = reportCount;
 
-    static GHControllerState lastState;
-    static bool fretStates[5] = {false, false, false, false, false};
+    // A strum edge since the last pass re-articulates the held frets
+    uint32_t strumCount = controller->getStrumCount();
+    bool strummed = (strumCount != player.lastStrumCount);
+    player.lastStrumCount = strumCount;
 
     // Process fret buttons (Green, Red, Yellow, Blue, Orange)
     bool newFretStates[5] = {
@@ -330,56 +608,65 @@ void processControllerInput() {
         for (int i = 0; i < 5; i++) {
             if (newFretStates[i] && !fretStates[i]) {
                 // Change scale
-                currentScale = i;
-                scaleQuantizer.setScale(currentScale);
-                Serial.print(F("Scale changed to: "));
-                Serial.println(scaleQuantizer.getScaleName(currentScale));
-                sendESPStatus();
+                player.currentScale = i;
+                player.scaleQuantizer.setScale(player.currentScale);
+                Serial.print(F("Player "));
+                Serial.print(playerIndex + 1);
+                Serial.print(F(" scale changed to: "));
+                Serial.println(player.scaleQuantizer.getScaleName(player.currentScale));
+                syncESPState();
             }
         }
     } else {
         // Normal note triggering
+        uint8_t fretMask = 0;
         for (int i = 0; i < 5; i++) {
+            if (newFretStates[i]) fretMask |= (1 << i);
+
             if (newFretStates[i] != fretStates[i]) {
-                if (newFretStates[i]) {
+                if (newFretStates[i] && strummed) {
+                    // Pressed together with the strum - the chord below plays it
+                } else if (newFretStates[i]) {
                     // Note on - map fret to scale degree
                     uint8_t scaleDegree = i;
-                    uint8_t midiNote = scaleQuantizer.quantizeNote(scaleDegree, octaveShift);
-
-                    // Apply pitch bend from whammy bar
-                    if (state.whammyBar > 10) {  // Deadzone
-                        float bendAmount = (state.whammyBar - 10) / 245.0f;  // Normalize to 0-1
-                        pitchBend = bendAmount * 2.0f;  // +2 semitones max
-                    } else {
-                        pitchBend = 0.0f;
+                    uint8_t midiNote = player.scaleQuantizer.quantizeNote(scaleDegree, player.octaveShift);
+
+                    // Fixed velocity for now; replayed reports carry capture
+                    // times, not arrivals, so they don't count as latency
+                    if (noteOn(playerIndex, midiNote, 100) && freshReport && !hidReplay.isActive()) {
+                        uint32_t latencyUs = micros() - controller->getReportMicros();
+                        player.latencyCount++;
+                        player.latencySumUs += latencyUs;
+                        if (latencyUs > player.latencyMaxUs) player.latencyMaxUs = latencyUs;
                     }
-
-                    noteOn(midiNote, 100);  // Fixed velocity for now
                 } else {
                     // Note off
                     uint8_t scaleDegree = i;
-                    uint8_t midiNote = scaleQuantizer.quantizeNote(scaleDegree, octaveShift);
-                    noteOff(midiNote);
+                    uint8_t midiNote = player.scaleQuantizer.quantizeNote(scaleDegree, player.octaveShift);
+                    noteOff(playerIndex, midiNote);
                 }
                 fretStates[i] = newFretStates[i];
             }
         }
+
+        if (strummed && fretMask) {
+            strumChord(playerIndex, controller->getStrumDirection(), controller->getStrumMicros(), fretMask);
+        }
     }
 
     // Star Power button - octave boost
     if (state.starPower != lastState.starPower) {
         if (state.starPower) {
-            octaveShift = 1;  // +1 octave
+            player.octaveShift = 1;  // +1 octave
             Serial.println(F("Star Power: Octave UP"));
         } else {
-            octaveShift = 0;  // Normal octave
+            player.octaveShift = 0;  // Normal octave
             Serial.println(F("Star Power: Normal octave"));
         }
     }
 
     // Pickup selector - tone presets
-    static uint8_t lastPickup = 0;
-    if (state.pickupSelector != lastPickup) {
+    if (state.pickupSelector != player.lastPickup) {
         switch (state.pickupSelector) {
             case 0:  // Bridge pickup - bright
                 synthEngine.setTonePreset(TONE_BRIGHT);
@@ -391,7 +678,8 @@ void processControllerInput() {
                 synthEngine.setTonePreset(TONE_WARM);
                 break;
         }
-        lastPickup = state.pickupSelector;
+        player.lastPickup = state.pickupSelector;
+        applyDetune();
         Serial.print(F("Tone preset: "));
         Serial.println(state.pickupSelector);
     }
@@ -400,180 +688,650 @@ void processControllerInput() {
     if (state.plusButton != lastState.plusButton && state.plusButton) {
         // Transport play/stop
         Serial.println(F("Transport: Play/Stop"));
-        sendESPStatus();
+        syncESPState();
+    }
+
+    // Whammy and tilt for additional expression
+    processAnalogControls(playerIndex, freshReport);
+
+    lastState = state;
+    player.lastControllerUpdate = millis();
+}
+
+void processAnalogControls(uint8_t playerIndex, bool freshReport) {
+    Player& player = players[playerIndex];
+
+    if (freshReport) {
+        GHControllerState state = player.controller->getState();
+        player.whammy.update(state.whammyBar);
+        player.tilt.update(state.tiltX);
+    }
+
+    // Conditioners emit at most once per audio block, so report rate and
+    // sensor noise can't multiply the parameter writes below
+    uint32_t block = noteScheduler.getBlockCount();
+    int16_t value;
+
+    // Each update also goes out over USB-MIDI: the whammy as pitch bend,
+    // tilt as MIDI_TILT_CC
+    if (player.whammy.poll(block, value)) {
+        applyWhammy(playerIndex, value);
+        midiOut.pitchBend(MIDI_CHANNEL + playerIndex, midiBendFromAnalog(value), micros());
     }
 
-    // Update tilt for additional expression
-    if (abs(state.tiltX - lastState.tiltX) > 5) {
-        // Use tilt for filter cutoff modulation
-        float tiltNorm = (state.tiltX + 32768) / 65536.0f;  // Normalize to 0-1
-        float filterFreq = 500.0f + (tiltNorm * 3500.0f);   // 500Hz to 4000Hz
+    if (player.tilt.poll(block, value)) {
+        applyTilt(playerIndex, value);
+        midiOut.controlChange(MIDI_CHANNEL + playerIndex, MIDI_TILT_CC, midiCCFromAnalog(value), micros());
+    }
+}
 
-        for (int i = 0; i < NUM_VOICES; i++) {
-            voices[i].filter->frequency(filterFreq);
+void applyWhammy(uint8_t playerIndex, int16_t value) {
+    // Conditioned whammy position, or a USB-MIDI pitch bend
+    Player& player = players[playerIndex];
+    if (player.glideMode == GLIDE_WHAMMY) {
+        glideVoices(playerIndex, value);
+    } else {
+        // Pitch bend on this player's sounding voices, +2 semitones max
+        player.pitchBend = value * 2.0f / ANALOG_FULL_SCALE;
+        for (uint8_t v = voicePool.first(playerIndex); v != VOICE_NONE; v = voicePool.next(v)) {
+            modulateVoice(playerIndex, v);
         }
     }
+}
 
-    lastState = state;
-    lastControllerUpdate = millis();
+void applyTilt(uint8_t playerIndex, int16_t value) {
+    // Conditioned tilt, or USB-MIDI MIDI_TILT_CC
+    Player& player = players[playerIndex];
+    if (player.glideMode == GLIDE_TILT) {
+        glideVoices(playerIndex, value);
+    } else {
+        // Filter cutoff on this player's voices, 500Hz to 4000Hz around level
+        float tiltNorm = (value + ANALOG_FULL_SCALE) / (2.0f * ANALOG_FULL_SCALE);
+        float filterFreq = 500.0f + (tiltNorm * 3500.0f);
+
+        for (uint8_t v = voicePool.first(playerIndex); v != VOICE_NONE; v = voicePool.next(v)) {
+            voices[v].filter->frequency(filterFreq);
+        }
+    }
+}
+
+void glideVoices(uint8_t playerIndex, int16_t value) {
+    // Sweep up to GLIDE_RANGE_SEMITONES; each voice heads for the scale
+    // note nearest its own note plus the sweep, and the pitch bus renders
+    // the slide sample by sample
+    Player& player = players[playerIndex];
+    player.glideOffset = (int32_t)value * GLIDE_RANGE_SEMITONES * SNAP_STEPS_PER_SEMITONE / ANALOG_FULL_SCALE;
+
+    for (uint8_t v = voicePool.first(playerIndex); v != VOICE_NONE; v = voicePool.next(v)) {
+        voices[v].pitchBus->glideTo(glidePitch(playerIndex, voices[v].note), GLIDE_TIME_MS);
+    }
+}
+
+int32_t glidePitch(uint8_t playerIndex, uint8_t note) {
+    // Pitch-bus offset for note under the player's current sweep
+    Player& player = players[playerIndex];
+    if (player.glideMode == GLIDE_OFF || player.glideOffset == 0) return 0;
+
+    uint8_t target = player.scaleQuantizer.snapNote(note, player.glideOffset);
+    if (!tuning.isMapped(target)) return 0;
+    return tuning.pitch(target) - tuning.pitch(note);
+}
+
+void setGlideMode(uint8_t mode) {
+    // Drop any glide in progress and the bend/filter the mode took over
+    for (int p = 0; p < NUM_CONTROLLERS; p++) {
+        Player& player = players[p];
+        player.glideMode = mode;
+        player.glideOffset = 0;
+        player.pitchBend = 0.0f;
+        for (uint8_t v = voicePool.first(p); v != VOICE_NONE; v = voicePool.next(v)) {
+            voices[v].pitchBus->glideTo(0, GLIDE_TIME_MS);
+            modulateVoice(p, v);
+        }
+    }
+
+    static const char* const modeNames[NUM_GLIDE_MODES] = {"off", "whammy", "tilt"};
+    Serial.print(F("Scale glide: "));
+    Serial.println(modeNames[mode]);
+}
+
+void modulateVoice(uint8_t playerIndex, uint8_t voiceIndex) {
+    // Whammy bend, plus a vibrato that deepens with it. The pitch bus
+    // renders both per sample, so this only runs when the bend changes.
+    float bend = players[playerIndex].pitchBend;
+    AudioPitchBus* bus = voices[voiceIndex].pitchBus;
+    bus->setBend((int32_t)(bend * PITCH_UNITS_PER_OCTAVE / 12));
+    bus->setVibrato(VIBRATO_RATE_HZ, bend > 0 ? (int32_t)(bend * PITCH_CENTS(VIBRATO_DEPTH_CENTS)) : 0);
+}
+
+void applyDetune() {
+    // Spread the preset's detune across the pool, alternating sharp and
+    // flat so chords beat against themselves
+    int32_t detune = PITCH_CENTS(synthEngine.getParams().detune) / 2;
+    for (uint8_t v = 0; v < NUM_VOICES; v++) {
+        voices[v].pitchBus->setDetune((v & 1) ? detune : -detune);
+    }
 }
 
-void noteOn(uint8_t note, uint8_t velocity) {
-    // Allocate a voice for this note
-    int8_t voiceIndex = allocateVoice();
-    if (voiceIndex < 0) {
+bool noteOn(uint8_t playerIndex, uint8_t note, uint8_t velocity) {
+    // Keys the tuning leaves unmapped are silent
+    if (!tuning.isMapped(note)) return false;
+
+    // Allocate a voice for this note from the player's share of the pool
+    uint8_t stolen;
+    uint8_t voiceIndex = voicePool.allocate(playerIndex, &stolen);
+    if (voiceIndex == VOICE_NONE) {
         Serial.println(F("No free voices!"));
-        return;
+        return false;
     }
+    if (stolen != VOICE_NONE) endVoiceNote(stolen);
+    noteScheduler.cancel(voiceIndex);  // A stolen voice's strum onset is void
 
     Voice& voice = voices[voiceIndex];
-    voice.active = true;
     voice.note = note;
+    voice.player = playerIndex;
+    voice.fromMIDI = midiDispatching;
     voice.velocity = velocity;
     voice.startTime = millis();
 
-    // Calculate frequency with pitch bend
-    float frequency = 440.0f * powf(2.0f, (note - 69 + pitchBend) / 12.0f);
+    // Frequency from the tuning table; bend and glides ride on the pitch bus
+    Player& player = players[playerIndex];
+    float frequency = tuning.frequency(note);
+    planVoicePitch(playerIndex, voiceIndex, note, player.lastNote);
+    player.lastNote = note;
 
-    // Set voice parameters
+    // Oscillator and bus must change in the same audio block
+    AudioNoInterrupts();
     voice.waveform->frequency(frequency);
     voice.waveform->amplitude(velocity / 127.0f * 0.8f);
+    startVoicePitch(voiceIndex);
+    AudioInterrupts();
 
-    // Trigger envelope
+    // Trigger envelope (retriggers a stolen voice in place)
     voice.envelope->noteOn();
+    sendESPNote(playerIndex, note, velocity);
+    if (!voice.fromMIDI) sendMIDINote(playerIndex, note, velocity, micros());
+
+    if (hidReplay.isActive()) {
+        uint8_t event[4] = {1, playerIndex, note, voiceIndex};
+        replayDigest = hidCaptureHash(replayDigest, event, sizeof(event));
+    }
 
     Serial.print(F("Note ON: "));
     Serial.print(note);
+    Serial.print(F(" Player: "));
+    Serial.print(playerIndex + 1);
     Serial.print(F(" Voice: "));
     Serial.print(voiceIndex);
+    if (stolen != VOICE_NONE) {
+        Serial.print(F(" (stolen)"));
+    }
     Serial.print(F(" Freq: "));
     Serial.println(frequency);
+    return true;
 }
 
-void noteOff(uint8_t note) {
-    // Find the voice playing this note
-    for (int i = 0; i < NUM_VOICES; i++) {
-        if (voices[i].active && voices[i].note == note) {
-            releaseVoice(i);
-            Serial.print(F("Note OFF: "));
-            Serial.print(note);
-            Serial.print(F(" Voice: "));
-            Serial.println(i);
-            break;
+void strumChord(uint8_t playerIndex, StrumDirection direction, uint32_t strumUs, uint8_t fretMask) {
+    Player& player = players[playerIndex];
+
+    StrumNote notes[STRUM_MAX_NOTES];
+    uint8_t count = player.strumEngine.plan(direction, strumUs, fretMask, notes);
+
+    // Anchor the chord to the sample the strum report arrived at, plus one
+    // block so the first string is never already in the past
+    uint32_t baseSample = noteScheduler.sampleAtMicros(strumUs) + STRUM_SCHEDULE_LATENCY;
+
+    // Pitches come ready-made from the quantizer's chord table (fret order)
+    const FretChord& chord = player.scaleQuantizer.chord(fretMask, player.octaveShift);
+
+    // With portamento, every string slides from the note played before
+    // the strum, not from the string before it
+    uint8_t fromNote = player.lastNote;
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t slot = __builtin_popcount(fretMask & ((1 << notes[i].fret) - 1));
+        if (chord.phaseIncrements[slot] == 0) continue;  // Unmapped in this tuning
+        float frequency = phaseIncrementToFrequency(chord.phaseIncrements[slot]);
+        if (scheduleNote(playerIndex, chord.notes[slot], frequency, 100, baseSample + notes[i].offsetSamples, fromNote) &&
+            i == 0 && !hidReplay.isActive()) {
+            uint32_t latencyUs = micros() - strumUs;
+            player.latencyCount++;
+            player.latencySumUs += latencyUs;
+            if (latencyUs > player.latencyMaxUs) player.latencyMaxUs = latencyUs;
         }
     }
+
+    Serial.print(F("Strum "));
+    Serial.print(direction == STRUM_DOWN ? F("down") : F("up"));
+    Serial.print(F(" Player: "));
+    Serial.print(playerIndex + 1);
+    Serial.print(F(" Notes: "));
+    Serial.print(count);
+    Serial.print(F(" Spread: "));
+    Serial.print(player.strumEngine.getLastSpread());
+    Serial.println(F("us"));
 }
 
-int8_t allocateVoice() {
-    // First, look for a free voice
-    for (int i = 0; i < NUM_VOICES; i++) {
-        if (!voices[i].active) {
-            return i;
+bool scheduleNote(uint8_t playerIndex, uint8_t note, float frequency, uint8_t velocity, uint32_t sampleTime, uint8_t fromNote) {
+    // A held fret already has a voice on this note - restrike it rather
+    // than stacking a second copy
+    uint8_t voiceIndex = VOICE_NONE;
+    for (uint8_t v = voicePool.first(playerIndex); v != VOICE_NONE; v = voicePool.next(v)) {
+        if (voices[v].note == note) {
+            voiceIndex = v;
+            break;
         }
     }
 
-    // Voice stealing: find the oldest voice
-    uint32_t oldestTime = 0xFFFFFFFF;
-    int8_t oldestVoice = -1;
-
-    for (int i = 0; i < NUM_VOICES; i++) {
-        if (voices[i].startTime < oldestTime) {
-            oldestTime = voices[i].startTime;
-            oldestVoice = i;
+    if (voiceIndex == VOICE_NONE) {
+        uint8_t stolen;
+        voiceIndex = voicePool.allocate(playerIndex, &stolen);
+        if (voiceIndex == VOICE_NONE) {
+            Serial.println(F("No free voices!"));
+            return false;
         }
+        if (stolen != VOICE_NONE) endVoiceNote(stolen);
+    }
+    noteScheduler.cancel(voiceIndex);
+
+    Voice& voice = voices[voiceIndex];
+    voice.note = note;
+    voice.player = playerIndex;
+    voice.fromMIDI = midiDispatching;
+    voice.velocity = velocity;
+    voice.startTime = millis();
+
+    // The pitch bus changes at the onset, with the oscillator, so a
+    // restruck voice's tail keeps its pitch until then
+    float amplitude = velocity / 127.0f * 0.8f;
+    planVoicePitch(playerIndex, voiceIndex, note, fromNote);
+    players[playerIndex].lastNote = note;
+
+    if (!noteScheduler.schedule(sampleTime, voiceIndex, frequency, amplitude)) {
+        // Queue full - fall back to starting it at the next block
+        AudioNoInterrupts();
+        voice.waveform->frequency(frequency);
+        voice.waveform->amplitude(amplitude);
+        startVoicePitch(voiceIndex);
+        AudioInterrupts();
+        voice.envelope->noteOn();
+    }
+    sendESPNote(playerIndex, note, velocity);
+
+    // Over MIDI at the onset's own time, so the strum spread is recorded
+    uint32_t now = micros();
+    int32_t aheadSamples = (int32_t)(sampleTime - noteScheduler.sampleAtMicros(now));
+    uint32_t atUs = now;
+    if (aheadSamples > 0) atUs += (uint32_t)((int64_t)aheadSamples * 1000000 / AUDIO_SAMPLE_RATE);
+    if (!voice.fromMIDI) sendMIDINote(playerIndex, note, velocity, atUs);
+
+    if (hidReplay.isActive()) {
+        uint8_t event[4] = {2, playerIndex, note, voiceIndex};
+        replayDigest = hidCaptureHash(replayDigest, event, sizeof(event));
+    }
+    return true;
+}
+
+// Where a new note's pitch bus starts: on the player's scale glide, or -
+// with portamento - at fromNote's pitch, sliding to it
+void planVoicePitch(uint8_t playerIndex, uint8_t voiceIndex, uint8_t note, uint8_t fromNote) {
+    Player& player = players[playerIndex];
+    Voice& voice = voices[voiceIndex];
+    int32_t glide = glidePitch(playerIndex, note);
+    voice.onsetTarget = glide;
+    voice.onsetPitch = glide;
+    voice.onsetGlideMs = 0.0f;
+    if (player.portamentoMs > 0 && fromNote && tuning.isMapped(fromNote)) {
+        voice.onsetPitch = tuning.pitch(fromNote) - tuning.pitch(note) + glide;
+        voice.onsetGlideMs = player.portamentoMs;
     }
+}
+
+// Put the planned pitch on the bus, with the player's bend and vibrato.
+// Called with the oscillator change, in the same audio block.
+void startVoicePitch(uint8_t voiceIndex) {
+    Voice& voice = voices[voiceIndex];
+    voice.pitchBus->jumpTo(voice.onsetPitch);
+    if (voice.onsetGlideMs > 0) voice.pitchBus->glideTo(voice.onsetTarget, voice.onsetGlideMs);
+    modulateVoice(voice.player, voiceIndex);
+}
+
+void fireScheduledNote(uint8_t voiceIndex, float frequency, float amplitude, uint16_t offset) {
+    // Runs inside the audio update, ahead of the pitch buses and voices
+    Voice& voice = voices[voiceIndex];
+    voice.waveform->frequency(frequency);
+    voice.waveform->amplitude(amplitude);
+    startVoicePitch(voiceIndex);
+    voice.envelope->noteOn();
+    voice.gate->openAt(offset);
+}
 
-    if (oldestVoice >= 0) {
-        releaseVoice(oldestVoice);
+void noteOff(uint8_t playerIndex, uint8_t note) {
+    // Find the voice this player has playing this note
+    for (uint8_t v = voicePool.first(playerIndex); v != VOICE_NONE; v = voicePool.next(v)) {
+        if (voices[v].note == note) {
+            if (hidReplay.isActive()) {
+                uint8_t event[4] = {0, playerIndex, note, v};
+                replayDigest = hidCaptureHash(replayDigest, event, sizeof(event));
+            }
+            releaseVoice(v);
+            Serial.print(F("Note OFF: "));
+            Serial.print(note);
+            Serial.print(F(" Voice: "));
+            Serial.println(v);
+            break;
+        }
     }
+}
 
-    return oldestVoice;
+// Tell the ESP and USB-MIDI a voice's note has ended - released, or
+// stolen for another note - so nothing hangs downstream. Only notes
+// played from USB-MIDI input skip MIDI, whatever is being handled now.
+void endVoiceNote(uint8_t voiceIndex) {
+    Voice& voice = voices[voiceIndex];
+    if (voice.note == 0) return;
+    sendESPNote(voice.player, voice.note, 0);
+    if (!voice.fromMIDI) sendMIDINote(voice.player, voice.note, 0, micros());
+    voice.note = 0;
 }
 
 void releaseVoice(uint8_t voiceIndex) {
     if (voiceIndex >= NUM_VOICES) return;
 
     Voice& voice = voices[voiceIndex];
+    noteScheduler.cancel(voiceIndex);  // Released before its strum onset
+    endVoiceNote(voiceIndex);
     voice.envelope->noteOff();
-    voice.active = false;
-    voice.note = 0;
+    voicePool.release(voiceIndex);
 }
 
-void updateSynthParameters() {
-    // This function updates global synth parameters based on current control states
-    // Called every loop iteration for smooth parameter changes
+void releasePlayerVoices(uint8_t playerIndex) {
+    uint8_t v = voicePool.first(playerIndex);
+    while (v != VOICE_NONE) {
+        uint8_t next = voicePool.next(v);
+        releaseVoice(v);
+        v = next;
+    }
+}
 
-    // Apply any LFO or modulation here
-    static elapsedMillis lfoTimer;
-    static float lfoPhase = 0;
+void resetPlayer(uint8_t playerIndex) {
+    Player& player = players[playerIndex];
+    memset(&player.lastState, 0, sizeof(player.lastState));
+    memset(player.fretStates, 0, sizeof(player.fretStates));
+    player.currentScale = SCALE_PENTATONIC_MINOR;
+    player.octaveShift = 0;
+    player.pitchBend = 0.0f;
+    player.glideOffset = 0;
+    player.lastNote = 0;
+    player.lastPickup = 0;
+    player.lastControllerUpdate = 0;
+    player.lastReportCount = player.controller->getReportCount();
+    player.lastStrumCount = player.controller->getStrumCount();
+    player.strumEngine.reset();
+    player.whammy.reset();
+    player.tilt.reset();
+    player.latencyCount = 0;
+    player.latencySumUs = 0;
+    player.latencyMaxUs = 0;
+    player.scaleQuantizer.setScale(player.currentScale);
+}
 
-    if (lfoTimer >= 10) {  // 100Hz LFO update rate
-        lfoTimer = 0;
-        lfoPhase += 0.0628f;  // 1Hz LFO
-        if (lfoPhase > 6.283f) lfoPhase -= 6.283f;
+bool anyControllerConnected() {
+    for (int p = 0; p < NUM_CONTROLLERS; p++) {
+        if (players[p].connected) return true;
+    }
+    return false;
+}
 
-        // Subtle vibrato when whammy is engaged
-        if (pitchBend > 0) {
-            float vibrato = sinf(lfoPhase * 5.0f) * 0.05f * pitchBend;
-            for (int i = 0; i < NUM_VOICES; i++) {
-                if (voices[i].active) {
-                    float baseFreq = 440.0f * powf(2.0f, (voices[i].note - 69) / 12.0f);
-                    voices[i].waveform->frequency(baseFreq * (1.0f + vibrato));
-                }
+void syncESPState(LinkLane lane) {
+    // Refresh the shared state (scale/root/octave follow player 1) and send the
+    // ESP whatever changed. State changes go on the command lane; the
+    // periodic refresh is telemetry. A delta that gets dropped is resent
+    // until the ESP acknowledges it.
+    LinkState& state = espState.state();
+    state.connected = anyControllerConnected();
+    state.scale = players[0].currentScale;
+    state.root = players[0].scaleQuantizer.getRootNote();
+    state.octave = players[0].octaveShift;
+    state.voices = NUM_VOICES - voicePool.freeCount();
+    state.cpuTenths = (uint16_t)(AudioProcessorUsage() * 10.0f);
+    state.memBlocks = AudioMemoryUsage();
+    state.totalNotes = totalNotes;
+    state.loopMaxUs = loopMaxUs;
+
+    uint8_t payload[LINK_MAX_PAYLOAD];
+    size_t len = espState.poll(millis(), payload);
+    if (len) sendESPFrame(LINK_MSG_STATE, payload, len, lane);
+}
+
+void sendESPNote(uint8_t playerIndex, uint8_t note, uint8_t velocity) {
+    // Batched: the ESP gets every note from a LINK_NOTE_BATCH_MS window in
+    // one frame, sent from loop()
+    if (velocity) totalNotes++;
+    if (espNotes.full()) {
+        uint8_t payload[LINK_MAX_PAYLOAD];
+        sendESPFrame(LINK_MSG_NOTES, payload, espNotes.flush(payload), LINK_LANE_NOTES);
+    }
+    espNotes.add(note, velocity, playerIndex, millis());
+}
+
+void sendMIDINote(uint8_t playerIndex, uint8_t note, uint8_t velocity, uint32_t atUs) {
+    uint8_t channel = MIDI_CHANNEL + playerIndex;
+    if (velocity) {
+        midiOut.noteOnAt(channel, note, velocity, micros(), atUs);
+    } else {
+        midiOut.noteOff(channel, note, micros());
+    }
+}
+
+void serviceMIDI() {
+    handleMIDIInput();
+
+    // Round-trip probe: comes back only if the host echoes it
+    if (midiProbing && midiProbeTimer >= MIDI_PROBE_INTERVAL_MS) {
+        midiProbeTimer = 0;
+        uint8_t probe[MIDI_PROBE_LENGTH];
+        usbMIDI.sendSysEx(midiProbeEncode(micros(), probe), probe, true);
+        usbMIDI.send_now();
+    }
+
+    // Everything due goes out together, without waiting for the core to
+    // flush a part-filled packet
+    uint32_t now = micros();
+    if (!midiOut.due(now)) return;
+    MidiEvent batch[MIDI_OUT_QUEUE];
+    uint8_t count = midiOut.take(now, batch);
+    for (uint8_t i = 0; i < count; i++) {
+        usbMIDI.send(batch[i].type, batch[i].data1, batch[i].data2, batch[i].channel, 0);
+    }
+    usbMIDI.send_now();
+}
+
+void handleMIDIInput() {
+    // Input plays through the controller's own paths: notes through
+    // noteOn()/noteOff(), pitch bend as the whammy, MIDI_TILT_CC as tilt.
+    // Channel MIDI_CHANNEL + n is player n + 1; other channels are ignored.
+    midiDispatching = true;
+    for (uint8_t i = 0; i < MIDI_IN_PER_LOOP && usbMIDI.read(); i++) {
+        uint8_t type = usbMIDI.getType();
+        if (type == usbMIDI.SystemExclusive) {
+            uint32_t sentUs;
+            if (midiProbeDecode(usbMIDI.getSysExArray(), usbMIDI.getSysExArrayLength(), sentUs)) {
+                midiRtt.record(sentUs, micros());
             }
+            continue;
+        }
+
+        int player = usbMIDI.getChannel() - MIDI_CHANNEL;
+        if (player < 0 || player >= NUM_CONTROLLERS) continue;
+        uint8_t data1 = usbMIDI.getData1();
+        uint8_t data2 = usbMIDI.getData2();
+        midiInCount++;
+
+        switch (type) {
+            case usbMIDI.NoteOn:
+            case usbMIDI.NoteOff:
+                // A note-on at velocity 0 is a note-off
+                if (type == usbMIDI.NoteOn && data2) {
+                    noteOn(player, data1, data2);
+                } else {
+                    noteOff(player, data1);
+                }
+                break;
+            case usbMIDI.PitchBend:
+                applyWhammy(player, midiAnalogFromBend(data1 | (data2 << 7)));
+                break;
+            case usbMIDI.ControlChange:
+                if (data1 == MIDI_TILT_CC) {
+                    applyTilt(player, midiAnalogFromCC(data2));
+                } else if (data1 == MIDI_CC_ALL_NOTES_OFF) {
+                    releasePlayerVoices(player);
+                }
+                break;
         }
     }
+    midiDispatching = false;
+}
+
+void sendESPFrame(uint8_t type, const uint8_t* payload, size_t len, LinkLane lane) {
+    uint8_t frame[LINK_MAX_FRAME];
+    if (espTx.push(frame, linkEncode(type, payload, len, frame), lane)) return;
+
+    // Lane full. A state delta goes out again until the ESP acks it, but
+    // a note batch is gone for good.
+    if (type == LINK_MSG_NOTES) espNoteBatchesLost++;
+    else espStatesRefused++;
 }
 
-void sendESPStatus() {
-    // Send status update to ESP8266 as JSON
-    ESP_SERIAL.print(F("{\"connected\":"));
-    ESP_SERIAL.print(controllerConnected ? F("true") : F("false"));
-    ESP_SERIAL.print(F(",\"scale\":"));
-    ESP_SERIAL.print(currentScale);
-    ESP_SERIAL.print(F(",\"octave\":"));
-    ESP_SERIAL.print(octaveShift);
-    ESP_SERIAL.print(F(",\"cpu\":"));
-    ESP_SERIAL.print(AudioProcessorUsage());
-    ESP_SERIAL.print(F(",\"mem\":"));
-    ESP_SERIAL.print(AudioMemoryUsage());
-    ESP_SERIAL.println(F("}"));
+void serviceESPLink() {
+    // Tell the ESP how much more it may send, and probe the round trip
+    uint32_t now = millis();
+    if (espFlow.creditDue(now)) espTx.send(espFlow.grant(now), LINK_LANE_LINK);
+    if (espFlow.pingDue(now)) espTx.send(espFlow.ping(now, micros()), LINK_LANE_LINK);
+
+    // Hand queued frames to the UART, never more than it can take without
+    // blocking (or the ESP has credit for); its TX interrupt sends them
+    // out from there
+    int space = ESP_SERIAL.availableForWrite();
+    while (space > 0) {
+        uint8_t chunk[64];
+        size_t n = espTx.pull(chunk, space < (int)sizeof(chunk) ? space : sizeof(chunk), &espFlow, now);
+        if (n == 0) break;
+        ESP_SERIAL.write(chunk, n);
+        space -= n;
+    }
 }
 
 void handleSerialCommand() {
-    static char cmdBuffer[128];
-    static uint8_t cmdIndex = 0;
+    // A full receive buffer means the ESP outran its credit (or doesn't
+    // use it) and bytes were lost
+    if (ESP_SERIAL.available() >= ESP_RX_HARDWARE_BYTES + ESP_RX_BUFFER_BYTES - 1) {
+        espFlow.overrun();
+    }
 
     while (ESP_SERIAL.available()) {
-        char c = ESP_SERIAL.read();
-
-        if (c == '\n' || c == '\r') {
-            if (cmdIndex > 0) {
-                cmdBuffer[cmdIndex] = '\0';
-                // Parse JSON command
-                // Simple parser for basic commands
-                if (strstr(cmdBuffer, "getStatus")) {
-                    sendESPStatus();
-                } else if (strstr(cmdBuffer, "setScale")) {
-                    // Extract scale number
-                    char* p = strstr(cmdBuffer, ":");
-                    if (p) {
-                        int scale = atoi(p + 1);
-                        if (scale >= 0 && scale < 6) {
-                            currentScale = scale;
-                            scaleQuantizer.setScale(currentScale);
-                            sendESPStatus();
-                        }
-                    }
-                }
-                cmdIndex = 0;
+        bool complete = espLink.push(ESP_SERIAL.read());
+        espFlow.received(1);
+        if (!complete) continue;
+
+        LinkCommand command;
+        LinkSetParam param;
+        LinkStateAck ack;
+        LinkCredit credit;
+        LinkPing ping;
+        LinkPong pong;
+        if (espLink.get(credit)) {
+            espFlow.onCredit(credit);
+        } else if (espLink.get(ping)) {
+            espTx.send(LinkFlow::pong(ping), LINK_LANE_LINK);
+        } else if (espLink.get(pong)) {
+            espFlow.onPong(pong, micros());
+        } else if (espLink.get(ack)) {
+            espState.ack(ack.generation);
+        } else if (espLink.get(command)) {
+            if (command.command == LINK_CMD_RESYNC) {
+                // ESP (re)started with no copy of the state
+                espState.resync();
+                syncESPState();
             }
-        } else if (cmdIndex < 127) {
-            cmdBuffer[cmdIndex++] = c;
+        } else if (espLink.get(param)) {
+            applyLinkParam(param);
         }
     }
 }
 
+void applyLinkParam(const LinkSetParam& param) {
+    // Parameters from the web UI and OSC. The ESP clamps already; clamp
+    // again so a garbled or hand-made frame can't push anything out of range.
+    float value;
+    if (!linkParamClamp(param.param, param.value, value)) return;
+    SynthParams& params = synthEngine.getParams();
+
+    switch (param.param) {
+        case LINK_PARAM_SCALE:
+            // Every player's scale
+            for (int i = 0; i < NUM_CONTROLLERS; i++) {
+                players[i].currentScale = (uint8_t)value;
+                players[i].scaleQuantizer.setScale((uint8_t)value);
+            }
+            syncESPState();
+            return;
+        case LINK_PARAM_ROOT:
+            for (int i = 0; i < NUM_CONTROLLERS; i++) {
+                players[i].scaleQuantizer.setRootNote((uint8_t)value);
+            }
+            syncESPState();
+            return;
+        case LINK_PARAM_OCTAVE:
+            for (int i = 0; i < NUM_CONTROLLERS; i++) {
+                players[i].octaveShift = (int8_t)value;
+            }
+            syncESPState();
+            return;
+        case LINK_PARAM_PORTAMENTO:
+            // Slide time in ms between successive notes, 0 = off
+            for (int i = 0; i < NUM_CONTROLLERS; i++) {
+                players[i].portamentoMs = value;
+            }
+            return;
+        case LINK_PARAM_REVERB:
+            synthEngine.setReverbMix(value / 100.0f);
+            effectsReturn.gain(0, params.reverbMix);
+            return;
+        case LINK_PARAM_DELAY:
+            synthEngine.setDelayMix(value / 100.0f);
+            effectsReturn.gain(1, params.delayMix);
+            return;
+        case LINK_PARAM_DELAY_TIME:
+            synthEngine.setDelayTime(value);
+            delay1.delay(0, params.delayTime);
+            return;
+        case LINK_PARAM_DETUNE:
+            params.detune = value;
+            applyDetune();
+            return;
+        case LINK_PARAM_WAVEFORM: synthEngine.setWaveform((uint8_t)value); break;
+        case LINK_PARAM_FILTER: synthEngine.setFilterFreq(value); break;
+        case LINK_PARAM_RESONANCE: synthEngine.setFilterResonance(value); break;
+        case LINK_PARAM_ATTACK: synthEngine.setEnvelope(value, params.decay, params.sustain, params.release); break;
+        case LINK_PARAM_DECAY: synthEngine.setEnvelope(params.attack, value, params.sustain, params.release); break;
+        case LINK_PARAM_SUSTAIN: synthEngine.setEnvelope(params.attack, params.decay, value, params.release); break;
+        case LINK_PARAM_RELEASE: synthEngine.setEnvelope(params.attack, params.decay, params.sustain, value); break;
+        // Kept with the preset; the voices don't use them (yet)
+        case LINK_PARAM_PULSE_WIDTH: params.pulseWidth = value; return;
+        case LINK_PARAM_FILTER_ENV: params.filterEnvAmount = value; return;
+        case LINK_PARAM_LFO_RATE: params.lfoRate = value; return;
+        case LINK_PARAM_LFO_DEPTH: params.lfoDepth = value; return;
+        case LINK_PARAM_LFO_TARGET: params.lfoTarget = (uint8_t)value; return;
+        default: return;
+    }
+
+    // Oscillator, envelope and filter settings: onto every voice
+    for (uint8_t v = 0; v < NUM_VOICES; v++) {
+        synthEngine.applyToVoice(voices[v].waveform, voices[v].envelope, voices[v].filter);
+    }
+}
+
 void performanceReport() {
     float cpu = AudioProcessorUsage();
     float cpuMax = AudioProcessorUsageMax();
@@ -592,7 +1350,132 @@ void performanceReport() {
     Serial.print(F(" (max: "));
     Serial.print(memMax);
     Serial.print(F(") Loops/sec: "));
-    Serial.println(loopCount);
+    Serial.print(loopCount);
+    Serial.print(F(" Strum notes: "));
+    Serial.print(noteScheduler.getFiredCount());
+    Serial.print(F(" (late "));
+    Serial.print(noteScheduler.getLateCount());
+    Serial.print(F(") ESP frames: "));
+    Serial.print(espLink.getFrameCount());
+    Serial.print(F(" (CRC errors "));
+    Serial.print(espLink.getCrcErrors());
+    Serial.print(F(", framing "));
+    Serial.print(espLink.getFramingErrors());
+    Serial.print(F(") ESP TX queued "));
+    Serial.print(espTx.getBytesQueued());
+    Serial.print(F(" dropped "));
+    Serial.print(espTx.getBytesDropped());
+    Serial.print(F(" max depth "));
+    Serial.print(espTx.getMaxDepth());
+    Serial.print(F(" note batches lost "));
+    Serial.print(espNoteBatchesLost);
+    Serial.print(F(" states refused "));
+    Serial.print(espStatesRefused);
+    Serial.print(F(" state gen "));
+    Serial.print(espState.getGeneration());
+    Serial.print(F(" acked "));
+    Serial.print(espState.getAckedGeneration());
+    Serial.print(F(" deltas "));
+    Serial.print(espState.getDeltaCount());
+    Serial.print(F(" retries "));
+    Serial.print(espState.getRetryCount());
+    Serial.print(F(" note batches "));
+    Serial.println(espNotes.getBatchCount());
+
+    // Link health: round trip, resends, lost bytes, time spent out of credit
+    Serial.print(F("  ESP link: RTT "));
+    Serial.print(espFlow.getRttUs());
+    Serial.print(F("us (avg "));
+    Serial.print(espFlow.getRttAvgUs());
+    Serial.print(F(", max "));
+    Serial.print(espFlow.getRttMaxUs());
+    Serial.print(F(") pings lost "));
+    Serial.print(espFlow.getPingsLost());
+    Serial.print(F(" retransmits "));
+    Serial.print(espState.getRetryCount());
+    Serial.print(F(" overruns "));
+    Serial.print(espFlow.getOverruns());
+    Serial.print(F(" credit stalls "));
+    Serial.print(espFlow.getCreditStalls());
+    Serial.print(F(" (timeouts "));
+    Serial.print(espFlow.getCreditTimeouts());
+    Serial.println(espFlow.isGranted() ? F(")") : F(", ESP not granting)"));
+
+    // USB-MIDI: packets are send_now() calls; waited is the most any event
+    // sat past its time before going out. RTT needs the host to echo ('m').
+    if (midiOut.getEvents() || midiInCount || midiProbing) {
+        Serial.print(F("  USB-MIDI: out "));
+        Serial.print(midiOut.getEvents());
+        Serial.print(F(" events in "));
+        Serial.print(midiOut.getBatches());
+        Serial.print(F(" packets (max "));
+        Serial.print(midiOut.getMaxBatch());
+        Serial.print(F(", coalesced "));
+        Serial.print(midiOut.getCoalesced());
+        Serial.print(F(", refused "));
+        Serial.print(midiOut.getRefused());
+        Serial.print(F(", waited max "));
+        Serial.print(midiOut.getMaxWaitUs());
+        Serial.print(F("us) in "));
+        Serial.print(midiInCount);
+        Serial.print(F(" RTT "));
+        Serial.print(midiRtt.getMinUs());
+        Serial.print(F("/"));
+        Serial.print(midiRtt.getAvgUs());
+        Serial.print(F("/"));
+        Serial.print(midiRtt.getMaxUs());
+        Serial.print(F("us min/avg/max ("));
+        Serial.print(midiRtt.getCount());
+        Serial.println(F(" probes)"));
+        midiOut.clearCounts();
+    }
+
+    // USB audio: usb_out's own update only queues block pointers; packing
+    // them into USB packets happens in the USB interrupt, which
+    // AudioProcessorUsage() doesn't see. 'u' compares with it off.
+    Serial.print(F("  USB audio: "));
+    Serial.print(usbAudioOn ? (USB_AUDIO_DRY ? F("wet L, dry R") : F("mix L+R")) : F("off"));
+    Serial.print(F(", update "));
+    Serial.print(usb_out.processorUsage());
+    Serial.print(F("% (max "));
+    Serial.print(usb_out.processorUsageMax());
+    Serial.println(F("%)"));
+    usb_out.processorUsageMaxReset();
+
+    // Per-player input latency and voice usage
+    for (int p = 0; p < NUM_CONTROLLERS; p++) {
+        Player& player = players[p];
+        if (!player.connected) continue;
+
+        Serial.print(F("  Player "));
+        Serial.print(p + 1);
+        Serial.print(F(": voices "));
+        Serial.print(voicePool.activeCount(p));
+        Serial.print(F("/"));
+        Serial.print(voicePool.getShare(p));
+        Serial.print(F(" stolen "));
+        Serial.print(voicePool.getStealCount(p));
+        Serial.print(F(" latency avg "));
+        Serial.print(player.latencyCount ? player.latencySumUs / player.latencyCount : 0);
+        Serial.print(F("us max "));
+        Serial.print(player.latencyMaxUs);
+        Serial.print(F("us ("));
+        Serial.print(player.latencyCount);
+        Serial.print(F(" notes) whammy "));
+        Serial.print(player.whammy.getSampleCount());
+        Serial.print(F("->"));
+        Serial.print(player.whammy.getEmitCount());
+        Serial.print(F(" tilt "));
+        Serial.print(player.tilt.getSampleCount());
+        Serial.print(F("->"));
+        Serial.println(player.tilt.getEmitCount());
+        player.whammy.clearCounts();
+        player.tilt.clearCounts();
+
+        player.latencyCount = 0;
+        player.latencySumUs = 0;
+        player.latencyMaxUs = 0;
+    }
 
     // Warning if CPU usage is too high
     if (cpuMax > 80.0f) {
@@ -601,4 +1484,252 @@ void performanceReport() {
 
     AudioProcessorUsageMaxReset();
     AudioMemoryUsageMaxReset();
-}
\ No newline at end of file
+}
+
+// ===== HID CAPTURE / REPLAY =====
+
+size_t captureWrite(void* ctx, const uint8_t* data, size_t len) {
+    return ((File*)ctx)->write(data, len);
+}
+
+size_t captureRead(void* ctx, uint8_t* data, size_t len) {
+    int n = ((File*)ctx)->read(data, len);
+    return n > 0 ? n : 0;
+}
+
+void replayReport(void* ctx, const HIDCaptureRecord& record) {
+    if (record.controller >= NUM_CONTROLLERS) return;
+
+    // Decoded as the device that sent it, whatever is plugged in now
+    const ControllerProfile* layout = findControllerProfile(record.vendorID, record.productID);
+    if (!layout) return;
+
+    // Same path as live input: parse, then run the player's input handler.
+    // Timed by the capture, not by when this pass got to it.
+    controllers[record.controller]->injectReport(record.data, record.length, hidReplay.replayTimeUs(record), layout);
+    processControllerInput(record.controller);
+}
+
+// Connect or disconnect the USB tap, and restart the CPU and block maxima
+// so the next reports show the difference
+void setUSBAudio(bool on) {
+    // The dry mixer's inputs too, so 'off' saves its pass as well
+    uint8_t last = USB_AUDIO_DRY ? 55 : 53;
+    for (uint8_t i = 52; i <= last; i++) {
+        if (on) {
+            patchCords[i].connect();
+        } else {
+            patchCords[i].disconnect();
+        }
+    }
+    usbAudioOn = on;
+    AudioProcessorUsageMaxReset();
+    AudioMemoryUsageMaxReset();
+    cpuUsageMax = 0;
+    memoryUsageMax = 0;
+    Serial.println(on ? F("USB audio on") : F("USB audio off"));
+}
+
+void handleDebugCommand() {
+    char cmd = Serial.read();
+
+    switch (cmd) {
+        case 'c':  // Start/stop capture
+            toggleCapture();
+            break;
+        case 'y':  // Replay with captured timing
+            startReplay(HIDReplay::REPLAY_REALTIME);
+            break;
+        case 'f':  // Replay as fast as possible (benchmark)
+            startReplay(HIDReplay::REPLAY_FAST);
+            break;
+        case 'x':  // Abort replay
+            if (hidReplay.isActive()) {
+                hidReplay.end();
+                finishReplay();
+            }
+            break;
+        case 't':  // Load Scala tuning from SD
+            loadTuning();
+            break;
+        case 'g':  // Cycle scale glide: off -> whammy -> tilt
+            setGlideMode((players[0].glideMode + 1) % NUM_GLIDE_MODES);
+            break;
+        case 'e':  // Back to equal temperament
+            tuning.reset();
+            applyTuning();
+            break;
+        case 'u':  // USB audio tap on/off
+            setUSBAudio(!usbAudioOn);
+            break;
+        case 'm':  // USB-MIDI round-trip probes on/off
+            midiProbing = !midiProbing;
+            if (midiProbing) midiRtt.clear();
+            Serial.println(midiProbing ? F("MIDI probes on (echo them back, e.g. aconnect)") : F("MIDI probes off"));
+            break;
+    }
+}
+
+bool ensureSD() {
+    if (!sdReady) {
+        sdReady = SD.begin(SD_CS_PIN);
+        if (!sdReady) Serial.println(F("SD card not available"));
+    }
+    return sdReady;
+}
+
+// ===== TUNING =====
+
+// Whole file into tuningText; returns length, 0 if missing or too big
+size_t readTextFile(const char* path) {
+    File file = SD.open(path, FILE_READ);
+    if (!file) return 0;
+
+    size_t len = 0;
+    if (file.size() <= sizeof(tuningText)) {
+        len = file.read(tuningText, sizeof(tuningText));
+    } else {
+        Serial.print(F("Tuning file too large: "));
+        Serial.println(path);
+    }
+    file.close();
+    return len;
+}
+
+void loadTuning() {
+    if (!ensureSD()) return;
+
+    uint32_t startUs = micros();
+    size_t len = readTextFile(TUNING_SCL_FILE);
+    if (len == 0 || !scalaParse(tuningText, len, scalaScale)) {
+        Serial.println(F("No valid " TUNING_SCL_FILE));
+        return;
+    }
+
+    // The keyboard map is optional
+    len = readTextFile(TUNING_KBM_FILE);
+    if (len == 0) {
+        keyboardMapDefault(keyboardMap);
+    } else if (!keyboardMapParse(tuningText, len, keyboardMap)) {
+        Serial.println(F("Invalid " TUNING_KBM_FILE));
+        return;
+    }
+
+    if (!tuning.load(scalaScale, keyboardMap)) {
+        Serial.println(F("Tuning reference key is unmapped"));
+        return;
+    }
+    applyTuning();
+
+    Serial.print(F("Loaded in "));
+    Serial.print(micros() - startUs);
+    Serial.println(F("us"));
+}
+
+void applyTuning() {
+    // Chord tables carry phase increments, so rebuild them; sounding notes
+    // keep their pitch until retriggered
+    for (int p = 0; p < NUM_CONTROLLERS; p++) {
+        players[p].scaleQuantizer.setTuning(&tuning);
+    }
+
+    Serial.print(F("Tuning: "));
+    Serial.println(tuning.getDescription());
+}
+
+void toggleCapture() {
+    if (hidCapture.isActive()) {
+        hidCapture.end();
+        hidCapture.drain(captureWrite, &captureFile);
+        captureFile.close();
+        Serial.print(F("Capture stopped: "));
+        Serial.print(hidCapture.getRecorded());
+        Serial.print(F(" reports, "));
+        Serial.print(hidCapture.getDropped());
+        Serial.println(F(" dropped"));
+        return;
+    }
+
+    if (hidReplay.isActive() || !ensureSD()) return;
+
+    SD.remove(HID_CAPTURE_FILE);
+    captureFile = SD.open(HID_CAPTURE_FILE, FILE_WRITE);
+    if (!captureFile) {
+        Serial.println(F("Cannot open capture file"));
+        return;
+    }
+    hidCaptureWriteHeader(captureWrite, &captureFile);
+    hidCapture.begin();
+    Serial.println(F("Capture started: " HID_CAPTURE_FILE));
+}
+
+void startReplay(HIDReplay::Mode mode) {
+    if (hidCapture.isActive() || hidReplay.isActive() || !ensureSD()) return;
+
+    captureFile = SD.open(HID_CAPTURE_FILE, FILE_READ);
+    if (!captureFile) {
+        Serial.println(F("No capture file"));
+        return;
+    }
+
+    // Start every replay from the same state so runs are bit-identical
+    for (int p = 0; p < NUM_CONTROLLERS; p++) {
+        releasePlayerVoices(p);
+        resetPlayer(p);
+    }
+    voicePool.init(NUM_VOICES, NUM_CONTROLLERS);
+    for (int p = 0; p < NUM_CONTROLLERS; p++) {
+        voicePool.setShare(p, VOICE_SHARE_DEFAULT, VOICE_LIMIT_DEFAULT);
+    }
+    replayDigest = HID_CAPTURE_HASH_SEED;
+
+    replayStartUs = micros();
+    if (!hidReplay.begin(captureRead, &captureFile, mode, replayStartUs)) {
+        Serial.println(F("Invalid capture file"));
+        captureFile.close();
+        return;
+    }
+    for (int p = 0; p < NUM_CONTROLLERS; p++) controllers[p]->setLiveInput(false);
+    Serial.println(mode == HIDReplay::REPLAY_FAST ? F("Replay started (fast)") : F("Replay started (real time)"));
+}
+
+void serviceCaptureReplay() {
+    if (hidCapture.isActive()) {
+        hidCapture.drain(captureWrite, &captureFile);
+    }
+
+    if (!hidReplay.isActive()) return;
+
+    // Fast mode drains the whole file in one go so loop() overhead
+    // doesn't pollute the reports-per-second figure
+    if (hidReplay.getMode() == HIDReplay::REPLAY_FAST) {
+        while (hidReplay.poll(micros(), replayReport, nullptr) > 0) {}
+    } else {
+        hidReplay.poll(micros(), replayReport, nullptr);
+    }
+
+    if (!hidReplay.isActive()) finishReplay();
+}
+
+// End of file or aborted: close the capture, silence the replayed notes
+// and hand the players back to the guitars
+void finishReplay() {
+    uint32_t elapsedUs = micros() - replayStartUs;
+    captureFile.close();
+    for (int p = 0; p < NUM_CONTROLLERS; p++) {
+        releasePlayerVoices(p);
+        resetPlayer(p);
+        controllers[p]->setLiveInput(true);
+    }
+
+    Serial.print(F("Replay done: "));
+    Serial.print(hidReplay.getDelivered());
+    Serial.print(F(" reports in "));
+    Serial.print(elapsedUs);
+    Serial.print(F("us ("));
+    Serial.print(elapsedUs ? (uint32_t)((uint64_t)hidReplay.getDelivered() * 1000000 / elapsedUs) : 0);
+    Serial.print(F(" reports/s), gaps "));
+    Serial.print(hidReplay.getSequenceGaps());
+    Serial.print(F(", digest 0x"));
+    Serial.println(replayDigest, HEX);
+}
@@ -3,6 +3,7 @@
  */
 
 #include "scale_quantizer.h"
+#include <math.h>
 
 // Scale interval definitions (semitones from root)
 const uint8_t ScaleQuantizer::scaleIntervals[NUM_SCALES][7] = {
@@ -48,22 +49,104 @@ const char* ScaleQuantizer::scaleNames[NUM_SCALES] = {
 ScaleQuantizer::ScaleQuantizer() {
     currentScale = SCALE_PENTATONIC_MINOR;
     rootNote = 60;  // Middle C
+    tuning = nullptr;
+    rebuildChords();
 }
 
 void ScaleQuantizer::setScale(uint8_t scaleIndex) {
-    if (scaleIndex < NUM_SCALES) {
+    if (scaleIndex < NUM_SCALES && scaleIndex != currentScale) {
         currentScale = scaleIndex;
+        rebuildChords();
     }
 }
 
 void ScaleQuantizer::setRootNote(uint8_t note) {
     // Clamp to valid MIDI range
-    if (note <= 127) {
+    if (note <= 127 && note != rootNote) {
         rootNote = note;
+        rebuildChords();
     }
 }
 
+void ScaleQuantizer::setTuning(const TuningEngine* tuning) {
+    this->tuning = tuning;
+    rebuildChords();
+}
+
 uint8_t ScaleQuantizer::quantizeNote(uint8_t scaleDegree, int8_t octaveShift) {
+    // Single frets are one-note chords in the table
+    if (scaleDegree < QUANTIZER_FRETS &&
+        octaveShift >= QUANTIZER_MIN_OCTAVE && octaveShift <= QUANTIZER_MAX_OCTAVE) {
+        return chords[octaveShift - QUANTIZER_MIN_OCTAVE][1 << scaleDegree].notes[0];
+    }
+    return computeNote(scaleDegree, octaveShift);
+}
+
+uint8_t ScaleQuantizer::snapNote(uint8_t baseNote, int32_t offset) const {
+    int32_t position = ((int32_t)baseNote - rootNote) * SNAP_STEPS_PER_SEMITONE + offset;
+    int32_t octave = (position >= 0) ? position / SNAP_STEPS : -((-position + SNAP_STEPS - 1) / SNAP_STEPS);
+    int32_t note = rootNote + octave * 12 + snapTable[position - octave * SNAP_STEPS];
+
+    if (note < 0) note = 0;
+    if (note > 127) note = 127;
+    return (uint8_t)note;
+}
+
+void ScaleQuantizer::rebuildChords() {
+    // Nearest scale note for every position in the octave, over all the
+    // scale's degrees (not just the five on the frets); ties go down
+    uint8_t numNotes = scaleNotes[currentScale];
+    for (int step = 0; step < SNAP_STEPS; step++) {
+        int best = 0;
+        int bestDistance = step;
+        for (uint8_t degree = 1; degree < numNotes; degree++) {
+            int distance = step - scaleIntervals[currentScale][degree] * SNAP_STEPS_PER_SEMITONE;
+            if (distance < 0) distance = -distance;
+            if (distance < bestDistance) {
+                best = scaleIntervals[currentScale][degree];
+                bestDistance = distance;
+            }
+        }
+        if (SNAP_STEPS - step < bestDistance) best = 12;
+        snapTable[step] = best;
+    }
+
+    // Pitch of every fret at every octave shift, then assemble the
+    // combinations from those
+    uint8_t fretNotes[QUANTIZER_FRETS];
+    uint32_t fretIncrements[QUANTIZER_FRETS];
+
+    for (int8_t octave = QUANTIZER_MIN_OCTAVE; octave <= QUANTIZER_MAX_OCTAVE; octave++) {
+        for (uint8_t fret = 0; fret < QUANTIZER_FRETS; fret++) {
+            fretNotes[fret] = computeNote(fret, octave);
+            if (tuning) {
+                fretIncrements[fret] = tuning->phaseIncrement(fretNotes[fret]);
+            } else {
+                float frequency = 440.0f * powf(2.0f, (fretNotes[fret] - 69) / 12.0f);
+                fretIncrements[fret] = frequencyToPhaseIncrement(frequency);
+            }
+        }
+
+        FretChord* table = chords[octave - QUANTIZER_MIN_OCTAVE];
+        for (uint8_t mask = 0; mask < QUANTIZER_CHORDS; mask++) {
+            FretChord& chord = table[mask];
+            chord.count = 0;
+            for (uint8_t fret = 0; fret < QUANTIZER_FRETS; fret++) {
+                if (mask & (1 << fret)) {
+                    chord.notes[chord.count] = fretNotes[fret];
+                    chord.phaseIncrements[chord.count] = fretIncrements[fret];
+                    chord.count++;
+                }
+            }
+            for (uint8_t i = chord.count; i < QUANTIZER_FRETS; i++) {
+                chord.notes[i] = 0;
+                chord.phaseIncrements[i] = 0;
+            }
+        }
+    }
+}
+
+uint8_t ScaleQuantizer::computeNote(uint8_t scaleDegree, int8_t octaveShift) const {
     // Map the 5 fret buttons to scale degrees
     uint8_t numNotes = scaleNotes[currentScale];
 
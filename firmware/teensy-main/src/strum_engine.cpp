@@ -0,0 +1,55 @@
+/**
+ * Strum Engine Implementation
+ */
+
+#include "strum_engine.h"
+#include "config.h"
+
+StrumEngine::StrumEngine() {
+    spreadUs = STRUM_SPREAD_US;
+    sampleRate = AUDIO_SAMPLE_RATE;
+    lastStrumUs = 0;
+    lastSpreadUs = 0;
+    haveLastStrum = false;
+}
+
+uint32_t StrumEngine::spreadForInterval(uint32_t intervalUs, StrumDirection direction) const {
+    // Scale from STRUM_MIN_SPREAD_PERCENT for fast strumming up to 100%
+    // for an isolated strum, linearly between the two interval limits
+    uint32_t percent;
+    if (intervalUs >= STRUM_SLOW_INTERVAL_US) {
+        percent = 100;
+    } else if (intervalUs <= STRUM_FAST_INTERVAL_US) {
+        percent = STRUM_MIN_SPREAD_PERCENT;
+    } else {
+        percent = STRUM_MIN_SPREAD_PERCENT +
+                  (100 - STRUM_MIN_SPREAD_PERCENT) * (intervalUs - STRUM_FAST_INTERVAL_US) /
+                  (STRUM_SLOW_INTERVAL_US - STRUM_FAST_INTERVAL_US);
+    }
+
+    if (direction == STRUM_UP) {
+        percent = percent * STRUM_UPSTROKE_PERCENT / 100;
+    }
+
+    return spreadUs * percent / 100;
+}
+
+uint8_t StrumEngine::plan(StrumDirection direction, uint32_t timestampUs, uint8_t fretMask, StrumNote* notes) {
+    uint32_t intervalUs = haveLastStrum ? timestampUs - lastStrumUs : STRUM_SLOW_INTERVAL_US;
+    lastStrumUs = timestampUs;
+    haveLastStrum = true;
+
+    lastSpreadUs = spreadForInterval(intervalUs, direction);
+    uint32_t spreadSamples = (uint32_t)((uint64_t)lastSpreadUs * sampleRate / 1000000);
+
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < STRUM_MAX_NOTES; i++) {
+        uint8_t fret = (direction == STRUM_DOWN) ? i : (STRUM_MAX_NOTES - 1 - i);
+        if (fretMask & (1 << fret)) {
+            notes[count].fret = fret;
+            notes[count].offsetSamples = count * spreadSamples;
+            count++;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,236 @@
+/**
+ * Tuning Engine Implementation
+ */
+
+#include "tuning.h"
+#include "config.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Line-by-line reader over a text buffer that skips Scala '!' comments
+struct ScalaReader {
+    const char* pos;
+    const char* end;
+
+    // Next non-comment line into line (trimmed of the line ending);
+    // false at end of text
+    bool next(char* line, size_t size) {
+        while (pos < end) {
+            const char* start = pos;
+            while (pos < end && *pos != '\n') pos++;
+            const char* stop = pos;
+            if (pos < end) pos++;  // Skip '\n'
+            if (stop > start && stop[-1] == '\r') stop--;
+
+            if (start < stop && *start == '!') continue;
+
+            size_t n = stop - start;
+            if (n >= size) n = size - 1;
+            memcpy(line, start, n);
+            line[n] = '\0';
+            return true;
+        }
+        return false;
+    }
+};
+
+static const char* skipSpace(const char* s) {
+    while (*s == ' ' || *s == '\t') s++;
+    return s;
+}
+
+// One pitch line: cents if it has a '.', otherwise a ratio "n/d" or "n"
+static bool parsePitch(const char* line, double& cents) {
+    const char* s = skipSpace(line);
+    if (*s == '\0') return false;
+
+    const char* tokenEnd = s;
+    bool isCents = false;
+    while (*tokenEnd && *tokenEnd != ' ' && *tokenEnd != '\t') {
+        if (*tokenEnd == '.') isCents = true;
+        tokenEnd++;
+    }
+
+    char* parsed;
+    if (isCents) {
+        cents = strtod(s, &parsed);
+        return parsed != s;
+    }
+
+    double numerator = strtod(s, &parsed);
+    if (parsed == s || numerator <= 0) return false;
+    double denominator = 1.0;
+    if (*parsed == '/') {
+        const char* d = parsed + 1;
+        denominator = strtod(d, &parsed);
+        if (parsed == d || denominator <= 0) return false;
+    }
+    cents = 1200.0 * log2(numerator / denominator);
+    return true;
+}
+
+static bool parseInt(const char* line, long minValue, long maxValue, long& value) {
+    const char* s = skipSpace(line);
+    char* parsed;
+    value = strtol(s, &parsed, 10);
+    return parsed != s && value >= minValue && value <= maxValue;
+}
+
+bool scalaParse(const char* text, size_t len, ScalaScale& scale) {
+    ScalaReader reader = {text, text + len};
+    char line[128];
+
+    // Description (may be empty), then the pitch count
+    if (!reader.next(line, sizeof(line))) return false;
+    strncpy(scale.description, line, TUNING_DESCRIPTION_LENGTH - 1);
+    scale.description[TUNING_DESCRIPTION_LENGTH - 1] = '\0';
+
+    long count;
+    if (!reader.next(line, sizeof(line)) || !parseInt(line, 1, SCALA_MAX_NOTES, count)) return false;
+    scale.count = (uint8_t)count;
+
+    for (uint8_t i = 0; i < scale.count; i++) {
+        if (!reader.next(line, sizeof(line)) || !parsePitch(line, scale.cents[i])) return false;
+    }
+    return true;
+}
+
+bool keyboardMapParse(const char* text, size_t len, KeyboardMap& map) {
+    ScalaReader reader = {text, text + len};
+    char line[128];
+    long value;
+
+    if (!reader.next(line, sizeof(line)) || !parseInt(line, 0, TUNING_NOTES - 1, value)) return false;
+    map.size = (uint8_t)value;
+    if (!reader.next(line, sizeof(line)) || !parseInt(line, 0, TUNING_NOTES - 1, value)) return false;
+    map.firstNote = (uint8_t)value;
+    if (!reader.next(line, sizeof(line)) || !parseInt(line, 0, TUNING_NOTES - 1, value)) return false;
+    map.lastNote = (uint8_t)value;
+    if (!reader.next(line, sizeof(line)) || !parseInt(line, 0, TUNING_NOTES - 1, value)) return false;
+    map.middleNote = (uint8_t)value;
+    if (!reader.next(line, sizeof(line)) || !parseInt(line, 0, TUNING_NOTES - 1, value)) return false;
+    map.referenceNote = (uint8_t)value;
+
+    if (!reader.next(line, sizeof(line))) return false;
+    char* parsed;
+    map.referenceFrequency = strtod(skipSpace(line), &parsed);
+    if (parsed == skipSpace(line) || map.referenceFrequency <= 0) return false;
+
+    if (!reader.next(line, sizeof(line)) || !parseInt(line, 0, SCALA_MAX_NOTES, value)) return false;
+    map.octaveDegree = (uint8_t)value;
+
+    // Mapping entries; missing trailing entries count as unmapped
+    for (uint8_t i = 0; i < map.size; i++) {
+        map.map[i] = KBM_UNMAPPED;
+        if (!reader.next(line, sizeof(line))) continue;
+        const char* s = skipSpace(line);
+        if (*s == 'x' || *s == 'X') continue;
+        if (!parseInt(s, 0, SCALA_MAX_NOTES * 16, value)) return false;
+        map.map[i] = (int16_t)value;
+    }
+    return true;
+}
+
+void scalaEqualTemperament(ScalaScale& scale) {
+    strcpy(scale.description, "12-TET");
+    scale.count = 12;
+    for (uint8_t i = 0; i < 12; i++) {
+        scale.cents[i] = (i + 1) * 100.0;
+    }
+}
+
+void keyboardMapDefault(KeyboardMap& map) {
+    map.size = 0;
+    map.firstNote = 0;
+    map.lastNote = TUNING_NOTES - 1;
+    map.middleNote = 60;
+    map.referenceNote = 69;
+    map.referenceFrequency = 440.0;
+    map.octaveDegree = 0;
+}
+
+static int floorDiv(int a, int b) {
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+// Scale degree a key plays relative to the middle note
+static bool keyDegree(const ScalaScale& scale, const KeyboardMap& map, int key, int& degree) {
+    int offset = key - map.middleNote;
+    if (map.size == 0) {
+        degree = offset;
+        return true;
+    }
+
+    int repeats = floorDiv(offset, map.size);
+    int index = offset - repeats * map.size;
+    if (map.map[index] == KBM_UNMAPPED) return false;
+
+    int octaveDegree = map.octaveDegree ? map.octaveDegree : scale.count;
+    degree = map.map[index] + repeats * octaveDegree;
+    return true;
+}
+
+// Cents of any (possibly negative) scale degree above the tonic
+static double degreeCents(const ScalaScale& scale, int degree) {
+    int periods = floorDiv(degree, scale.count);
+    int step = degree - periods * scale.count;
+    double period = scale.cents[scale.count - 1];
+    return periods * period + (step ? scale.cents[step - 1] : 0.0);
+}
+
+bool tuningCompile(const ScalaScale& scale, const KeyboardMap& map, uint32_t sampleRate, TuningTable& table) {
+    if (scale.count == 0) return false;
+
+    int referenceDegree;
+    if (!keyDegree(scale, map, map.referenceNote, referenceDegree)) return false;
+    double referenceCents = degreeCents(scale, referenceDegree);
+
+    strncpy(table.description, scale.description, TUNING_DESCRIPTION_LENGTH - 1);
+    table.description[TUNING_DESCRIPTION_LENGTH - 1] = '\0';
+
+    double nyquist = sampleRate / 2.0;
+    for (int key = 0; key < TUNING_NOTES; key++) {
+        table.phaseIncrements[key] = 0;
+        table.pitches[key] = 0;
+
+        int degree;
+        if (key < map.firstNote || key > map.lastNote || !keyDegree(scale, map, key, degree)) continue;
+
+        double frequency = map.referenceFrequency * pow(2.0, (degreeCents(scale, degree) - referenceCents) / 1200.0);
+        if (frequency >= nyquist) continue;  // Would only alias
+
+        uint32_t increment = (uint32_t)(frequency * 4294967296.0 / sampleRate + 0.5);
+        table.phaseIncrements[key] = increment ? increment : 1;
+        table.pitches[key] = (int32_t)lround(log2(frequency / 440.0) * PITCH_UNITS_PER_OCTAVE);
+    }
+    return true;
+}
+
+TuningEngine::TuningEngine() {
+    generation = 0;
+    active = &tables[0];
+    reset();
+}
+
+bool TuningEngine::load(const ScalaScale& scale, const KeyboardMap& map) {
+    TuningTable* spare = (active == &tables[0]) ? &tables[1] : &tables[0];
+    if (!tuningCompile(scale, map, AUDIO_SAMPLE_RATE, *spare)) return false;
+
+    // A single aligned pointer store - readers see the old table or the new
+    active = spare;
+    generation++;
+    return true;
+}
+
+void TuningEngine::reset() {
+    ScalaScale scale;
+    KeyboardMap map;
+    scalaEqualTemperament(scale);
+    keyboardMapDefault(map);
+    load(scale, map);
+}
+
+float TuningEngine::frequency(uint8_t note) const {
+    return phaseIncrement(note) * ((float)AUDIO_SAMPLE_RATE / 4294967296.0f);
+}
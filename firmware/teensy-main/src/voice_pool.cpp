@@ -0,0 +1,128 @@
+/**
+ * Voice Pool Implementation
+ */
+
+#include "voice_pool.h"
+
+VoicePool::VoicePool() {
+    init(0, 0);
+}
+
+void VoicePool::init(uint8_t voices, uint8_t owners) {
+    if (voices > VOICE_POOL_MAX_VOICES) voices = VOICE_POOL_MAX_VOICES;
+    if (owners > VOICE_POOL_MAX_OWNERS) owners = VOICE_POOL_MAX_OWNERS;
+    numVoices = voices;
+    numOwners = owners;
+
+    // Push in reverse so voice 0 is handed out first
+    freeTop = 0;
+    for (int i = numVoices - 1; i >= 0; i--) {
+        freeStack[freeTop++] = i;
+    }
+
+    for (uint8_t i = 0; i < VOICE_POOL_MAX_VOICES; i++) {
+        voiceOwner[i] = VOICE_NONE;
+        prevVoice[i] = VOICE_NONE;
+        nextVoice[i] = VOICE_NONE;
+    }
+
+    // Default policy: equal shares, no cap beyond the whole pool
+    uint8_t share = numOwners ? numVoices / numOwners : 0;
+    for (uint8_t i = 0; i < VOICE_POOL_MAX_OWNERS; i++) {
+        ownerHead[i] = VOICE_NONE;
+        ownerTail[i] = VOICE_NONE;
+        ownerCount[i] = 0;
+        ownerShare[i] = share;
+        ownerLimit[i] = numVoices;
+        stealCount[i] = 0;
+    }
+}
+
+void VoicePool::setShare(uint8_t owner, uint8_t share, uint8_t limit) {
+    if (owner >= numOwners) return;
+    if (limit > numVoices) limit = numVoices;
+    if (share > limit) share = limit;
+    ownerShare[owner] = share;
+    ownerLimit[owner] = limit;
+}
+
+uint8_t VoicePool::allocate(uint8_t owner, uint8_t* stolen) {
+    if (stolen) *stolen = VOICE_NONE;
+    if (owner >= numOwners || ownerLimit[owner] == 0) return VOICE_NONE;
+
+    uint8_t voice = VOICE_NONE;
+
+    if (ownerCount[owner] >= ownerLimit[owner]) {
+        // At the cap: recycle our own oldest voice
+        voice = stealOldest(owner);
+        if (stolen) *stolen = voice;
+    } else if (freeTop > 0) {
+        voice = freeStack[--freeTop];
+    } else {
+        // Pool exhausted. An owner still inside its share may take a voice
+        // from whoever is furthest over theirs; otherwise it recycles its own.
+        uint8_t victim = owner;
+        if (ownerCount[owner] < ownerShare[owner]) {
+            uint8_t worstExcess = 0;
+            for (uint8_t o = 0; o < numOwners; o++) {
+                if (ownerCount[o] > ownerShare[o] && ownerCount[o] - ownerShare[o] > worstExcess) {
+                    worstExcess = ownerCount[o] - ownerShare[o];
+                    victim = o;
+                }
+            }
+        }
+        voice = stealOldest(victim);
+        if (stolen) *stolen = voice;
+    }
+
+    if (voice == VOICE_NONE) return VOICE_NONE;
+
+    link(owner, voice);
+    return voice;
+}
+
+void VoicePool::release(uint8_t voice) {
+    if (!isActive(voice)) return;
+    unlink(voice);
+    freeStack[freeTop++] = voice;
+}
+
+void VoicePool::link(uint8_t owner, uint8_t voice) {
+    voiceOwner[voice] = owner;
+    prevVoice[voice] = ownerTail[owner];
+    nextVoice[voice] = VOICE_NONE;
+
+    if (ownerTail[owner] != VOICE_NONE) {
+        nextVoice[ownerTail[owner]] = voice;
+    } else {
+        ownerHead[owner] = voice;
+    }
+    ownerTail[owner] = voice;
+    ownerCount[owner]++;
+}
+
+void VoicePool::unlink(uint8_t voice) {
+    uint8_t owner = voiceOwner[voice];
+    uint8_t prev = prevVoice[voice];
+    uint8_t next = nextVoice[voice];
+
+    if (prev != VOICE_NONE) nextVoice[prev] = next;
+    else ownerHead[owner] = next;
+
+    if (next != VOICE_NONE) prevVoice[next] = prev;
+    else ownerTail[owner] = prev;
+
+    voiceOwner[voice] = VOICE_NONE;
+    prevVoice[voice] = VOICE_NONE;
+    nextVoice[voice] = VOICE_NONE;
+    ownerCount[owner]--;
+}
+
+uint8_t VoicePool::stealOldest(uint8_t victimOwner) {
+    uint8_t voice = ownerHead[victimOwner];
+    if (voice == VOICE_NONE) return VOICE_NONE;
+
+    unlink(voice);
+    stealCount[victimOwner]++;
+    return voice;
+}
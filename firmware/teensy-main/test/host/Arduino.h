@@ -0,0 +1,16 @@
+/**
+ * Host stand-in for the Teensy core, just enough for the audio objects
+ * the host tests build (audio_scheduler.cpp). The test supplies micros().
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+uint32_t micros();
+inline void __disable_irq() {}
+inline void __enable_irq() {}
+
+#endif // HOST_ARDUINO_H
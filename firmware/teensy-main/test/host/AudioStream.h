@@ -0,0 +1,33 @@
+/**
+ * Host stand-in for the Teensy Audio library's AudioStream: one block in
+ * and out per update(), set and read by the test, no graph
+ */
+
+#ifndef HOST_AUDIO_STREAM_H
+#define HOST_AUDIO_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define AUDIO_BLOCK_SAMPLES 128
+
+struct audio_block_t {
+    int16_t data[AUDIO_BLOCK_SAMPLES];
+};
+
+class AudioStream {
+public:
+    AudioStream(unsigned char, audio_block_t**) : input(NULL), output(NULL) {}
+    virtual ~AudioStream() {}
+    virtual void update(void) = 0;
+
+    audio_block_t* input;    // What the next update() receives (NULL = no block)
+    audio_block_t* output;   // What it transmitted last
+
+protected:
+    audio_block_t* receiveWritable(unsigned int = 0) { return input; }
+    void transmit(audio_block_t* block, unsigned char = 0) { output = block; }
+    void release(audio_block_t*) {}
+};
+
+#endif // HOST_AUDIO_STREAM_H
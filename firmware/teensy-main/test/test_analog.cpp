@@ -0,0 +1,123 @@
+/**
+ * Host Test for Analog Control Conditioning
+ * Checks calibration, deadzone, smoothing and the one-update-per-block
+ * limit, then feeds a noisy whammy to show how many writes it saves
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_analog.cpp -o test_analog
+ *   ./test_analog
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "analog_conditioner.h"
+#include "config.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static void testCalibration() {
+    AnalogConditioner tilt;
+    tilt.init(TILT_DEADZONE, TILT_SPAN, ANALOG_SMOOTHING_SHIFT, TILT_HYSTERESIS);
+    int16_t value;
+
+    // Nothing comes out before the first report
+    CHECK(!tilt.poll(1, value));
+
+    // Connected while held at an angle: that angle reads level
+    tilt.update(5000);
+    CHECK(tilt.isCalibrated() && tilt.getRest() == 5000);
+    CHECK(!tilt.poll(2, value));
+
+    // Inside the deadzone stays at zero
+    tilt.update(5000 + TILT_DEADZONE / 2);
+    for (uint32_t block = 3; block < 40; block++) CHECK(!tilt.poll(block, value));
+    CHECK(tilt.getValue() == 0);
+
+    // Far past the span settles on full scale
+    tilt.update(5000 + TILT_SPAN * 2);
+    for (uint32_t block = 40; block < 100; block++) tilt.poll(block, value);
+    CHECK(tilt.getValue() == ANALOG_FULL_SCALE);
+
+    // And back to rest lands exactly on zero
+    tilt.update(5000);
+    for (uint32_t block = 100; block < 200; block++) tilt.poll(block, value);
+    CHECK(tilt.getValue() == 0);
+
+    // reset() recalibrates from the next report
+    tilt.reset();
+    tilt.update(-1200);
+    CHECK(tilt.getRest() == -1200);
+}
+
+static void testRateLimit() {
+    AnalogConditioner whammy;
+    whammy.init(WHAMMY_DEADZONE, WHAMMY_SPAN, ANALOG_SMOOTHING_SHIFT, WHAMMY_HYSTERESIS);
+    int16_t value = 0;
+
+    whammy.update(0);
+    whammy.update(255);
+
+    // Many polls in one block give at most one update
+    int emits = 0;
+    for (int i = 0; i < 50; i++) emits += whammy.poll(7, value);
+    CHECK(emits == 1);
+    CHECK(value > 0 && value < ANALOG_FULL_SCALE);  // Smoothed, not a jump
+
+    // Output rises monotonically towards full scale, one step per block
+    int16_t last = value;
+    for (uint32_t block = 8; block < 60; block++) {
+        if (whammy.poll(block, value)) {
+            CHECK(value > last);
+            last = value;
+        }
+    }
+    CHECK(last == ANALOG_FULL_SCALE);
+}
+
+static void testNoise() {
+    // 1kHz reports of a half-pressed whammy with +/-3 counts of noise,
+    // for ten seconds of audio blocks
+    AnalogConditioner whammy;
+    whammy.init(WHAMMY_DEADZONE, WHAMMY_SPAN, ANALOG_SMOOTHING_SHIFT, WHAMMY_HYSTERESIS);
+    int16_t value;
+    srand(1);
+
+    whammy.update(0);
+    const uint32_t REPORTS = 10000;
+    uint32_t naiveWrites = 0;
+    int lastRaw = 0;
+    for (uint32_t i = 0; i < REPORTS; i++) {
+        int raw = 128 + rand() % 7 - 3;
+        if (raw != lastRaw) naiveWrites++;  // Old path: a write per change
+        lastRaw = raw;
+        whammy.update(raw);
+
+        uint32_t block = (uint32_t)((uint64_t)i * 1000 * AUDIO_SAMPLE_RATE / 1000000 / AUDIO_BLOCK_SIZE);
+        whammy.poll(block, value);
+    }
+
+    printf("Noisy whammy: %u reports, %u raw changes, %u conditioned updates\n",
+           whammy.getSampleCount(), naiveWrites, whammy.getEmitCount());
+    CHECK(whammy.getEmitCount() < 40);  // Settles then holds inside the hysteresis band
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Analog Conditioner Test\n");
+    printf("=================================\n");
+
+    testCalibration();
+    testRateLimit();
+    testNoise();
+
+    if (failures == 0) {
+        printf("All analog tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
@@ -0,0 +1,195 @@
+/**
+ * Host Test for the Fret Chord Tables
+ * Checks every table entry against the original per-note interval
+ * arithmetic and measures chord lookups per second against it; also
+ * checks scale-glide snapping against a brute-force nearest-note search
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_chords.cpp src/scale_quantizer.cpp -o test_chords
+ *   ./test_chords
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include "scale_quantizer.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+// The single-note mapping as it was before the tables, kept verbatim as
+// the reference
+static const uint8_t refIntervals[NUM_SCALES][7] = {
+    {0, 3, 5, 7, 10, 0, 0},
+    {0, 2, 3, 5, 7, 8, 10},
+    {0, 2, 3, 5, 7, 9, 10},
+    {0, 2, 3, 6, 7, 8, 11},
+    {0, 2, 3, 5, 7, 8, 11},
+    {0, 1, 3, 5, 7, 8, 10}
+};
+static const uint8_t refNotes[NUM_SCALES] = {5, 7, 7, 7, 7, 7};
+
+static uint8_t referenceNote(uint8_t scale, uint8_t root, uint8_t scaleDegree, int8_t octaveShift) {
+    uint8_t numNotes = refNotes[scale];
+    uint8_t mappedDegree = scaleDegree;
+    if (numNotes == 7 && scaleDegree < 5) {
+        static const uint8_t fretToScaleMap[5] = {0, 2, 3, 4, 6};
+        mappedDegree = fretToScaleMap[scaleDegree];
+    }
+    uint8_t interval = refIntervals[scale][mappedDegree % numNotes];
+    uint8_t octaveOffset = (mappedDegree / numNotes) * 12;
+    int16_t finalNote = root + interval + octaveOffset + (octaveShift * 12);
+    if (finalNote < 0) finalNote = 0;
+    if (finalNote > 127) finalNote = 127;
+    return (uint8_t)finalNote;
+}
+
+static void testTables() {
+    ScaleQuantizer quantizer;
+    uint32_t entries = 0;
+
+    for (uint8_t scale = 0; scale < NUM_SCALES; scale++) {
+        quantizer.setScale(scale);
+        for (int root = 0; root <= 127; root++) {
+            quantizer.setRootNote(root);
+            for (int8_t octave = QUANTIZER_MIN_OCTAVE; octave <= QUANTIZER_MAX_OCTAVE; octave++) {
+                for (uint8_t fret = 0; fret < QUANTIZER_FRETS; fret++) {
+                    CHECK(quantizer.quantizeNote(fret, octave) == referenceNote(scale, root, fret, octave));
+                }
+                for (uint8_t mask = 0; mask < QUANTIZER_CHORDS; mask++) {
+                    const FretChord& chord = quantizer.chord(mask, octave);
+                    CHECK(chord.count == __builtin_popcount(mask));
+
+                    uint8_t slot = 0;
+                    for (uint8_t fret = 0; fret < QUANTIZER_FRETS; fret++) {
+                        if (!(mask & (1 << fret))) continue;
+                        uint8_t note = referenceNote(scale, root, fret, octave);
+                        float expected = 440.0f * powf(2.0f, (note - 69) / 12.0f);
+                        float actual = phaseIncrementToFrequency(chord.phaseIncrements[slot]);
+                        CHECK(chord.notes[slot] == note);
+                        CHECK(fabsf(actual - expected) < expected * 1e-5f);
+                        slot++;
+                    }
+                    entries++;
+                }
+            }
+        }
+    }
+
+    // Degrees past the frets still go through the arithmetic
+    quantizer.setScale(SCALE_PENTATONIC_MINOR);
+    quantizer.setRootNote(60);
+    CHECK(quantizer.quantizeNote(7, 0) == referenceNote(SCALE_PENTATONIC_MINOR, 60, 7, 0));
+    CHECK(quantizer.quantizeNote(2, 3) == referenceNote(SCALE_PENTATONIC_MINOR, 60, 2, 3));
+
+    printf("Checked %u chord table entries\n", entries);
+}
+
+// Nearest note whose pitch class is in the scale, ties going down
+static int nearestScaleNote(uint8_t scale, uint8_t root, int32_t position) {
+    int best = -1;
+    int32_t bestDistance = 0x7FFFFFFF;
+    for (int note = -24; note < 160; note++) {
+        int pitchClass = ((note - root) % 12 + 12) % 12;
+        bool inScale = false;
+        for (uint8_t d = 0; d < refNotes[scale]; d++) {
+            if (refIntervals[scale][d] == pitchClass) inScale = true;
+        }
+        if (!inScale) continue;
+        int32_t distance = position - note * SNAP_STEPS_PER_SEMITONE;
+        if (distance < 0) distance = -distance;
+        if (distance < bestDistance) {
+            best = note;
+            bestDistance = distance;
+        }
+    }
+    return best < 0 ? 0 : (best > 127 ? 127 : best);
+}
+
+static void testSnap() {
+    ScaleQuantizer quantizer;
+    for (uint8_t scale = 0; scale < NUM_SCALES; scale++) {
+        quantizer.setScale(scale);
+        for (int root = 55; root <= 66; root++) {
+            quantizer.setRootNote(root);
+            for (uint8_t fret = 0; fret < QUANTIZER_FRETS; fret++) {
+                uint8_t note = quantizer.quantizeNote(fret, 0);
+                CHECK(quantizer.snapNote(note, 0) == note);
+                for (int32_t offset = -24 * SNAP_STEPS_PER_SEMITONE; offset <= 24 * SNAP_STEPS_PER_SEMITONE; offset++) {
+                    int expected = nearestScaleNote(scale, root, note * SNAP_STEPS_PER_SEMITONE + offset);
+                    CHECK(quantizer.snapNote(note, offset) == expected);
+                }
+            }
+        }
+    }
+
+    // Clamped at the ends of the MIDI range
+    quantizer.setRootNote(60);
+    CHECK(quantizer.snapNote(120, 24 * SNAP_STEPS_PER_SEMITONE) == 127);
+    CHECK(quantizer.snapNote(3, -24 * SNAP_STEPS_PER_SEMITONE) == 0);
+}
+
+static void benchmark() {
+    const uint32_t CHORDS = 20000000;
+    ScaleQuantizer quantizer;
+    quantizer.setScale(SCALE_DORIAN);
+    uint32_t checksum = 0;
+
+    // Table: one lookup per chord, pitches ready
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < CHORDS; i++) {
+        const FretChord& chord = quantizer.chord(i & 31, (int8_t)(i % 5) - 2);
+        for (uint8_t n = 0; n < chord.count; n++) checksum += chord.phaseIncrements[n] + chord.notes[n];
+    }
+    double tableSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Per note: interval arithmetic plus a pitch conversion for each fret
+    const uint32_t SLOW_CHORDS = CHORDS / 10;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < SLOW_CHORDS; i++) {
+        uint8_t mask = i & 31;
+        int8_t octave = (int8_t)(i % 5) - 2;
+        for (uint8_t fret = 0; fret < QUANTIZER_FRETS; fret++) {
+            if (!(mask & (1 << fret))) continue;
+            uint8_t note = referenceNote(SCALE_DORIAN, 60, fret, octave);
+            checksum += frequencyToPhaseIncrement(440.0f * powf(2.0f, (note - 69) / 12.0f)) + note;
+        }
+    }
+    double noteSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("\nChord throughput (all 32 combinations, 5 octaves):\n");
+    printf("  table lookup      %8.1f M chords/s  (%.2f ns/chord)\n",
+           CHORDS / tableSeconds / 1e6, tableSeconds * 1e9 / CHORDS);
+    printf("  per-note compute  %8.1f M chords/s  (%.2f ns/chord)\n",
+           SLOW_CHORDS / noteSeconds / 1e6, noteSeconds * 1e9 / SLOW_CHORDS);
+    printf("  (checksum %08X)\n", checksum);
+
+    // Rebuild cost on a scale change
+    const uint32_t REBUILDS = 20000;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < REBUILDS; i++) quantizer.setRootNote(48 + (i & 15));
+    double rebuildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("  table rebuild     %8.2f us\n", rebuildSeconds * 1e6 / REBUILDS);
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Chord Table Test\n");
+    printf("=================================\n");
+
+    testTables();
+    testSnap();
+
+    if (failures == 0) {
+        printf("All chord table tests passed\n");
+    } else {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+
+    benchmark();
+    return 0;
+}
@@ -0,0 +1,269 @@
+/**
+ * Host Test and Benchmark for the Web Control Parser
+ * Checks the incremental parser on the bodies both web UIs send, split at
+ * every possible point, and on malformed input; shows that parsing makes
+ * no heap allocations; and measures messages per second against the
+ * String-and-substring approach it replaces.
+ *
+ * Allocations are counted through operator new and, with glibc, malloc
+ * itself.
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_control_parser.cpp -o test_control_parser
+ *   ./test_control_parser
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <new>
+#include <string>
+#include <chrono>
+#include "control_parser.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+// ---- Allocation counting
+
+static volatile unsigned long allocations = 0;
+
+#ifdef __GLIBC__
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+extern "C" void* malloc(size_t size) {
+    allocations++;
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    allocations++;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    allocations++;
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+void* operator new(size_t size) {
+#ifndef __GLIBC__
+    allocations++;  // Otherwise counted by malloc() above
+#endif
+    void* p = malloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// ---- Helpers
+
+static bool parseWhole(ControlParser& parser, const char* body) {
+    parser.reset();
+    return parser.push(body, strlen(body));
+}
+
+static bool near(float a, float b) { return fabsf(a - b) < 1e-4f * (1 + fabsf(b)); }
+
+// The handler this parser replaced, on std::string in place of Arduino
+// String: copy the body, find the keys, substring out the parts
+static bool parseWithStrings(const char* data, std::string& command, float& value) {
+    std::string body(data);
+    size_t cmdPos = body.find("\"cmd\":\"");
+    if (cmdPos == std::string::npos) return false;
+    command = body.substr(cmdPos + 7, body.find('"', cmdPos + 7) - (cmdPos + 7));
+    size_t valuePos = body.find("\"value\":");
+    value = valuePos != std::string::npos ? (float)atof(body.substr(valuePos + 8).c_str()) : 0.0f;
+    return true;
+}
+
+// ---- Tests
+
+static void testBodies() {
+    ControlParser parser;
+
+    // Main firmware UI
+    CHECK(parseWhole(parser, "{\"command\":\"setScale\",\"value\":3}"));
+    CHECK(strcmp(parser.message().command, "setScale") == 0);
+    CHECK(parser.message().hasValue && parser.message().value == 3.0f);
+
+    CHECK(parseWhole(parser, "{\"command\":\"savePreset\"}"));
+    CHECK(strcmp(parser.message().command, "savePreset") == 0 && !parser.message().hasValue);
+
+    // OSC sketch UI, key order and spacing as JSON.stringify may give them
+    CHECK(parseWhole(parser, " { \"value\" : -12.5 , \"cmd\" : \"octave\" } "));
+    CHECK(strcmp(parser.message().command, "octave") == 0);
+    CHECK(near(parser.message().value, -12.5f));
+
+    // Number forms
+    CHECK(parseWhole(parser, "{\"cmd\":\"filter\",\"value\":2.5e3}") && near(parser.message().value, 2500));
+    CHECK(parseWhole(parser, "{\"cmd\":\"filter\",\"value\":1E-2}") && near(parser.message().value, 0.01f));
+    CHECK(parseWhole(parser, "{\"cmd\":\"filter\",\"value\":0.333333333333}") && near(parser.message().value, 0.333333f));
+    CHECK(parseWhole(parser, "{\"cmd\":\"arp\",\"value\":true}") && parser.message().value == 1.0f);
+    CHECK(parseWhole(parser, "{\"cmd\":\"arp\",\"value\":null}") && !parser.message().hasValue);
+
+    // Unknown keys skipped, nested values and strings with braces included
+    CHECK(parseWhole(parser, "{\"id\":7,\"meta\":{\"a\":[1,{\"b\":\"}]\\\"\"}],\"c\":false},"
+                             "\"averyveryverylongkey\":\"x\",\"cmd\":\"root\",\"value\":4}"));
+    CHECK(strcmp(parser.message().command, "root") == 0 && parser.message().value == 4.0f);
+
+    // Escapes in the command
+    CHECK(parseWhole(parser, "{\"cmd\":\"a\\\"b\\\\c\\/\"}") && strcmp(parser.message().command, "a\"b\\c/") == 0);
+
+    // Empty object is complete with nothing in it
+    CHECK(parseWhole(parser, "{}") && parser.message().command[0] == 0);
+    CHECK(parser.getErrorCount() == 0);
+}
+
+static void testSplits() {
+    // Every way of cutting the body in two gives the same result
+    const char* body = "{\"command\":\"setFilter\",\"value\":1234.5,\"extra\":[1,2]}";
+    size_t len = strlen(body);
+    ControlParser parser;
+
+    for (size_t cut = 0; cut <= len; cut++) {
+        parser.reset();
+        bool first = parser.push(body, cut);
+        bool second = parser.push(body + cut, len - cut);
+        CHECK(!first || cut == len);
+        CHECK(first || second);
+        CHECK(strcmp(parser.message().command, "setFilter") == 0);
+        CHECK(near(parser.message().value, 1234.5f));
+    }
+
+    // Back-to-back messages in one stream, one per push() call
+    const char* stream = "{\"cmd\":\"a\",\"value\":1}\r\n{\"cmd\":\"b\",\"value\":2}";
+    size_t used = 0;
+    parser.reset();
+    CHECK(parser.push(stream, strlen(stream), &used));
+    CHECK(strcmp(parser.message().command, "a") == 0);
+    CHECK(parser.push(stream + used, strlen(stream) - used));
+    CHECK(strcmp(parser.message().command, "b") == 0 && parser.message().value == 2.0f);
+}
+
+static void testMalformed() {
+    static const char* const bad[] = {
+        "",                                          // Incomplete
+        "{\"cmd\":\"scale\",\"value\":3",            // Incomplete
+        "[1,2]",
+        "{\"cmd\":scale}",
+        "{\"cmd\":\"scale\" \"value\":3}",
+        "{\"cmd\":\"scale\",\"value\":-}",
+        "{\"cmd\":\"scale\",\"value\":1e}",
+        "{\"cmd\":\"scale\",\"value\":tru}",
+        "{\"cmd\":\"scale\",\"value\":\"3\"}",       // Value must be a number
+        "{\"cmd\":3}",                               // Command must be a string
+        "{\"cmd\":{\"x\":1}}",
+        "{\"cmd\":\"\\u0041\"}",                      // \u not supported
+        "{\"cmd\":\"abcdefghijklmnopqrstuvwxyz\"}",  // Longer than CONTROL_MAX_COMMAND
+        "{\"cmd\":\"line\nbreak\"}",
+        "{\"x\":[[[[[[[[[[1]]]]]]]]]]}",             // Deeper than CONTROL_MAX_DEPTH
+    };
+
+    ControlParser parser;
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        bool complete = parseWhole(parser, bad[i]);
+        CHECK(!complete && !parser.isComplete());
+        if (complete) printf("  accepted: %s\n", bad[i]);
+    }
+    CHECK(parser.getMessageCount() == 0);
+
+    // Stays in error until reset, then parses normally
+    parser.reset();
+    parser.push("x", 1);
+    CHECK(parser.hasError() && !parser.push("{}", 2));
+    CHECK(parseWhole(parser, "{}"));
+}
+
+static const char* const traffic[] = {
+    "{\"cmd\":\"scale\",\"value\":2}",
+    "{\"cmd\":\"octave\",\"value\":-1}",
+    "{\"cmd\":\"root\",\"value\":7}",
+    "{\"cmd\":\"arp\"}",
+    "{\"cmd\":\"filter\",\"value\":1873.25}",
+};
+#define NUM_TRAFFIC (sizeof(traffic) / sizeof(traffic[0]))
+
+static void testNoHeap() {
+    ControlParser parser;
+    unsigned long before = allocations;
+
+    for (int round = 0; round < 1000; round++) {
+        for (size_t i = 0; i < NUM_TRAFFIC; i++) {
+            // Byte at a time, as a streamed body arrives at worst
+            parser.reset();
+            for (const char* p = traffic[i]; *p; p++) parser.push(*p);
+            CHECK(parser.isComplete());
+        }
+    }
+    unsigned long parserAllocations = allocations - before;
+
+    std::string command;
+    float value;
+    before = allocations;
+    for (int round = 0; round < 1000; round++) {
+        for (size_t i = 0; i < NUM_TRAFFIC; i++) parseWithStrings(traffic[i], command, value);
+    }
+    unsigned long stringAllocations = allocations - before;
+
+    printf("Heap allocations per message: parser %.2f, strings %.2f\n",
+           parserAllocations / (1000.0 * NUM_TRAFFIC), stringAllocations / (1000.0 * NUM_TRAFFIC));
+    CHECK(parserAllocations == 0);
+#ifdef __GLIBC__
+    CHECK(stringAllocations > 0);  // The counter does see allocations
+#endif
+}
+
+static void benchmark() {
+    const int rounds = 200000;
+    ControlParser parser;
+    float sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        const char* body = traffic[round % NUM_TRAFFIC];
+        parser.reset();
+        parser.push(body, strlen(body));
+        sink += parser.message().value;
+    }
+    double parserSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::string command;
+    float value = 0;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        parseWithStrings(traffic[round % NUM_TRAFFIC], command, value);
+        sink += value;
+    }
+    double stringSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("Messages per second: parser %.0f, strings %.0f (checksum %.0f)\n",
+           rounds / parserSeconds, rounds / stringSeconds, sink);
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Web Control Parser Test\n");
+    printf("=================================\n");
+
+    testBodies();
+    testSplits();
+    testMalformed();
+    testNoHeap();
+    benchmark();
+
+    if (failures == 0) {
+        printf("All control parser tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
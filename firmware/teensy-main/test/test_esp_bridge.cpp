@@ -0,0 +1,247 @@
+/**
+ * Host Test for the ESP Bridge
+ * The ESP firmware's logic without the ESP (esp8266-wifi/src/esp_bridge.h),
+ * against a Teensy end built from the same link classes: resync on boot,
+ * state deltas mirrored, acknowledged and shown in /status, a delta on a
+ * generation the bridge never saw, OSC and web commands out as coalesced
+ * LinkSetParam frames, and browser pushes
+ *
+ * The bridge under load, natively on Linux, is esp8266-wifi/tools/load_generator.cpp.
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_esp_bridge.cpp ../esp8266-wifi/src/esp_bridge.cpp -o test_esp_bridge
+ *   ./test_esp_bridge
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "../../esp8266-wifi/src/esp_bridge.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+// What came out of the bridge for the Teensy, by frame type
+struct Received {
+    int commands;
+    uint8_t lastCommand;
+    int acks;
+    uint16_t lastAck;
+    int credits;
+    int params;
+    LinkSetParam lastParam;
+};
+
+static LinkDecoder teensyDecoder;
+
+static Received drain(EspBridge& bridge, uint32_t nowMs) {
+    Received got;
+    memset(&got, 0, sizeof(got));
+    bridge.tick(nowMs, nowMs * 1000);
+
+    uint8_t chunk[64];
+    size_t n;
+    while ((n = bridge.pull(chunk, sizeof(chunk), nowMs)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (!teensyDecoder.push(chunk[i])) continue;
+            LinkCommand command;
+            LinkStateAck ack;
+            LinkCredit credit;
+            if (teensyDecoder.get(command)) {
+                got.commands++;
+                got.lastCommand = command.command;
+            } else if (teensyDecoder.get(ack)) {
+                got.acks++;
+                got.lastAck = ack.generation;
+            } else if (teensyDecoder.get(credit)) {
+                got.credits++;
+            } else if (teensyDecoder.get(got.lastParam)) {
+                got.params++;
+            }
+        }
+    }
+    return got;
+}
+
+// A STATE frame from sender into the bridge; false if nothing was due
+static bool sendState(EspBridge& bridge, LinkStateSender& sender, uint32_t nowMs) {
+    uint8_t payload[LINK_MAX_PAYLOAD];
+    size_t len = sender.poll(nowMs, payload);
+    if (!len) return false;
+    uint8_t frame[LINK_MAX_FRAME];
+    bridge.receive(frame, linkEncode(LINK_MSG_STATE, payload, len, frame), nowMs * 1000);
+    return true;
+}
+
+static size_t oscFloat(const char* address, float value, uint8_t* out) {
+    size_t len = strlen(address) + 1;
+    memcpy(out, address, len);
+    while (len % 4) out[len++] = 0;
+    memcpy(out + len, ",f\0\0", 4);
+    len += 4;
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    for (int i = 0; i < 4; i++) out[len++] = bits >> (24 - 8 * i);
+    return len;
+}
+
+static ControlMessage control(const char* json) {
+    ControlParser parser;
+    parser.push(json, strlen(json));
+    return parser.message();
+}
+
+static void testLinkSync() {
+    printf("\n--- Link sync ---\n");
+    EspBridge bridge;
+    LinkStateSender sender;
+    uint32_t now = 1000;
+
+    // Boot: no mirror, so a resync request (and the first credit grant)
+    Received got = drain(bridge, now);
+    CHECK(!bridge.isSynced());
+    CHECK(got.commands == 1 && got.lastCommand == LINK_CMD_RESYNC);
+    CHECK(got.credits == 1);
+    CHECK(drain(bridge, now + 10).commands == 0);                       // Not again straight away
+    CHECK(drain(bridge, now + BRIDGE_RESYNC_INTERVAL_MS).commands == 1);
+    now += BRIDGE_RESYNC_INTERVAL_MS;
+
+    size_t len;
+    const char* status = bridge.status(now, len);
+    CHECK(strstr(status, "\"connected\":false") != NULL);
+    CHECK(strstr(status, "\"message\":\"System initialized\"") != NULL);
+
+    // The Teensy answers with everything; the bridge mirrors and acks it
+    sender.resync();
+    sender.state().connected = 1;
+    sender.state().voices = 5;
+    sender.state().cpuTenths = 123;
+    sender.state().memBlocks = 300;     // Wider than a byte
+    CHECK(sendState(bridge, sender, now));
+    CHECK(bridge.isSynced());
+    got = drain(bridge, now + 1);
+    CHECK(got.acks == 1 && got.lastAck == sender.getGeneration());
+    sender.ack(got.lastAck);
+    CHECK(sender.isSynced());
+
+    status = bridge.status(now + 1, len);
+    CHECK(len == strlen(status));
+    CHECK(strstr(status, "\"connected\":true") != NULL);
+    CHECK(strstr(status, "\"voices\":5") != NULL);
+    CHECK(strstr(status, "\"cpu\":12.3") != NULL);
+    CHECK(strstr(status, "\"memory\":300") != NULL);
+    printf("  %s\n", status);
+
+    // A delta: only what changed crosses, the mirror has all of it
+    sender.state().voices = 7;
+    CHECK(sendState(bridge, sender, now + 2));
+    CHECK(bridge.getState().activeVoices == 7 && bridge.getState().controllerConnected);
+    CHECK(drain(bridge, now + 3).lastAck == sender.getGeneration());
+
+    // A delta building on a generation the bridge never saw: mirror
+    // dropped, resync asked for
+    LinkStateSender stranger;
+    stranger.state().voices = 9;
+    uint8_t payload[LINK_MAX_PAYLOAD];
+    stranger.poll(now, payload);
+    stranger.ack(stranger.getGeneration());
+    stranger.state().voices = 10;
+    size_t deltaLen = stranger.poll(now, payload);
+    payload[2] += 40;          // Acked generation the bridge doesn't have
+    uint8_t frame[LINK_MAX_FRAME];
+    bridge.receive(frame, linkEncode(LINK_MSG_STATE, payload, deltaLen, frame), now * 1000);
+    CHECK(!bridge.isSynced());
+    got = drain(bridge, now + 2 * BRIDGE_RESYNC_INTERVAL_MS);
+    CHECK(got.commands == 1 && got.lastCommand == LINK_CMD_RESYNC);
+
+    CHECK(bridge.getLinkErrors() == 0);
+}
+
+static void testInputs() {
+    printf("\n--- OSC and web commands ---\n");
+    EspBridge bridge;
+    uint32_t now = 5000;
+    drain(bridge, now);
+
+    // One OSC message: straight out after a quiet spell
+    uint8_t packet[32];
+    bridge.receiveOSC(packet, oscFloat("/synth/filter", 1234.0f, packet));
+    Received got = drain(bridge, now);
+    CHECK(got.params == 1);
+    CHECK(got.lastParam.param == LINK_PARAM_FILTER && got.lastParam.value == 1234.0f);
+
+    // A fader flood: only the latest value per interval
+    for (int i = 0; i < 100; i++) {
+        bridge.receiveOSC(packet, oscFloat("/synth/filter", 100.0f + i, packet));
+    }
+    CHECK(drain(bridge, now + 1).params == 0);
+    got = drain(bridge, now + PARAM_COALESCE_INTERVAL_MS);
+    CHECK(got.params == 1 && got.lastParam.value == 199.0f);
+    CHECK(bridge.getParams().getReceived() == 101 && bridge.getParams().getForwarded() == 2);
+
+    // Unknown addresses and out-of-range values
+    bridge.receiveOSC(packet, oscFloat("/synth/nothing", 1.0f, packet));
+    CHECK(bridge.getParams().getReceived() == 101);
+    bridge.receiveOSC(packet, oscFloat("/synth/reverb", 250.0f, packet));
+    got = drain(bridge, now + 2 * PARAM_COALESCE_INTERVAL_MS);
+    CHECK(got.params == 1 && got.lastParam.param == LINK_PARAM_REVERB && got.lastParam.value == 100.0f);
+
+    // Web commands
+    now += 3 * PARAM_COALESCE_INTERVAL_MS;
+    CHECK(bridge.applyControl(control("{\"command\":\"setOctave\",\"value\":-1}")));
+    got = drain(bridge, now);
+    CHECK(got.params == 1 && got.lastParam.param == LINK_PARAM_OCTAVE && got.lastParam.value == -1.0f);
+    CHECK(bridge.applyControl(control("{\"command\":\"savePreset\"}")));
+    got = drain(bridge, now + 1);
+    CHECK(got.commands == 1 && got.lastCommand == LINK_CMD_SAVE_PRESET);
+    CHECK(!bridge.applyControl(control("{\"command\":\"setReverb\"}")));   // No value
+    CHECK(!bridge.applyControl(control("{\"command\":\"reboot\",\"value\":1}")));
+
+    CHECK(EspBridge::paramFromCommand("setScale") == LINK_PARAM_SCALE);
+    CHECK(EspBridge::paramFromCommand("setlforate") == LINK_PARAM_LFO_RATE);
+    CHECK(EspBridge::paramFromCommand("SETLfoDepth") == LINK_PARAM_LFO_DEPTH);
+    CHECK(EspBridge::paramFromCommand("scale") == 0);
+    CHECK(EspBridge::paramFromCommand("setAVeryLongNameIndeed") == 0);
+}
+
+static void testPush() {
+    printf("\n--- Browser push ---\n");
+    EspBridge bridge;
+    LinkStateSender sender;
+    uint32_t now = 9000;
+    char text[STATE_PUSH_MAX_TEXT];
+
+    // Nothing to push, or snapshot, before there's a mirror
+    CHECK(bridge.pollPush(now, text, sizeof(text)) == 0);
+
+    sender.state().scale = 3;
+    sendState(bridge, sender, now);
+    size_t n = bridge.snapshot(text, sizeof(text));
+    CHECK(n > 0 && strstr(text, "\"scale\":3") != NULL);
+
+    size_t pushed = 0;
+    for (uint32_t t = now; t < now + 2 * STATE_PUSH_INTERVAL_MS && !pushed; t++) {
+        pushed = bridge.pollPush(t, text, sizeof(text));
+    }
+    CHECK(pushed > 0);
+    printf("  snapshot %u bytes, first push %u bytes\n", (unsigned)n, (unsigned)pushed);
+}
+
+int main() {
+    printf("=================================\n");
+    printf("ESP Bridge Test\n");
+    printf("=================================\n");
+
+    testLinkSync();
+    testInputs();
+    testPush();
+
+    if (failures == 0) {
+        printf("\nAll ESP bridge tests passed\n");
+        return 0;
+    }
+    printf("\n%d check(s) failed\n", failures);
+    return 1;
+}
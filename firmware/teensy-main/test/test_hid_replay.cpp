@@ -0,0 +1,260 @@
+/**
+ * Host Test for HID Capture and Replay
+ * Round-trips synthetic reports through a capture file and checks that
+ * replay is deterministic in both fast and real-time modes
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_hid_replay.cpp src/hid_capture.cpp -o test_hid_replay
+ *   ./test_hid_replay [capture.ghc]
+ *
+ * With a file argument the capture (e.g. copied off the SD card) is
+ * replayed as fast as possible and its report digest is printed, so two
+ * firmware versions can be diffed on the same input.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "hid_capture.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+#define TEST_VID 0x1430
+#define TEST_PID 0x4748
+
+// In-memory capture storage
+struct MemFile {
+    uint8_t data[HID_CAPTURE_HEADER_SIZE + 2000 * HID_CAPTURE_RECORD_SIZE];
+    size_t size;
+    size_t pos;
+};
+
+static size_t memWrite(void* ctx, const uint8_t* data, size_t len) {
+    MemFile* f = (MemFile*)ctx;
+    if (f->size + len > sizeof(f->data)) return 0;
+    memcpy(f->data + f->size, data, len);
+    f->size += len;
+    return len;
+}
+
+static size_t memRead(void* ctx, uint8_t* data, size_t len) {
+    MemFile* f = (MemFile*)ctx;
+    if (f->pos + len > f->size) len = f->size - f->pos;
+    memcpy(data, f->data + f->pos, len);
+    f->pos += len;
+    return len;
+}
+
+static size_t fileRead(void* ctx, uint8_t* data, size_t len) {
+    return fread(data, 1, len, (FILE*)ctx);
+}
+
+// Replay sink that fingerprints everything it receives
+struct Collector {
+    uint32_t digest;
+    uint32_t count;
+    uint32_t lastDeliveredAt;
+    bool early;
+    uint32_t now;
+    uint32_t firstStamp;
+    const HIDReplay* replay;    // Set to fingerprint replay times too
+    uint32_t start;
+    uint32_t timeDigest;
+    bool wrongDevice;
+
+    Collector(const HIDReplay* replay = nullptr, uint32_t start = 0)
+        : digest(HID_CAPTURE_HASH_SEED), count(0), lastDeliveredAt(0), early(false),
+          now(0), firstStamp(0), replay(replay), start(start),
+          timeDigest(HID_CAPTURE_HASH_SEED), wrongDevice(false) {}
+};
+
+static void collect(void* ctx, const HIDCaptureRecord& record) {
+    Collector* c = (Collector*)ctx;
+    // Each report keeps the device it came from
+    if (record.vendorID != TEST_VID || record.productID != TEST_PID + (record.controller & 1)) c->wrongDevice = true;
+    if (c->count == 0) c->firstStamp = record.timestampUs;
+    // Real-time replay must never deliver a report before its offset
+    if (record.timestampUs - c->firstStamp > c->now) c->early = true;
+    c->digest = hidCaptureHash(c->digest, &record.controller, 1);
+    c->digest = hidCaptureHash(c->digest, record.data, record.length);
+    if (c->replay) {
+        uint32_t offset = c->replay->replayTimeUs(record) - c->start;
+        c->timeDigest = hidCaptureHash(c->timeDigest, &offset, sizeof(offset));
+    }
+    c->count++;
+}
+
+// Deterministic fake Xbox 360 style report stream
+static void makeReport(uint32_t i, uint8_t* report) {
+    memset(report, 0, 20);
+    report[1] = 20;
+    report[2] = (i * 7) & 0x0F;
+    report[3] = (i >> 3) & 0x01;
+    report[5] = (uint8_t)(i * 13);
+    report[6] = (uint8_t)i;
+    report[7] = (uint8_t)(i >> 8);
+}
+
+static void buildCapture(MemFile& file, uint32_t reports) {
+    static HIDCapture capture;
+    memset(&file, 0, sizeof(file));
+    hidCaptureWriteHeader(memWrite, &file);
+    capture.begin();
+
+    uint8_t report[20];
+    for (uint32_t i = 0; i < reports; i++) {
+        makeReport(i, report);
+        // 250Hz, two players on different guitars
+        capture.record(i & 1, TEST_VID, TEST_PID + (i & 1), report, sizeof(report), 1000 + i * 4000);
+        if ((i & 15) == 15) capture.drain(memWrite, &file);
+    }
+    capture.drain(memWrite, &file);
+    capture.end();
+}
+
+static void testRoundTrip() {
+    static MemFile file;
+    buildCapture(file, 1000);
+    CHECK(file.size == HID_CAPTURE_HEADER_SIZE + 1000 * HID_CAPTURE_RECORD_SIZE);
+
+    HIDReplay replay;
+    Collector c;
+    file.pos = 0;
+    CHECK(replay.begin(memRead, &file, HIDReplay::REPLAY_FAST, 0));
+    while (replay.poll(0, collect, &c) > 0) {}
+    CHECK(!replay.isActive());
+    CHECK(c.count == 1000);
+    CHECK(!c.wrongDevice);
+    CHECK(replay.getSequenceGaps() == 0);
+
+    // Expected digest computed straight from the generator
+    uint32_t expected = HID_CAPTURE_HASH_SEED;
+    uint8_t report[20];
+    for (uint32_t i = 0; i < 1000; i++) {
+        uint8_t controller = i & 1;
+        makeReport(i, report);
+        expected = hidCaptureHash(expected, &controller, 1);
+        expected = hidCaptureHash(expected, report, sizeof(report));
+    }
+    CHECK(c.digest == expected);
+}
+
+static void testRealtime() {
+    static MemFile file;
+    buildCapture(file, 200);
+
+    HIDReplay replay;
+    // Start the replay clock near the micros() wrap point
+    uint32_t start = 0xFFFF0000u;
+    Collector c(&replay, start);
+    file.pos = 0;
+    CHECK(replay.begin(memRead, &file, HIDReplay::REPLAY_REALTIME, start));
+
+    // Step a fake clock in uneven increments
+    for (uint32_t t = 0; replay.isActive() && t < 2000000; t += 1700) {
+        c.now = t;
+        replay.poll(start + t, collect, &c);
+    }
+    CHECK(c.count == 200);
+    CHECK(!c.early);
+
+    // Same capture, fast mode: same digest, and the same report times
+    // relative to the start however the polls fell
+    HIDReplay fast;
+    Collector f(&fast, 1234);
+    f.now = 0xFFFFFFFFu;
+    file.pos = 0;
+    CHECK(fast.begin(memRead, &file, HIDReplay::REPLAY_FAST, 1234));
+    while (fast.poll(1234, collect, &f) > 0) {}
+    CHECK(f.digest == c.digest);
+    CHECK(f.timeDigest == c.timeDigest);
+}
+
+static void testDropCounting() {
+    static MemFile file;
+    static HIDCapture capture;
+    memset(&file, 0, sizeof(file));
+    hidCaptureWriteHeader(memWrite, &file);
+    capture.begin();
+
+    // Overfill the ring without draining
+    uint8_t report[20] = {0};
+    for (uint32_t i = 0; i < HID_CAPTURE_RING_SIZE + 10; i++) {
+        capture.record(0, TEST_VID, TEST_PID, report, sizeof(report), i);
+    }
+    CHECK(capture.getRecorded() == HID_CAPTURE_RING_SIZE);
+    CHECK(capture.getDropped() == 10);
+    capture.drain(memWrite, &file);
+    capture.record(0, TEST_VID, TEST_PID, report, sizeof(report), 999);
+    capture.drain(memWrite, &file);
+
+    // Replay sees the hole in the sequence numbers
+    HIDReplay replay;
+    Collector c;
+    file.pos = 0;
+    CHECK(replay.begin(memRead, &file, HIDReplay::REPLAY_FAST, 0));
+    while (replay.poll(0, collect, &c) > 0) {}
+    CHECK(c.count == HID_CAPTURE_RING_SIZE + 1);
+    CHECK(replay.getSequenceGaps() == 1);
+}
+
+static void testBadHeader() {
+    static MemFile file;
+    memset(&file, 0, sizeof(file));
+    const uint8_t junk[HID_CAPTURE_HEADER_SIZE] = {'N', 'O', 'P', 'E', 1, 0, 72, 0};
+    memWrite(&file, junk, sizeof(junk));
+
+    HIDReplay replay;
+    CHECK(!replay.begin(memRead, &file, HIDReplay::REPLAY_FAST, 0));
+    CHECK(!replay.isActive());
+}
+
+static int replayFile(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        printf("Cannot open %s\n", path);
+        return 1;
+    }
+
+    HIDReplay replay;
+    Collector c;
+    if (!replay.begin(fileRead, f, HIDReplay::REPLAY_FAST, 0)) {
+        printf("Invalid capture file\n");
+        fclose(f);
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    while (replay.poll(0, collect, &c) > 0) {}
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fclose(f);
+
+    printf("Replayed %u reports in %.3f ms (%.0f reports/s), gaps %u, digest 0x%08X\n",
+           c.count, seconds * 1000.0, seconds > 0 ? c.count / seconds : 0.0,
+           replay.getSequenceGaps(), c.digest);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) return replayFile(argv[1]);
+
+    printf("=================================\n");
+    printf("HID Capture/Replay Test\n");
+    printf("=================================\n");
+
+    testRoundTrip();
+    testRealtime();
+    testDropCounting();
+    testBadHeader();
+
+    if (failures == 0) {
+        printf("All HID capture/replay tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
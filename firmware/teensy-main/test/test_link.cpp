@@ -0,0 +1,248 @@
+/**
+ * Host Test for the Teensy <-> ESP Link Protocol
+ * Round-trips every message through framing and the byte-wise decoder,
+ * checks error detection and resync, and benchmarks codec speed and link
+ * throughput of state deltas and note batches against the old JSON lines
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_link.cpp -o test_link
+ *   ./test_link
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include "link_protocol.h"
+#include "link_state.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+// Encode, feed byte by byte, and copy the message back out
+template <typename T>
+static bool roundTrip(const T& in, T& out, LinkDecoder& decoder) {
+    uint8_t frame[LINK_MAX_FRAME];
+    size_t len = linkEncode(in, frame);
+    if (len == 0 || len > LINK_MAX_FRAME || frame[0] != 0 || frame[len - 1] != 0) return false;
+    if (decoder.push(frame[0])) return false;
+    for (size_t i = 1; i + 1 < len; i++) {
+        if (frame[i] == 0) return false;            // COBS left a zero in
+        if (decoder.push(frame[i])) return false;   // Completed early
+    }
+    return decoder.push(0) && decoder.get(out);
+}
+
+// Same for a variable-length payload
+static bool roundTripRaw(uint8_t type, const uint8_t* in, size_t len, LinkDecoder& decoder) {
+    uint8_t frame[LINK_MAX_FRAME];
+    size_t frameLen = linkEncode(type, in, len, frame);
+    if (frameLen == 0 || frameLen > LINK_MAX_FRAME) return false;
+    bool done = false;
+    for (size_t i = 0; i < frameLen; i++) done = decoder.push(frame[i]);
+    return done && decoder.type() == type && decoder.payloadLength() == len &&
+           memcmp(decoder.payload(), in, len) == 0;
+}
+
+static void testCrc() {
+    // CRC-16/CCITT-FALSE check value
+    CHECK(linkCrc16((const uint8_t*)"123456789", 9) == 0x29B1);
+}
+
+static void testCobs() {
+    uint8_t in[300], enc[310], dec[300];
+
+    // All zeros, no zeros, and runs either side of the 254-byte block limit
+    const size_t lengths[] = {1, 2, 253, 254, 255, 300};
+    for (size_t fill = 0; fill < 2; fill++) {
+        for (size_t l : lengths) {
+            for (size_t i = 0; i < l; i++) in[i] = fill ? (uint8_t)(i % 255 + 1) : 0;
+            size_t e = cobsEncode(in, l, enc);
+            CHECK(e <= l + l / 254 + 1);
+            CHECK(memchr(enc, 0, e) == NULL);
+            CHECK(cobsDecode(enc, e, dec) == l && memcmp(in, dec, l) == 0);
+        }
+    }
+
+    // A zero inside the block, or a code running past the end, is malformed
+    uint8_t bad1[] = {3, 1, 0};
+    uint8_t bad2[] = {5, 1, 2};
+    CHECK(cobsDecode(bad1, sizeof(bad1), dec) == 0);
+    CHECK(cobsDecode(bad2, sizeof(bad2), dec) == 0);
+}
+
+static void testRoundTrip() {
+    LinkDecoder decoder;
+
+    LinkCommand command = {LINK_CMD_RESYNC}, command2;
+    CHECK(roundTrip(command, command2, decoder));
+    CHECK(command2.command == LINK_CMD_RESYNC);
+
+    LinkSetParam param = {LINK_PARAM_FILTER, 1234.5f}, param2 = {0, 0.0f};
+    CHECK(roundTrip(param, param2, decoder));
+    CHECK(param2.param == LINK_PARAM_FILTER && param2.value == 1234.5f);
+
+    LinkStateAck ack = {0xBEEF}, ack2 = {0};
+    CHECK(roundTrip(ack, ack2, decoder));
+    CHECK(ack2.generation == 0xBEEF);
+
+    // Variable payloads: shortest, longest, all zeros and all 0xFF
+    uint8_t payload[LINK_MAX_PAYLOAD];
+    for (size_t i = 0; i < sizeof(payload); i++) payload[i] = (uint8_t)(i * 37);
+    CHECK(roundTripRaw(LINK_MSG_NOTES, payload, 1, decoder));
+    CHECK(roundTripRaw(LINK_MSG_STATE, payload, LINK_MAX_PAYLOAD, decoder));
+    memset(payload, 0, sizeof(payload));
+    CHECK(roundTripRaw(LINK_MSG_STATE, payload, LINK_MAX_PAYLOAD, decoder));
+    memset(payload, 0xFF, sizeof(payload));
+    CHECK(roundTripRaw(LINK_MSG_NOTES, payload, 7, decoder));
+
+    // Sizes the type doesn't allow are refused at encode time
+    uint8_t frame[LINK_MAX_FRAME + 8];
+    CHECK(linkEncode(LINK_MSG_STATE, payload, 0, frame) == 0);
+    CHECK(linkEncode(LINK_MSG_STATE, payload, LINK_MAX_PAYLOAD + 1, frame) == 0);
+    CHECK(linkEncode(LINK_MSG_COMMAND, payload, 2, frame) == 0);
+    CHECK(linkEncode(0x7E, payload, 1, frame) == 0);
+
+    // Every catalogue entry fits a frame; the wrong struct is refused
+    for (int type = 0; type < 256; type++) {
+        CHECK(linkPayloadSize(type) <= LINK_MAX_PAYLOAD);
+    }
+    CHECK(!decoder.get(command2));
+
+    CHECK(decoder.getFrameCount() == 7);
+    CHECK(decoder.getCrcErrors() == 0 && decoder.getFramingErrors() == 0);
+}
+
+static void testErrors() {
+    LinkDecoder decoder;
+    LinkSetParam param = {LINK_PARAM_ROOT, 7.0f}, out;
+    uint8_t frame[LINK_MAX_FRAME];
+    size_t len = linkEncode(param, frame);
+
+    // Every single-bit flip is caught
+    int accepted = 0;
+    for (size_t byte = 1; byte + 1 < len; byte++) {
+        for (int bit = 0; bit < 8; bit++) {
+            uint8_t copy[LINK_MAX_FRAME];
+            memcpy(copy, frame, len);
+            copy[byte] ^= 1 << bit;
+            for (size_t i = 0; i < len; i++) {
+                if (decoder.push(copy[i])) accepted++;
+            }
+            // A flip to zero splits the frame - finish off the leftover
+            decoder.push(0);
+        }
+    }
+    CHECK(accepted == 0);
+    CHECK(decoder.getCrcErrors() + decoder.getFramingErrors() > 0);
+
+    // Debug text and a runaway line ahead of a frame don't stop it decoding
+    decoder = LinkDecoder();
+    const char* text = "ESP8266 WiFi module ready\r\n";
+    for (const char* c = text; *c; c++) decoder.push(*c);
+    for (int i = 0; i < 500; i++) decoder.push('x');
+    bool got = false;
+    for (size_t i = 0; i < len; i++) got = decoder.push(frame[i]);
+    CHECK(got && decoder.get(out) && out.value == 7.0f);
+    CHECK(decoder.getFramingErrors() == 1);  // The text + runaway line
+
+    // A fixed-size type arriving with the wrong length is refused
+    uint8_t shortRaw[4] = {LINK_MSG_SET_PARAM, 1, 0, 0};
+    uint16_t shortCrc = linkCrc16(shortRaw, 2);
+    shortRaw[2] = shortCrc & 0xFF;
+    shortRaw[3] = shortCrc >> 8;
+    uint8_t shortFrame[8];
+    size_t shortLen = cobsEncode(shortRaw, 4, shortFrame);
+    decoder = LinkDecoder();
+    for (size_t i = 0; i < shortLen; i++) decoder.push(shortFrame[i]);
+    CHECK(!decoder.push(0));
+    CHECK(decoder.getFramingErrors() == 1);
+
+    // Unknown type with a good CRC is a framing error, not a message
+    uint8_t raw[4] = {0x7E, 1, 0, 0};
+    uint16_t crc = linkCrc16(raw, 2);
+    raw[2] = crc & 0xFF;
+    raw[3] = crc >> 8;
+    uint8_t bogus[8];
+    size_t bogusLen = cobsEncode(raw, 4, bogus);
+    decoder = LinkDecoder();
+    for (size_t i = 0; i < bogusLen; i++) decoder.push(bogus[i]);
+    CHECK(!decoder.push(0));
+    CHECK(decoder.getFramingErrors() == 1);
+}
+
+static void benchmark() {
+    const uint32_t FRAMES = 5000000;
+    LinkStateSender sender;
+    LinkState& state = sender.state();
+    state.connected = 1;
+    state.voices = 4;
+    state.cpuTenths = 250;
+    state.memBlocks = 40;
+    LinkDecoder decoder;
+    uint8_t payload[LINK_MAX_PAYLOAD];
+    uint8_t frame[LINK_MAX_FRAME];
+    size_t fullLen = sender.poll(0, payload);
+    uint32_t checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < FRAMES; i++) {
+        payload[7] = (uint8_t)i;
+        payload[9] = (uint8_t)(i * 7);
+        size_t len = linkEncode(LINK_MSG_STATE, payload, fullLen, frame);
+        for (size_t b = 0; b < len; b++) {
+            if (decoder.push(frame[b])) checksum += decoder.payload()[7];
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("\nCodec: %.1f M full-state frames/s encode+decode (%.0f ns/frame, checksum %08X)\n",
+           FRAMES / seconds / 1e6, seconds * 1e9 / FRAMES, checksum);
+
+    // Wire cost per message vs the JSON lines the firmware used to print.
+    // The usual periodic update only changes the CPU figure.
+    size_t fullBytes = linkEncode(LINK_MSG_STATE, payload, fullLen, frame);
+    sender.ack(sender.getGeneration());
+    state.cpuTenths = 260;
+    size_t deltaBytes = linkEncode(LINK_MSG_STATE, payload, sender.poll(1000, payload), frame);
+    LinkNoteBatcher batcher;
+    for (uint8_t n = 0; n < 4; n++) batcher.add(60 + n, 100, 0, 0);
+    size_t chordBytes = linkEncode(LINK_MSG_NOTES, payload, batcher.flush(payload), frame);
+    const size_t jsonStatusBytes = sizeof("{\"connected\":true,\"scale\":0,\"octave\":0,\"voices\":4,\"cpu\":25.00,\"mem\":40}\r\n") - 1;
+    const size_t jsonNoteBytes = sizeof("{\"type\":\"note\",\"note\":64,\"on\":true}\r\n") - 1;
+
+    printf("Link throughput (8N1, 10 bits/byte):\n");
+    printf("  %8s %10s %14s %12s %16s\n", "baud", "deltas/s", "JSON status/s", "4-note chords/s", "JSON chords/s");
+    const uint32_t bauds[] = {115200, 230400, 460800, 921600, 2000000};
+    for (uint32_t baud : bauds) {
+        double bytesPerSecond = baud / 10.0;
+        printf("  %8u %10.0f %14.0f %12.0f %16.0f\n", baud,
+               bytesPerSecond / deltaBytes, bytesPerSecond / jsonStatusBytes,
+               bytesPerSecond / chordBytes, bytesPerSecond / (4 * jsonNoteBytes));
+    }
+    printf("  Frame sizes: full state %u bytes, CPU delta %u (JSON status %u), 4-note batch %u (JSON %u)\n",
+           (unsigned)fullBytes, (unsigned)deltaBytes, (unsigned)jsonStatusBytes,
+           (unsigned)chordBytes, (unsigned)(4 * jsonNoteBytes));
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Link Protocol Test\n");
+    printf("=================================\n");
+
+    testCrc();
+    testCobs();
+    testRoundTrip();
+    testErrors();
+
+    if (failures == 0) {
+        printf("All link tests passed\n");
+    } else {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+
+    benchmark();
+    return 0;
+}
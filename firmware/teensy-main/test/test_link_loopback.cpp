@@ -0,0 +1,346 @@
+/**
+ * Host Loopback Benchmark for the ESP Link
+ * Runs a Teensy end and an ESP end of the link against each other through
+ * a pseudo-terminal pair, at a simulated 115200 baud, with the ESP
+ * regularly too busy to read (serving a web page). Compares one shared
+ * queue, priority lanes, and lanes with credit flow control on control
+ * and note latency, lost frames and UART overruns.
+ *
+ * Time is simulated in 1ms ticks so results don't depend on the host;
+ * every byte still goes through the kernel's tty layer. Linux/macOS only.
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_link_loopback.cpp -o test_link_loopback
+ *   ./test_link_loopback
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <chrono>
+#include "link_tx_queue.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+#define BYTES_PER_MS (115200 / 10 / 1000.0)
+#define RUN_MS 10000
+#define TEENSY_RX_BYTES 320      // Serial1 built-in + ESP_RX_BUFFER_BYTES
+#define ESP_RX_BYTES 512         // TEENSY_RX_BUFFER on the ESP
+#define ESP_BUSY_EVERY_MS 200    // The ESP stops reading this often...
+#define ESP_BUSY_FOR_MS 60       // ...for this long
+#define TELEMETRY_EVERY_MS 2     // Offered load is above the line rate
+#define CONTROL_EVERY_MS 100
+#define NOTES_EVERY_MS 50
+#define COMMAND_EVERY_MS 100     // Web UI commands, ESP -> Teensy
+
+enum Scenario {
+    ONE_QUEUE,      // Everything in one never-drop FIFO, no flow control
+    LANES,          // Priority lanes, no flow control
+    LANES_CREDIT,   // Priority lanes and credit
+    NUM_SCENARIOS
+};
+
+static const char* const scenarioNames[NUM_SCENARIOS] = {"one queue", "lanes", "lanes+credit"};
+
+struct Latency {
+    uint32_t count;
+    uint64_t sum;
+    uint32_t max;
+
+    Latency() : count(0), sum(0), max(0) {}
+    void add(uint32_t ms) {
+        count++;
+        sum += ms;
+        if (ms > max) max = ms;
+    }
+    double avg() const { return count ? (double)sum / count : 0.0; }
+};
+
+struct Endpoint {
+    int fd;
+    LinkTxQueue tx;
+    LinkFlow flow;
+    LinkDecoder decoder;
+    bool grants;            // Sends credit (flow control on)
+    bool oneQueue;
+    double lineBudget;
+    uint32_t written;
+    uint32_t readTotal;
+
+    // Emulated UART receive buffer: bytes beyond it are lost
+    uint8_t fifo[ESP_RX_BYTES];
+    size_t fifoCap;
+    size_t fifoHead;
+    size_t fifoUsed;
+    uint32_t overrunBytes;
+
+    Endpoint(int fd_, uint16_t rxBytes, Scenario scenario) : fd(fd_), flow(rxBytes) {
+        grants = scenario == LANES_CREDIT;
+        oneQueue = scenario == ONE_QUEUE;
+        lineBudget = 0;
+        written = 0;
+        readTotal = 0;
+        fifoCap = rxBytes;
+        fifoHead = 0;
+        fifoUsed = 0;
+        overrunBytes = 0;
+    }
+
+    bool queue(uint8_t type, const uint8_t* payload, size_t len, LinkLane lane) {
+        uint8_t frame[LINK_MAX_FRAME];
+        if (oneQueue && lane != LINK_LANE_LINK) lane = LINK_LANE_COMMAND;
+        return tx.push(frame, linkEncode(type, payload, len, frame), lane);
+    }
+
+    template <typename T>
+    bool queue(const T& message, LinkLane lane) {
+        return queue(T::TYPE, (const uint8_t*)&message, sizeof(T), lane);
+    }
+
+    // Housekeeping and one tick's worth of line time
+    void transmit(uint32_t nowMs) {
+        if (grants && flow.creditDue(nowMs)) queue(flow.grant(nowMs), LINK_LANE_LINK);
+        if (flow.pingDue(nowMs)) queue(flow.ping(nowMs, nowMs * 1000), LINK_LANE_LINK);
+
+        lineBudget += BYTES_PER_MS;
+        uint8_t buffer[64];
+        size_t n = tx.pull(buffer, (size_t)lineBudget, &flow, nowMs);
+        lineBudget -= n;
+        if (lineBudget > BYTES_PER_MS) lineBudget = BYTES_PER_MS;  // An idle line doesn't bank time
+        if (n && write(fd, buffer, n) != (ssize_t)n) {
+            perror("write");
+            exit(1);
+        }
+        written += n;
+    }
+
+    // Collect everything the peer wrote this tick into the UART buffer
+    void receive(uint32_t peerWritten) {
+        while (readTotal != peerWritten) {
+            struct pollfd p = {fd, POLLIN, 0};
+            if (poll(&p, 1, 1000) <= 0) {
+                printf("pty stalled\n");
+                exit(1);
+            }
+            uint8_t buffer[256];
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            for (ssize_t i = 0; i < n; i++) {
+                if (fifoUsed == fifoCap) {
+                    overrunBytes++;
+                    continue;
+                }
+                fifo[(fifoHead + fifoUsed) % fifoCap] = buffer[i];
+                fifoUsed++;
+            }
+            if (n > 0) readTotal += n;
+        }
+    }
+
+    // Read out of the UART buffer; returns true with a frame in decoder
+    bool nextFrame() {
+        while (fifoUsed) {
+            uint8_t byte = fifo[fifoHead];
+            fifoHead = (fifoHead + 1) % fifoCap;
+            fifoUsed--;
+            flow.received(1);
+            if (decoder.push(byte)) return true;
+        }
+        return false;
+    }
+
+    // Link housekeeping frames; true if the frame was one
+    bool housekeeping(uint32_t nowMs) {
+        LinkCredit credit;
+        LinkPing ping;
+        LinkPong pong;
+        if (decoder.get(credit)) {
+            flow.onCredit(credit);
+        } else if (decoder.get(ping)) {
+            queue(LinkFlow::pong(ping), LINK_LANE_LINK);
+        } else if (decoder.get(pong)) {
+            flow.onPong(pong, nowMs * 1000);
+        } else {
+            return false;
+        }
+        return true;
+    }
+};
+
+struct Result {
+    Latency control;        // Teensy -> ESP, command lane
+    Latency notes;          // Teensy -> ESP, notes lane
+    Latency commands;       // ESP -> Teensy
+    uint32_t controlSent;
+    uint32_t notesSent;
+    uint32_t commandsSent;
+    uint32_t telemetrySent;
+    uint32_t telemetryReceived;
+    uint32_t overrunBytes;
+    uint32_t badFrames;
+    uint32_t refused;
+    uint32_t rttAvgMs;
+    uint32_t rttMaxMs;
+    double wallSeconds;
+    uint32_t ptyBytes;
+};
+
+static void stamp(uint8_t* p, uint32_t ms) {
+    p[0] = ms & 0xFF;
+    p[1] = (ms >> 8) & 0xFF;
+    p[2] = (ms >> 16) & 0xFF;
+}
+
+static uint32_t unstamp(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16);
+}
+
+static Result run(Scenario scenario) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        perror("posix_openpt");
+        exit(1);
+    }
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    if (slave < 0) {
+        perror("open pty");
+        exit(1);
+    }
+    struct termios raw;
+    tcgetattr(slave, &raw);
+    cfmakeraw(&raw);
+    tcsetattr(slave, TCSANOW, &raw);
+    fcntl(master, F_SETFL, O_NONBLOCK);
+    fcntl(slave, F_SETFL, O_NONBLOCK);
+
+    Endpoint* teensy = new Endpoint(master, TEENSY_RX_BYTES, scenario);
+    Endpoint* esp = new Endpoint(slave, ESP_RX_BYTES, scenario);
+    Result r = Result();
+
+    auto start = std::chrono::steady_clock::now();
+    const uint32_t endMs = RUN_MS + 2000;  // Then let the queues drain
+    for (uint32_t now = 0; now < endMs; now++) {
+        bool offering = now < RUN_MS;
+
+        // Teensy traffic: telemetry flood, state changes, strums
+        if (offering && now % TELEMETRY_EVERY_MS == 0) {
+            uint8_t payload[20] = {2};
+            stamp(payload + 1, now);
+            teensy->queue(LINK_MSG_STATE, payload, sizeof(payload), LINK_LANE_TELEMETRY);
+            r.telemetrySent++;
+        }
+        if (offering && now % CONTROL_EVERY_MS == 7) {
+            uint8_t payload[8] = {0};
+            stamp(payload + 1, now);
+            if (teensy->queue(LINK_MSG_STATE, payload, sizeof(payload), LINK_LANE_COMMAND)) r.controlSent++;
+        }
+        if (offering && now % NOTES_EVERY_MS == 3) {
+            // Three events; the first slot carries the send time
+            uint8_t payload[10] = {3, 0, 0, 0, 60, 100, 0, 64, 100, 0};
+            stamp(payload + 1, now);
+            if (teensy->queue(LINK_MSG_NOTES, payload, sizeof(payload), LINK_LANE_NOTES)) r.notesSent++;
+        }
+
+        // ESP traffic: web UI commands
+        if (offering && now % COMMAND_EVERY_MS == 11) {
+            LinkSetParam param = {LINK_PARAM_SCALE, (float)now};
+            if (esp->queue(param, LINK_LANE_COMMAND)) r.commandsSent++;
+        }
+
+        teensy->transmit(now);
+        esp->transmit(now);
+        teensy->receive(esp->written);
+        esp->receive(teensy->written);
+
+        // Teensy reads everything every loop
+        while (teensy->nextFrame()) {
+            if (teensy->housekeeping(now)) continue;
+            LinkSetParam param;
+            if (teensy->decoder.get(param)) r.commands.add(now - (uint32_t)param.value);
+        }
+
+        // ESP only reads when it isn't busy
+        bool busy = offering && now % ESP_BUSY_EVERY_MS < ESP_BUSY_FOR_MS;
+        while (!busy && esp->nextFrame()) {
+            if (esp->housekeeping(now)) continue;
+            const uint8_t* p = esp->decoder.payload();
+            if (esp->decoder.type() == LINK_MSG_NOTES) {
+                r.notes.add(now - unstamp(p + 1));
+            } else if (esp->decoder.type() == LINK_MSG_STATE && p[0] == 0) {
+                r.control.add(now - unstamp(p + 1));
+            } else if (esp->decoder.type() == LINK_MSG_STATE) {
+                r.telemetryReceived++;
+            }
+        }
+    }
+    r.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    r.overrunBytes = teensy->overrunBytes + esp->overrunBytes;
+    r.badFrames = teensy->decoder.getCrcErrors() + teensy->decoder.getFramingErrors() +
+                  esp->decoder.getCrcErrors() + esp->decoder.getFramingErrors();
+    r.refused = teensy->tx.getFramesRefused() + esp->tx.getFramesRefused();
+    r.rttAvgMs = teensy->flow.getRttAvgUs() / 1000;
+    r.rttMaxMs = teensy->flow.getRttMaxUs() / 1000;
+    r.ptyBytes = teensy->written + esp->written;
+
+    delete teensy;
+    delete esp;
+    close(slave);
+    close(master);
+    return r;
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Link Loopback Benchmark (pty)\n");
+    printf("=================================\n");
+    printf("115200 baud, ESP busy %dms of every %dms, %ds per run\n\n",
+           ESP_BUSY_FOR_MS, ESP_BUSY_EVERY_MS, RUN_MS / 1000);
+
+    Result results[NUM_SCENARIOS];
+    for (int s = 0; s < NUM_SCENARIOS; s++) results[s] = run((Scenario)s);
+
+    printf("%-13s %15s %15s %15s %9s %9s %8s %7s %10s\n", "", "control ms", "notes ms", "commands ms",
+           "telemetry", "overrun B", "bad frm", "refused", "RTT ms");
+    printf("%-13s %15s %15s %15s %9s %9s %8s %7s %10s\n", "", "avg/max (got)", "avg/max (got)",
+           "avg/max (got)", "delivered", "", "", "", "avg/max");
+    for (int s = 0; s < NUM_SCENARIOS; s++) {
+        const Result& r = results[s];
+        printf("%-13s %5.1f/%4u %3u%% %5.1f/%4u %3u%% %5.1f/%4u %3u%% %8u%% %9u %8u %7u %5u/%4u\n",
+               scenarioNames[s],
+               r.control.avg(), r.control.max, r.controlSent ? r.control.count * 100 / r.controlSent : 0,
+               r.notes.avg(), r.notes.max, r.notesSent ? r.notes.count * 100 / r.notesSent : 0,
+               r.commands.avg(), r.commands.max, r.commandsSent ? r.commands.count * 100 / r.commandsSent : 0,
+               r.telemetrySent ? r.telemetryReceived * 100 / r.telemetrySent : 0,
+               r.overrunBytes, r.badFrames, r.refused, r.rttAvgMs, r.rttMaxMs);
+    }
+    const Result& c = results[LANES_CREDIT];
+    printf("\nWall time %.2fs for %u simulated seconds (%.0f KB through the pty)\n",
+           c.wallSeconds, (RUN_MS + 2000) / 1000, c.ptyBytes / 1024.0);
+
+    // With credit nothing is lost: every control frame, note batch and
+    // command arrives, only stale telemetry is dropped, and nothing
+    // overruns the ESP's UART
+    CHECK(c.overrunBytes == 0 && c.badFrames == 0 && c.refused == 0);
+    CHECK(c.control.count == c.controlSent && c.notes.count == c.notesSent);
+    CHECK(c.commands.count == c.commandsSent);
+    CHECK(c.control.max <= ESP_BUSY_FOR_MS + 10 && c.notes.max <= ESP_BUSY_FOR_MS + 10);
+
+    // Without it the busy ESP overruns, and one queue makes control wait
+    // behind telemetry
+    CHECK(results[LANES].overrunBytes > 0);
+    CHECK(results[ONE_QUEUE].control.avg() > c.control.avg());
+
+    if (failures == 0) {
+        printf("All link loopback checks passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
@@ -0,0 +1,235 @@
+/**
+ * Host Test for the Shared State Sync
+ * Runs a sender and receiver over a link that can lose frames: checks that
+ * deltas carry only changed fields, that lost deltas and lost acks are
+ * recovered by retries, that a receiver restart resyncs, and that note
+ * events batch into one frame per window
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_link_state.cpp -o test_link_state
+ *   ./test_link_state
+ */
+
+#include <stdio.h>
+#include "link_state.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+// Sender and receiver joined by a link that drops on request. Returns the
+// payload length sent (0 = nothing due).
+struct Link {
+    LinkStateSender sender;
+    LinkStateReceiver receiver;
+    bool dropData;
+    bool dropAck;
+    bool resyncWanted;
+
+    Link() : dropData(false), dropAck(false), resyncWanted(false) {}
+
+    size_t step(uint32_t nowMs) {
+        uint8_t payload[LINK_MAX_PAYLOAD];
+        size_t len = sender.poll(nowMs, payload);
+        if (len == 0 || dropData) return len;
+
+        // Through the real framing, as the firmware does it
+        uint8_t frame[LINK_MAX_FRAME];
+        LinkDecoder decoder;
+        size_t frameLen = linkEncode(LINK_MSG_STATE, payload, len, frame);
+        bool got = false;
+        for (size_t i = 0; i < frameLen; i++) got = decoder.push(frame[i]);
+        if (!got) return len;
+
+        if (!receiver.apply(decoder.payload(), decoder.payloadLength())) {
+            receiver.reset();
+            resyncWanted = true;
+        } else if (!dropAck) {
+            sender.ack(receiver.getGeneration());
+        }
+        return len;
+    }
+};
+
+// Header plus every field, packed
+static size_t fullLength() {
+    size_t len = LINK_STATE_HEADER;
+    for (uint8_t f = 0; f < LINK_NUM_FIELDS; f++) len += linkStateField(f).size;
+    return len;
+}
+
+static bool sameState(const LinkState& a, const LinkState& b) {
+    return linkStateDiff(a, b) == 0;
+}
+
+static void testFullThenDelta() {
+    Link link;
+    LinkState& state = link.sender.state();
+    state.connected = 1;
+    state.scale = 3;
+    state.octave = -1;
+    state.totalNotes = 123456;
+
+    // Nothing acknowledged yet: every field goes
+    CHECK(link.step(0) == fullLength());
+    CHECK(link.receiver.isValid() && sameState(link.receiver.state(), state));
+    CHECK(link.sender.isSynced());
+
+    // Nothing changed, nothing sent - not even after the retry time
+    CHECK(link.step(10) == 0);
+    CHECK(link.step(1000) == 0);
+
+    // One field changed: header plus that field
+    state.cpuTenths = 512;
+    CHECK(link.step(1010) == LINK_STATE_HEADER + 2);
+    CHECK(link.receiver.getChangedMask() == (1 << LINK_FIELD_CPU));
+    CHECK(sameState(link.receiver.state(), state));
+    CHECK(link.sender.getDeltaCount() == 2 && link.sender.getRetryCount() == 0);
+}
+
+static void testLostDelta() {
+    Link link;
+    LinkState& state = link.sender.state();
+    link.step(0);
+
+    // Scale change lost on the wire, then octave change gets through: the
+    // second delta carries both, since neither was acknowledged
+    link.dropData = true;
+    state.scale = 4;
+    link.step(10);
+    link.dropData = false;
+    state.octave = 2;
+    CHECK(link.step(20) == LINK_STATE_HEADER + 2);
+    CHECK(sameState(link.receiver.state(), state));
+
+    // Lost with nothing following: the retry timer resends it
+    link.dropData = true;
+    state.root = 9;
+    link.step(30);
+    link.dropData = false;
+    CHECK(link.step(30 + LINK_STATE_RETRY_MS - 1) == 0);
+    CHECK(link.step(30 + LINK_STATE_RETRY_MS) == LINK_STATE_HEADER + 1);
+    CHECK(link.receiver.state().root == 9);
+    CHECK(link.sender.isSynced() && link.sender.getRetryCount() == 1);
+}
+
+static void testLostAck() {
+    Link link;
+    LinkState& state = link.sender.state();
+    link.step(0);
+
+    // Receiver has it but the ack is lost; a retry is harmless
+    link.dropAck = true;
+    state.arp = 1;
+    link.step(10);
+    uint16_t generation = link.receiver.getGeneration();
+    link.dropAck = false;
+    CHECK(!link.sender.isSynced());
+    CHECK(link.step(10 + LINK_STATE_RETRY_MS) > 0);
+    CHECK(link.receiver.getGeneration() == generation);
+    CHECK(link.receiver.getChangedMask() == 0);
+    CHECK(link.sender.isSynced());
+
+    // Change reverted before its ack arrived: still sent, so the receiver
+    // doesn't keep the value it never confirmed
+    link.dropAck = true;
+    state.voices = 5;
+    link.step(400);
+    link.dropAck = false;
+    state.voices = 0;
+    link.step(410);
+    CHECK(link.receiver.state().voices == 0);
+    CHECK(link.sender.isSynced());
+}
+
+static void testResync() {
+    Link link;
+    LinkState& state = link.sender.state();
+    state.scale = 2;
+    link.step(0);
+
+    // Receiver restarts: a delta builds on state it no longer has
+    link.receiver = LinkStateReceiver();
+    state.octave = 1;
+    link.step(10);
+    CHECK(link.resyncWanted && !link.receiver.isValid());
+
+    // Resync request: the next delta is the whole state
+    link.sender.resync();
+    CHECK(link.step(20) == fullLength());
+    CHECK(link.receiver.isValid() && sameState(link.receiver.state(), state));
+    CHECK(link.receiver.getChangedMask() == LINK_FIELDS_ALL);
+
+    // Malformed payloads are refused
+    uint8_t bad[LINK_STATE_HEADER + 1] = {5, 0, 0, 0, 0x01, 0x00, 1};  // Partial "full" state
+    LinkStateReceiver receiver;
+    CHECK(!receiver.apply(bad, sizeof(bad)));
+    CHECK(!receiver.apply(bad, 3));
+}
+
+static void testWrap() {
+    // Generations wrap past 65535 without stalling (and never use 0)
+    Link link;
+    LinkState& state = link.sender.state();
+    for (uint32_t i = 0; i < 70000; i++) {
+        state.totalNotes = i;
+        link.step(i);
+        if (link.sender.getGeneration() == 0) break;
+    }
+    CHECK(link.sender.getGeneration() != 0);
+    CHECK(link.receiver.state().totalNotes == 69999);
+    CHECK(link.sender.isSynced());
+    CHECK(linkGenerationAfter(1, 65535) && !linkGenerationAfter(65535, 1));
+}
+
+static void testNoteBatching() {
+    LinkNoteBatcher batcher;
+    uint8_t payload[LINK_MAX_PAYLOAD];
+    LinkNoteEvent events[LINK_NOTES_PER_BATCH];
+
+    // A 3-note strum inside one window is one frame
+    batcher.add(60, 100, 0, 1000);
+    batcher.add(64, 100, 0, 1003);
+    batcher.add(67, 100, 1, 1006);
+    CHECK(batcher.poll(1000 + LINK_NOTE_BATCH_MS - 1, payload) == 0);
+    size_t len = batcher.poll(1000 + LINK_NOTE_BATCH_MS, payload);
+    CHECK(len == 1 + 3 * sizeof(LinkNoteEvent));
+    CHECK(linkNotesDecode(payload, len, events) == 3);
+    CHECK(events[0].note == 60 && events[2].note == 67 && events[2].player == 1);
+    CHECK(batcher.poll(2000, payload) == 0);
+
+    // A full batch goes without waiting; the next add needs a flush first
+    for (uint8_t n = 0; n < LINK_NOTES_PER_BATCH; n++) CHECK(batcher.add(n, 0, 0, 3000));
+    CHECK(batcher.full() && !batcher.add(99, 0, 0, 3000));
+    len = batcher.poll(3000, payload);
+    CHECK(len == 1 + LINK_NOTES_PER_BATCH * sizeof(LinkNoteEvent) && len <= LINK_MAX_PAYLOAD);
+    CHECK(linkNotesDecode(payload, len, events) == LINK_NOTES_PER_BATCH);
+    CHECK(batcher.getBatchCount() == 2 && batcher.getEventCount() == 3 + LINK_NOTES_PER_BATCH);
+
+    // Counts that don't match the length are malformed
+    payload[0] = 2;
+    CHECK(linkNotesDecode(payload, len, events) == 0);
+    CHECK(linkNotesDecode(payload, 0, events) == 0);
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Link State Sync Test\n");
+    printf("=================================\n");
+
+    testFullThenDelta();
+    testLostDelta();
+    testLostAck();
+    testResync();
+    testWrap();
+    testNoteBatching();
+
+    if (failures == 0) {
+        printf("All link state tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
@@ -0,0 +1,277 @@
+/**
+ * Host Test for the ESP Link Transmit Queue
+ * Checks lane priority, whole-frame ordering, drop-oldest telemetry, that
+ * queued commands always get through a slow UART, and credit flow control
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_link_tx.cpp -o test_link_tx
+ *   ./test_link_tx
+ */
+
+#include <stdio.h>
+#include "link_tx_queue.h"
+#include "link_state.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+// Telemetry stand-in: a one-field state delta (link_state.h layout)
+struct StateDelta {
+    enum { TYPE = LINK_MSG_STATE };
+    uint16_t generation;
+    uint16_t base;
+    uint16_t mask;
+    uint8_t scale;
+} __attribute__((packed));
+
+// Drain the queue through a UART that takes chunk bytes per call, decoding
+// what arrives; counts each message type received
+struct Receiver {
+    LinkDecoder decoder;
+    int status;
+    int commands;
+    uint8_t lastScale;
+
+    Receiver() : status(0), commands(0), lastScale(0) {}
+
+    void drain(LinkTxQueue& queue, size_t chunk, int calls = 1000000) {
+        uint8_t buffer[64];
+        while (calls-- > 0) {
+            size_t n = queue.pull(buffer, chunk);
+            if (n == 0) break;
+            for (size_t i = 0; i < n; i++) {
+                if (!decoder.push(buffer[i])) continue;
+                StateDelta s;
+                if (decoder.get(s)) {
+                    status++;
+                    lastScale = s.scale;
+                } else {
+                    commands++;
+                }
+            }
+        }
+    }
+};
+
+static StateDelta makeStatus(uint8_t scale) {
+    StateDelta s = {(uint16_t)(scale + 1), 1, 1 << LINK_FIELD_SCALE, scale};
+    return s;
+}
+
+static void testCommandsFirst() {
+    LinkTxQueue queue;
+    Receiver rx;
+
+    // Telemetry queued first, then a command: the command goes out first,
+    // but only after the telemetry frame already in flight completes
+    CHECK(queue.send(makeStatus(1), LINK_LANE_TELEMETRY));
+    CHECK(queue.send(makeStatus(2), LINK_LANE_TELEMETRY));
+    uint8_t first[4];
+    CHECK(queue.pull(first, 4) == 4);  // Status 1 now in flight
+    LinkCommand command = {LINK_CMD_RESYNC};
+    CHECK(queue.send(command, LINK_LANE_COMMAND));
+
+    for (int i = 0; i < 4; i++) rx.decoder.push(first[i]);
+    rx.drain(queue, 3);
+    CHECK(rx.status == 2 && rx.commands == 1);
+    CHECK(rx.decoder.getCrcErrors() == 0 && rx.decoder.getFramingErrors() == 0);
+    CHECK(queue.idle() && queue.depth() == 0);
+}
+
+static void testDropOldest() {
+    LinkTxQueue queue;
+    uint8_t frame[LINK_MAX_FRAME];
+    size_t frameLen = linkEncode(makeStatus(0), frame);
+    size_t fits = LINK_TX_TELEMETRY_BYTES / (frameLen + 1);
+
+    // Flood telemetry with nothing draining: only the newest survive
+    for (int i = 0; i < 100; i++) {
+        CHECK(queue.send(makeStatus((uint8_t)i), LINK_LANE_TELEMETRY));
+    }
+    CHECK(queue.getFramesDropped() == 100 - fits);
+    CHECK(queue.getBytesDropped() == (100 - fits) * frameLen);
+    CHECK(queue.getBytesQueued() == 100 * frameLen);
+    CHECK(queue.getMaxDepth() <= LINK_TX_TELEMETRY_BYTES);
+
+    Receiver rx;
+    rx.drain(queue, 64);
+    CHECK(rx.status == (int)fits);
+    CHECK(rx.lastScale == 99);
+}
+
+static void testCommandsNeverDropped() {
+    LinkTxQueue queue;
+    LinkSetParam param = {LINK_PARAM_SCALE, 0};
+    uint8_t frame[LINK_MAX_FRAME];
+    size_t frameLen = linkEncode(param, frame);
+    size_t fits = LINK_TX_COMMAND_BYTES / (frameLen + 1);
+
+    // A full command ring refuses new commands instead of losing old ones
+    int accepted = 0;
+    for (int i = 0; i < 100; i++) {
+        if (queue.send(param, LINK_LANE_COMMAND)) accepted++;
+    }
+    CHECK(accepted == (int)fits);
+    CHECK(queue.getFramesRefused() == 100 - fits);
+    CHECK(queue.getFramesDropped() == 0);
+
+    // Telemetry flooding alongside a slow UART can't crowd them out
+    Receiver rx;
+    for (int i = 0; i < 200; i++) {
+        queue.send(makeStatus(7), LINK_LANE_TELEMETRY);
+        rx.drain(queue, 2, 1);  // Two bytes per loop pass
+    }
+    rx.drain(queue, 64);
+    CHECK(rx.commands == (int)fits);
+    CHECK(rx.status > 0);
+    CHECK(rx.decoder.getCrcErrors() == 0 && rx.decoder.getFramingErrors() == 0);
+}
+
+static void testOversize() {
+    LinkTxQueue queue;
+    uint8_t big[LINK_MAX_FRAME + 1] = {0};
+    CHECK(!queue.push(big, sizeof(big), LINK_LANE_TELEMETRY));
+    CHECK(!queue.push(big, 0, LINK_LANE_COMMAND));
+    CHECK(queue.idle());
+}
+
+// Decode everything the queue hands out and return the message types in order
+static size_t drainTypes(LinkTxQueue& queue, uint8_t* types, size_t max, LinkFlow* flow = NULL, uint32_t nowMs = 0) {
+    LinkDecoder decoder;
+    uint8_t buffer[16];
+    size_t count = 0;
+    size_t n;
+    while ((n = queue.pull(buffer, sizeof(buffer), flow, nowMs)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (decoder.push(buffer[i]) && count < max) types[count++] = decoder.type();
+        }
+    }
+    return count;
+}
+
+static void testLaneOrder() {
+    LinkTxQueue queue;
+    uint8_t notes[4] = {1, 60, 100, 0};
+    uint8_t frame[LINK_MAX_FRAME];
+
+    // Queued lowest priority first, sent highest first
+    CHECK(queue.send(makeStatus(1), LINK_LANE_TELEMETRY));
+    CHECK(queue.push(frame, linkEncode(LINK_MSG_NOTES, notes, sizeof(notes), frame), LINK_LANE_NOTES));
+    LinkCommand command = {LINK_CMD_TOGGLE_ARP};
+    CHECK(queue.send(command, LINK_LANE_COMMAND));
+    LinkFlow flow(256);
+    CHECK(queue.send(flow.grant(0), LINK_LANE_LINK));
+
+    uint8_t types[8];
+    CHECK(drainTypes(queue, types, 8) == 4);
+    CHECK(types[0] == LINK_MSG_CREDIT && types[1] == LINK_MSG_COMMAND);
+    CHECK(types[2] == LINK_MSG_NOTES && types[3] == LINK_MSG_STATE);
+
+    // Note batches are refused, never dropped, when their ring is full
+    size_t noteLen = linkEncode(LINK_MSG_NOTES, notes, sizeof(notes), frame);
+    size_t fits = LINK_TX_NOTE_BYTES / (noteLen + 1);
+    for (size_t i = 0; i < fits; i++) CHECK(queue.push(frame, noteLen, LINK_LANE_NOTES));
+    CHECK(!queue.push(frame, noteLen, LINK_LANE_NOTES));
+    CHECK(queue.getFramesRefused() == 1 && queue.getFramesDropped() == 0);
+}
+
+static void testCredit() {
+    LinkTxQueue queue;
+    LinkFlow sender(256);
+    LinkFlow receiver(64);   // Small UART on the far side
+
+    // No grant heard yet: unlimited
+    CHECK(sender.credit() == LINK_CREDIT_UNLIMITED);
+
+    // Peer grants its window; a frame only starts once it fits
+    LinkCredit grant = receiver.grant(0);
+    CHECK(grant.window == 64 - LINK_RX_HEADROOM);
+    sender.onCredit(grant);
+    CHECK(sender.credit() == grant.window);
+
+    uint8_t frame[LINK_MAX_FRAME];
+    size_t frameLen = linkEncode(makeStatus(0), frame);
+    for (int i = 0; i < 5; i++) CHECK(queue.send(makeStatus((uint8_t)i), LINK_LANE_TELEMETRY));
+    uint8_t types[8];
+    size_t sent = drainTypes(queue, types, 8, &sender, 10);
+    CHECK(sent == grant.window / frameLen);
+    CHECK(queue.waitingForCredit());
+    CHECK(sender.getCreditStalls() == 1);
+
+    // Housekeeping frames still go while stalled
+    CHECK(queue.send(LinkFlow::pong(sender.ping(10, 1000)), LINK_LANE_LINK));
+    CHECK(drainTypes(queue, types, 8, &sender, 20) == 1 && types[0] == LINK_MSG_PONG);
+
+    // The receiver reads what arrived and grants more: the rest flows
+    receiver.received(sent * frameLen);
+    CHECK(receiver.creditDue(30));
+    sender.onCredit(receiver.grant(30));
+    size_t more = drainTypes(queue, types, 8, &sender, 30);
+    CHECK(more >= 1 && sent + more <= 5);
+
+    // Lost grants are repeated on a timer
+    CHECK(!receiver.creditDue(31));
+    CHECK(receiver.creditDue(30 + LINK_CREDIT_INTERVAL_MS));
+
+    // A peer that falls silent while we wait stops being enforced
+    while (queue.send(makeStatus(9), LINK_LANE_TELEMETRY) && queue.depth(LINK_LANE_TELEMETRY) < 100) {}
+    drainTypes(queue, types, 8, &sender, 100);
+    CHECK(queue.waitingForCredit());
+    drainTypes(queue, types, 8, &sender, 100 + LINK_CREDIT_TIMEOUT_MS);
+    CHECK(sender.getCreditTimeouts() == 1 && !sender.isGranted());
+    drainTypes(queue, types, 8, &sender, 101 + LINK_CREDIT_TIMEOUT_MS);
+    CHECK(queue.idle());
+
+    // A restarted peer (count back at zero) is lined up, not stalled on
+    LinkFlow restarted(64);
+    sender.onCredit(restarted.grant(0));
+    CHECK(sender.credit() == restarted.getWindow());
+    restarted.received(10);
+    sender.onCredit(restarted.grant(1));
+    CHECK(sender.credit() == restarted.getWindow());
+}
+
+static void testPing() {
+    LinkFlow flow(256);
+    CHECK(flow.pingDue(LINK_PING_INTERVAL_MS));
+    LinkPing ping = flow.ping(1000, 5000);
+    CHECK(!flow.pingDue(1000 + LINK_PING_INTERVAL_MS - 1));
+
+    // Answered: round trip measured on our own clock
+    flow.onPong(LinkFlow::pong(ping), 5700);
+    CHECK(flow.getRttUs() == 700 && flow.getRttMinUs() == 700 && flow.getRttMaxUs() == 700);
+
+    // Unanswered probe counts as lost once the next goes out; a stale
+    // answer is ignored
+    LinkPing lost = flow.ping(2000, 10000);
+    LinkPing next = flow.ping(3000, 20000);
+    flow.onPong(LinkFlow::pong(lost), 20100);
+    CHECK(flow.getPingsLost() == 1 && flow.getRttUs() == 700);
+    flow.onPong(LinkFlow::pong(next), 21500);
+    CHECK(flow.getRttUs() == 1500 && flow.getRttMaxUs() == 1500);
+    CHECK(flow.getRttAvgUs() > 700 && flow.getRttAvgUs() < 1500);
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Link TX Queue Test\n");
+    printf("=================================\n");
+
+    testCommandsFirst();
+    testDropOldest();
+    testCommandsNeverDropped();
+    testOversize();
+    testLaneOrder();
+    testCredit();
+    testPing();
+
+    if (failures == 0) {
+        printf("All link TX queue tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
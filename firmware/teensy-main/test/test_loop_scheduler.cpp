@@ -0,0 +1,313 @@
+/**
+ * Host Test and Benchmark for the Loop Scheduler
+ * Checks task ordering (critical tasks between every other task),
+ * periods, pass budgets and deferral, the starvation guard, overrun
+ * counting, the histogram buckets and the JSON report; then runs the OSC
+ * sketch's loop() work - Teensy serial, OSC input, HTTP with the odd
+ * slow client, mDNS - under the old fixed loop with its delay(1) and
+ * under the scheduler, and compares how long Teensy data and OSC packets
+ * wait to be handled
+ *
+ * Time is a simulated microsecond clock that the tasks advance by their
+ * run times.
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_loop_scheduler.cpp -o test_loop_scheduler
+ *   ./test_loop_scheduler
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "loop_scheduler.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static uint32_t fakeNow = 0;
+static uint32_t fakeClock() { return fakeNow; }
+
+// ---- Ordering, periods, budgets
+
+static std::string trace;
+static uint32_t costCritical = 10, costHigh = 10, costNormal = 10, costLow = 10;
+
+static void runCritical() { trace += 'C'; fakeNow += costCritical; }
+static void runHigh() { trace += 'H'; fakeNow += costHigh; }
+static void runNormal() { trace += 'N'; fakeNow += costNormal; }
+static void runLow() { trace += 'L'; fakeNow += costLow; }
+
+static void testOrder() {
+    fakeNow = 0;
+    LoopScheduler scheduler(fakeClock);
+    CHECK(scheduler.add("low", runLow, LOOP_PRIORITY_LOW, 100));
+    CHECK(scheduler.add("normal", runNormal, LOOP_PRIORITY_NORMAL, 100));
+    CHECK(scheduler.add("critical", runCritical, LOOP_PRIORITY_CRITICAL, 100));
+    CHECK(scheduler.add("high", runHigh, LOOP_PRIORITY_HIGH, 100));
+    CHECK(strcmp(scheduler.get(0).name, "critical") == 0 && strcmp(scheduler.get(3).name, "low") == 0);
+
+    // The critical task first and after every other task
+    trace.clear();
+    scheduler.runPass();
+    CHECK(trace == "CHCNCLC");
+
+    for (int i = 0; i < 4; i++) scheduler.add("more", runLow, LOOP_PRIORITY_LOW, 100);
+    CHECK(!scheduler.add("full", runLow, LOOP_PRIORITY_LOW, 100));
+}
+
+static void testPeriod() {
+    fakeNow = 0;
+    costCritical = 10;
+    LoopScheduler scheduler(fakeClock);
+    scheduler.add("critical", runCritical, LOOP_PRIORITY_CRITICAL, 100);
+    scheduler.add("low", runLow, LOOP_PRIORITY_LOW, 100, 10000);
+    while (fakeNow < 1000000) {
+        scheduler.runPass();
+        fakeNow += 50;
+    }
+    // Every 10ms for a second, never late by more than a pass
+    CHECK(scheduler.get(1).runs >= 99 && scheduler.get(1).runs <= 101);
+    CHECK(scheduler.get(1).latencyMaxUs < 100);
+}
+
+static void testBudget() {
+    fakeNow = 0;
+    costCritical = 10;
+    costHigh = 1800;
+    costNormal = 10;
+    LoopScheduler scheduler(fakeClock);
+    scheduler.add("critical", runCritical, LOOP_PRIORITY_CRITICAL, 100);
+    scheduler.add("high", runHigh, LOOP_PRIORITY_HIGH, 2000);
+    scheduler.add("normal", runNormal, LOOP_PRIORITY_NORMAL, 500);
+
+    // High uses up the pass: normal waits for the next one
+    trace.clear();
+    scheduler.runPass();
+    CHECK(trace == "CHC");
+    CHECK(scheduler.get(2).deferrals == 1 && scheduler.getOverBudgetPasses() == 1);
+
+    // ...and the next, until it has waited LOOP_MAX_DEFER_US: then it runs
+    while (scheduler.get(2).runs == 0 && fakeNow < 1000000) scheduler.runPass();
+    CHECK(scheduler.get(2).runs == 1);
+    CHECK(scheduler.get(2).latencyMaxUs >= LOOP_MAX_DEFER_US);
+    CHECK(scheduler.get(2).latencyMaxUs < LOOP_MAX_DEFER_US + 2 * 1820);
+
+    // High always runs: it's the first task of its pass
+    CHECK(scheduler.get(1).deferrals == 0);
+    CHECK(scheduler.get(1).overruns == 0);
+
+    // Over budget is counted
+    costHigh = 2500;
+    scheduler.runPass();
+    CHECK(scheduler.get(1).overruns == 1 && scheduler.get(1).runMaxUs == 2500);
+    costHigh = 10;
+}
+
+static void testHistogram() {
+    CHECK(LoopScheduler::bucketFor(0) == 0);
+    CHECK(LoopScheduler::bucketFor(63) == 0);
+    CHECK(LoopScheduler::bucketFor(64) == 1);
+    CHECK(LoopScheduler::bucketFor(127) == 1);
+    CHECK(LoopScheduler::bucketFor(65535) == LOOP_HIST_BUCKETS - 2);
+    CHECK(LoopScheduler::bucketFor(65536) == LOOP_HIST_BUCKETS - 1);
+    CHECK(LoopScheduler::bucketFor(UINT32_MAX) == LOOP_HIST_BUCKETS - 1);
+
+    LoopTask task;
+    memset(&task, 0, sizeof(task));
+    task.runs = 100;
+    task.histogram[0] = 90;
+    task.histogram[3] = 9;
+    task.histogram[LOOP_HIST_BUCKETS - 1] = 1;
+    CHECK(LoopScheduler::percentileUs(task, 50) == 64);
+    CHECK(LoopScheduler::percentileUs(task, 90) == 64);
+    CHECK(LoopScheduler::percentileUs(task, 99) == 512);
+    CHECK(LoopScheduler::percentileUs(task, 100) == UINT32_MAX);
+}
+
+static void testReport() {
+    fakeNow = 0;
+    LoopScheduler scheduler(fakeClock);
+    static const char* names[LOOP_MAX_TASKS] = {"teensy", "osc", "http", "push", "mdns", "sixth", "seventh", "eighth"};
+    for (int i = 0; i < LOOP_MAX_TASKS; i++) scheduler.add(names[i], runLow, LOOP_PRIORITY_LOW, 100000);
+    char out[LOOP_REPORT_MAX_TEXT];
+    size_t len = scheduler.report(out, sizeof(out));
+    CHECK(len > 0 && len == strlen(out));
+    CHECK(strncmp(out, "{\"passes\":0,", 12) == 0 && out[len - 1] == '}');
+    CHECK(strstr(out, "\"name\":\"teensy\"") != NULL);
+
+    // Worst case: every counter at ten digits still fits
+    LoopScheduler big(fakeClock);
+    for (int i = 0; i < LOOP_MAX_TASKS; i++) big.add(names[i], runLow, LOOP_PRIORITY_LOW, 4000000000u);
+    for (uint8_t i = 0; i < LOOP_MAX_TASKS; i++) {
+        LoopTask& task = const_cast<LoopTask&>(big.get(i));
+        task.runs = task.overruns = task.deferrals = task.latencyMaxUs = task.runMaxUs = 4000000000u;
+        for (uint8_t b = 0; b < LOOP_HIST_BUCKETS; b++) task.histogram[b] = 4000000000u;
+    }
+    CHECK(big.report(out, sizeof(out)) > 0);
+    CHECK(scheduler.report(out, 64) == 0);
+}
+
+// ---- The OSC sketch's loop, fixed order against the scheduler
+
+#define RUN_US 20000000u              // 20s
+#define TEENSY_FRAME_EVERY_US 1000    // State deltas and notes while playing
+#define OSC_PACKET_EVERY_US 4000      // A fader on a control surface
+#define HTTP_REQUEST_EVERY_US 100000  // The page polling /api/status
+#define HTTP_SLOW_EVERY 50            // One request in this many from a slow client
+#define HTTP_SLOW_US 12000
+
+struct Input {
+    uint32_t nextArrival;
+    uint32_t every;
+    uint32_t waitingSince;      // Oldest unhandled arrival; 0 = none
+    LoopTask waits;             // Arrival to handling, as a histogram
+};
+
+static Input teensyInput, oscInput;
+static uint32_t nextHttpRequest;
+static uint32_t httpRequests;
+static bool httpPending;
+
+static void arrive(Input& input) {
+    while (input.nextArrival <= fakeNow) {
+        if (!input.waitingSince) input.waitingSince = input.nextArrival;
+        input.nextArrival += input.every;
+    }
+}
+
+static void handle(Input& input) {
+    arrive(input);
+    if (!input.waitingSince) return;
+    uint32_t wait = fakeNow - input.waitingSince;
+    input.waits.runs++;
+    input.waits.histogram[LoopScheduler::bucketFor(wait)]++;
+    if (wait > input.waits.latencyMaxUs) input.waits.latencyMaxUs = wait;
+    input.waitingSince = 0;
+}
+
+static void processTeensyData() {
+    fakeNow += 15;
+    bool pending = teensyInput.nextArrival <= fakeNow || teensyInput.waitingSince;
+    handle(teensyInput);
+    if (pending) fakeNow += 80;     // Decode, mirror, OSC bundle out
+}
+
+static void processOSCInput() {
+    fakeNow += 10;
+    bool pending = oscInput.nextArrival <= fakeNow || oscInput.waitingSince;
+    handle(oscInput);
+    if (pending) fakeNow += 120;    // Parse, dispatch, frame to the Teensy
+}
+
+static void handleClient() {
+    fakeNow += 20;
+    if (nextHttpRequest <= fakeNow) {
+        nextHttpRequest += HTTP_REQUEST_EVERY_US;
+        httpRequests++;
+        httpPending = true;
+    }
+    if (!httpPending) return;
+    // A slow client's request trickles in while handleClient() waits on it
+    fakeNow += httpRequests % HTTP_SLOW_EVERY == 0 ? HTTP_SLOW_US : 900;
+    httpPending = false;
+}
+
+static void mdnsUpdate() { fakeNow += 30; }
+
+static void resetInputs() {
+    fakeNow = 1;
+    memset(&teensyInput, 0, sizeof(teensyInput));
+    memset(&oscInput, 0, sizeof(oscInput));
+    teensyInput.nextArrival = 500;
+    teensyInput.every = TEENSY_FRAME_EVERY_US;
+    oscInput.nextArrival = 1700;
+    oscInput.every = OSC_PACKET_EVERY_US;
+    nextHttpRequest = 3000;
+    httpRequests = 0;
+    httpPending = false;
+}
+
+static void printWaits(const char* name, const LoopTask& waits) {
+    long p99 = (long)LoopScheduler::percentileUs(waits, 99);
+    printf("    %-6s: p50 <%5luus, p99 <%5ldus, max %5luus\n", name,
+           (unsigned long)LoopScheduler::percentileUs(waits, 50), p99, (unsigned long)waits.latencyMaxUs);
+}
+
+static void benchmarkLoop() {
+    // Before: handleClient, mDNS, Teensy, OSC, delay(1)
+    resetInputs();
+    while (fakeNow < RUN_US) {
+        handleClient();
+        mdnsUpdate();
+        processTeensyData();
+        processOSCInput();
+        fakeNow += 1000;
+    }
+    LoopTask fixedTeensy = teensyInput.waits, fixedOsc = oscInput.waits;
+
+    // After: the scheduler, then yield()
+    resetInputs();
+    LoopScheduler scheduler(fakeClock);
+    scheduler.add("teensy", processTeensyData, LOOP_PRIORITY_CRITICAL, 500);
+    scheduler.add("osc", processOSCInput, LOOP_PRIORITY_HIGH, 500);
+    scheduler.add("http", handleClient, LOOP_PRIORITY_NORMAL, 1000);
+    scheduler.add("mdns", mdnsUpdate, LOOP_PRIORITY_LOW, 500, 10000);
+    while (fakeNow < RUN_US) {
+        scheduler.runPass();
+        fakeNow += 10;
+    }
+    LoopTask scheduledTeensy = teensyInput.waits, scheduledOsc = oscInput.waits;
+
+    printf("OSC sketch loop, %us: Teensy frame every %uus, OSC packet every %uus,\n"
+           "HTTP request every %ums, 1 in %u from a slow client (%ums)\n",
+           RUN_US / 1000000, TEENSY_FRAME_EVERY_US, OSC_PACKET_EVERY_US,
+           HTTP_REQUEST_EVERY_US / 1000, HTTP_SLOW_EVERY, HTTP_SLOW_US / 1000);
+    printf("  fixed order + delay(1), wait to be handled:\n");
+    printWaits("teensy", fixedTeensy);
+    printWaits("osc", fixedOsc);
+    printf("  scheduler, wait to be handled:\n");
+    printWaits("teensy", scheduledTeensy);
+    printWaits("osc", scheduledOsc);
+    printf("  scheduler's own view (due to run):\n");
+    for (uint8_t i = 0; i < scheduler.getCount(); i++) {
+        const LoopTask& task = scheduler.get(i);
+        printf("    %-6s: %7lu runs, p99 <%5ldus, max %5luus, run max %5luus, %lu overruns, %lu deferred\n",
+               task.name, (unsigned long)task.runs, (long)LoopScheduler::percentileUs(task, 99),
+               (unsigned long)task.latencyMaxUs, (unsigned long)task.runMaxUs,
+               (unsigned long)task.overruns, (unsigned long)task.deferrals);
+    }
+
+    // The slow client still blocks once in a while (nothing preempts
+    // handleClient()), but the delay and the rest of the pass no longer
+    // sit in front of every frame
+    CHECK(LoopScheduler::percentileUs(scheduledTeensy, 50) < LoopScheduler::percentileUs(fixedTeensy, 50));
+    CHECK(LoopScheduler::percentileUs(scheduledTeensy, 99) < LoopScheduler::percentileUs(fixedTeensy, 99));
+    CHECK(LoopScheduler::percentileUs(scheduledOsc, 99) < LoopScheduler::percentileUs(fixedOsc, 99));
+    CHECK(scheduledTeensy.latencyMaxUs <= fixedTeensy.latencyMaxUs);
+    CHECK(scheduledTeensy.latencyMaxUs < HTTP_SLOW_US + 500);
+    CHECK(scheduler.get(0).overruns == 0);
+    CHECK(scheduler.get(2).overruns > 0);   // The slow clients, as the UI shows them
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Loop Scheduler Test\n");
+    printf("=================================\n");
+
+    testOrder();
+    testPeriod();
+    testBudget();
+    testHistogram();
+    testReport();
+    benchmarkLoop();
+
+    if (failures == 0) {
+        printf("All loop scheduler tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
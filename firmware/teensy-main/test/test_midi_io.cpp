@@ -0,0 +1,253 @@
+/**
+ * Host Test for USB-MIDI Input/Output
+ * Checks the bend/CC conversions, that events in one microframe go out
+ * in one batch, that bends and CCs coalesce while notes don't, that
+ * strum notes wait for their onset and are dropped with their note-off if
+ * released first, queue overflow, and the round-trip probe encoding.
+ * Then plays the same note stream down both routes out of the Teensy -
+ * USB-MIDI batched per microframe, and the ESP link's note batches at
+ * 115200 baud - and reports the latency each adds before the data leaves
+ * the Teensy's side of the cable. The ESP route still has the ESP, OSC and
+ * Wi-Fi to go after that; USB-MIDI is at the host's USB stack.
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_midi_io.cpp -o test_midi_io
+ *   ./test_midi_io
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include "midi_io.h"
+#include "link_protocol.h"
+#include "link_state.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+#define SIM_SECONDS 30
+#define SIM_LOOP_US 110            // loop(): delayMicroseconds(100) plus its work
+#define UART_BAUD 115200
+
+static void testConversions() {
+    printf("\n--- Conversions ---\n");
+    CHECK(midiBendFromAnalog(0) == MIDI_BEND_CENTER);
+    CHECK(midiBendFromAnalog(ANALOG_FULL_SCALE) == MIDI_BEND_MAX);
+    CHECK(midiBendFromAnalog(-ANALOG_FULL_SCALE) == 1);
+    CHECK(midiAnalogFromBend(MIDI_BEND_CENTER) == 0);
+    CHECK(midiAnalogFromBend(MIDI_BEND_MAX) == ANALOG_FULL_SCALE);
+    CHECK(midiAnalogFromBend(0) == -ANALOG_FULL_SCALE);
+
+    CHECK(midiCCFromAnalog(0) == 64);
+    CHECK(midiCCFromAnalog(ANALOG_FULL_SCALE) == 127);
+    CHECK(midiCCFromAnalog(-ANALOG_FULL_SCALE) == 0);
+    CHECK(midiAnalogFromCC(64) == 0);
+    CHECK(midiAnalogFromCC(127) == ANALOG_FULL_SCALE);
+    CHECK(midiAnalogFromCC(0) == -ANALOG_FULL_SCALE);
+
+    // Round trips land within one step of where they started
+    int bendErr = 0;
+    int ccErr = 0;
+    for (int32_t v = -ANALOG_FULL_SCALE; v <= ANALOG_FULL_SCALE; v += 97) {
+        int e = abs(midiAnalogFromBend(midiBendFromAnalog(v)) - v);
+        if (e > bendErr) bendErr = e;
+        e = abs(midiAnalogFromCC(midiCCFromAnalog(v)) - v);
+        if (e > ccErr) ccErr = e;
+    }
+    CHECK(bendErr <= ANALOG_FULL_SCALE / 8191 + 1);
+    CHECK(ccErr <= ANALOG_FULL_SCALE / 63 / 2 + 1);
+    for (int cc = 0; cc < 128; cc++) CHECK(midiCCFromAnalog(midiAnalogFromCC(cc)) == cc);
+    printf("  Worst round trip: bend %d, CC %d (of +-%d)\n", bendErr, ccErr, ANALOG_FULL_SCALE);
+}
+
+static void testBatching() {
+    printf("\n--- Batching ---\n");
+    MidiOutBatcher out;
+    MidiEvent batch[MIDI_OUT_QUEUE];
+
+    // A chord and a bend in one microframe: one batch, in order
+    out.noteOn(1, 60, 100, 1000);
+    out.noteOn(1, 64, 100, 1010);
+    out.pitchBend(1, 9000, 1020);
+    out.noteOn(1, 67, 100, 1030);
+    CHECK(!out.due(1000 + MIDI_BATCH_US - 1));
+    CHECK(out.due(1000 + MIDI_BATCH_US));
+    uint8_t n = out.take(1000 + MIDI_BATCH_US, batch);
+    CHECK(n == 4 && out.pending() == 0);
+    CHECK(batch[0].type == MIDI_NOTE_ON && batch[0].data1 == 60 && batch[0].data2 == 100);
+    CHECK(batch[2].type == MIDI_PITCH_BEND && batch[2].data1 == (9000 & 0x7F) && batch[2].data2 == (9000 >> 7));
+    CHECK(batch[3].data1 == 67);
+    CHECK(out.getBatches() == 1 && out.getMaxBatch() == 4);
+
+    // Bends coalesce per channel, CCs per controller; notes never
+    uint32_t t = 5000;
+    for (int i = 0; i < 10; i++) out.pitchBend(1, 8192 + i * 100, t + i);
+    out.pitchBend(2, 100, t);
+    out.controlChange(1, MIDI_TILT_CC, 10, t);
+    out.controlChange(1, MIDI_TILT_CC, 20, t + 1);
+    out.controlChange(1, 1, 5, t + 2);
+    out.noteOn(1, 60, 90, t + 3);
+    out.noteOn(1, 60, 90, t + 4);
+    n = out.take(t + MIDI_BATCH_US, batch);
+    CHECK(n == 6);
+    CHECK(batch[0].type == MIDI_PITCH_BEND && (batch[0].data1 | batch[0].data2 << 7) == 8192 + 900);
+    CHECK(batch[1].channel == 2);
+    CHECK(batch[2].data1 == MIDI_TILT_CC && batch[2].data2 == 20);
+    CHECK(batch[3].data1 == 1 && batch[3].data2 == 5);
+    CHECK(out.getCoalesced() == 10);
+
+    // A strum: strings at their onsets, a fret's note-off behind them
+    t = 10000;
+    out.noteOnAt(1, 60, 100, t, t);
+    out.noteOnAt(1, 64, 100, t, t + 4000);
+    out.noteOnAt(1, 67, 100, t, t + 8000);
+    out.noteOff(1, 55, t);
+    n = out.take(t + MIDI_BATCH_US, batch);
+    CHECK(n == 2 && batch[0].data1 == 60 && batch[1].type == MIDI_NOTE_OFF && out.pending() == 2);
+    CHECK(!out.due(t + 2000));
+    CHECK(out.due(t + 4000));
+    n = out.take(t + 4000, batch);
+    CHECK(n == 1 && batch[0].data1 == 64);
+
+    // Released before its onset: neither note-on nor note-off goes out
+    out.noteOff(1, 67, t + 5000);
+    CHECK(out.pending() == 0 && out.getCancelled() == 1);
+    CHECK(!out.due(t + 9000));
+
+    // Full: refused, and due at once
+    MidiOutBatcher full;
+    for (int i = 0; i < MIDI_OUT_QUEUE; i++) CHECK(full.noteOn(1, i, 100, 0));
+    CHECK(!full.noteOn(1, 100, 100, 0));
+    CHECK(full.getRefused() == 1);
+    CHECK(full.due(1));
+    CHECK(full.take(1, batch) == MIDI_OUT_QUEUE);
+}
+
+static void testProbe() {
+    printf("\n--- Round-trip probe ---\n");
+    uint8_t probe[MIDI_PROBE_LENGTH];
+    uint32_t times[] = {0, 1, 123456789, 0xFFFFFFFF, 0x80000000};
+    for (uint32_t sent : times) {
+        CHECK(midiProbeEncode(sent, probe) == MIDI_PROBE_LENGTH);
+        for (int i = 1; i < MIDI_PROBE_LENGTH - 1; i++) CHECK(probe[i] < 0x80);  // SysEx data bytes
+        uint32_t decoded = 0;
+        CHECK(midiProbeDecode(probe, sizeof(probe), decoded) && decoded == sent);
+    }
+    uint32_t decoded;
+    CHECK(!midiProbeDecode(probe, sizeof(probe) - 1, decoded));
+    probe[2] = 'X';
+    CHECK(!midiProbeDecode(probe, sizeof(probe), decoded));
+
+    MidiRoundTrip rtt;
+    CHECK(rtt.getMinUs() == 0 && rtt.getAvgUs() == 0);
+    rtt.record(0xFFFFFF00, 0x00000100);  // Across micros() wrapping
+    rtt.record(1000, 1600);
+    CHECK(rtt.getCount() == 2 && rtt.getMinUs() == 512 && rtt.getMaxUs() == 600 && rtt.getAvgUs() == 556);
+}
+
+// ---- Both routes, same notes
+
+static uint32_t rng = 12345;
+static uint32_t nextRandom() {
+    rng = rng * 1103515245 + 12345;
+    return (rng >> 8) & 0xFFFFFF;
+}
+
+static void percentiles(const char* name, std::vector<uint32_t>& us) {
+    std::sort(us.begin(), us.end());
+    printf("  %-36s p50 %6u us  p99 %6u us  max %6u us  (%u events)\n", name,
+           us[us.size() / 2], us[us.size() * 99 / 100], us.back(), (unsigned)us.size());
+}
+
+static void compareRoutes() {
+    printf("\n--- USB-MIDI vs ESP link (%ds of playing) ---\n", SIM_SECONDS);
+
+    // Fret presses and releases every 20-120ms, a third of them chords
+    std::vector<uint32_t> eventUs;
+    for (uint32_t t = 1000; t < SIM_SECONDS * 1000000u; t += 20000 + nextRandom() % 100000) {
+        int notes = nextRandom() % 3 == 0 ? 3 : 1;
+        for (int i = 0; i < notes; i++) eventUs.push_back(t + i * 300);
+    }
+
+    MidiOutBatcher midi;
+    LinkNoteBatcher esp;
+    std::vector<uint32_t> midiLatency;
+    std::vector<uint32_t> espLatency;
+    std::vector<uint32_t> midiWaiting;
+    std::vector<uint32_t> espWaiting;
+    uint32_t uartFreeUs = 0;                 // When the UART finishes what it's sending
+    size_t next = 0;
+    MidiEvent batch[MIDI_OUT_QUEUE];
+
+    for (uint32_t now = 0; now < SIM_SECONDS * 1000000u + 20000; now += SIM_LOOP_US) {
+        while (next < eventUs.size() && eventUs[next] <= now) {
+            uint8_t note = 60 + next % 12;
+            midi.noteOn(1, note, 100, now);
+            midiWaiting.push_back(eventUs[next]);
+            if (esp.full()) {
+                // As sendESPNote() does: flush a full batch first
+                uint8_t payload[LINK_MAX_PAYLOAD];
+                esp.flush(payload);
+            }
+            esp.add(note, 100, 0, now / 1000);
+            espWaiting.push_back(eventUs[next]);
+            next++;
+        }
+
+        // USB: the batch is sent now and leaves at the next microframe
+        if (midi.due(now)) {
+            uint8_t n = midi.take(now, batch);
+            uint32_t leaves = (now / MIDI_BATCH_US + 1) * MIDI_BATCH_US;
+            for (uint8_t i = 0; i < n; i++) {
+                midiLatency.push_back(leaves - midiWaiting.front());
+                midiWaiting.erase(midiWaiting.begin());
+            }
+        }
+
+        // UART: one frame per batch, 10 bits a byte, behind whatever the
+        // UART is still sending
+        uint8_t payload[LINK_MAX_PAYLOAD];
+        size_t len = esp.poll(now / 1000, payload);
+        if (len) {
+            uint8_t frame[LINK_MAX_FRAME];
+            size_t bytes = linkEncode(LINK_MSG_NOTES, payload, len, frame);
+            uint32_t start = std::max(now, uartFreeUs);
+            uartFreeUs = start + (uint32_t)(bytes * 10 * 1000000ull / UART_BAUD);
+            uint8_t count = payload[0];
+            for (uint8_t i = 0; i < count; i++) {
+                espLatency.push_back(uartFreeUs - espWaiting.front());
+                espWaiting.erase(espWaiting.begin());
+            }
+        }
+    }
+
+    CHECK(midiLatency.size() == eventUs.size());
+    CHECK(espLatency.size() == eventUs.size());
+    percentiles("USB-MIDI (batch + microframe)", midiLatency);
+    percentiles("ESP link (note batch + 115200 baud)", espLatency);
+    CHECK(midiLatency.back() < 1000);        // Sub-millisecond, worst case
+    CHECK(espLatency[espLatency.size() / 2] > midiLatency.back());
+    CHECK(midi.getRefused() == 0);
+}
+
+int main() {
+    printf("=================================\n");
+    printf("USB-MIDI Test\n");
+    printf("=================================\n");
+
+    testConversions();
+    testBatching();
+    testProbe();
+    compareRoutes();
+
+    if (failures == 0) {
+        printf("\nAll USB-MIDI tests passed\n");
+        return 0;
+    }
+    printf("\n%d check(s) failed\n", failures);
+    return 1;
+}
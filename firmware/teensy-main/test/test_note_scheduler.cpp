@@ -0,0 +1,168 @@
+/**
+ * Host Test for Sample-Accurate Note Scheduling
+ * Drives AudioNoteScheduler block by block, as the audio interrupt does,
+ * and checks that micros() timestamps map to the block they fell in,
+ * that note-ons fire in the block holding their sample at the right
+ * offset, that late ones fire at once and are counted, and that a
+ * cancelled onset never fires - including one whose voice was stolen
+ * from the voice pool (voice_pool.h) by a new note before its onset.
+ *
+ * Build and run on the host (test/host stands in for the Teensy core and
+ * AudioStream):
+ *   g++ -std=c++11 -O2 -Iinclude -Itest/host test/test_note_scheduler.cpp src/audio_scheduler.cpp src/voice_pool.cpp -o test_note_scheduler
+ *   ./test_note_scheduler
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "audio_scheduler.h"
+#include "voice_pool.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+// The audio interrupt's clock: one block every AUDIO_BLOCK_SAMPLES samples
+static uint32_t nowUs = 0;
+uint32_t micros() { return nowUs; }
+
+static const uint32_t BLOCK_US = (uint32_t)((uint64_t)AUDIO_BLOCK_SAMPLES * 1000000 / AUDIO_SAMPLE_RATE);
+
+// What the scheduler fired, in order
+struct Fired {
+    uint8_t voice;
+    float frequency;
+    uint16_t offset;
+};
+
+static Fired fired[64];
+static int firedCount = 0;
+
+static void onFire(uint8_t voice, float frequency, float amplitude, uint16_t offset) {
+    (void)amplitude;
+    if (firedCount < 64) fired[firedCount++] = {voice, frequency, offset};
+}
+
+// Render one block, then let time run to the next
+static void renderBlock(AudioNoteScheduler& scheduler) {
+    scheduler.update();
+    nowUs += BLOCK_US;
+}
+
+static void reset(AudioNoteScheduler& scheduler) {
+    nowUs = 0;
+    firedCount = 0;
+    scheduler.setFireCallback(onFire);
+}
+
+static void testOffsets() {
+    printf("\n--- Onset offsets ---\n");
+    AudioNoteScheduler scheduler;
+    reset(scheduler);
+    renderBlock(scheduler);
+    renderBlock(scheduler);
+
+    // Two blocks in: one note inside the next block, one a block later
+    uint32_t next = 2 * AUDIO_BLOCK_SAMPLES;
+    CHECK(scheduler.schedule(next + 40, 3, 220.0f, 0.5f));
+    CHECK(scheduler.schedule(next + AUDIO_BLOCK_SAMPLES + 5, 4, 330.0f, 0.5f));
+
+    renderBlock(scheduler);
+    CHECK(firedCount == 1 && fired[0].voice == 3 && fired[0].offset == 40);
+    renderBlock(scheduler);
+    CHECK(firedCount == 2 && fired[1].voice == 4 && fired[1].offset == 5);
+
+    // Already in the past: fires at the start of the next block, counted late
+    CHECK(scheduler.schedule(10, 5, 440.0f, 0.5f));
+    renderBlock(scheduler);
+    CHECK(firedCount == 3 && fired[2].voice == 5 && fired[2].offset == 0);
+    CHECK(scheduler.getLateCount() == 1 && scheduler.getFiredCount() == 3);
+
+    // Queue full
+    for (int i = 0; i < STRUM_MAX_PENDING; i++) CHECK(scheduler.schedule(100000, i, 100.0f, 0.5f));
+    CHECK(!scheduler.schedule(100000, 0, 100.0f, 0.5f));
+}
+
+static void testClock() {
+    printf("\n--- Sample clock ---\n");
+    AudioNoteScheduler scheduler;
+    reset(scheduler);
+    for (int b = 0; b < 10; b++) renderBlock(scheduler);
+    CHECK(scheduler.getBlockCount() == 10);
+
+    // Block 9 started rendering at 9 * BLOCK_US, block 10 is due now
+    CHECK(scheduler.sampleAtMicros(9 * BLOCK_US) == 9 * AUDIO_BLOCK_SAMPLES);
+    uint32_t now = scheduler.sampleAtMicros(nowUs);
+    CHECK(now >= 10 * AUDIO_BLOCK_SAMPLES - 1 && now <= 10 * AUDIO_BLOCK_SAMPLES);
+
+    // A strum anchored the way strumChord() does it sounds in the next
+    // block rendered, STRUM_SCHEDULE_LATENCY after the report - not a
+    // block after that
+    CHECK(scheduler.schedule(now + STRUM_SCHEDULE_LATENCY, 1, 220.0f, 0.5f));
+    renderBlock(scheduler);
+    CHECK(firedCount == 1 && fired[0].offset >= STRUM_SCHEDULE_LATENCY - 1);
+}
+
+static void testCancel() {
+    printf("\n--- Cancel before the onset ---\n");
+    AudioNoteScheduler scheduler;
+    reset(scheduler);
+
+    CHECK(scheduler.schedule(AUDIO_BLOCK_SAMPLES + 10, 1, 220.0f, 0.5f));
+    CHECK(scheduler.schedule(AUDIO_BLOCK_SAMPLES + 20, 2, 330.0f, 0.5f));
+    scheduler.cancel(1);   // Released before it sounded
+    renderBlock(scheduler);
+    renderBlock(scheduler);
+    CHECK(firedCount == 1 && fired[0].voice == 2);
+
+    // The freed slot takes a new event
+    for (int i = 0; i < STRUM_MAX_PENDING; i++) CHECK(scheduler.schedule(100000, i, 100.0f, 0.5f));
+}
+
+static void testStealPendingOnset() {
+    printf("\n--- Voice stolen before its strum onset ---\n");
+    AudioNoteScheduler scheduler;
+    reset(scheduler);
+
+    // Two voices, one player: a strum queues an onset on each
+    VoicePool pool;
+    pool.init(2, 1);
+    uint8_t stolen;
+    uint8_t first = pool.allocate(0, &stolen);
+    uint8_t second = pool.allocate(0, &stolen);
+    uint32_t onset = 3 * AUDIO_BLOCK_SAMPLES;
+    CHECK(scheduler.schedule(onset, first, 220.0f, 0.5f));
+    CHECK(scheduler.schedule(onset + 30, second, 330.0f, 0.5f));
+
+    // An immediate note-on before the onsets takes the oldest voice and
+    // starts it at once, so its pending onset is cancelled (as noteOn()
+    // does) or it would retune and retrigger the new note later
+    uint8_t voice = pool.allocate(0, &stolen);
+    CHECK(voice == first && stolen == first);
+    scheduler.cancel(voice);
+
+    for (int b = 0; b < 5; b++) renderBlock(scheduler);
+    CHECK(firedCount == 1);
+    CHECK(fired[0].voice == second && fired[0].frequency == 330.0f && fired[0].offset == 30);
+    CHECK(scheduler.getLateCount() == 0);
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Note Scheduler Test\n");
+    printf("=================================\n");
+
+    testOffsets();
+    testClock();
+    testCancel();
+    testStealPendingOnset();
+
+    if (failures == 0) {
+        printf("All note scheduler tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
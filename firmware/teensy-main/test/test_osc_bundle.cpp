@@ -0,0 +1,198 @@
+/**
+ * Host Test and Benchmark for OSC Bundles
+ * Checks messages and bundles byte for byte against the OSC 1.0 layout,
+ * NTP timetags, and what happens when a bundle fills up; then replays the
+ * OSC sketch's telemetry to compare one datagram per message with one
+ * bundle per update in packets and bytes per second
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_osc_bundle.cpp -o test_osc_bundle
+ *   ./test_osc_bundle
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include "osc_bundle.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+#define UDP_IP_HEADER 28   // IPv4 + UDP header per datagram
+
+static void testMessages() {
+    uint8_t out[64];
+
+    // Address padded to 4 (10 chars + NUL + 1), ",f" + 2 NULs, 41.5f big-endian
+    static const uint8_t cpu[] = {
+        '/', 's', 'y', 'n', 't', 'h', '/', 'c', 'p', 'u', 0, 0,
+        ',', 'f', 0, 0,
+        0x42, 0x26, 0x00, 0x00
+    };
+    size_t len = oscEncodeMessage(out, sizeof(out), "/synth/cpu", "f", 41.5f);
+    CHECK(len == sizeof(cpu) && memcmp(out, cpu, len) == 0);
+
+    // A 12-char address needs four NULs; ",is" one; "Blues" three
+    static const uint8_t scale[] = {
+        '/', 's', 'y', 'n', 't', 'h', '/', 's', 'c', 'a', 'l', 'e', 0, 0, 0, 0,
+        ',', 'i', 's', 0,
+        0x00, 0x00, 0x00, 0x03,
+        'B', 'l', 'u', 'e', 's', 0, 0, 0
+    };
+    len = oscEncodeMessage(out, sizeof(out), "/synth/scale", "is", 3, "Blues");
+    CHECK(len == sizeof(scale) && memcmp(out, scale, len) == 0);
+
+    // Negative int, boolean tags without data
+    static const uint8_t octave[] = {
+        '/', 'o', 'c', 't', 0, 0, 0, 0,
+        ',', 'i', 'T', 0,
+        0xFF, 0xFF, 0xFF, 0xFE
+    };
+    len = oscEncodeMessage(out, sizeof(out), "/oct", "iT", -2);
+    CHECK(len == sizeof(octave) && memcmp(out, octave, len) == 0);
+
+    // Doesn't fit, or unknown type: nothing
+    CHECK(oscEncodeMessage(out, sizeof(cpu) - 1, "/synth/cpu", "f", 41.5f) == 0);
+    CHECK(oscEncodeMessage(out, sizeof(out), "/x", "d", 1.0) == 0);
+}
+
+static void testTimetag() {
+    // 1970 is 2208988800 s after 1900; half a second is 2^31
+    CHECK(oscTimetag(0, 0) == (uint64_t)0x83AA7E80 << 32);
+    CHECK(oscTimetag(0, 500000) == (((uint64_t)0x83AA7E80 << 32) | 0x80000000));
+    CHECK((uint32_t)oscTimetag(1700000000, 999999) == 0xFFFFEF39);
+    CHECK(oscTimetag(1700000000, 0) >> 32 == 1700000000ULL + 2208988800ULL);
+}
+
+static void testBundle() {
+    OscBundle bundle;
+    bundle.begin(oscTimetag(0, 500000));
+    CHECK(bundle.empty() && bundle.size() == 16);
+    CHECK(bundle.add("/synth/cpu", "f", 41.5f));
+    CHECK(bundle.add("/synth/scale", "is", 3, "Blues"));
+
+    static const uint8_t expected[] = {
+        '#', 'b', 'u', 'n', 'd', 'l', 'e', 0,
+        0x83, 0xAA, 0x7E, 0x80, 0x80, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 20,
+        '/', 's', 'y', 'n', 't', 'h', '/', 'c', 'p', 'u', 0, 0,
+        ',', 'f', 0, 0,
+        0x42, 0x26, 0x00, 0x00,
+        0x00, 0x00, 0x00, 32,
+        '/', 's', 'y', 'n', 't', 'h', '/', 's', 'c', 'a', 'l', 'e', 0, 0, 0, 0,
+        ',', 'i', 's', 0,
+        0x00, 0x00, 0x00, 0x03,
+        'B', 'l', 'u', 'e', 's', 0, 0, 0
+    };
+    CHECK(bundle.size() == sizeof(expected));
+    CHECK(memcmp(bundle.data(), expected, sizeof(expected)) == 0);
+    CHECK(bundle.getCount() == 2);
+
+    // Reused: begin() starts over with the new timetag
+    bundle.sent();
+    bundle.begin(OSC_IMMEDIATE);
+    CHECK(bundle.empty() && bundle.size() == 16);
+    CHECK(bundle.data()[15] == 1 && bundle.data()[8] == 0);
+    CHECK(bundle.getBundlesSent() == 1 && bundle.getMessagesSent() == 2);
+
+    // Full: the message that doesn't fit is refused and the rest kept
+    size_t added = 0;
+    while (bundle.add("/synth/noteon", "i", 60)) added++;
+    CHECK(added == (OSC_BUNDLE_BYTES - 16) / (4 + 24));
+    size_t size = bundle.size();
+    CHECK(!bundle.add("/synth/noteon", "i", 61) && bundle.size() == size);
+    CHECK(size <= OSC_BUNDLE_BYTES);
+}
+
+// The OSC sketch's traffic: a state delta every 100ms changing CPU,
+// memory and loop time, now and then scale/root/octave, and note batches
+// while playing (a couple of events per 10ms window, ~8 windows/s)
+static void benchmarkTelemetry() {
+    const uint32_t runMs = 60000;
+    uint8_t single[OSC_BUNDLE_BYTES];
+    OscBundle bundle;
+    uint32_t seed = 1;
+
+    uint32_t separatePackets = 0, separateBytes = 0;
+    uint32_t bundlePackets = 0, bundleBytes = 0;
+
+    for (uint32_t now = 0; now < runMs; now += 10) {
+        seed = seed * 1103515245 + 12345;
+        bool stateUpdate = now % 100 == 0;
+        uint8_t notes = (seed >> 16) % 100 < 8 ? 1 + (seed >> 24) % 3 : 0;
+        if (!stateUpdate && !notes) continue;
+
+        bundle.begin(oscTimetag(1700000000 + now / 1000, (now % 1000) * 1000));
+        size_t len;
+
+        #define SEND(address, types, ...) \
+            len = oscEncodeMessage(single, sizeof(single), address, types, __VA_ARGS__); \
+            separatePackets++; \
+            separateBytes += len + UDP_IP_HEADER; \
+            CHECK(bundle.add(address, types, __VA_ARGS__))
+
+        if (stateUpdate) {
+            SEND("/synth/cpu", "f", 12.5f + (seed % 100) / 10.0f);
+            SEND("/synth/memory", "i", 12);
+            SEND("/synth/latency", "i", 850);
+            if ((seed >> 8) % 20 == 0) {
+                SEND("/synth/scale", "is", 2, "Blues");
+                SEND("/synth/root", "is", 4, "E");
+            }
+        }
+        for (uint8_t n = 0; n < notes; n++) {
+            SEND(n & 1 ? "/synth/noteoff" : "/synth/noteon", "i", 60 + n);
+        }
+        #undef SEND
+
+        bundlePackets++;
+        bundleBytes += bundle.size() + UDP_IP_HEADER;
+        bundle.sent();
+    }
+
+    double seconds = runMs / 1000.0;
+    printf("Telemetry over %.0fs (payload + %d B UDP/IP header per datagram):\n", seconds, UDP_IP_HEADER);
+    printf("  one datagram per message: %6.1f packets/s %7.0f B/s\n", separatePackets / seconds, separateBytes / seconds);
+    printf("  one bundle per update:    %6.1f packets/s %7.0f B/s\n", bundlePackets / seconds, bundleBytes / seconds);
+    printf("  saved:                    %6.1f packets/s %7.0f B/s (%.0f%% of packets)\n",
+           (separatePackets - bundlePackets) / seconds, ((double)separateBytes - bundleBytes) / seconds,
+           100.0 * (separatePackets - bundlePackets) / separatePackets);
+
+    CHECK(bundlePackets < separatePackets / 2);
+    CHECK(bundleBytes < separateBytes);
+    CHECK(bundle.getMessagesSent() == separatePackets);
+
+    // Encoding cost
+    const int rounds = 1000000;
+    size_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        bundle.begin(OSC_IMMEDIATE);
+        bundle.add("/synth/cpu", "f", (float)i);
+        bundle.add("/synth/memory", "i", i);
+        bundle.add("/synth/latency", "i", i);
+        total += bundle.size();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("Encoding: %.0f three-message bundles/s on this host (%zu bytes)\n", rounds / elapsed, total);
+}
+
+int main() {
+    printf("=================================\n");
+    printf("OSC Bundle Test\n");
+    printf("=================================\n");
+
+    testMessages();
+    testTimetag();
+    testBundle();
+    benchmarkTelemetry();
+
+    if (failures == 0) {
+        printf("All OSC bundle tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
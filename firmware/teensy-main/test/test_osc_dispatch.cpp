@@ -0,0 +1,348 @@
+/**
+ * Host Test and Benchmark for OSC Input Dispatch
+ * Sends every synth parameter through /synth/<name> (bundled and nested
+ * the way TouchOSC and friends send them), checks range clamping, unknown
+ * addresses and malformed datagrams, shows that dispatch makes no heap
+ * allocations, and measures the hashed lookup against the strcmp chain
+ * it replaces
+ *
+ * Allocations are counted through operator new and, with glibc, malloc
+ * itself.
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_osc_dispatch.cpp -o test_osc_dispatch
+ *   ./test_osc_dispatch
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <new>
+#include <chrono>
+#include "osc_bundle.h"
+#include "osc_dispatch.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+// ---- Allocation counting
+
+static volatile unsigned long allocations = 0;
+
+#ifdef __GLIBC__
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+extern "C" void* malloc(size_t size) {
+    allocations++;
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    allocations++;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    allocations++;
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+void* operator new(size_t size) {
+#ifndef __GLIBC__
+    allocations++;  // Otherwise counted by malloc() above
+#endif
+    void* p = malloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// ---- Helpers
+
+// What the ESP would send the Teensy
+struct Sink {
+    LinkSetParam params[LINK_NUM_PARAMS];
+    uint8_t count;
+    uint8_t ignored;
+};
+
+static void collect(const OscMessageView& message, void* context) {
+    Sink* sink = (Sink*)context;
+    LinkSetParam param;
+    if (oscToLinkParam(message, param) && sink->count < LINK_NUM_PARAMS) {
+        sink->params[sink->count++] = param;
+    } else {
+        sink->ignored++;
+    }
+}
+
+static uint16_t dispatch(const uint8_t* data, size_t len, Sink& sink) {
+    memset(&sink, 0, sizeof(sink));
+    return oscForEachMessage(data, len, collect, &sink);
+}
+
+static bool near(float a, float b) { return fabsf(a - b) < 1e-4f * (1 + fabsf(b)); }
+
+// The chain of comparisons the ESP used to run on every address
+static uint8_t findByStrcmp(const char* name) {
+    for (uint8_t p = 1; p < LINK_NUM_PARAMS; p++) {
+        if (strcmp(name, linkParamInfo(p)->name) == 0) return p;
+    }
+    return 0;
+}
+
+// ---- Tests
+
+static void testParamTable() {
+    // Every parameter has a name, the hash finds it, and no two collide
+    // (the switch in linkParamFind() wouldn't compile if they did)
+    for (uint8_t p = 1; p < LINK_NUM_PARAMS; p++) {
+        const LinkParamInfo* info = linkParamInfo(p);
+        CHECK(info != NULL && info->name != NULL);
+        CHECK(strlen(info->name) < OSC_MAX_NAME);
+        CHECK(info->min < info->max);
+        CHECK(linkParamFind(info->name) == p);
+    }
+    CHECK(linkParamInfo(0) == NULL && linkParamInfo(LINK_NUM_PARAMS) == NULL);
+    CHECK(linkParamFind("") == 0);
+    CHECK(linkParamFind("Reverb") == 0);
+    CHECK(linkParamFind("reverbs") == 0);
+    CHECK(linkParamFind("noteon") == 0);
+}
+
+static void testEveryParam() {
+    uint8_t packet[64];
+    char address[32];
+    Sink sink;
+
+    for (uint8_t p = 1; p < LINK_NUM_PARAMS; p++) {
+        const LinkParamInfo* info = linkParamInfo(p);
+        float mid = info->integer ? (float)(int)((info->min + info->max) / 2) : (info->min + info->max) / 2;
+
+        snprintf(address, sizeof(address), "/synth/%s", info->name);
+        size_t len = oscEncodeMessage(packet, sizeof(packet), address, "f", mid);
+        CHECK(dispatch(packet, len, sink) == 1);
+        CHECK(sink.count == 1 && sink.params[0].param == p && near(sink.params[0].value, mid));
+
+        // Integer argument, and the short address the old UI used
+        snprintf(address, sizeof(address), "/%s", info->name);
+        len = oscEncodeMessage(packet, sizeof(packet), address, "i", (int32_t)info->min);
+        CHECK(dispatch(packet, len, sink) == 1);
+        CHECK(sink.count == 1 && sink.params[0].param == p && near(sink.params[0].value, info->min));
+    }
+}
+
+static void testValues() {
+    uint8_t packet[64];
+    Sink sink;
+
+    // Out of range is clamped, integer parameters rounded
+    size_t len = oscEncodeMessage(packet, sizeof(packet), "/synth/reverb", "f", 250.0f);
+    dispatch(packet, len, sink);
+    CHECK(sink.count == 1 && sink.params[0].value == 100.0f);
+
+    len = oscEncodeMessage(packet, sizeof(packet), "/synth/octave", "i", -9);
+    dispatch(packet, len, sink);
+    CHECK(sink.count == 1 && sink.params[0].value == -2.0f);
+
+    len = oscEncodeMessage(packet, sizeof(packet), "/synth/scale", "f", 2.6f);
+    dispatch(packet, len, sink);
+    CHECK(sink.count == 1 && sink.params[0].value == 3.0f);
+
+    len = oscEncodeMessage(packet, sizeof(packet), "/synth/filter", "f", 1.0f);
+    dispatch(packet, len, sink);
+    CHECK(sink.count == 1 && sink.params[0].value == 20.0f);
+
+    // NaN is dropped, not clamped
+    len = oscEncodeMessage(packet, sizeof(packet), "/synth/detune", "f", nanf(""));
+    dispatch(packet, len, sink);
+    CHECK(sink.count == 0 && sink.ignored == 1);
+
+    // Toggle buttons send T/F
+    len = oscEncodeMessage(packet, sizeof(packet), "/synth/lfotarget", "T");
+    dispatch(packet, len, sink);
+    CHECK(sink.count == 1 && sink.params[0].value == 1.0f);
+
+    // Unknown address, missing or non-numeric argument: seen, not sent
+    len = oscEncodeMessage(packet, sizeof(packet), "/synth/wobble", "f", 1.0f);
+    CHECK(dispatch(packet, len, sink) == 1 && sink.count == 0);
+    len = oscEncodeMessage(packet, sizeof(packet), "/synth/reverb", "");
+    CHECK(dispatch(packet, len, sink) == 1 && sink.count == 0);
+    len = oscEncodeMessage(packet, sizeof(packet), "/synth/reverb", "s", "loud");
+    CHECK(dispatch(packet, len, sink) == 1 && sink.count == 0);
+    len = oscEncodeMessage(packet, sizeof(packet), "/synth/averyveryverylongname", "f", 1.0f);
+    CHECK(dispatch(packet, len, sink) == 1 && sink.count == 0);
+    len = oscEncodeMessage(packet, sizeof(packet), "/other/reverb", "f", 1.0f);
+    CHECK(dispatch(packet, len, sink) == 1 && sink.count == 0);
+
+    // Second argument of a multi-argument message
+    len = oscEncodeMessage(packet, sizeof(packet), "/xy", "if", 7, 0.25f);
+    OscMessageView view;
+    view.address = (const char*)packet;
+    view.types = (const char*)packet + 5;
+    view.args = packet + 8;
+    view.argsLength = len - 8;
+    float value = 0;
+    CHECK(view.number(1, value) && value == 0.25f);
+    CHECK(!view.number(2, value));
+}
+
+static void testBundles() {
+    Sink sink;
+    OscBundle bundle;
+    bundle.begin(OSC_IMMEDIATE);
+    CHECK(bundle.add("/synth/attack", "f", 12.0f));
+    CHECK(bundle.add("/synth/release", "f", 800.0f));
+    CHECK(bundle.add("/synth/waveform", "i", 3));
+    CHECK(dispatch(bundle.data(), bundle.size(), sink) == 3);
+    CHECK(sink.count == 3);
+    CHECK(sink.params[0].param == LINK_PARAM_ATTACK && sink.params[0].value == 12.0f);
+    CHECK(sink.params[1].param == LINK_PARAM_RELEASE && sink.params[1].value == 800.0f);
+    CHECK(sink.params[2].param == LINK_PARAM_WAVEFORM && sink.params[2].value == 3.0f);
+
+    // A bundle inside a bundle, then a message after it
+    uint8_t nested[OSC_BUNDLE_BYTES];
+    memcpy(nested, "#bundle\0\0\0\0\0\0\0\0\1", 16);
+    size_t len = 16;
+    oscPutU32(nested + len, (uint32_t)bundle.size());
+    memcpy(nested + len + 4, bundle.data(), bundle.size());
+    len += 4 + bundle.size();
+    size_t message = oscEncodeMessage(nested + len + 4, sizeof(nested) - len - 4, "/synth/sustain", "f", 0.5f);
+    oscPutU32(nested + len, (uint32_t)message);
+    len += 4 + message;
+    CHECK(dispatch(nested, len, sink) == 4);
+    CHECK(sink.count == 4 && sink.params[3].param == LINK_PARAM_SUSTAIN);
+
+    // Nesting deeper than OSC_MAX_BUNDLE_DEPTH is dropped
+    uint8_t deep[256];
+    memset(deep, 0, sizeof(deep));
+    size_t depth = OSC_MAX_BUNDLE_DEPTH + 1;
+    size_t inner = oscEncodeMessage(deep + depth * 20, sizeof(deep) - depth * 20, "/synth/decay", "f", 1.0f);
+    for (size_t d = depth; d-- > 0;) {
+        memcpy(deep + d * 20, "#bundle\0\0\0\0\0\0\0\0\1", 16);
+        oscPutU32(deep + d * 20 + 16, (uint32_t)(inner + (depth - 1 - d) * 20));
+    }
+    CHECK(dispatch(deep, depth * 20 + inner, sink) == 0);
+    CHECK(dispatch(deep + 20, (depth - 1) * 20 + inner, sink) == 1);
+}
+
+static void testMalformed() {
+    uint8_t packet[64];
+    Sink sink;
+    size_t len = oscEncodeMessage(packet, sizeof(packet), "/synth/reverb", "f", 50.0f);
+
+    CHECK(dispatch(packet, 0, sink) == 0);
+    CHECK(dispatch(packet, len - 1, sink) == 0);       // Not a multiple of 4
+    CHECK(dispatch(packet, 12, sink) == 0);            // Address cut short
+    CHECK(dispatch(packet, 20, sink) == 1 && sink.count == 0);  // Argument missing
+
+    packet[0] = 'x';
+    CHECK(dispatch(packet, len, sink) == 0);
+
+    // Bundle element claiming more than is there: stop, keep what came before
+    OscBundle bundle;
+    bundle.begin(OSC_IMMEDIATE);
+    bundle.add("/synth/reverb", "f", 50.0f);
+    bundle.add("/synth/delay", "f", 25.0f);
+    uint8_t broken[OSC_BUNDLE_BYTES];
+    memcpy(broken, bundle.data(), bundle.size());
+    size_t second = 16 + 4 + 24;
+    oscPutU32(broken + second, 1000);
+    CHECK(dispatch(broken, bundle.size(), sink) == 1 && sink.count == 1);
+
+    // Random bytes never crash or run off the end
+    uint32_t seed = 7;
+    for (int i = 0; i < 100000; i++) {
+        uint8_t noise[128];
+        for (size_t b = 0; b < sizeof(noise); b++) {
+            seed = seed * 1103515245 + 12345;
+            noise[b] = seed >> 24;
+        }
+        if (i & 1) memcpy(noise, "/synth/", 7);
+        if (i % 3 == 0) memcpy(noise, "#bundle", 8);
+        dispatch(noise, (seed >> 8) % 33 * 4, sink);
+    }
+}
+
+static void testNoAllocations() {
+    // Every parameter in one bundle (short addresses, so it fits)
+    OscBundle bundle;
+    bundle.begin(OSC_IMMEDIATE);
+    for (uint8_t p = 1; p < LINK_NUM_PARAMS; p++) {
+        char address[32];
+        snprintf(address, sizeof(address), "/%s", linkParamInfo(p)->name);
+        bundle.add(address, "f", 1.0f);
+    }
+    CHECK(bundle.getCount() == LINK_NUM_PARAMS - 1);
+
+    Sink sink;
+    unsigned long before = allocations;
+    for (int i = 0; i < 1000; i++) dispatch(bundle.data(), bundle.size(), sink);
+    CHECK(allocations == before);
+    CHECK(sink.count == LINK_NUM_PARAMS - 1 && sink.ignored == 0);
+}
+
+static void benchmarkLookup() {
+    const int rounds = 2000000;
+    const char* names[LINK_NUM_PARAMS];
+    for (uint8_t p = 1; p < LINK_NUM_PARAMS; p++) names[p - 1] = linkParamInfo(p)->name;
+    names[LINK_NUM_PARAMS - 1] = "unknown";
+
+    unsigned long total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) total += linkParamFind(names[i % LINK_NUM_PARAMS]);
+    double hashed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    unsigned long check = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) check += findByStrcmp(names[i % LINK_NUM_PARAMS]);
+    double chained = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    CHECK(total == check);
+
+    printf("Lookup of %d names (%d parameters + 1 unknown):\n", rounds, LINK_NUM_PARAMS - 1);
+    printf("  hash + one strcmp: %6.1f ns/lookup\n", hashed * 1e9 / rounds);
+    printf("  strcmp chain:      %6.1f ns/lookup (%.1fx)\n", chained * 1e9 / rounds, chained / hashed);
+
+    // Whole path: a 4-message bundle from a control surface to link params
+    OscBundle bundle;
+    bundle.begin(OSC_IMMEDIATE);
+    bundle.add("/synth/filter", "f", 1200.0f);
+    bundle.add("/synth/resonance", "f", 2.0f);
+    bundle.add("/synth/lfodepth", "f", 0.3f);
+    bundle.add("/synth/reverb", "i", 40);
+    Sink sink;
+    unsigned long messages = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds / 4; i++) messages += dispatch(bundle.data(), bundle.size(), sink);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("Dispatch: %.0f messages/s on this host\n", messages / elapsed);
+}
+
+int main() {
+    printf("=================================\n");
+    printf("OSC Dispatch Test\n");
+    printf("=================================\n");
+
+    testParamTable();
+    testEveryParam();
+    testValues();
+    testBundles();
+    testMalformed();
+    testNoAllocations();
+    benchmarkLookup();
+
+    if (failures == 0) {
+        printf("All OSC dispatch tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
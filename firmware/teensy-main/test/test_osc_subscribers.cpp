@@ -0,0 +1,318 @@
+/**
+ * Host Test and Benchmark for OSC Subscribers
+ * Checks /subscribe and /unsubscribe parsing, registration of inbound
+ * senders, expiry, eviction, topic filters and the per-client stats rate
+ * limit; then replays the OSC sketch's telemetry and compares the Wi-Fi
+ * airtime of broadcasting it with unicasting it to 0-8 subscribers
+ *
+ * Airtime is modelled per frame: broadcast at the 1 Mbit/s basic rate
+ * (long preamble, no ACK), unicast at 54 Mbit/s OFDM with its ACK, both
+ * with DIFS and average backoff, and 28 + 34 bytes of IP/UDP and MAC/LLC
+ * headers.
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_osc_subscribers.cpp -o test_osc_subscribers
+ *   ./test_osc_subscribers
+ */
+
+#include <stdio.h>
+#include "osc_bundle.h"
+#include "osc_subscribers.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+#define IP(a, b, c, d) ((uint32_t)(a) | (uint32_t)(b) << 8 | (uint32_t)(c) << 16 | (uint32_t)(d) << 24)
+#define FRAME_HEADERS (28 + 34)
+
+#define STATE_BIT (1 << OSC_TOPIC_STATE)
+#define NOTES_BIT (1 << OSC_TOPIC_NOTES)
+#define STATS_BIT (1 << OSC_TOPIC_STATS)
+
+// ---- Helpers
+
+struct Inbound {
+    OscSubscribers* subscribers;
+    uint32_t ip;
+    uint32_t now;
+    uint8_t handled;
+    uint8_t passed;
+};
+
+static void deliver(const OscMessageView& message, void* context) {
+    Inbound* in = (Inbound*)context;
+    if (in->subscribers->handle(message, in->ip, in->now)) in->handled++;
+    else in->passed++;
+}
+
+// Encode one message and hand it to the registry as if received from ip
+#define RECEIVE(subs, ip, now, ...) do { \
+    uint8_t packet_[128]; \
+    size_t len_ = oscEncodeMessage(packet_, sizeof(packet_), __VA_ARGS__); \
+    Inbound in_ = {&(subs), ip, now, 0, 0}; \
+    oscForEachMessage(packet_, len_, deliver, &in_); \
+    lastHandled = in_.handled; \
+} while (0)
+
+static uint8_t lastHandled;
+
+static int findSubscriber(const OscSubscribers& subs, uint32_t ip, uint16_t port) {
+    for (uint8_t i = 0; i < subs.getCount(); i++) {
+        if (subs.get(i).ip == ip && subs.get(i).port == port) return i;
+    }
+    return -1;
+}
+
+// ---- Tests
+
+static void testTopics() {
+    CHECK(OscSubscribers::topicsFromList("all") == OSC_TOPICS_ALL);
+    CHECK(OscSubscribers::topicsFromList("state,notes") == (STATE_BIT | NOTES_BIT));
+    CHECK(OscSubscribers::topicsFromList("stats") == STATS_BIT);
+    CHECK(OscSubscribers::topicsFromList("stats,bogus,") == STATS_BIT);
+    CHECK(OscSubscribers::topicsFromList("") == 0);
+    CHECK(OscSubscribers::topicsFromList("statestats") == 0);
+}
+
+static void testSubscribe() {
+    OscSubscribers subs;
+    uint32_t phone = IP(192, 168, 4, 2), laptop = IP(192, 168, 4, 3);
+
+    RECEIVE(subs, phone, 0, "/subscribe", "");
+    CHECK(lastHandled == 1 && subs.getCount() == 1);
+    CHECK(subs.get(0).port == OSC_SUBSCRIBER_DEFAULT_PORT && subs.get(0).topics == OSC_TOPICS_ALL);
+    CHECK(subs.get(0).statsIntervalMs == OSC_STATS_INTERVAL_MS);
+
+    // Same client again updates in place; another port is another subscription
+    RECEIVE(subs, phone, 10, "/subscribe", "s", "notes");
+    CHECK(subs.getCount() == 1 && subs.get(0).topics == NOTES_BIT);
+    RECEIVE(subs, phone, 20, "/subscribe", "sii", "stats", 9000, 500);
+    CHECK(subs.getCount() == 2);
+    int stats = findSubscriber(subs, phone, 9000);
+    CHECK(stats >= 0 && subs.get(stats).topics == STATS_BIT && subs.get(stats).statsIntervalMs == 500);
+
+    // Port without a topic list; float arguments work too
+    RECEIVE(subs, laptop, 30, "/subscribe", "f", 9001.0f);
+    CHECK(findSubscriber(subs, laptop, 9001) >= 0);
+
+    // Nonsense is consumed but doesn't subscribe
+    RECEIVE(subs, laptop, 40, "/subscribe", "s", "everything");
+    RECEIVE(subs, laptop, 40, "/subscribe", "si", "all", 70000);
+    CHECK(lastHandled == 1 && subs.getCount() == 3);
+
+    // Unsubscribe one port, then everything from an address
+    RECEIVE(subs, phone, 50, "/unsubscribe", "i", 9000);
+    CHECK(subs.getCount() == 2 && findSubscriber(subs, phone, 9000) < 0);
+    RECEIVE(subs, laptop, 60, "/unsubscribe", "");
+    CHECK(subs.getCount() == 1 && findSubscriber(subs, phone, OSC_SUBSCRIBER_DEFAULT_PORT) >= 0);
+    CHECK(subs.getSubscribes() == 4);
+}
+
+static void testAutoRegistration() {
+    OscSubscribers subs;
+    uint32_t surface = IP(192, 168, 4, 5);
+
+    // A control surface's /synth/... registers it, and is passed on
+    RECEIVE(subs, surface, 0, "/synth/reverb", "f", 40.0f);
+    CHECK(lastHandled == 0 && subs.getCount() == 1);
+    CHECK(subs.get(0).topics == OSC_TOPICS_ALL && subs.get(0).port == OSC_SUBSCRIBER_DEFAULT_PORT);
+
+    // Once subscribed its own way, traffic only keeps it alive
+    RECEIVE(subs, surface, 100, "/subscribe", "si", "state", 9100);
+    RECEIVE(subs, surface, 100, "/unsubscribe", "i", OSC_SUBSCRIBER_DEFAULT_PORT);
+    CHECK(subs.getCount() == 1);
+    RECEIVE(subs, surface, 50000, "/synth/filter", "f", 900.0f);
+    CHECK(subs.getCount() == 1 && subs.get(0).port == 9100 && subs.get(0).lastHeardMs == 50000);
+
+    // Expiry: quiet for the timeout and it's gone
+    subs.expire(50000 + OSC_SUBSCRIBER_TIMEOUT_MS - 1);
+    CHECK(subs.getCount() == 1);
+    subs.expire(50000 + OSC_SUBSCRIBER_TIMEOUT_MS);
+    CHECK(subs.getCount() == 0 && subs.getExpired() == 1);
+}
+
+static void testEviction() {
+    OscSubscribers subs;
+    for (uint8_t i = 0; i < OSC_MAX_SUBSCRIBERS; i++) {
+        subs.subscribe(IP(10, 0, 0, 10 + i), 8000, OSC_TOPICS_ALL, 0, 1000 + i);
+    }
+    subs.subscribe(IP(10, 0, 0, 12), 8000, OSC_TOPICS_ALL, 0, 5000);  // Refreshes, no eviction
+    CHECK(subs.getCount() == OSC_MAX_SUBSCRIBERS && subs.getEvicted() == 0);
+
+    // Table full: the one heard from longest ago (10.0.0.10) makes room
+    subs.subscribe(IP(10, 0, 0, 99), 8000, OSC_TOPICS_ALL, 0, 6000);
+    CHECK(subs.getCount() == OSC_MAX_SUBSCRIBERS && subs.getEvicted() == 1);
+    CHECK(findSubscriber(subs, IP(10, 0, 0, 10), 8000) < 0);
+    CHECK(findSubscriber(subs, IP(10, 0, 0, 99), 8000) >= 0);
+    CHECK(findSubscriber(subs, IP(10, 0, 0, 12), 8000) >= 0);
+}
+
+static void testRateLimit() {
+    OscSubscribers subs;
+    subs.subscribe(IP(10, 0, 0, 1), 8000, OSC_TOPICS_ALL, 100, 0);
+    subs.subscribe(IP(10, 0, 0, 2), 8000, STATE_BIT | NOTES_BIT, 100, 0);
+
+    // First stats go at once, then at most every 100ms; events always go
+    CHECK(subs.topicsFor(0, OSC_TOPICS_ALL, 0) == OSC_TOPICS_ALL);
+    CHECK(subs.topicsFor(0, OSC_TOPICS_ALL, 10) == (STATE_BIT | NOTES_BIT));
+    CHECK(subs.topicsFor(0, STATS_BIT, 99) == 0);
+    CHECK(subs.topicsFor(0, STATS_BIT, 100) == STATS_BIT);
+    CHECK(subs.getStatsSkipped() == 2);
+
+    // Topic filter
+    CHECK(subs.topicsFor(1, OSC_TOPICS_ALL, 200) == (STATE_BIT | NOTES_BIT));
+    CHECK(subs.topicsFor(1, STATS_BIT, 300) == 0);
+}
+
+static void testAppend() {
+    OscBundle state, notes, out;
+    state.begin(OSC_IMMEDIATE);
+    notes.begin(OSC_IMMEDIATE);
+    state.add("/synth/scale", "is", 2, "Blues");
+    notes.add("/synth/noteon", "i", 60);
+    notes.add("/synth/noteoff", "i", 60);
+
+    // Appended bundles read back as all their messages, in order
+    out.begin(OSC_IMMEDIATE);
+    CHECK(out.append(state) && out.append(notes));
+    CHECK(out.getCount() == 3 && out.size() == state.size() + notes.size() - 16);
+
+    struct Seen { uint8_t count; char last[16]; } seen = {0, ""};
+    struct Collect {
+        static void call(const OscMessageView& message, void* context) {
+            Seen* s = (Seen*)context;
+            s->count++;
+            strncpy(s->last, message.address, sizeof(s->last) - 1);
+        }
+    };
+    CHECK(oscForEachMessage(out.data(), out.size(), Collect::call, &seen) == 3);
+    CHECK(strcmp(seen.last, "/synth/noteoff") == 0);
+
+    // Doesn't fit: nothing appended
+    OscBundle big;
+    big.begin(OSC_IMMEDIATE);
+    while (big.add("/synth/noteon", "i", 1)) {}
+    size_t size = out.size();
+    CHECK(!out.append(big) && out.size() == size && out.getCount() == 3);
+}
+
+// ---- Airtime
+
+// Microseconds on air for one datagram of len bytes of OSC
+static double broadcastAirtimeUs(size_t len) {
+    // 802.11b 1 Mbit/s, long preamble, DIFS + average backoff, no ACK
+    return 50 + 15.5 * 20 + 192 + (len + FRAME_HEADERS) * 8.0;
+}
+
+static double unicastAirtimeUs(size_t len) {
+    // 802.11g 54 Mbit/s: 4us symbols of 216 bits, SIFS + ACK at 24 Mbit/s
+    double symbols = ((len + FRAME_HEADERS) * 8.0 + 22) / 216;
+    if (symbols != (int)symbols) symbols = (int)symbols + 1;
+    return 28 + 7.5 * 9 + 20 + symbols * 4 + 10 + 28;
+}
+
+// The sketch's telemetry: a state delta every 100ms changing the stats,
+// now and then scale/root, and note batches while playing. Returns the
+// airtime used per second, and the datagrams sent.
+static double replay(uint8_t subscribers, bool broadcast, uint32_t& datagrams) {
+    const uint32_t runMs = 60000;
+    OscSubscribers subs;
+    for (uint8_t i = 0; i < subscribers; i++) {
+        // A mix: everything, a note visualiser, a stats monitor at 2/s
+        uint8_t topics = i % 3 == 0 ? OSC_TOPICS_ALL : i % 3 == 1 ? NOTES_BIT : STATS_BIT;
+        subs.subscribe(IP(10, 0, 0, 2 + i), 8000, topics, i % 3 == 2 ? 500 : OSC_STATS_INTERVAL_MS, 0);
+    }
+
+    OscBundle topics[OSC_NUM_TOPICS], out;
+    uint32_t seed = 1;
+    double airtimeUs = 0;
+    datagrams = 0;
+
+    for (uint32_t now = 0; now < runMs; now += 10) {
+        seed = seed * 1103515245 + 12345;
+        bool stateUpdate = now % 100 == 0;
+        uint8_t notes = (seed >> 16) % 100 < 8 ? 1 + (seed >> 24) % 3 : 0;
+        if (!stateUpdate && !notes) continue;
+
+        for (uint8_t t = 0; t < OSC_NUM_TOPICS; t++) topics[t].begin(OSC_IMMEDIATE);
+        if (stateUpdate) {
+            topics[OSC_TOPIC_STATS].add("/synth/cpu", "f", 12.5f);
+            topics[OSC_TOPIC_STATS].add("/synth/memory", "i", 12);
+            topics[OSC_TOPIC_STATS].add("/synth/latency", "i", 850);
+            if ((seed >> 8) % 20 == 0) {
+                topics[OSC_TOPIC_STATE].add("/synth/scale", "is", 2, "Blues");
+                topics[OSC_TOPIC_STATE].add("/synth/root", "is", 4, "E");
+            }
+        }
+        for (uint8_t n = 0; n < notes; n++) {
+            topics[OSC_TOPIC_NOTES].add(n & 1 ? "/synth/noteoff" : "/synth/noteon", "i", 60 + n);
+        }
+        uint8_t available = 0;
+        for (uint8_t t = 0; t < OSC_NUM_TOPICS; t++) {
+            if (!topics[t].empty()) available |= 1 << t;
+        }
+
+        if (broadcast) {
+            out.begin(OSC_IMMEDIATE);
+            for (uint8_t t = 0; t < OSC_NUM_TOPICS; t++) out.append(topics[t]);
+            airtimeUs += broadcastAirtimeUs(out.size());
+            datagrams++;
+            continue;
+        }
+        for (uint8_t i = 0; i < subs.getCount(); i++) {
+            uint8_t wanted = subs.topicsFor(i, available, now);
+            if (!wanted) continue;
+            out.begin(OSC_IMMEDIATE);
+            for (uint8_t t = 0; t < OSC_NUM_TOPICS; t++) {
+                if (wanted & (1 << t)) CHECK(out.append(topics[t]));
+            }
+            airtimeUs += unicastAirtimeUs(out.size());
+            datagrams++;
+        }
+    }
+    return airtimeUs / (runMs / 1000.0);
+}
+
+static void benchmarkAirtime() {
+    uint32_t datagrams;
+    double broadcast = replay(0, true, datagrams);
+    printf("Telemetry airtime per second (and share of the channel):\n");
+    printf("  broadcast @1M:          %6.1f ms (%4.1f%%), %5.1f datagrams/s, to any number of listeners\n",
+           broadcast / 1000, broadcast / 10000, datagrams / 60.0);
+
+    static const uint8_t counts[] = {0, 1, 2, 4, 8};
+    double previous = -1;
+    for (size_t c = 0; c < sizeof(counts); c++) {
+        double unicast = replay(counts[c], false, datagrams);
+        printf("  unicast @54M, %u client%s: %6.1f ms (%4.1f%%), %5.1f datagrams/s\n",
+               counts[c], counts[c] == 1 ? " " : "s", unicast / 1000, unicast / 10000, datagrams / 60.0);
+        if (counts[c] == 0) CHECK(unicast == 0);
+        CHECK(unicast > previous);   // Grows with the clients...
+        CHECK(unicast < broadcast);  // ...and stays below broadcast even at the table's limit
+        previous = unicast;
+    }
+}
+
+int main() {
+    printf("=================================\n");
+    printf("OSC Subscribers Test\n");
+    printf("=================================\n");
+
+    testTopics();
+    testSubscribe();
+    testAutoRegistration();
+    testEviction();
+    testRateLimit();
+    testAppend();
+    benchmarkAirtime();
+
+    if (failures == 0) {
+        printf("All OSC subscriber tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
@@ -0,0 +1,259 @@
+/**
+ * Host Test and Benchmark for Parameter Coalescing
+ * Checks the last-value-wins table (first change at once, then the
+ * control rate; values held while there's no credit or the lane is full),
+ * then plays a control surface streaming several faders into the ESP at
+ * more than the 115200 baud link carries, and compares forwarding every
+ * message with coalescing: frames sent and lost, and how far behind the
+ * faders the Teensy plays
+ *
+ * Time is simulated in 1ms ticks, with the ESP's 128 byte UART FIFO
+ * draining at the line rate.
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_param_coalescer.cpp -o test_param_coalescer
+ *   ./test_param_coalescer
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "param_coalescer.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+#define BYTES_PER_MS (115200 / 10 / 1000.0)
+#define UART_FIFO_BYTES 128
+#define RUN_MS 10000
+#define FADERS 5                 // Parameters moving at once
+#define FADER_EVERY_MS 4         // Each sends 250 messages/s
+
+// Everything the Teensy would decode from a queue, drained as the UART
+// allows; remembers the last value per parameter and what arrived in the
+// latest tick
+struct Teensy {
+    LinkDecoder decoder;
+    float values[LINK_NUM_PARAMS];
+    uint32_t frames;
+    double budget;
+    size_t fifo;
+    LinkSetParam arrived[UART_FIFO_BYTES];
+    size_t arrivedCount;
+
+    Teensy() : frames(0), budget(0), fifo(0), arrivedCount(0) {
+        for (uint8_t p = 0; p < LINK_NUM_PARAMS; p++) values[p] = NAN;
+    }
+
+    void tick(LinkTxQueue& queue) {
+        // The FIFO drains at the line rate; whatever leaves it arrives
+        budget += BYTES_PER_MS;
+        size_t drained = (size_t)budget < fifo ? (size_t)budget : fifo;
+        budget -= drained;
+        if (fifo == 0) budget = 0;  // An idle line saves nothing up
+        fifo -= drained;
+
+        uint8_t chunk[UART_FIFO_BYTES];
+        size_t n = queue.pull(chunk, UART_FIFO_BYTES - fifo);
+        arrivedCount = 0;
+        fifo += n;
+        for (size_t i = 0; i < n; i++) {
+            // Bytes are decoded as they enter the FIFO; close enough at 1ms
+            if (!decoder.push(chunk[i])) continue;
+            LinkSetParam param;
+            if (decoder.get(param)) {
+                values[param.param] = param.value;
+                arrived[arrivedCount++] = param;
+                frames++;
+            }
+        }
+    }
+};
+
+static void testTable() {
+    ParamCoalescer coalescer;
+    LinkTxQueue queue;
+    CHECK(!coalescer.isPending());
+    CHECK(!coalescer.set(0, 1.0f) && !coalescer.set(LINK_NUM_PARAMS, 1.0f));
+    CHECK(!coalescer.set(LINK_PARAM_REVERB, NAN));
+    CHECK(coalescer.getReceived() == 0);
+
+    // First change goes straight out, clamped
+    CHECK(coalescer.set(LINK_PARAM_REVERB, 150.0f));
+    CHECK(coalescer.flush(0, queue) == 1);
+    CHECK(queue.depth(LINK_LANE_COMMAND) > 0 && !coalescer.isPending());
+
+    // Within the interval values wait, and only the newest of each goes
+    CHECK(coalescer.set(LINK_PARAM_REVERB, 10.0f));
+    CHECK(coalescer.set(LINK_PARAM_REVERB, 20.0f));
+    CHECK(coalescer.set(LINK_PARAM_FILTER, 800.0f));
+    CHECK(coalescer.set(LINK_PARAM_REVERB, 30.0f));
+    CHECK(coalescer.flush(1, queue) == 0);
+    CHECK(coalescer.flush(PARAM_COALESCE_INTERVAL_MS - 1, queue) == 0);
+    CHECK(coalescer.flush(PARAM_COALESCE_INTERVAL_MS, queue) == 2);
+    CHECK(coalescer.getReceived() == 5 && coalescer.getForwarded() == 3 && coalescer.getSuperseded() == 2);
+
+    Teensy teensy;
+    for (int i = 0; i < 10; i++) teensy.tick(queue);
+    CHECK(teensy.frames == 3);
+    CHECK(teensy.values[LINK_PARAM_REVERB] == 30.0f && teensy.values[LINK_PARAM_FILTER] == 800.0f);
+
+    // No credit from the Teensy: values stay in the table
+    LinkTxQueue stalled;
+    LinkFlow flow(512);
+    LinkCredit none = {0, 0};
+    flow.onCredit(none);
+    LinkSetParam filler = {LINK_PARAM_ROOT, 0.0f};
+    stalled.send(filler, LINK_LANE_COMMAND);
+    uint8_t out[64];
+    CHECK(stalled.pull(out, sizeof(out), &flow, 0) == 0 && stalled.waitingForCredit());
+    ParamCoalescer waiting;
+    waiting.set(LINK_PARAM_DELAY, 40.0f);
+    CHECK(waiting.flush(0, stalled) == 0 && waiting.isPending());
+
+    // A full command lane: what doesn't fit stays pending, nothing lost
+    LinkTxQueue full;
+    while (full.send(filler, LINK_LANE_COMMAND)) {}
+    ParamCoalescer held;
+    held.set(LINK_PARAM_DELAY, 40.0f);
+    CHECK(held.flush(100, full) == 0 && held.isPending());
+    Teensy drain;
+    for (int i = 0; i < 200; i++) drain.tick(full);
+    CHECK(held.flush(200, full) == 1 && !held.isPending());
+    for (int i = 0; i < 10; i++) drain.tick(full);
+    CHECK(drain.values[LINK_PARAM_DELAY] == 40.0f);
+}
+
+struct Result {
+    uint32_t received;
+    uint32_t queued;
+    uint32_t refused;
+    uint32_t delivered;
+    double lagAvgMs;       // Age of the value the Teensy is playing, while faders move
+    uint32_t lagMaxMs;
+    bool finalMatch;
+};
+
+static const uint8_t faders[FADERS] = {
+    LINK_PARAM_FILTER, LINK_PARAM_RESONANCE, LINK_PARAM_REVERB, LINK_PARAM_LFO_RATE, LINK_PARAM_DETUNE
+};
+
+// Fader f's position at time t: a 2s sweep, offset per fader
+static float faderValue(uint8_t f, uint32_t t) {
+    const LinkParamInfo* info = linkParamInfo(faders[f]);
+    float phase = (float)((t + f * 137) % 2000) / 2000.0f;
+    float value = 0;
+    linkParamClamp(faders[f], info->min + (info->max - info->min) * phase, value);
+    return value;
+}
+
+static bool sendsAt(uint8_t f, uint32_t t) { return t < RUN_MS && (t + f) % FADER_EVERY_MS == 0; }
+
+// When a value the Teensy received was sent by its fader
+static uint32_t sentAt(uint8_t f, float value, uint32_t now) {
+    for (uint32_t t = now; t + 2000 > now && t != (uint32_t)-1; t--) {
+        if (sendsAt(f, t) && faderValue(f, t) == value) return t;
+    }
+    return now;
+}
+
+static Result run(bool coalesce) {
+    LinkTxQueue queue;
+    ParamCoalescer coalescer;
+    Teensy teensy;
+    Result result = {0, 0, 0, 0, 0, 0, true};
+
+    uint32_t playingSince[FADERS];   // When the Teensy's current value was sent
+    bool playing[FADERS];
+    for (uint8_t f = 0; f < FADERS; f++) playing[f] = false;
+    uint64_t lagSum = 0;
+    uint32_t lagSamples = 0;
+
+    // The faders stop a second before the end, so everything can settle
+    for (uint32_t now = 0; now < RUN_MS + 1000; now++) {
+        for (uint8_t f = 0; f < FADERS; f++) {
+            if (!sendsAt(f, now)) continue;
+            float value = faderValue(f, now);
+            result.received++;
+            if (coalesce) {
+                coalescer.set(faders[f], value);
+            } else {
+                LinkSetParam message = {faders[f], value};
+                if (queue.send(message, LINK_LANE_COMMAND)) result.queued++;
+                else result.refused++;
+            }
+        }
+        if (coalesce) result.queued += coalescer.flush(now, queue);
+        teensy.tick(queue);
+
+        for (size_t i = 0; i < teensy.arrivedCount; i++) {
+            for (uint8_t f = 0; f < FADERS; f++) {
+                if (teensy.arrived[i].param != faders[f]) continue;
+                playingSince[f] = sentAt(f, teensy.arrived[i].value, now);
+                playing[f] = true;
+            }
+        }
+        if (now >= RUN_MS) continue;
+        for (uint8_t f = 0; f < FADERS; f++) {
+            if (!playing[f]) continue;
+            uint32_t lag = now - playingSince[f];
+            lagSum += lag;
+            lagSamples++;
+            if (lag > result.lagMaxMs) result.lagMaxMs = lag;
+        }
+    }
+
+    // Each fader's last position is what the synth ends up on
+    for (uint8_t f = 0; f < FADERS; f++) {
+        uint32_t last = RUN_MS - 1;
+        while (!sendsAt(f, last)) last--;
+        if (teensy.values[faders[f]] != faderValue(f, last)) result.finalMatch = false;
+    }
+    result.delivered = teensy.frames;
+    result.lagAvgMs = lagSamples ? (double)lagSum / lagSamples : 0.0;
+    if (coalesce) CHECK(coalescer.getReceived() == result.received && coalescer.getForwarded() == result.queued);
+    return result;
+}
+
+static void benchmarkFaders() {
+    Result direct = run(false);
+    Result coalesced = run(true);
+    double seconds = RUN_MS / 1000.0;
+
+    printf("%d faders at %d msg/s each for %.0fs, 115200 baud (~%.0f param frames/s max):\n",
+           FADERS, 1000 / FADER_EVERY_MS, seconds, BYTES_PER_MS * 1000 / 10);
+    const Result* results[2] = {&direct, &coalesced};
+    const char* names[2] = {"every message", "coalesced"};
+    for (int i = 0; i < 2; i++) {
+        const Result& r = *results[i];
+        printf("  %-13s: %5.0f msg/s in, %5.0f frames/s sent, %5u refused, lag avg %5.1fms max %3ums, final %s\n",
+               names[i], r.received / seconds, r.delivered / seconds, r.refused, r.lagAvgMs, r.lagMaxMs,
+               r.finalMatch ? "ok" : "WRONG");
+    }
+
+    // Forwarding everything overflows the lane, loses commands and can
+    // leave the synth on an old value; coalescing never does
+    CHECK(direct.refused > 0);
+    CHECK(coalesced.refused == 0 && coalesced.finalMatch);
+    CHECK(coalesced.delivered < coalesced.received / 2);
+    CHECK(coalesced.lagMaxMs <= 2 * PARAM_COALESCE_INTERVAL_MS);
+    CHECK(coalesced.lagAvgMs < direct.lagAvgMs);
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Parameter Coalescing Test\n");
+    printf("=================================\n");
+
+    testTable();
+    benchmarkFaders();
+
+    if (failures == 0) {
+        printf("All parameter coalescing tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
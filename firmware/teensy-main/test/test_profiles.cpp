@@ -0,0 +1,170 @@
+/**
+ * Host Test for Controller Profile Parsers
+ * Checks each layout's decoder against hand-built reports and measures
+ * how many reports per second each specialised parser handles
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -DSUPPORT_PS3=true -DSUPPORT_WII=true -Iinclude \
+ *       test/test_profiles.cpp -o test_profiles
+ *   ./test_profiles
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "controller_profiles.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static const ControllerProfile* profileFor(uint16_t vid, uint16_t pid) {
+    const ControllerProfile* profile = findControllerProfile(vid, pid);
+    CHECK(profile != nullptr);
+    return profile;
+}
+
+static void testXInputGuitar() {
+    const ControllerProfile* profile = profileFor(XBOX360_VID, XBOX360_PID_GH_GUITAR);
+    if (!profile) return;
+
+    uint8_t report[20] = {0x00, 0x14};
+    GHControllerState state;
+
+    // Green (A) + orange (LB) + strum down + back (star power)
+    report[2] = 0x02 | 0x20;
+    report[3] = 0x10 | 0x01;
+    report[10] = 0x00; report[11] = 0x80;  // Whammy at rest (-32768)
+    report[12] = 0xFF; report[13] = 0x7F;  // Tilt fully up
+    profile->decode(report, state);
+    CHECK(state.greenFret && state.orangeFret);
+    CHECK(!state.redFret && !state.yellowFret && !state.blueFret);
+    CHECK(state.strumDown && !state.strumUp);
+    CHECK(state.starPower && !state.plusButton && !state.minusButton);
+    CHECK(state.whammyBar == 0);
+    CHECK(state.tiltY == 32767);
+    CHECK(state.pickupSelector == 0);
+
+    // Red/yellow/blue (B/Y/X) + strum up-left + guide, whammy fully pressed
+    report[2] = 0x01 | 0x04;
+    report[3] = 0x20 | 0x80 | 0x40 | 0x04;
+    report[10] = 0xFF; report[11] = 0x7F;
+    report[4] = 200;
+    profile->decode(report, state);
+    CHECK(!state.greenFret && state.redFret && state.yellowFret && state.blueFret && !state.orangeFret);
+    CHECK(state.strumUp && state.dpadLeft && !state.dpadRight);
+    CHECK(state.minusButton && !state.starPower);
+    CHECK(state.whammyBar == 255);
+    CHECK(state.pickupSelector == 2);
+    CHECK(state.buttonsRaw == (0xE4 << 8 | 0x05));
+
+    // The X-plorer shares the layout
+    CHECK(profileFor(XBOX360_VID, XBOX360_PID_GH_XPLORER)->decode == profile->decode);
+}
+
+static void testXInputPad() {
+    const ControllerProfile* profile = profileFor(MSFT_VID, MSFT_PID_XBOX360);
+    if (!profile) return;
+
+    uint8_t report[20] = {0x00, 0x14};
+    GHControllerState state;
+    report[4] = 100;                       // Pickup middle
+    report[5] = 180;                       // Whammy on right trigger
+    report[6] = 0x00; report[7] = 0xC0;    // Tilt on left stick X
+    report[8] = 0x34; report[9] = 0x12;
+    profile->decode(report, state);
+    CHECK(state.whammyBar == 180);
+    CHECK(state.pickupSelector == 1);
+    CHECK(state.tiltX == -16384);
+    CHECK(state.tiltY == 0x1234);
+}
+
+static void testPS3AndWii() {
+    const ControllerProfile* ps3 = profileFor(PS3_GH_VID, PS3_GH_PID_GUITAR);
+    const ControllerProfile* wii = profileFor(WII_RB_VID, WII_RB_PID_GUITAR);
+    if (!ps3 || !wii) return;
+    CHECK(ps3->decode == wii->decode);
+
+    uint8_t report[27] = {0};
+    GHControllerState state;
+
+    // Every hat position
+    static const uint8_t expected[9][4] = {
+        {1, 0, 0, 0}, {1, 0, 0, 1}, {0, 0, 0, 1}, {0, 1, 0, 1},
+        {0, 1, 0, 0}, {0, 1, 1, 0}, {0, 0, 1, 0}, {1, 0, 1, 0}, {0, 0, 0, 0}
+    };
+    for (uint8_t hat = 0; hat <= 8; hat++) {
+        report[2] = hat;
+        ps3->decode(report, state);
+        CHECK(state.dpadUp == expected[hat][0]);
+        CHECK(state.dpadDown == expected[hat][1]);
+        CHECK(state.dpadLeft == expected[hat][2]);
+        CHECK(state.dpadRight == expected[hat][3]);
+        CHECK(state.strumUp == state.dpadUp && state.strumDown == state.dpadDown);
+    }
+
+    // Green + blue + select, whammy half, pickup high, tilt centred
+    report[0] = 0x02 | 0x01;
+    report[1] = 0x01;
+    report[5] = 128;
+    report[6] = 255;
+    report[19] = 0x00; report[20] = 0x02;  // 512 = level
+    ps3->decode(report, state);
+    CHECK(state.greenFret && state.blueFret && !state.redFret);
+    CHECK(state.starPower);
+    CHECK(state.whammyBar == 128);
+    CHECK(state.pickupSelector == 2);
+    CHECK(state.tiltX == 0);
+}
+
+static void testUnknownDevice() {
+    CHECK(findControllerProfile(0x046D, 0xC21D) == nullptr);  // Logitech pad
+}
+
+static void benchmark() {
+    const uint32_t REPORTS = 20000000;
+    uint8_t reports[16][32];
+    for (int r = 0; r < 16; r++) {
+        for (int i = 0; i < 32; i++) reports[r][i] = (uint8_t)(r * 37 + i * 11);
+    }
+
+    printf("\nProfile parser throughput (%u reports each):\n", REPORTS);
+    for (unsigned p = 0; p < NUM_CONTROLLER_PROFILES; p++) {
+        const ControllerProfile& profile = controllerProfiles[p];
+        GHControllerState state;
+        uint32_t checksum = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < REPORTS; i++) {
+            profile.decode(reports[i & 15], state);
+            checksum += state.buttonsRaw + state.whammyBar + state.greenFret;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        printf("  %-34s %8.1f M reports/s  (%.2f ns/report, checksum %08X)\n",
+               profile.name, REPORTS / seconds / 1e6, seconds * 1e9 / REPORTS, checksum);
+    }
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Controller Profile Test\n");
+    printf("=================================\n");
+
+    testXInputGuitar();
+    testXInputPad();
+    testPS3AndWii();
+    testUnknownDevice();
+
+    if (failures == 0) {
+        printf("All profile tests passed\n");
+    } else {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+
+    benchmark();
+    return 0;
+}
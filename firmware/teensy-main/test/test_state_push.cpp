@@ -0,0 +1,184 @@
+/**
+ * Host Test and Benchmark for the Browser State Push
+ * Checks the JSON deltas and snapshots, coalescing and the periodic
+ * refresh, then replays a busy playing session (link deltas every 10ms)
+ * to measure the update latency pushing adds and the traffic per
+ * connected browser, against polling /status once a second
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_state_push.cpp -o test_state_push
+ *   ./test_state_push
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "state_push.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static LinkState sampleState() {
+    LinkState state;
+    memset(&state, 0, sizeof(state));
+    state.connected = 1;
+    state.scale = 2;
+    state.root = 9;
+    state.octave = -1;
+    state.voices = 3;
+    state.cpuTenths = 412;
+    state.memBlocks = 18;
+    state.totalNotes = 4294967295u;
+    state.loopMaxUs = 1234567;
+    return state;
+}
+
+static void testFormat() {
+    LinkState state = sampleState();
+    char text[STATE_PUSH_MAX_TEXT];
+
+    size_t len = StatePush::format(state, (1 << LINK_FIELD_CPU) | (1 << LINK_FIELD_VOICES), false, text, sizeof(text));
+    CHECK(len == strlen(text));
+    CHECK(strcmp(text, "{\"voices\":3,\"cpu\":41.2}") == 0);
+
+    len = StatePush::format(state, 1 << LINK_FIELD_OCTAVE, false, text, sizeof(text));
+    CHECK(strcmp(text, "{\"octave\":-1}") == 0);
+
+    state.cpuTenths = 5;
+    len = StatePush::format(state, 1 << LINK_FIELD_CPU, false, text, sizeof(text));
+    CHECK(strcmp(text, "{\"cpu\":0.5}") == 0);
+
+    // Snapshot: every field, largest values still fit the buffer
+    state = sampleState();
+    state.octave = -128;
+    state.cpuTenths = 65535;
+    state.memBlocks = 65535;
+    len = StatePush::format(state, LINK_FIELDS_ALL, true, text, sizeof(text));
+    CHECK(len > 0 && len < STATE_PUSH_MAX_TEXT);
+    CHECK(strncmp(text, "{\"full\":1,\"connected\":1,", 24) == 0);
+    CHECK(strstr(text, "\"notes\":4294967295,\"loopUs\":1234567}") != NULL);
+    printf("Largest snapshot: %zu bytes\n", len);
+
+    // Nothing changed is an empty object; too small a buffer is 0
+    CHECK(StatePush::format(state, 0, false, text, sizeof(text)) == 2);
+    CHECK(StatePush::format(state, LINK_FIELDS_ALL, true, text, 40) == 0);
+}
+
+static void testCoalescing() {
+    StatePush push;
+    LinkState state = sampleState();
+    char text[STATE_PUSH_MAX_TEXT];
+
+    // First change after a quiet spell goes straight out
+    push.changed(1 << LINK_FIELD_SCALE);
+    CHECK(push.poll(100, state, text, sizeof(text)) > 0);
+    CHECK(strcmp(text, "{\"scale\":2}") == 0);
+
+    // A burst inside the interval becomes one message with every field
+    push.changed(1 << LINK_FIELD_CPU);
+    CHECK(push.poll(110, state, text, sizeof(text)) == 0);
+    push.changed(1 << LINK_FIELD_VOICES);
+    CHECK(push.poll(149, state, text, sizeof(text)) == 0);
+    CHECK(push.poll(150, state, text, sizeof(text)) > 0);
+    CHECK(strcmp(text, "{\"voices\":3,\"cpu\":41.2}") == 0);
+
+    // Nothing pending, nothing sent...
+    CHECK(push.poll(1000, state, text, sizeof(text)) == 0);
+
+    // ...until the refresh, which is a full snapshot
+    CHECK(push.poll(STATE_PUSH_REFRESH_MS, state, text, sizeof(text)) > 0);
+    CHECK(strncmp(text, "{\"full\":1", 9) == 0);
+    CHECK(push.getPushCount() == 3 && push.getSnapshotCount() == 1);
+}
+
+// Busy playing: CPU/voices/notes change on nearly every 10ms link delta,
+// plus the occasional scale or octave change
+static void benchmarkSession() {
+    const uint32_t runMs = 60000;
+    StatePush push;
+    LinkState state = sampleState();
+    char text[STATE_PUSH_MAX_TEXT];
+
+    uint32_t changedAt = 0;      // Oldest unpushed change
+    bool waiting = false;
+    uint64_t latencySum = 0;
+    uint32_t latencyMax = 0;
+    uint32_t changes = 0;
+    uint32_t seed = 12345;
+
+    for (uint32_t now = 0; now < runMs; now++) {
+        if (now % 10 == 0) {
+            seed = seed * 1103515245 + 12345;
+            uint16_t mask = (1 << LINK_FIELD_CPU) | (1 << LINK_FIELD_TOTAL_NOTES);
+            if (seed & 0x100) mask |= 1 << LINK_FIELD_VOICES;
+            if ((seed >> 16) % 500 == 0) mask |= 1 << LINK_FIELD_SCALE;
+            state.cpuTenths = 300 + (seed >> 20) % 200;
+            state.totalNotes++;
+            push.changed(mask);
+            changes++;
+            if (!waiting) {
+                waiting = true;
+                changedAt = now;
+            }
+        }
+
+        if (push.poll(now, state, text, sizeof(text)) > 0 && waiting) {
+            uint32_t latency = now - changedAt;
+            latencySum += latency;
+            if (latency > latencyMax) latencyMax = latency;
+            waiting = false;
+        }
+    }
+
+    uint32_t pushes = push.getPushCount();
+    double seconds = runMs / 1000.0;
+    printf("Busy session, %u link deltas over %.0fs:\n", changes, seconds);
+    printf("  push:    %.1f msg/s, %.0f B/s per browser, added latency avg %.1fms max %ums\n",
+           pushes / seconds, push.getBytesPushed() / seconds, (double)latencySum / pushes, latencyMax);
+
+    // Polling /status at 1Hz: one connection and a full rebuild per poll,
+    // a change waits half a poll on average
+    size_t statusBody = StatePush::format(state, LINK_FIELDS_ALL, true, text, sizeof(text));
+    printf("  polling: 1.0 msg/s + 1 TCP connection/s, %zu B body per poll, latency avg 500ms max 1000ms\n",
+           statusBody);
+
+    CHECK(latencyMax <= STATE_PUSH_INTERVAL_MS);
+    CHECK(pushes <= runMs / STATE_PUSH_INTERVAL_MS + runMs / STATE_PUSH_REFRESH_MS + 1);
+    CHECK(push.getSnapshotCount() == (runMs - 1) / STATE_PUSH_REFRESH_MS);
+}
+
+static void benchmarkFormat() {
+    const int rounds = 1000000;
+    LinkState state = sampleState();
+    char text[STATE_PUSH_MAX_TEXT];
+    size_t total = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        state.cpuTenths = i & 1023;
+        total += StatePush::format(state, (1 << LINK_FIELD_CPU) | (1 << LINK_FIELD_VOICES), false, text, sizeof(text));
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("Delta formatting: %.0f msg/s on this host (%zu bytes)\n", rounds / seconds, total);
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Browser State Push Test\n");
+    printf("=================================\n");
+
+    testFormat();
+    testCoalescing();
+    benchmarkSession();
+    benchmarkFormat();
+
+    if (failures == 0) {
+        printf("All state push tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
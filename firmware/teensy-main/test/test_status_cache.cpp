@@ -0,0 +1,316 @@
+/**
+ * Host Test and Load Test for the Status Cache
+ * Checks when the cached text is reformatted (invalidate, max age), that
+ * a too-long state keeps the last text, JSON string escaping, and that
+ * text handed out stays intact across the next reformat; then serves the
+ * OSC sketch's /api/status as fast as it can, the old way (a String
+ * concatenated per request) against the cache, with the synth state
+ * changing every few requests, and reports requests/s and what each
+ * does to the heap
+ *
+ * The heap is watched by replacing operator new/delete, so the String
+ * stand-in (std::string) is counted; allocations and live bytes are
+ * sampled as the run goes.
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_status_cache.cpp -o test_status_cache
+ *   ./test_status_cache
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <new>
+#include <chrono>
+#include "status_cache.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+#define REQUESTS 200000
+#define REQUESTS_PER_CHANGE 8     // Polled faster than the state changes
+#define HEAP_SAMPLES 5
+
+// ---- Heap accounting
+
+static size_t heapLive = 0;
+static size_t heapPeak = 0;
+static unsigned long heapAllocs = 0;
+
+void* operator new(size_t size) {
+    size_t* block = (size_t*)malloc(size + sizeof(size_t) * 2);
+    if (!block) throw std::bad_alloc();
+    block[0] = size;
+    heapLive += size;
+    heapAllocs++;
+    if (heapLive > heapPeak) heapPeak = heapLive;
+    return block + 2;
+}
+
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    size_t* block = (size_t*)p - 2;
+    heapLive -= block[0];
+    free(block);
+}
+
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+// ---- The OSC sketch's state and its two formatters
+
+struct SynthState {
+    uint8_t currentScale;
+    char scaleName[32];
+    char rootName[8];
+    int8_t octave;
+    bool arpActive;
+    uint8_t lastNote;
+    bool noteOn;
+    float cpuUsage;
+    uint16_t memUsage;
+    uint32_t totalNotes;
+    uint32_t latency;
+    uint8_t oscClients;
+};
+
+static const char* const scaleNames[] = {"Major Pentatonic", "Minor Pentatonic", "Blues", "Japanese (In Sen)"};
+static const char* const noteNames[12] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+
+// What playing does to it
+static void change(SynthState& state, uint32_t step) {
+    state.lastNote = 40 + step % 24;
+    state.noteOn = step & 1;
+    state.cpuUsage = 20.0f + (step % 173) / 10.0f;
+    state.memUsage = 10 + step % 7;
+    state.totalNotes = step / 2;
+    state.latency = 300 + step % 900;
+    if (step % 64 == 0) {
+        state.currentScale = (step / 64) % 4;
+        strcpy(state.scaleName, scaleNames[state.currentScale]);
+        strcpy(state.rootName, noteNames[(step / 64) % 12]);
+    }
+}
+
+static std::string num(unsigned long v) { return std::to_string(v); }
+
+// The old handleStatus(): String temporaries concatenated per request
+static std::string formatConcatenated(const SynthState& state) {
+    char cpu[16];
+    snprintf(cpu, sizeof(cpu), "%.1f", state.cpuUsage);
+    std::string json = "{";
+    json += "\"noteOn\":" + std::string(state.noteOn ? "true" : "false") + ",";
+    json += "\"lastNote\":" + num(state.lastNote) + ",";
+    json += "\"noteName\":\"" + std::string(state.rootName) + "\",";
+    json += "\"cpu\":" + std::string(cpu) + ",";
+    json += "\"mem\":" + num(state.memUsage) + ",";
+    json += "\"latency\":" + num(state.latency) + ",";
+    json += "\"notes\":" + num(state.totalNotes) + ",";
+    json += "\"scale\":\"" + std::string(state.scaleName) + "\",";
+    json += "\"root\":\"" + std::string(state.rootName) + "\",";
+    json += "\"octave\":" + std::to_string((int)state.octave) + ",";
+    json += "\"arp\":" + std::string(state.arpActive ? "true" : "false") + ",";
+    json += "\"oscClients\":" + num(state.oscClients);
+    json += "}";
+    return json;
+}
+
+// The sketch's formatStatus()
+static size_t formatCached(char* out, size_t max, void* context) {
+    const SynthState& state = *(const SynthState*)context;
+    size_t len = 0;
+    unsigned cpuTenths = (unsigned)(state.cpuUsage * 10.0f + 0.5f);
+    bool ok = jsonAppend(out, max, len, "{\"noteOn\":%s,\"lastNote\":%u,\"noteName\":",
+                                  state.noteOn ? "true" : "false", state.lastNote);
+    ok = ok && jsonAppendString(out, max, len, state.rootName);
+    ok = ok && jsonAppend(out, max, len, ",\"cpu\":%u.%u,\"mem\":%u,\"latency\":%lu,\"notes\":%lu,\"scale\":",
+                                   cpuTenths / 10, cpuTenths % 10, state.memUsage,
+                                   (unsigned long)state.latency, (unsigned long)state.totalNotes);
+    ok = ok && jsonAppendString(out, max, len, state.scaleName);
+    ok = ok && jsonAppend(out, max, len, ",\"root\":");
+    ok = ok && jsonAppendString(out, max, len, state.rootName);
+    ok = ok && jsonAppend(out, max, len, ",\"octave\":%d,\"arp\":%s,\"oscClients\":%u}",
+                                   state.octave, state.arpActive ? "true" : "false", state.oscClients);
+    return ok ? len : 0;
+}
+
+// ---- Tests
+
+struct Counter {
+    unsigned calls;
+    const char* text;
+};
+
+static size_t formatCounter(char* out, size_t max, void* context) {
+    Counter* counter = (Counter*)context;
+    counter->calls++;
+    size_t len = 0;
+    if (!jsonAppend(out, max, len, "{\"n\":%u,\"text\":", counter->calls)) return 0;
+    if (!jsonAppendString(out, max, len, counter->text)) return 0;
+    return jsonAppend(out, max, len, "}") ? len : 0;
+}
+
+static void testCache() {
+    Counter counter = {0, "a"};
+    StatusCache cache(formatCounter, &counter);
+    size_t len = 0;
+
+    // Formatted on the first request, then served as it is
+    const char* text = cache.get(0, len);
+    CHECK(counter.calls == 1 && strcmp(text, "{\"n\":1,\"text\":\"a\"}") == 0 && len == strlen(text));
+    CHECK(cache.get(100000, len) == text && counter.calls == 1);
+
+    // Reformatted after invalidate(), into the other buffer: the text a
+    // response may still be sending stays as it was
+    cache.invalidate();
+    const char* next = cache.get(1, len);
+    CHECK(counter.calls == 2 && next != text);
+    CHECK(strcmp(text, "{\"n\":1,\"text\":\"a\"}") == 0);
+    CHECK(strcmp(next, "{\"n\":2,\"text\":\"a\"}") == 0);
+    CHECK(cache.getRequests() == 3 && cache.getRebuilds() == 2);
+
+    // Max age: reformatted when that old even without invalidate()
+    Counter aged = {0, "b"};
+    StatusCache ageing(formatCounter, &aged, 250);
+    ageing.get(1000, len);
+    ageing.get(1249, len);
+    CHECK(aged.calls == 1);
+    ageing.get(1250, len);
+    CHECK(aged.calls == 2);
+
+    // A state too long for the buffer keeps the last text that fit
+    char longText[STATUS_CACHE_MAX_TEXT + 1];
+    memset(longText, 'x', STATUS_CACHE_MAX_TEXT);
+    longText[STATUS_CACHE_MAX_TEXT] = 0;
+    counter.text = longText;
+    cache.invalidate();
+    text = cache.get(2, len);
+    CHECK(strcmp(text, "{\"n\":2,\"text\":\"a\"}") == 0 && len == strlen(text));
+    CHECK(cache.getOverflows() == 1);
+
+    // Escaping
+    char out[64];
+    size_t n = 0;
+    CHECK(jsonAppendString(out, sizeof(out), n, "say \"hi\"\\\n"));
+    CHECK(strcmp(out, "\"say \\\"hi\\\"\\\\\\u000a\"") == 0 && n == strlen(out));
+    n = 0;
+    CHECK(!jsonAppendString(out, 8, n, "12345678"));
+    n = 0;
+    CHECK(jsonAppendString(out, 8, n, "12345") && n == 7);
+}
+
+// Same text both ways, for a spread of states
+static void testSameJson() {
+    SynthState state;
+    memset(&state, 0, sizeof(state));
+    StatusCache cache(formatCached, &state);
+    for (uint32_t step = 0; step < 2000; step += 7) {
+        change(state, step);
+        state.octave = (int8_t)(step % 5) - 2;
+        state.arpActive = step & 2;
+        cache.invalidate();
+        size_t len;
+        const char* text = cache.get(step, len);
+        CHECK(formatConcatenated(state) == std::string(text, len));
+    }
+}
+
+struct LoadResult {
+    double requestsPerSec;
+    double allocsPerRequest;
+    size_t liveAtStart;
+    size_t liveMin;
+    size_t liveMax;
+    size_t peakExtra;          // Above where it started
+    size_t bytesSent;
+};
+
+static LoadResult load(bool cached) {
+    SynthState state;
+    memset(&state, 0, sizeof(state));
+    change(state, 0);
+    StatusCache cache(formatCached, &state);
+
+    LoadResult result;
+    result.liveAtStart = heapLive;
+    result.liveMin = (size_t)-1;
+    result.liveMax = 0;
+    result.bytesSent = 0;
+    unsigned long allocsBefore = heapAllocs;
+    heapPeak = heapLive;
+
+    char sent[STATUS_CACHE_MAX_TEXT];   // Where the response's bytes go
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < REQUESTS; i++) {
+        if (i % REQUESTS_PER_CHANGE == 0) {
+            change(state, i / REQUESTS_PER_CHANGE);
+            cache.invalidate();
+        }
+        if (cached) {
+            size_t len;
+            const char* text = cache.get(i, len);
+            memcpy(sent, text, len);
+            result.bytesSent += len;
+        } else {
+            std::string json = formatConcatenated(state);
+            memcpy(sent, json.data(), json.size() < sizeof(sent) ? json.size() : sizeof(sent));
+            result.bytesSent += json.size();
+        }
+        // Between requests, as a heap monitor would see it
+        if (i % (REQUESTS / HEAP_SAMPLES) == 0) {
+            if (heapLive < result.liveMin) result.liveMin = heapLive;
+            if (heapLive > result.liveMax) result.liveMax = heapLive;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    result.requestsPerSec = REQUESTS / seconds;
+    result.allocsPerRequest = (double)(heapAllocs - allocsBefore) / REQUESTS;
+    result.peakExtra = heapPeak - result.liveAtStart;
+    if (cached) CHECK(cache.getRebuilds() == REQUESTS / REQUESTS_PER_CHANGE);
+    return result;
+}
+
+static void loadTest() {
+    LoadResult concatenated = load(false);
+    LoadResult cached = load(true);
+
+    printf("/api/status, %d requests, state changing every %d:\n", REQUESTS, REQUESTS_PER_CHANGE);
+    const LoadResult* results[2] = {&concatenated, &cached};
+    const char* names[2] = {"String concat", "cached"};
+    for (int i = 0; i < 2; i++) {
+        const LoadResult& r = *results[i];
+        printf("  %-13s: %9.0f req/s, %5.1f allocs/req, peak +%4zu heap bytes, live %zu..%zu between requests\n",
+               names[i], r.requestsPerSec, r.allocsPerRequest, r.peakExtra, r.liveMin, r.liveMax);
+    }
+
+    CHECK(concatenated.allocsPerRequest > 1);
+    CHECK(concatenated.peakExtra > 0);
+    CHECK(concatenated.bytesSent == cached.bytesSent);
+
+    // Flat: nothing allocated, ever
+    CHECK(cached.allocsPerRequest == 0);
+    CHECK(cached.peakExtra == 0);
+    CHECK(cached.liveMin == cached.liveAtStart && cached.liveMax == cached.liveAtStart);
+    CHECK(cached.requestsPerSec > concatenated.requestsPerSec);
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Status Cache Test\n");
+    printf("=================================\n");
+
+    testCache();
+    testSameJson();
+    loadTest();
+
+    if (failures == 0) {
+        printf("All status cache tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
@@ -0,0 +1,86 @@
+/**
+ * Host Test for the Strum Engine
+ * Checks chord ordering per direction and how the per-string spread
+ * follows strum speed
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_strum.cpp src/strum_engine.cpp -o test_strum
+ *   ./test_strum
+ */
+
+#include <stdio.h>
+#include "strum_engine.h"
+#include "config.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static uint32_t samples(uint32_t us) {
+    return (uint32_t)((uint64_t)us * AUDIO_SAMPLE_RATE / 1000000);
+}
+
+static void testOrdering() {
+    StrumEngine engine;
+    StrumNote notes[STRUM_MAX_NOTES];
+
+    // Green + yellow + orange, isolated down strum: low to high, full spread
+    uint8_t count = engine.plan(STRUM_DOWN, 1000000, 0x15, notes);
+    CHECK(count == 3);
+    CHECK(notes[0].fret == 0 && notes[1].fret == 2 && notes[2].fret == 4);
+    CHECK(notes[0].offsetSamples == 0);
+    CHECK(notes[1].offsetSamples == samples(STRUM_SPREAD_US));
+    CHECK(notes[2].offsetSamples == 2 * samples(STRUM_SPREAD_US));
+
+    // Same chord, slow up strum: high to low, up-stroke spread
+    engine.reset();
+    count = engine.plan(STRUM_UP, 2000000, 0x15, notes);
+    CHECK(count == 3);
+    CHECK(notes[0].fret == 4 && notes[1].fret == 2 && notes[2].fret == 0);
+    CHECK(engine.getLastSpread() == STRUM_SPREAD_US * STRUM_UPSTROKE_PERCENT / 100);
+
+    // No frets, no notes
+    CHECK(engine.plan(STRUM_DOWN, 3000000, 0, notes) == 0);
+}
+
+static void testSpeed() {
+    StrumEngine engine;
+    StrumNote notes[STRUM_MAX_NOTES];
+
+    engine.plan(STRUM_DOWN, 0, 0x03, notes);
+    CHECK(engine.getLastSpread() == STRUM_SPREAD_US);
+
+    // Fast tremolo strumming tightens to the minimum
+    engine.plan(STRUM_DOWN, STRUM_FAST_INTERVAL_US / 2, 0x03, notes);
+    CHECK(engine.getLastSpread() == STRUM_SPREAD_US * STRUM_MIN_SPREAD_PERCENT / 100);
+
+    // Halfway between fast and slow lands halfway between the limits
+    uint32_t t = STRUM_FAST_INTERVAL_US / 2 + (STRUM_FAST_INTERVAL_US + STRUM_SLOW_INTERVAL_US) / 2;
+    engine.plan(STRUM_DOWN, t, 0x03, notes);
+    uint32_t mid = STRUM_SPREAD_US * (STRUM_MIN_SPREAD_PERCENT + (100 - STRUM_MIN_SPREAD_PERCENT) / 2) / 100;
+    CHECK(engine.getLastSpread() >= mid - STRUM_SPREAD_US / 100 && engine.getLastSpread() <= mid + STRUM_SPREAD_US / 100);
+
+    // Spread stays monotonic in interval across the micros() wrap
+    engine.reset();
+    engine.plan(STRUM_DOWN, 0xFFFFFF00u, 0x03, notes);
+    engine.plan(STRUM_DOWN, 0xFFFFFF00u + STRUM_SLOW_INTERVAL_US, 0x03, notes);
+    CHECK(engine.getLastSpread() == STRUM_SPREAD_US);
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Strum Engine Test\n");
+    printf("=================================\n");
+
+    testOrdering();
+    testSpeed();
+
+    if (failures == 0) {
+        printf("All strum tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
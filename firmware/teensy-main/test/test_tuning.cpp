@@ -0,0 +1,257 @@
+/**
+ * Host Test for the Tuning Engine
+ * Parses Scala scales and keyboard maps, checks the compiled phase
+ * increments, and times table compilation against note lookups
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_tuning.cpp src/tuning.cpp -o test_tuning
+ *   ./test_tuning
+ *
+ * Print the table for your own files:
+ *   ./test_tuning scale.scl [mapping.kbm]
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include "tuning.h"
+#include "config.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static double toHz(uint32_t increment) {
+    return increment * (double)AUDIO_SAMPLE_RATE / 4294967296.0;
+}
+
+static bool near(double actual, double expected) {
+    return fabs(actual - expected) < expected * 1e-6 + 1e-3;
+}
+
+static const char JUST_SCL[] =
+    "! just.scl\r\n"
+    "!\r\n"
+    "5-limit just major\r\n"
+    " 7\r\n"
+    "!\r\n"
+    " 9/8\r\n"
+    " 5/4\r\n"
+    " 4/3\r\n"
+    " 3/2\r\n"
+    " 5/3\r\n"
+    " 15/8\r\n"
+    " 2/1\r\n";
+
+// Bohlen-Pierce: 13 equal steps of the 3/1 tritave, mixed cents/ratio
+static const char BP_SCL[] =
+    "! bp.scl\n"
+    "Bohlen-Pierce equal\n"
+    "13\n"
+    "146.304 cents\n"
+    "292.608\n" "438.913\n" "585.217\n" "731.521\n" "877.825\n" "1024.130\n"
+    "1170.434\n" "1316.738\n" "1463.042\n" "1609.347\n" "1755.651\n"
+    "3\n";
+
+// Seven white keys per octave, black keys silent, A4 = 432Hz
+static const char WHITE_KBM[] =
+    "! white.kbm\n"
+    "12\n0\n127\n60\n69\n432.0\n7\n"
+    "0\nx\n1\nx\n2\n3\nx\n4\nx\n5\nx\n6\n";
+
+static void testEqualTemperament() {
+    TuningEngine engine;
+    CHECK(strcmp(engine.getDescription(), "12-TET") == 0);
+    for (int note = 0; note < TUNING_NOTES; note++) {
+        double expected = 440.0 * pow(2.0, (note - 69) / 12.0);
+        CHECK(near(toHz(engine.phaseIncrement(note)), expected));
+    }
+}
+
+static void testJustIntonation() {
+    ScalaScale scale;
+    KeyboardMap map;
+    TuningTable table;
+    CHECK(scalaParse(JUST_SCL, strlen(JUST_SCL), scale));
+    CHECK(strcmp(scale.description, "5-limit just major") == 0);
+    CHECK(scale.count == 7);
+    CHECK(near(scale.cents[6], 1200.0));
+
+    // Default map: consecutive keys walk the 7 degrees from middle C
+    keyboardMapDefault(map);
+    CHECK(tuningCompile(scale, map, AUDIO_SAMPLE_RATE, table));
+    double c4 = toHz(table.phaseIncrements[60]);
+    CHECK(near(toHz(table.phaseIncrements[61]), c4 * 9 / 8));
+    CHECK(near(toHz(table.phaseIncrements[66]), c4 * 15 / 8));
+    CHECK(near(toHz(table.phaseIncrements[67]), c4 * 2));
+    CHECK(near(toHz(table.phaseIncrements[53]), c4 / 2));
+    // Key 69 is the reference
+    CHECK(near(toHz(table.phaseIncrements[69]), 440.0));
+
+    // White-key map: D is 9/8 above C, black keys silent, A at 432
+    CHECK(keyboardMapParse(WHITE_KBM, strlen(WHITE_KBM), map));
+    CHECK(map.size == 12 && map.octaveDegree == 7 && map.map[1] == KBM_UNMAPPED);
+    CHECK(tuningCompile(scale, map, AUDIO_SAMPLE_RATE, table));
+    CHECK(near(toHz(table.phaseIncrements[69]), 432.0));
+    c4 = toHz(table.phaseIncrements[60]);
+    CHECK(near(c4, 432.0 * 3 / 5));
+    CHECK(near(toHz(table.phaseIncrements[62]), c4 * 9 / 8));
+    CHECK(near(toHz(table.phaseIncrements[72]), c4 * 2));
+    CHECK(near(toHz(table.phaseIncrements[59]), c4 * 15 / 16));
+    CHECK(table.phaseIncrements[61] == 0 && table.phaseIncrements[70] == 0);
+}
+
+static void testNonOctave() {
+    ScalaScale scale;
+    KeyboardMap map;
+    TuningTable table;
+    CHECK(scalaParse(BP_SCL, strlen(BP_SCL), scale));
+    CHECK(scale.count == 13);
+    keyboardMapDefault(map);
+    CHECK(tuningCompile(scale, map, AUDIO_SAMPLE_RATE, table));
+    double c4 = toHz(table.phaseIncrements[60]);
+    CHECK(near(toHz(table.phaseIncrements[73]), c4 * 3));   // Tritave
+    CHECK(near(toHz(table.phaseIncrements[47]), c4 / 3));
+
+    // Keys that would land above Nyquist are left unmapped
+    CHECK(table.phaseIncrements[127] == 0);
+}
+
+static void testMalformed() {
+    ScalaScale scale;
+    KeyboardMap map;
+    const char* noCount = "desc\n";
+    const char* shortList = "desc\n3\n100.0\n200.0\n";
+    const char* badRatio = "desc\n1\n3/0\n";
+    CHECK(!scalaParse(noCount, strlen(noCount), scale));
+    CHECK(!scalaParse(shortList, strlen(shortList), scale));
+    CHECK(!scalaParse(badRatio, strlen(badRatio), scale));
+
+    // Reference key unmapped: refused, old table stays live
+    const char* refUnmapped = "12\n0\n127\n60\n61\n440.0\n12\n0\nx\n";
+    CHECK(keyboardMapParse(refUnmapped, strlen(refUnmapped), map));
+    scalaEqualTemperament(scale);
+    TuningEngine engine;
+    uint32_t generation = engine.getGeneration();
+    uint32_t a4 = engine.phaseIncrement(69);
+    CHECK(!engine.load(scale, map));
+    CHECK(engine.getGeneration() == generation && engine.phaseIncrement(69) == a4);
+}
+
+static void testSwap() {
+    TuningEngine engine;
+    ScalaScale scale;
+    KeyboardMap map;
+    scalaParse(JUST_SCL, strlen(JUST_SCL), scale);
+    keyboardMapDefault(map);
+
+    uint32_t generation = engine.getGeneration();
+    CHECK(engine.load(scale, map));
+    CHECK(engine.getGeneration() == generation + 1);
+    CHECK(strcmp(engine.getDescription(), "5-limit just major") == 0);
+    engine.reset();
+    CHECK(strcmp(engine.getDescription(), "12-TET") == 0);
+    CHECK(engine.load(scale, map));
+    CHECK(near(engine.frequency(69), 440.0));
+}
+
+static void benchmark() {
+    ScalaScale simple, complex;
+    KeyboardMap map;
+    scalaEqualTemperament(simple);
+    scalaParse(BP_SCL, strlen(BP_SCL), complex);
+    keyboardMapDefault(map);
+    TuningEngine engine;
+
+    const uint32_t LOADS = 20000;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < LOADS; i++) engine.load(complex, map);
+    double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Note-on lookup cost is the same table read for either tuning
+    const uint32_t LOOKUPS = 100000000;
+    uint32_t checksum = 0;
+    double lookupSeconds[2];
+    for (int t = 0; t < 2; t++) {
+        engine.load(t ? complex : simple, map);
+        start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < LOOKUPS; i++) checksum += engine.phaseIncrement((uint8_t)(i * 7));
+        lookupSeconds[t] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    printf("\nTuning compile: %.2f us per load (13-note tritave scale)\n", loadSeconds * 1e6 / LOADS);
+    printf("Note lookup: 12-TET %.2f ns, Bohlen-Pierce %.2f ns (checksum %08X)\n",
+           lookupSeconds[0] * 1e9 / LOOKUPS, lookupSeconds[1] * 1e9 / LOOKUPS, checksum);
+}
+
+static size_t readFile(const char* path, char* buffer, size_t size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+    size_t len = fread(buffer, 1, size, f);
+    fclose(f);
+    return len;
+}
+
+static int printFiles(const char* sclPath, const char* kbmPath) {
+    static char text[TUNING_MAX_FILE_SIZE];
+    static ScalaScale scale;
+    static KeyboardMap map;
+    TuningTable table;
+
+    size_t len = readFile(sclPath, text, sizeof(text));
+    if (!scalaParse(text, len, scale)) {
+        printf("Cannot parse %s\n", sclPath);
+        return 1;
+    }
+    keyboardMapDefault(map);
+    if (kbmPath) {
+        len = readFile(kbmPath, text, sizeof(text));
+        if (!keyboardMapParse(text, len, map)) {
+            printf("Cannot parse %s\n", kbmPath);
+            return 1;
+        }
+    }
+    if (!tuningCompile(scale, map, AUDIO_SAMPLE_RATE, table)) {
+        printf("Reference key is unmapped\n");
+        return 1;
+    }
+
+    printf("%s (%u notes)\n", table.description, scale.count);
+    for (int note = 0; note < TUNING_NOTES; note++) {
+        if (table.phaseIncrements[note]) {
+            printf("%3d  %10.4f Hz  %08X\n", note, toHz(table.phaseIncrements[note]), table.phaseIncrements[note]);
+        } else {
+            printf("%3d  unmapped\n", note);
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        return printFiles(argv[1], argc > 2 ? argv[2] : nullptr);
+    }
+
+    printf("=================================\n");
+    printf("Tuning Engine Test\n");
+    printf("=================================\n");
+
+    testEqualTemperament();
+    testJustIntonation();
+    testNonOctave();
+    testMalformed();
+    testSwap();
+
+    if (failures == 0) {
+        printf("All tuning tests passed\n");
+    } else {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+
+    benchmark();
+    return 0;
+}
@@ -0,0 +1,196 @@
+/**
+ * Host Test for the Partitioned Voice Pool
+ * Checks share/limit clamping, exhaustion with two players, which voice
+ * is stolen (oldest of the owner furthest over its share), recycling at
+ * an owner's cap, and that each owner's list stays oldest-first after
+ * voices leave from its middle
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_voice_pool.cpp src/voice_pool.cpp -o test_voice_pool
+ *   ./test_voice_pool
+ */
+
+#include <stdio.h>
+#include "voice_pool.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+// An owner's voices, oldest first, as a count plus the first few
+static int listVoices(const VoicePool& pool, uint8_t owner, uint8_t* out, int max) {
+    int n = 0;
+    for (uint8_t v = pool.first(owner); v != VOICE_NONE; v = pool.next(v)) {
+        if (n < max) out[n] = v;
+        n++;
+    }
+    return n;
+}
+
+static void testShares() {
+    printf("\n--- Shares and limits ---\n");
+    VoicePool pool;
+    pool.init(8, 2);
+    CHECK(pool.freeCount() == 8);
+    CHECK(pool.getShare(0) == 4 && pool.getShare(1) == 4);
+    CHECK(pool.getLimit(0) == 8 && pool.getLimit(1) == 8);
+
+    pool.setShare(0, 10, 20);      // Limit to the pool, share to the limit
+    CHECK(pool.getLimit(0) == 8 && pool.getShare(0) == 8);
+    pool.setShare(1, 5, 3);        // Share never above the limit
+    CHECK(pool.getLimit(1) == 3 && pool.getShare(1) == 3);
+    pool.setShare(2, 1, 1);        // No such owner
+    CHECK(pool.getShare(2) == 0 && pool.getLimit(2) == 0);
+
+    // A limit of 0 shuts an owner out
+    pool.setShare(1, 0, 0);
+    uint8_t stolen;
+    CHECK(pool.allocate(1, &stolen) == VOICE_NONE && stolen == VOICE_NONE);
+    CHECK(pool.allocate(3, &stolen) == VOICE_NONE);
+
+    // init() caps the pool itself
+    pool.init(VOICE_POOL_MAX_VOICES + 4, VOICE_POOL_MAX_OWNERS + 2);
+    CHECK(pool.freeCount() == VOICE_POOL_MAX_VOICES);
+}
+
+static void testExhaustion() {
+    printf("\n--- Two players, pool exhausted ---\n");
+    VoicePool pool;
+    pool.init(6, 2);   // Shares of 3 each
+    uint8_t stolen;
+
+    // Player 0 takes five voices while player 1 is idle: no stealing yet
+    uint8_t p0[5];
+    for (int i = 0; i < 5; i++) {
+        p0[i] = pool.allocate(0, &stolen);
+        CHECK(p0[i] != VOICE_NONE && stolen == VOICE_NONE);
+    }
+    CHECK(p0[0] == 0 && p0[4] == 4);   // Handed out in order
+    uint8_t p1 = pool.allocate(1, &stolen);
+    CHECK(p1 == 5 && stolen == VOICE_NONE && pool.freeCount() == 0);
+
+    // Player 1 is inside its share, so it takes player 0's oldest
+    uint8_t v = pool.allocate(1, &stolen);
+    CHECK(v == p0[0] && stolen == p0[0]);
+    CHECK(pool.ownerOf(v) == 1);
+    CHECK(pool.activeCount(0) == 4 && pool.activeCount(1) == 2);
+    CHECK(pool.getStealCount(0) == 1 && pool.getStealCount(1) == 0);
+
+    // And the next oldest, until player 0 is back down to its share
+    CHECK(pool.allocate(1, &stolen) == p0[1] && stolen == p0[1]);
+    CHECK(pool.activeCount(0) == 3 && pool.activeCount(1) == 3);
+
+    // Both at their share: each recycles its own oldest
+    CHECK(pool.allocate(1, &stolen) == p1 && stolen == p1);
+    CHECK(pool.allocate(0, &stolen) == p0[2] && stolen == p0[2]);
+    CHECK(pool.activeCount(0) == 3 && pool.activeCount(1) == 3);
+    CHECK(pool.getStealCount(0) == 3 && pool.getStealCount(1) == 1);
+}
+
+static void testVictimChoice() {
+    printf("\n--- Victim is furthest over its share ---\n");
+    VoicePool pool;
+    pool.init(8, 3);
+    pool.setShare(0, 1, 8);
+    pool.setShare(1, 2, 8);
+    pool.setShare(2, 2, 8);
+    uint8_t stolen;
+
+    // Owner 0: 3 voices (2 over), owner 1: 5 voices (3 over)
+    uint8_t first1 = VOICE_NONE;
+    for (int i = 0; i < 3; i++) pool.allocate(0, &stolen);
+    for (int i = 0; i < 5; i++) {
+        uint8_t v = pool.allocate(1, &stolen);
+        if (i == 0) first1 = v;
+    }
+    CHECK(pool.freeCount() == 0);
+
+    uint8_t v = pool.allocate(2, &stolen);
+    CHECK(v == first1 && stolen == first1);
+    CHECK(pool.getStealCount(1) == 1 && pool.getStealCount(0) == 0);
+
+    // Now 2 over each: the first found (lowest owner) loses one
+    uint8_t oldest0 = pool.first(0);
+    CHECK(pool.allocate(2, &stolen) == oldest0 && stolen == oldest0);
+}
+
+static void testLimit() {
+    printf("\n--- Recycling at the limit ---\n");
+    VoicePool pool;
+    pool.init(8, 2);
+    pool.setShare(0, 2, 3);
+    uint8_t stolen;
+
+    uint8_t a = pool.allocate(0, &stolen);
+    uint8_t b = pool.allocate(0, &stolen);
+    uint8_t c = pool.allocate(0, &stolen);
+    CHECK(stolen == VOICE_NONE && pool.activeCount(0) == 3);
+
+    // Free voices remain, but the cap makes the owner reuse its oldest
+    CHECK(pool.allocate(0, &stolen) == a && stolen == a);
+    CHECK(pool.freeCount() == 5 && pool.activeCount(0) == 3);
+    uint8_t order[4];
+    CHECK(listVoices(pool, 0, order, 4) == 3);
+    CHECK(order[0] == b && order[1] == c && order[2] == a);
+
+    // A null stolen pointer is allowed
+    CHECK(pool.allocate(0, NULL) == b);
+}
+
+static void testListOrder() {
+    printf("\n--- Oldest-first after releases ---\n");
+    VoicePool pool;
+    pool.init(8, 1);
+    uint8_t stolen;
+    uint8_t v[5];
+    for (int i = 0; i < 5; i++) v[i] = pool.allocate(0, &stolen);
+
+    // Out of the middle, then the head, then the tail
+    pool.release(v[2]);
+    pool.release(v[0]);
+    pool.release(v[4]);
+    CHECK(!pool.isActive(v[2]) && pool.ownerOf(v[2]) == VOICE_NONE);
+    CHECK(pool.activeCount(0) == 2 && pool.freeCount() == 6);
+
+    uint8_t order[8];
+    CHECK(listVoices(pool, 0, order, 8) == 2);
+    CHECK(order[0] == v[1] && order[1] == v[3]);
+
+    // Released twice, or never allocated: ignored
+    pool.release(v[2]);
+    pool.release(7);
+    pool.release(VOICE_NONE);
+    CHECK(pool.freeCount() == 6);
+
+    // New voices join at the tail; the last freed is reused first
+    uint8_t n = pool.allocate(0, &stolen);
+    CHECK(n == v[4] && stolen == VOICE_NONE);
+    CHECK(listVoices(pool, 0, order, 8) == 3);
+    CHECK(order[0] == v[1] && order[1] == v[3] && order[2] == n);
+
+    // Release everything: the list empties cleanly
+    for (uint8_t x = pool.first(0); x != VOICE_NONE; x = pool.first(0)) pool.release(x);
+    CHECK(pool.activeCount(0) == 0 && pool.freeCount() == 8);
+    CHECK(pool.first(0) == VOICE_NONE);
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Voice Pool Test\n");
+    printf("=================================\n");
+
+    testShares();
+    testExhaustion();
+    testVictimChoice();
+    testLimit();
+    testListOrder();
+
+    if (failures == 0) {
+        printf("All voice pool tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
@@ -0,0 +1,150 @@
+/**
+ * Host Test and Benchmark for the Web Assets
+ * Checks If-None-Match matching, path lookup and the generated asset
+ * tables (gzip framing, sizes, which files are versioned), then compares
+ * what a page load costs for each UI: the old single uncompressed page
+ * against the gzipped files on a first visit and on a repeat visit, in
+ * bytes, 536 byte TCP segments (the ESP's TCP_MSS) and heap held for the
+ * body.
+ *
+ * Uses the committed generated headers; regenerate them first if web/
+ * changed (esp8266-wifi/scripts/pre_build.py).
+ *
+ * Build and run on the host:
+ *   g++ -std=c++11 -O2 -Iinclude test/test_web_assets.cpp -o test_web_assets
+ *   ./test_web_assets
+ */
+
+#include <stdio.h>
+#include "web_asset.h"
+
+#define PROGMEM
+namespace esp {
+#include "../../esp8266-wifi/src/web_assets.h"
+}
+namespace osc {
+#include "../../osc_control_web.h"
+}
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+#define TCP_MSS 536
+#define RESPONSE_HEADERS 180    // Status line and headers, roughly
+#define REQUEST_BYTES 400       // A browser GET, roughly
+
+static void testEtag() {
+    const char* etag = "\"8e45a65b8f0a\"";
+    CHECK(webEtagMatches("\"8e45a65b8f0a\"", etag));
+    CHECK(webEtagMatches("W/\"8e45a65b8f0a\"", etag));
+    CHECK(webEtagMatches("\"0000\", \"8e45a65b8f0a\"", etag));
+    CHECK(webEtagMatches("\"0000\",W/\"8e45a65b8f0a\"", etag));
+    CHECK(webEtagMatches("*", etag));
+    CHECK(!webEtagMatches(NULL, etag));
+    CHECK(!webEtagMatches("", etag));
+    CHECK(!webEtagMatches("\"8e45a65b8f0\"", etag));
+    CHECK(!webEtagMatches("\"8e45a65b8f0a", etag));
+    CHECK(!webEtagMatches("\"0000\", \"1111\"", etag));
+}
+
+static void testFind(const WebAsset* assets, size_t count) {
+    const WebAsset* index = webAssetFind(assets, count, "/");
+    CHECK(index && strcmp(index->path, "/index.html") == 0);
+    CHECK(webAssetFind(assets, count, "/index.html") == index);
+    const WebAsset* css = webAssetFind(assets, count, "/app.css?v=0123456789ab");
+    CHECK(css && strcmp(css->type, "text/css") == 0);
+    CHECK(webAssetFind(assets, count, "/app.css") == css);
+    CHECK(webAssetFind(assets, count, "/app.cs") == NULL);
+    CHECK(webAssetFind(assets, count, "/app.css.map") == NULL);
+    CHECK(webAssetFind(assets, count, "/missing") == NULL);
+}
+
+// Each generated asset is a complete gzip stream of its raw size, and
+// everything but the page itself is versioned
+static void testTable(const WebAsset* assets, size_t count) {
+    CHECK(count == 3);
+    for (size_t i = 0; i < count; i++) {
+        const WebAsset& asset = assets[i];
+        CHECK(asset.length > 18 && asset.data[0] == 0x1f && asset.data[1] == 0x8b && asset.data[2] == 8);
+        const uint8_t* trailer = asset.data + asset.length - 4;
+        uint32_t size = trailer[0] | trailer[1] << 8 | trailer[2] << 16 | (uint32_t)trailer[3] << 24;
+        CHECK(size == asset.rawLength);
+        CHECK(asset.length < asset.rawLength / 2);
+        CHECK(asset.etag[0] == '"' && asset.etag[strlen(asset.etag) - 1] == '"');
+        bool page = strcmp(asset.path, "/index.html") == 0;
+        CHECK(asset.immutable == !page);
+        CHECK(strcmp(webAssetCacheControl(asset), page ? WEB_CACHE_REVALIDATE : WEB_CACHE_IMMUTABLE) == 0);
+    }
+}
+
+struct Cost {
+    uint32_t requests;
+    uint32_t bytes;        // Both ways
+    uint32_t segments;     // Server to browser
+    uint32_t heap;         // Held for the body while sending
+};
+
+static uint32_t segmentsFor(uint32_t bytes) { return (bytes + TCP_MSS - 1) / TCP_MSS; }
+
+static void addResponse(Cost& cost, uint32_t body) {
+    cost.requests++;
+    cost.bytes += REQUEST_BYTES + RESPONSE_HEADERS + body;
+    cost.segments += segmentsFor(RESPONSE_HEADERS + body);
+}
+
+// Before: one page with the CSS and JS inline, sent uncompressed on every
+// visit, from PROGMEM (ESP firmware) or built as a String (the sketch)
+static void benchmark(const char* name, const WebAsset* assets, size_t count, bool pageOnHeap) {
+    Cost before = {0, 0, 0, 0};
+    uint32_t page = 0;
+    for (size_t i = 0; i < count; i++) page += assets[i].rawLength;
+    addResponse(before, page);
+    before.heap = pageOnHeap ? page : 0;
+
+    // First visit: every file, gzipped, straight from flash
+    Cost first = {0, 0, 0, 0};
+    for (size_t i = 0; i < count; i++) addResponse(first, assets[i].length);
+
+    // Repeat visit: the page is revalidated (304, no body); the versioned
+    // files come from the browser's cache without a request
+    Cost repeat = {0, 0, 0, 0};
+    for (size_t i = 0; i < count; i++) {
+        if (!assets[i].immutable) addResponse(repeat, 0);
+    }
+
+    printf("%s UI:\n", name);
+    const Cost* costs[3] = {&before, &first, &repeat};
+    const char* labels[3] = {"uncompressed", "gzip, first", "gzip, repeat"};
+    for (int i = 0; i < 3; i++) {
+        printf("  %-13s: %u request(s), %5u bytes, %2u segment(s), %5u heap bytes\n",
+               labels[i], costs[i]->requests, costs[i]->bytes, costs[i]->segments, costs[i]->heap);
+    }
+
+    CHECK(first.segments < before.segments);
+    CHECK(repeat.requests == 1 && repeat.segments == 1);
+    CHECK(first.heap == 0 && repeat.heap == 0);
+}
+
+int main() {
+    printf("=================================\n");
+    printf("Web Assets Test\n");
+    printf("=================================\n");
+
+    testEtag();
+    testFind(esp::webAssets, esp::webAssetCount);
+    testFind(osc::webAssets, osc::webAssetCount);
+    testTable(esp::webAssets, esp::webAssetCount);
+    testTable(osc::webAssets, osc::webAssetCount);
+    benchmark("ESP firmware", esp::webAssets, esp::webAssetCount, false);
+    benchmark("OSC sketch", osc::webAssets, osc::webAssetCount, true);
+
+    if (failures == 0) {
+        printf("All web asset tests passed\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
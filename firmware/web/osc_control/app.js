@@ -0,0 +1,80 @@
+let lastUpdate = 0;
+
+function updateStatus() {
+  fetch('/api/status')
+    .then(r => r.json())
+    .then(data => {
+      document.getElementById('status').className = 'status-indicator status-online';
+      document.getElementById('statusText').textContent = 'Connected';
+
+      if (data.noteOn) {
+        document.getElementById('noteDisplay').textContent = data.noteName || data.lastNote;
+        document.getElementById('noteDisplay').className = 'note-display note-on';
+      } else {
+        document.getElementById('noteDisplay').textContent = '---';
+        document.getElementById('noteDisplay').className = 'note-display';
+      }
+
+      document.getElementById('cpu').textContent = data.cpu.toFixed(1) + '%';
+      document.getElementById('cpuMeter').style.width = data.cpu + '%';
+      document.getElementById('cpuText').textContent = data.cpu.toFixed(1) + '%';
+
+      document.getElementById('mem').textContent = data.mem + ' blocks';
+      document.getElementById('latency').textContent = data.latency + ' μs';
+      document.getElementById('notes').textContent = data.notes;
+
+      document.getElementById('scale').textContent = data.scale;
+      document.getElementById('root').textContent = data.root;
+      document.getElementById('octave').textContent = data.octave;
+      document.getElementById('arp').textContent = data.arp ? 'ON' : 'OFF';
+
+      lastUpdate = Date.now();
+    })
+    .catch(err => {
+      if (Date.now() - lastUpdate > 3000) {
+        document.getElementById('status').className = 'status-indicator status-offline';
+        document.getElementById('statusText').textContent = 'Disconnected';
+      }
+    });
+}
+
+function sendCmd(cmd, value) {
+  fetch('/api/cmd', {
+    method: 'POST',
+    headers: {'Content-Type': 'application/json'},
+    body: JSON.stringify({cmd: cmd, value: value})
+  });
+}
+
+function toggleArp() {
+  fetch('/api/cmd', {
+    method: 'POST',
+    headers: {'Content-Type': 'application/json'},
+    body: JSON.stringify({cmd: 'arp'})
+  });
+}
+
+// How long each ESP loop task waits to run (/api/loop): 99th
+// percentile and worst case since boot
+function formatUs(us) {
+  if (us < 0) return '>65ms';
+  return us >= 1000 ? (us / 1000).toFixed(1) + ' ms' : us + ' μs';
+}
+
+function updateLoop() {
+  fetch('/api/loop')
+    .then(r => r.json())
+    .then(report => {
+      document.getElementById('loopTasks').innerHTML = report.tasks.map(task =>
+        '<div class="info-row"><span class="info-label">' + task.name + ':</span>' +
+        '<span class="info-value">p99 &lt;' + formatUs(task.p99Us) +
+        ', max ' + formatUs(task.maxUs) + '</span></div>').join('');
+    })
+    .catch(() => {});
+}
+
+// Update every 100ms
+setInterval(updateStatus, 100);
+updateStatus();
+setInterval(updateLoop, 2000);
+updateLoop();